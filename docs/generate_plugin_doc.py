@@ -47,10 +47,18 @@ SPECTRUM_ORDERING = ['uniform',
                      'srgb_d65',
                      'blackbody']
 
-SAMPLER_ORDERING = ['independent']
+SAMPLER_ORDERING = ['independent',
+                    'multijitter',
+                    'sobol',
+                    'halton',
+                    'hammersley',
+                    'bluenoise']
 
 INTEGRATOR_ORDERING = ['direct',
                        'path',
+                       'ptracer',
+                       'bdpt',
+                       'sppm',
                        'aov']
 
 FILM_ORDERING = ['hdrfilm']
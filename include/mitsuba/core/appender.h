@@ -27,6 +27,17 @@ public:
         const std::string &formatted, const std::string &eta,
         const void *ptr = nullptr) = 0;
 
+    /**
+     * \brief Process a progress message with machine-readable information
+     * (elapsed time, smoothed ETA, samples and rays per second)
+     *
+     * This is the function invoked by \ref Logger. The default
+     * implementation ignores \c info and forwards to \ref log_progress().
+     */
+    virtual void log_progress_info(float progress, const std::string &name,
+        const std::string &formatted, const std::string &eta,
+        const ProgressInfo &info, const void *ptr = nullptr);
+
     MTS_DECLARE_CLASS()
 protected:
     /// Protected destructor
@@ -75,4 +86,44 @@ private:
     bool m_last_message_was_progress;
 };
 
+/** \brief %Appender implementation, which periodically replaces the contents
+ * of a file by the current progress in JSON format
+ *
+ * The file is written to a temporary file first and then renamed, so that
+ * external tools (e.g. a job scheduler) polling it never observe partial
+ * contents. Log messages are ignored.
+ */
+class MTS_EXPORT_CORE ProgressFileAppender : public Appender {
+public:
+    /// Create a new progress file appender
+    ProgressFileAppender(const std::string &filename);
+
+    /// Ignores log messages
+    void append(LogLevel level, const std::string &text) override;
+
+    /// Ignores progress messages without machine-readable information
+    void log_progress(float progress, const std::string &name,
+        const std::string &formatted, const std::string &eta,
+        const void *ptr) override;
+
+    /// Write the progress to the file
+    void log_progress_info(float progress, const std::string &name,
+        const std::string &formatted, const std::string &eta,
+        const ProgressInfo &info, const void *ptr) override;
+
+    /// Return a string representation
+    std::string to_string() const override;
+
+    MTS_DECLARE_CLASS()
+protected:
+    /// Protected destructor
+    virtual ~ProgressFileAppender() = default;
+
+    /// Report a failure to update the file on stderr (once)
+    void warn(const std::string &message);
+private:
+    std::string m_filename;
+    bool m_warned = false;
+};
+
 NAMESPACE_END(mitsuba)
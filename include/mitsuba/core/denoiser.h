@@ -0,0 +1,96 @@
+#pragma once
+
+#include <mitsuba/core/object.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Feature-guided edge-avoiding à-trous wavelet denoiser
+ *
+ * This class removes the Monte Carlo noise of a rendered image by repeatedly
+ * applying a sparse 5x5 B3-spline kernel, whose footprint doubles with every
+ * iteration [Dammertz et al. 2010]. The kernel weights are reduced across the
+ * edges of optional guide images (shading normals and depth), and across
+ * luminance differences that are large compared to the standard deviation of
+ * the noise [Schied et al. 2017]. The variance of every pixel is filtered
+ * along with its color.
+ *
+ * When an albedo image is provided, the color is divided by it before
+ * filtering and multiplied by it again afterwards, so that textures are
+ * preserved. When the per-pixel variance is not available (e.g. computed with
+ * the \c moment integrator), it is estimated from the luminance of the 5x5
+ * neighborhood of every pixel.
+ *
+ * The rows of the image are processed in parallel, and the color and variance
+ * of every pixel are stored in a single 4-wide SIMD register.
+ */
+class MTS_EXPORT_CORE Denoiser : public Object {
+public:
+    /**
+     * \brief Create a denoiser
+     *
+     * \param iterations
+     *    Number of filtering iterations. The final footprint of the filter
+     *    is <tt>2^(iterations + 2) - 3</tt> pixels wide.
+     *
+     * \param sigma_color
+     *    Luminance differences larger than \c sigma_color standard deviations
+     *    of the noise are considered to be edges
+     *
+     * \param sigma_normal
+     *    Exponent applied to the cosine between the normals of two pixels
+     *
+     * \param sigma_depth
+     *    Tolerance of the depth differences, relative to the depth gradient
+     */
+    Denoiser(uint32_t iterations = 5, float sigma_color = 4.f, float sigma_normal = 128.f,
+             float sigma_depth = 1.f);
+
+    /**
+     * \brief Denoise an image
+     *
+     * All images must have the same size and use the \ref Struct::Type::Float32
+     * component format. The guide images are optional.
+     *
+     * \param image
+     *    Linear RGB or RGBA image. The alpha channel is copied unchanged.
+     *
+     * \param albedo
+     *    RGB image storing the albedo of the visible surfaces
+     *
+     * \param normal
+     *    Three-channel image storing the normal of the visible surfaces
+     *
+     * \param depth
+     *    Single-channel image storing the distance to the visible surfaces
+     *
+     * \param variance
+     *    Single-channel image storing the variance of the luminance of
+     *    every pixel of \c image
+     *
+     * \return A new image with the same format as \c image
+     */
+    ref<Bitmap> denoise(const Bitmap *image,
+                        const Bitmap *albedo = nullptr,
+                        const Bitmap *normal = nullptr,
+                        const Bitmap *depth = nullptr,
+                        const Bitmap *variance = nullptr) const;
+
+    /// Return the number of filtering iterations
+    uint32_t iterations() const { return m_iterations; }
+
+    /// Return a human-readable summary
+    std::string to_string() const override;
+
+    MTS_DECLARE_CLASS()
+protected:
+    virtual ~Denoiser();
+
+protected:
+    uint32_t m_iterations;
+    float m_sigma_color;
+    float m_sigma_normal;
+    float m_sigma_depth;
+};
+
+NAMESPACE_END(mitsuba)
@@ -26,6 +26,7 @@ class Appender;
 class ArgParser;
 class Bitmap;
 class DefaultFormatter;
+class Denoiser;
 class DummyStream;
 class FileResolver;
 class FileStream;
@@ -34,6 +35,7 @@ class Logger;
 class MemoryStream;
 class Mutex;
 class PluginManager;
+struct ProgressInfo;
 class Properties;
 class ScopedThreadEnvironment;
 class Stream;
@@ -286,7 +288,7 @@ template <typename Float_> struct CoreAliases {
         mask = true;
 
 #define MTS_MASKED_FUNCTION(profiler_phase, mask)                                                  \
-    ScopedPhase scope_phase(profiler_phase);                                                       \
+    ScopedPhase scope_phase(profiler_phase, profiler_object(this));                                \
     (void) mask;                                                                                   \
     if constexpr (is_scalar_v<Float>)                                                              \
         mask = true;
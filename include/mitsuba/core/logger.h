@@ -23,6 +23,12 @@ enum LogLevel : int {
  * convert it into a human-readable form. Following that, it sends this
  * information to every registered Appender.
  *
+ * In asynchronous mode (see \ref set_async()), messages are instead pushed
+ * into a lock-free ring buffer and formatted and appended by a background
+ * thread, so that threads emitting many messages don't serialize on the
+ * appenders. Optionally, repeated messages are collapsed and the number of
+ * messages per call site is limited (see \ref set_rate_limit()).
+ *
  * \ingroup libcore
  */
 class MTS_EXPORT_CORE Logger : public Object {
@@ -58,6 +64,14 @@ public:
         const std::string &formatted, const std::string &eta,
         const void *ptr = nullptr);
 
+    /**
+     * \brief Process a progress message with machine-readable progress
+     * information, which is passed to \ref Appender::log_progress_info()
+     */
+    void log_progress(float progress, const std::string &name,
+        const std::string &formatted, const std::string &eta,
+        const ProgressInfo &info, const void *ptr = nullptr);
+
     /// Set the log level (everything below will be ignored)
     void set_log_level(LogLevel level);
 
@@ -77,6 +91,43 @@ public:
     /// Return the current error level
     LogLevel error_level() const;
 
+    /**
+     * \brief Enable or disable asynchronous logging
+     *
+     * When enabled, messages below the error level are queued in a bounded
+     * ring buffer (multiple producers, single consumer) and processed by a
+     * background thread. Messages that don't fit into a full buffer are
+     * dropped and their number is reported. Errors keep synchronous
+     * semantics: all queued messages are processed before the exception is
+     * raised.
+     *
+     * Note that appenders are invoked on the background thread in this mode.
+     * Disabling asynchronous logging processes all pending messages.
+     */
+    void set_async(bool value);
+
+    /// Is asynchronous logging enabled?
+    bool is_async() const;
+
+    /**
+     * \brief Limit the number of messages per call site and second
+     *
+     * Messages in excess of \c count are suppressed, and repeated identical
+     * messages are collapsed. Both are summarized by a message stating the
+     * number of skipped messages. A value of zero (the default) disables
+     * rate limiting and deduplication.
+     */
+    void set_rate_limit(uint32_t count);
+
+    /// Return the maximum number of messages per call site and second
+    uint32_t rate_limit() const;
+
+    /**
+     * \brief Wait until all queued messages have been processed and emit
+     * the summaries of suppressed and repeated messages
+     */
+    void flush();
+
     /// Add an appender to this logger
     void add_appender(Appender *appender);
 
@@ -0,0 +1,149 @@
+/* Accounting of the memory used by Mitsuba's subsystems (current usage and
+   high-water mark per category) */
+
+#pragma once
+
+#include <mitsuba/core/object.h>
+#include <memory>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Categories of tracked allocations
+enum class MemoryCategory : int {
+    Geometry = 0,               /* Mesh vertex and face buffers (shared buffers count once) */
+    KDTreeNodes,                /* kd-tree nodes */
+    KDTreeIndices,              /* kd-tree primitive indices */
+    KDTreeBuild,                /* Temporary storage of the kd-tree builder */
+    Textures,                   /* Bitmap texture data */
+    Volumes,                    /* Volume grid data */
+    Film,                       /* Film storage and image blocks */
+    Integrator,                 /* Caches and photon maps of integrators */
+    Python,                     /* Buffers registered from Python */
+
+    MemoryCategoryCount
+};
+
+constexpr const char
+    *memory_category_id[int(MemoryCategory::MemoryCategoryCount)] = {
+        "geometry",
+        "kdtree_nodes",
+        "kdtree_indices",
+        "kdtree_build",
+        "textures",
+        "volumes",
+        "film",
+        "integrator",
+        "python"
+    };
+
+static_assert(std::extent_v<decltype(memory_category_id)> ==
+                  int(MemoryCategory::MemoryCategoryCount),
+              "Memory categories and descriptions don't have matching length!");
+
+/**
+ * \brief Process-wide accounting of tracked allocations
+ *
+ * Subsystems report their allocations and releases, from which the current
+ * usage and the peak usage (high-water mark) of every category and of all
+ * categories combined are maintained using atomic operations. The sampling
+ * profiler additionally records the peak usage observed during each
+ * \ref ProfilerPhase.
+ */
+class MTS_EXPORT_CORE MemoryTracker : public Object {
+public:
+    /// Account for \c size bytes allocated in the given category
+    static void allocate(MemoryCategory category, size_t size);
+
+    /// Account for \c size bytes released in the given category
+    static void release(MemoryCategory category, size_t size);
+
+    /// Return the current usage of a category in bytes
+    static size_t current(MemoryCategory category);
+
+    /// Return the peak usage of a category in bytes
+    static size_t peak(MemoryCategory category);
+
+    /// Return the current usage of all categories combined in bytes
+    static size_t current_total();
+
+    /// Return the peak usage of all categories combined in bytes
+    static size_t peak_total();
+
+    /// Reset the peak usage of all categories to their current usage
+    static void reset_peak();
+
+    /// Print the current and peak usage of all categories to the log
+    static void print_report();
+
+    MTS_DECLARE_CLASS()
+private:
+    MemoryTracker() = delete;
+};
+
+/**
+ * \brief Tracks an allocation of a given size for the lifetime of this
+ * instance (e.g. as a member next to the storage it describes)
+ */
+class TrackedAllocation {
+public:
+    TrackedAllocation() = default;
+
+    TrackedAllocation(MemoryCategory category, size_t size) { reset(category, size); }
+
+    TrackedAllocation(TrackedAllocation &&other)
+        : m_category(other.m_category), m_size(other.m_size) {
+        other.m_size = 0;
+    }
+
+    TrackedAllocation &operator=(TrackedAllocation &&other) {
+        if (this != &other) {
+            reset();
+            m_category = other.m_category;
+            m_size = other.m_size;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    TrackedAllocation(const TrackedAllocation &) = delete;
+    TrackedAllocation &operator=(const TrackedAllocation &) = delete;
+
+    ~TrackedAllocation() { reset(); }
+
+    /// Release the tracked allocation
+    void reset() {
+        if (m_size > 0)
+            MemoryTracker::release(m_category, m_size);
+        m_size = 0;
+    }
+
+    /// Release the tracked allocation and track a new one
+    void reset(MemoryCategory category, size_t size) {
+        reset();
+        m_category = category;
+        m_size = size;
+        if (m_size > 0)
+            MemoryTracker::allocate(m_category, m_size);
+    }
+
+    /// Return the tracked size in bytes
+    size_t size() const { return m_size; }
+
+private:
+    MemoryCategory m_category = MemoryCategory::Geometry;
+    size_t m_size = 0;
+};
+
+/**
+ * \brief Allocate a reference counted byte buffer that is accounted in the
+ * given category until the last reference to it is released
+ */
+inline std::shared_ptr<uint8_t[]> tracked_shared_buffer(MemoryCategory category, size_t size) {
+    MemoryTracker::allocate(category, size);
+    return std::shared_ptr<uint8_t[]>(new uint8_t[size], [category, size](uint8_t *ptr) {
+        delete[] ptr;
+        MemoryTracker::release(category, size);
+    });
+}
+
+NAMESPACE_END(mitsuba)
@@ -8,6 +8,16 @@
 #  define MTS_PROFILE_HASH_SIZE 256
 #endif
 
+/// Max. number of (run-length encoded) timeline entries recorded per thread
+#if !defined(MTS_PROFILE_TIMELINE_SIZE)
+#  define MTS_PROFILE_TIMELINE_SIZE 16384
+#endif
+
+/// Number of scene objects per thread that can be attributed profiler samples
+#if !defined(MTS_PROFILE_OBJECT_HASH_SIZE)
+#  define MTS_PROFILE_OBJECT_HASH_SIZE 1024
+#endif
+
 NAMESPACE_BEGIN(mitsuba)
 
 /**
@@ -78,14 +88,110 @@ static_assert(std::extent_v<decltype(profiler_phase_id)> ==
                   int(ProfilerPhase::ProfilerPhaseCount),
               "Profiler phases and descriptions don't have matching length!");
 
+/**
+ * Hardware performance counters that can optionally be attributed to the
+ * profiler phases (Linux only, see \ref Profiler::enable_counters())
+ */
+enum class ProfilerCounter : int {
+    Cycles = 0,                 /* CPU cycles */
+    Instructions,               /* Instructions retired */
+    CacheMisses,                /* Last level cache misses */
+    BranchMisses,               /* Mispredicted branches */
+    StalledCycles,              /* Cycles stalled in the backend */
+
+    ProfilerCounterCount
+};
+
+constexpr const char
+    *profiler_counter_id[int(ProfilerCounter::ProfilerCounterCount)] = {
+        "cycles",
+        "instructions",
+        "cache_misses",
+        "branch_misses",
+        "stalled_cycles"
+    };
+
+static_assert(std::extent_v<decltype(profiler_counter_id)> ==
+                  int(ProfilerCounter::ProfilerCounterCount),
+              "Profiler counters and descriptions don't have matching length!");
+
+/// Scene objects whose cost can be attributed to individual instances
+enum class ProfilerObjectType : uint32_t {
+    Material = 0,               /* BSDF instances */
+    Texture,                    /* Texture and spectrum instances */
+    Emitter,                    /* Emitter instances */
+
+    ProfilerObjectTypeCount
+};
+
+constexpr const char
+    *profiler_object_type_id[int(ProfilerObjectType::ProfilerObjectTypeCount)] = {
+        "materials",
+        "textures",
+        "emitters"
+    };
+
+static_assert(int(ProfilerObjectType::ProfilerObjectTypeCount) <= 4,
+              "List of profiler object types is limited to 4 entries");
+
+/**
+ * \brief Register a scene object for per-instance cost attribution
+ *
+ * Returns a handle of the form <tt>(index << 2) | type</tt>, where
+ * <tt>index >= 1</tt>. Handles are never reused, hence costs attributed to
+ * an object remain valid after it has been destroyed.
+ *
+ * Attribution is optional: unless \ref profiler_enable_objects() was called
+ * before the object is created, the function returns zero, and the object's
+ * profiler phases reduce to the plain (unattributed) ones.
+ *
+ * \param plugin
+ *     Name of the plugin (e.g. <tt>roughplastic</tt>)
+ *
+ * \param id
+ *     Identifier of the instance in the scene description
+ */
+extern MTS_EXPORT_CORE uint32_t profiler_register_object(ProfilerObjectType type,
+                                                         const std::string &plugin,
+                                                         const std::string &id);
+
+/**
+ * \brief Make \ref profiler_register_object() return nonzero handles
+ *
+ * Called by \ref Profiler::enable_objects(). Must be invoked before the
+ * scene is loaded.
+ */
+extern MTS_EXPORT_CORE void profiler_enable_objects();
+
+/// Return a descriptive name (<tt>"id [plugin]"</tt>) of a registered object
+extern MTS_EXPORT_CORE std::string profiler_object_name(uint32_t handle);
+
+/**
+ * \brief Return the profiler handle of an object
+ *
+ * Objects are not attributed by default (handle zero). Overloads for BSDFs,
+ * textures and emitters are provided next to the respective classes and are
+ * picked up by \ref MTS_MASKED_FUNCTION.
+ */
+inline uint32_t profiler_object(const void *) { return 0; }
+
+#if defined(MTS_ENABLE_STATS)
+/// Count an invocation of a registered object (see \ref Statistics)
+extern MTS_EXPORT_CORE void stats_count_object(uint32_t handle);
+#endif
+
 #if defined(MTS_ENABLE_PROFILER)
 /* Inlining the access to a thread_local variable produces *awful* machine code
    with Clang on OSX. The combination of weak and noinline is needed to prevent
    the compiler from inlining it (just noinline does not seem to be enough). It
-   is marked as 'const' because separate function calls always produce the same
-   pointer. */
+   is not marked as 'const', since the first call on a thread registers it
+   with the profiler. */
 extern MTS_EXPORT_CORE uint64_t *profiler_flags()
-    __attribute__((noinline, weak, const));
+    __attribute__((noinline, weak));
+
+/// Handles of the innermost active object of each \ref ProfilerObjectType
+extern MTS_EXPORT_CORE uint32_t *profiler_objects()
+    __attribute__((noinline, weak));
 
 struct ScopedPhase {
     ScopedPhase(ProfilerPhase phase)
@@ -96,8 +202,29 @@ struct ScopedPhase {
             m_flag = 0;
     }
 
+    /**
+     * \brief Enter a phase on behalf of a registered object
+     *
+     * Samples taken while the phase is active are additionally attributed
+     * to the object. When calls are nested (e.g. a \c twosided BSDF
+     * invoking its nested BSDF), the innermost object of each type is used.
+     */
+    ScopedPhase(ProfilerPhase phase, uint32_t object) : ScopedPhase(phase) {
+        // Zero unless attribution was enabled (see profiler_register_object())
+        if (unlikely(object != 0)) {
+#if defined(MTS_ENABLE_STATS)
+            stats_count_object(object);
+#endif
+            m_object = profiler_objects() + (object & 3);
+            m_object_prev = *m_object;
+            *m_object = object;
+        }
+    }
+
     ~ScopedPhase() {
         *m_target &= ~m_flag;
+        if (m_object)
+            *m_object = m_object_prev;
     }
 
     ScopedPhase(const ScopedPhase &) = delete;
@@ -106,13 +233,71 @@ struct ScopedPhase {
 private:
     uint64_t* m_target;
     uint64_t  m_flag;
+    uint32_t* m_object = nullptr;
+    uint32_t  m_object_prev = 0;
 };
 
+/**
+ * \brief Sampling profiler
+ *
+ * Samples are recorded into per-thread tables, which are merged when a report
+ * is generated. The reporting functions should be called after
+ * \ref static_shutdown() has stopped the sampling timer.
+ */
 class MTS_EXPORT_CORE Profiler : public Object {
 public:
     static void static_initialization();
     static void static_shutdown();
+
+    /**
+     * \brief Attribute hardware performance counters (cycles, instructions,
+     * cache and branch misses, stalled cycles) to the profiler phases
+     *
+     * Counters are opened per thread using \c perf_event_open() and read
+     * whenever a profiler sample is taken. They are only available on Linux
+     * and require a sufficiently permissive
+     * <tt>/proc/sys/kernel/perf_event_paranoid</tt> setting. Should be
+     * called before any worker threads are launched; threads that already
+     * recorded samples (except for the calling thread) are not monitored.
+     *
+     * \return \c true if the counters could be opened on the calling thread
+     */
+    static bool enable_counters();
+
+    /**
+     * \brief Attribute samples to individual material, texture and emitter
+     * instances (identified by their ID in the scene description) and
+     * report the \c top_n most expensive ones of each type
+     *
+     * Only objects that are created after this call are attributed, hence
+     * it must be invoked before the scene is loaded.
+     */
+    static void enable_objects(size_t top_n = 10);
+
+    /**
+     * \brief Record the per-thread phase timeline that is written by
+     * \ref write_chrome_trace()
+     *
+     * Each thread allocates its timeline when it is first seen by the
+     * profiler, hence this should be called before any worker threads are
+     * launched.
+     */
+    static void enable_trace();
+
+    /// Print a hierarchical and a flat profile to the log
     static void print_report();
+
+    /// Write the hierarchical and flat profile with a per-thread breakdown to a JSON file
+    static void write_json(const fs::path &filename);
+
+    /**
+     * \brief Write the per-thread phase timeline using the Chrome trace event
+     * format (viewable in chrome://tracing, Perfetto or speedscope)
+     *
+     * The timeline is only recorded after \ref enable_trace() was called.
+     */
+    static void write_chrome_trace(const fs::path &filename);
+
     MTS_DECLARE_CLASS()
 private:
     Profiler() = delete;
@@ -121,12 +306,28 @@ private:
 #else
 
 /* Profiler not supported on this platform */
-struct ScopedPhase { ScopedPhase(ProfilerPhase) { } };
+struct ScopedPhase {
+    ScopedPhase(ProfilerPhase) { }
+    ScopedPhase(ProfilerPhase, uint32_t object) {
+#if defined(MTS_ENABLE_STATS)
+        if (unlikely(object != 0))
+            stats_count_object(object);
+#else
+        (void) object;
+#endif
+    }
+};
 class Profiler {
 public:
     static void static_initialization() { }
     static void static_shutdown() { }
+    static bool enable_counters() { return false; }
+    // Object invocations are still counted by the statistics subsystem
+    static void enable_objects(size_t = 10) { profiler_enable_objects(); }
+    static void enable_trace() { }
     static void print_report() { }
+    static void write_json(const fs::path &) { }
+    static void write_chrome_trace(const fs::path &) { }
 };
 
 #endif
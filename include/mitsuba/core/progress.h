@@ -2,15 +2,36 @@
 
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/object.h>
+#include <atomic>
 
 NAMESPACE_BEGIN(mitsuba)
 
+/// Machine-readable state of an operation, as delivered to \ref Appender::log_progress_info()
+struct ProgressInfo {
+    /// Fraction of the work that has been completed (in [0, 1])
+    float progress = 0.f;
+    /// Elapsed time in seconds
+    float elapsed = 0.f;
+    /// Exponentially smoothed estimate of the remaining time in seconds (negative if unknown)
+    float eta = -1.f;
+    /// Number of samples that have been computed so far
+    uint64_t samples = 0;
+    /// Average number of samples computed per second (zero if unknown)
+    double samples_per_second = 0.0;
+    /// Average number of rays traced per second (zero if unknown, requires MTS_ENABLE_STATS)
+    double rays_per_second = 0.0;
+};
+
 /**
  * \brief General-purpose progress reporter
  *
  * This class is used to track the progress of various operations that might
  * take longer than a second or so. It provides interactive feedback when
  * Mitsuba is run on the console, via the OpenGL GUI, or in Jupyter Notebook.
+ *
+ * Progress can be reported from many threads at once via \ref advance(),
+ * which only uses atomic operations. Refreshes are limited to two per second;
+ * threads that find another thread refreshing the display don't wait for it.
  */
 class MTS_EXPORT_CORE ProgressReporter : public Object {
 public:
@@ -20,16 +41,33 @@ public:
      *     An identifying name for the operation taking place (e.g. "Rendering")
      * \param ptr
      *     Custom pointer payload to be delivered as part of progress messages
+     * \param total
+     *     Total amount of work (e.g. the number of blocks), see \ref advance()
      */
-    ProgressReporter(const std::string &label, void *payload = nullptr);
+    ProgressReporter(const std::string &label, void *payload = nullptr,
+                     size_t total = 0);
 
     /// Update the progress to \c progress (which should be in the range [0, 1])
     void update(float progress);
 
+    /**
+     * \brief Account for \c work completed units of work (out of the total
+     * given to the constructor), during which \c samples samples were computed
+     *
+     * This function is thread-safe.
+     */
+    void advance(size_t work = 1, uint64_t samples = 0);
+
     MTS_DECLARE_CLASS()
 protected:
     ~ProgressReporter();
 
+    /// Refresh the display unless another thread is doing so (or always if \c final)
+    void report(float progress, bool final);
+
+    /// Format and send a progress message (only called by one thread at a time)
+    void refresh(float progress);
+
 protected:
     Timer m_timer;
     std::string m_label;
@@ -39,6 +77,14 @@ protected:
     size_t m_last_update;
     float m_last_progress;
     void *m_payload;
+
+    size_t m_total;
+    std::atomic<size_t> m_done { 0 };
+    std::atomic<uint64_t> m_samples { 0 };
+    std::atomic<size_t> m_next_update { 0 };
+    std::atomic<bool> m_refreshing { false };
+    uint64_t m_rays_start;
+    float m_rate;
 };
 
 NAMESPACE_END(mitsuba)
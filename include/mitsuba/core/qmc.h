@@ -183,4 +183,123 @@ private:
     int m_scramble;
 };
 
+// =======================================================================
+//! @{ \name Hash-based randomization of low-discrepancy sequences
+// =======================================================================
+
+/// Reverse the order of the bits of a 32 bit integer
+template <typename UInt32> UInt32 reverse_bits(UInt32 x) {
+    x = sl<16>(x) | sr<16>(x);
+    x = sl<8>(x & 0x00ff00ffu) | sr<8>(x & 0xff00ff00u);
+    x = sl<4>(x & 0x0f0f0f0fu) | sr<4>(x & 0xf0f0f0f0u);
+    x = sl<2>(x & 0x33333333u) | sr<2>(x & 0xccccccccu);
+    x = sl<1>(x & 0x55555555u) | sr<1>(x & 0xaaaaaaaau);
+    return x;
+}
+
+/**
+ * \brief Apply a hash-based approximation of Owen's nested uniform
+ * scrambling to a 32 bit fixed point value
+ *
+ * Every digit is flipped depending on the digits preceding it and on the
+ * \c seed, which preserves the stratification of (0, m, 2)-nets. For
+ * reference, see "Practical Hash-based Owen Scrambling" by Brent Burley,
+ * Journal of Computer Graphics Techniques, Vol. 9, 4, 2020.
+ */
+template <typename UInt32> UInt32 owen_scramble(UInt32 value, UInt32 seed) {
+    value = reverse_bits(value);
+    value ^= value * 0x3d20adeau;
+    value += seed;
+    value *= sr<16>(seed) | 1u;
+    value ^= value * 0x05526c56u;
+    value ^= value * 0x53a22864u;
+    return reverse_bits(value);
+}
+
+/**
+ * \brief Return the \c index-th element of a pseudorandom permutation of
+ * <tt>[0, size)</tt> selected by \c seed
+ *
+ * The permutation is evaluated in constant memory using a hash function
+ * restricted to the next power of two and cycle walking. For reference, see
+ * "Correlated Multi-Jittered Sampling" by Andrew Kensler, Pixar Technical
+ * Memo 13-01, 2013.
+ */
+template <typename UInt32>
+UInt32 permute_kensler(UInt32 index, uint32_t size, UInt32 seed,
+                       mask_t<UInt32> active = true) {
+    if (size <= 1)
+        return zero<UInt32>(slices(index));
+
+    uint32_t w = size - 1;
+    w |= w >> 1;
+    w |= w >> 2;
+    w |= w >> 4;
+    w |= w >> 8;
+    w |= w >> 16;
+
+    auto round = [&](UInt32 i) {
+        i ^= seed;             i *= 0xe170893du;
+        i ^= sr<16>(seed);     i ^= sr<4>(i & w);
+        i ^= sr<8>(seed);      i *= 0x0929eb3fu;
+        i ^= sr<23>(seed);     i ^= sr<1>(i & w);
+        i *= sr<27>(seed) | 1u; i *= 0x6935fa69u;
+        i ^= sr<11>(i & w);    i *= 0x74dcb303u;
+        i ^= sr<2>(i & w);     i *= 0x9e501cc3u;
+        i ^= sr<2>(i & w);     i *= 0xc860a3dfu;
+        i &= w;
+        i ^= sr<5>(i);
+        return i;
+    };
+
+    UInt32 result = round(index);
+
+    // Cycle walking: repeat until the result lies within [0, size)
+    mask_t<UInt32> invalid = active;
+    invalid &= result >= size;
+    while (any(invalid)) {
+        masked(result, invalid) = round(result);
+        invalid &= result >= size;
+    }
+
+    return (result + seed) % size;
+}
+
+/**
+ * \brief Evaluate the first two dimensions of the Sobol sequence
+ *
+ * Returns 32 bit fixed point values. Together, they form a (0, 2)-sequence in
+ * base 2: every aligned block of \f$2^m\f$ points is stratified with respect
+ * to all elementary intervals of area \f$2^{-m}\f$.
+ */
+template <typename UInt32> std::pair<UInt32, UInt32> sobol_2d(const UInt32 &index) {
+    UInt32 y = zero<UInt32>();
+    uint32_t v = 1u << 31;
+    for (int i = 0; i < 32; ++i) {
+        y ^= ((index >> i) & 1u) * v;
+        v ^= v >> 1;
+    }
+    return { reverse_bits(index), y };
+}
+
+/**
+ * \brief 256x256 blue noise threshold matrix generated using forced random
+ * dithering
+ *
+ * Contains a permutation of the integers <tt>0..65535</tt>, where the value
+ * \c k is stored as <tt>k / 65535 - 0.5</tt>. Used to dither images during
+ * quantization and to decorrelate the sample sequences of neighboring pixels.
+ */
+extern MTS_EXPORT_CORE const float dither_matrix256[65536];
+
+/// Convert a 32 bit fixed point value into a floating point value in [0, 1)
+template <typename Float, typename UInt32>
+Float fixed_to_unit(const UInt32 &value) {
+    return min(math::OneMinusEpsilon<Float>,
+               Float(value) * scalar_t<Float>(2.3283064365386963e-10 /* 2^-32 */));
+}
+
+//! @}
+// =======================================================================
+
 NAMESPACE_END(mitsuba)
@@ -0,0 +1,98 @@
+/* Machine-readable summary of a rendering job: timings of its stages,
+   memory usage and throughput figures (see the -r/--report switch of the
+   'mitsuba' executable) */
+
+#pragma once
+
+#include <mitsuba/core/object.h>
+#include <string>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Stages of a rendering job, whose wall clock and CPU time are recorded
+enum class ReportStage : int {
+    Parse = 0,                  /* Parsing of the XML scene description */
+    Geometry,                   /* Loading of mesh data from disk */
+    Textures,                   /* Loading and conversion of bitmap textures */
+    AccelBuild,                 /* Construction of the ray tracing acceleration data structure */
+    Render,                     /* Integrator::render() */
+    Develop,                    /* Film::develop() */
+
+    ReportStageCount
+};
+
+constexpr const char
+    *report_stage_id[int(ReportStage::ReportStageCount)] = {
+        "parse",
+        "geometry",
+        "textures",
+        "accel_build",
+        "render",
+        "develop"
+    };
+
+static_assert(std::extent_v<decltype(report_stage_id)> ==
+                  int(ReportStage::ReportStageCount),
+              "Report stages and descriptions don't have matching length!");
+
+class MTS_EXPORT_CORE RenderReport : public Object {
+public:
+    /// Clear all timings and values, and reset the peak memory usage (\ref MemoryTracker)
+    static void reset();
+
+    /**
+     * \brief Mark the beginning of a stage
+     *
+     * Stages may be entered by several threads at the same time (e.g. when
+     * meshes are loaded in parallel), in which case the recorded wall clock
+     * time corresponds to the union of the intervals and CPU time refers to
+     * the whole process during that period. Distinct stages may overlap.
+     */
+    static void begin_stage(ReportStage stage);
+
+    /// Mark the end of a stage started with \ref begin_stage()
+    static void end_stage(ReportStage stage);
+
+    /// Set a named scalar quantity (e.g. thread count, samples per second)
+    static void set_value(const std::string &name, double value);
+
+    /**
+     * \brief Write the report to a JSON file
+     *
+     * Contains the wall clock and CPU time of every stage, the peak
+     * resident set size of the process, the peak memory usage of every
+     * \ref MemoryCategory and the values specified via \ref set_value().
+     */
+    static void write_json(const fs::path &filename);
+
+    MTS_DECLARE_CLASS()
+private:
+    RenderReport() = delete;
+};
+
+/// RAII helper that records the duration of a stage in the \ref RenderReport
+class ScopedStage {
+public:
+    ScopedStage(ReportStage stage) : m_stage(stage) {
+        RenderReport::begin_stage(stage);
+    }
+
+    /// End the stage before the scope is left
+    void finish() {
+        if (m_active) {
+            RenderReport::end_stage(m_stage);
+            m_active = false;
+        }
+    }
+
+    ~ScopedStage() { finish(); }
+
+    ScopedStage(const ScopedStage &) = delete;
+    ScopedStage &operator=(const ScopedStage &) = delete;
+
+private:
+    ReportStage m_stage;
+    bool m_active = true;
+};
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,177 @@
+/* Render statistics (counters and histograms). Compiled out unless Mitsuba
+   is built with the MTS_ENABLE_STATS CMake option. */
+
+#pragma once
+
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/simd.h>
+
+#if !defined(MTS_STATS_HISTOGRAM_BINS)
+#  define MTS_STATS_HISTOGRAM_BINS 64
+#endif
+
+/// Number of most frequently invoked materials, textures and emitters to report
+#if !defined(MTS_STATS_TOP_OBJECTS)
+#  define MTS_STATS_TOP_OBJECTS 10
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// List of counters maintained by the statistics subsystem
+enum class StatsCounter : int {
+    CameraRays = 0,             /* Rays generated by SamplingIntegrator::render_sample() */
+    IntersectRays,              /* Scene::ray_intersect() queries */
+    IntersectHits,              /* .. that found an intersection */
+    ShadowRays,                 /* Scene::ray_test() queries */
+    ShadowRaysOccluded,         /* .. that were occluded */
+    KDTreeTraversals,           /* Rays traversing the kd-tree */
+    KDTreeNodes,                /* Interior kd-tree nodes visited */
+    KDTreePrimitives,           /* Ray-primitive tests performed in kd-tree leaves */
+    BSDFSamples,                /* BSDF::sample() calls made by integrators */
+    BSDFSamplesZero,            /* .. that returned a zero-valued weight */
+
+    StatsCounterCount
+};
+
+constexpr const char
+    *stats_counter_id[int(StatsCounter::StatsCounterCount)] = {
+        "Camera rays",
+        "Intersection rays",
+        "Intersection rays (hit)",
+        "Shadow rays",
+        "Shadow rays (occluded)",
+        "kd-tree traversals",
+        "kd-tree nodes visited",
+        "kd-tree primitive tests",
+        "BSDF samples",
+        "BSDF samples (zero weight)"
+    };
+
+/// List of histograms maintained by the statistics subsystem
+enum class StatsHistogram : int {
+    PathLength = 0,             /* Number of surface interactions of paths */
+
+    StatsHistogramCount
+};
+
+constexpr const char
+    *stats_histogram_id[int(StatsHistogram::StatsHistogramCount)] = {
+        "Path length"
+    };
+
+static_assert(std::extent_v<decltype(stats_counter_id)> ==
+                  int(StatsCounter::StatsCounterCount),
+              "Statistics counters and descriptions don't have matching length!");
+
+static_assert(std::extent_v<decltype(stats_histogram_id)> ==
+                  int(StatsHistogram::StatsHistogramCount),
+              "Statistics histograms and descriptions don't have matching length!");
+
+#if defined(MTS_ENABLE_STATS)
+
+/// Per-thread counter storage, merged by \ref Statistics when reporting
+struct StatsData {
+    uint64_t counters[int(StatsCounter::StatsCounterCount)];
+    uint64_t histograms[int(StatsHistogram::StatsHistogramCount)]
+                       [MTS_STATS_HISTOGRAM_BINS];
+    /// Invocations of registered scene objects, indexed by <tt>handle >> 2</tt>
+    std::vector<uint64_t> objects[int(ProfilerObjectType::ProfilerObjectTypeCount)];
+};
+
+/// Return the statistics of the calling thread
+extern MTS_EXPORT_CORE StatsData *stats_data();
+
+NAMESPACE_BEGIN(detail)
+
+/// Number of active lanes (not computed for CUDA arrays, since it would force evaluation)
+template <typename Mask> uint64_t stats_count(const Mask &mask) {
+    if constexpr (std::is_same_v<Mask, bool>)
+        return mask ? 1 : 0;
+    else if constexpr (is_cuda_array_v<Mask>)
+        return 0;
+    else
+        return (uint64_t) enoki::count(mask);
+}
+
+template <typename Value, typename Mask>
+void stats_histogram(StatsHistogram h, const Value &value, const Mask &mask) {
+    uint64_t *bins = stats_data()->histograms[int(h)];
+    auto put = [bins](uint64_t v) {
+        bins[std::min(v, (uint64_t) MTS_STATS_HISTOGRAM_BINS - 1)]++;
+    };
+
+    if constexpr (std::is_same_v<Mask, bool>) {
+        if (mask)
+            put((uint64_t) value);
+    } else if constexpr (!is_cuda_array_v<Mask>) {
+        for (size_t i = 0; i < array_size_v<Mask>; ++i) {
+            if (mask.coeff(i))
+                put((uint64_t) value.coeff(i));
+        }
+    }
+}
+
+NAMESPACE_END(detail)
+
+/// Expands to its arguments only when statistics are enabled
+#define MTS_STATS_ONLY(...) __VA_ARGS__
+
+/// Add \c value to the given counter
+#define MTS_STATS_ADD(counter, value)                                          \
+    (::mitsuba::stats_data()->counters[int(::mitsuba::StatsCounter::counter)] += \
+         (uint64_t) (value))
+
+/// Add the number of active entries of \c mask to the given counter
+#define MTS_STATS_COUNT(counter, mask)                                         \
+    MTS_STATS_ADD(counter, ::mitsuba::detail::stats_count(mask))
+
+/// Record the active entries of \c value in the given histogram
+#define MTS_STATS_HISTOGRAM(histogram, value, mask)                            \
+    ::mitsuba::detail::stats_histogram(                                        \
+        ::mitsuba::StatsHistogram::histogram, value, mask)
+
+class MTS_EXPORT_CORE Statistics : public Object {
+public:
+    /// Clear all counters and histograms
+    static void reset();
+
+    /// Return the current value of a counter, summed over all threads
+    static uint64_t counter(StatsCounter counter);
+
+    /**
+     * \brief Print a summary table to the log
+     *
+     * \param render_time
+     *     Duration of the rendering process in seconds, used to compute
+     *     throughput metrics such as rays per second (if nonzero).
+     */
+    static void print_report(double render_time = 0.0);
+
+    /// Write all counters, derived quantities and histograms to a JSON file
+    static void write_json(const fs::path &filename, double render_time = 0.0);
+
+    MTS_DECLARE_CLASS()
+private:
+    Statistics() = delete;
+};
+
+#else
+
+#define MTS_STATS_ONLY(...)
+#define MTS_STATS_ADD(counter, value)               do { (void) sizeof(value); } while (0)
+#define MTS_STATS_COUNT(counter, mask)              do { (void) sizeof(mask); } while (0)
+#define MTS_STATS_HISTOGRAM(histogram, value, mask) do { (void) sizeof(value); (void) sizeof(mask); } while (0)
+
+/* Statistics are disabled */
+class Statistics {
+public:
+    static void reset() { }
+    static uint64_t counter(StatsCounter) { return 0; }
+    static void print_report(double = 0.0) { }
+    static void write_json(const fs::path &, double = 0.0) { }
+};
+
+#endif
+
+NAMESPACE_END(mitsuba)
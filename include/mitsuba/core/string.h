@@ -95,5 +95,8 @@ inline void replace_inplace(std::string &str, const std::string &source,
 extern MTS_EXPORT_CORE std::string trim(const std::string &s,
                                         const std::string &whitespace = " \t");
 
+/// Quote and escape a string for inclusion in a JSON document
+extern MTS_EXPORT_CORE std::string json_string(const std::string &s);
+
 NAMESPACE_END(string)
 NAMESPACE_END(mitsuba)
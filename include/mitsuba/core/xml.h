@@ -29,16 +29,36 @@ using ParameterList = std::vector<std::pair<std::string, std::string>>;
  * \param update_scene
  *     When Mitsuba updates scene to a newer version, should the
  *     updated XML file be written back to disk?
+ *
+ * \param use_cache
+ *     Store the parsed scene description in a binary cache file next to
+ *     the scene (<tt>path + ".cache"</tt>) and reuse it on subsequent loads
+ *     with identical file contents, variant and parameters. This skips XML
+ *     parsing, parameter substitution and version upgrades.
+ *
+ * \param stream_objects
+ *     Instantiate top-level objects whose references are resolved while the
+ *     rest of the file is still being parsed, so that plugin construction
+ *     overlaps with parsing. Errors in later parts of the file may then be
+ *     reported after earlier objects were created. Ignored when
+ *     \c use_cache is set.
  */
 extern MTS_EXPORT_CORE ref<Object> load_file(const fs::path &path,
                                              const std::string &variant,
                                              ParameterList parameters = ParameterList(),
-                                             bool update_scene = false);
+                                             bool update_scene = false,
+                                             bool use_cache = false,
+                                             bool stream_objects = false);
 
-/// Load a Mitsuba scene from an XML string
+/**
+ * \brief Load a Mitsuba scene from an XML string
+ *
+ * See \ref load_file() for a description of the \c stream_objects parameter.
+ */
 extern MTS_EXPORT_CORE ref<Object> load_string(const std::string &string,
                                                const std::string &variant,
-                                               ParameterList parameters = ParameterList());
+                                               ParameterList parameters = ParameterList(),
+                                               bool stream_objects = false);
 
 NAMESPACE_END(xml)
 NAMESPACE_END(mitsuba)
@@ -115,6 +115,13 @@ Parameter ``ptr``:
     progress message. When rendering a scene, it will usually contain
     a pointer to the associated ``RenderJob``.)doc";
 
+static const char *__doc_mitsuba_Appender_log_progress_info =
+R"doc(Process a progress message with machine-readable information (elapsed
+time, smoothed ETA, samples and rays per second)
+
+This is the function invoked by Logger. The default implementation
+ignores ``info`` and forwards to log_progress().)doc";
+
 static const char *__doc_mitsuba_ArgParser =
 R"doc(Minimal command line argument parser
 
@@ -1503,6 +1510,82 @@ static const char *__doc_mitsuba_DefaultFormatter_set_has_log_level = R"doc(Shou
 
 static const char *__doc_mitsuba_DefaultFormatter_set_has_thread = R"doc(Should thread information be included? The default is yes.)doc";
 
+static const char *__doc_mitsuba_Denoiser =
+R"doc(Feature-guided edge-avoiding à-trous wavelet denoiser
+
+This class removes the Monte Carlo noise of a rendered image by
+repeatedly applying a sparse 5x5 B3-spline kernel, whose footprint
+doubles with every iteration [Dammertz et al. 2010]. The kernel
+weights are reduced across the edges of optional guide images (shading
+normals and depth), and across luminance differences that are large
+compared to the standard deviation of the noise [Schied et al. 2017].
+The variance of every pixel is filtered along with its color.
+
+When an albedo image is provided, the color is divided by it before
+filtering and multiplied by it again afterwards, so that textures are
+preserved. When the per-pixel variance is not available (e.g. computed
+with the ``moment`` integrator), it is estimated from the luminance of
+the 5x5 neighborhood of every pixel.
+
+The rows of the image are processed in parallel, and the color and
+variance of every pixel are stored in a single 4-wide SIMD register.)doc";
+
+static const char *__doc_mitsuba_Denoiser_Denoiser =
+R"doc(Create a denoiser
+
+Parameter ``iterations``:
+    Number of filtering iterations. The final footprint of the filter
+    is <tt>2^(iterations + 2) - 3</tt> pixels wide.
+
+Parameter ``sigma_color``:
+    Luminance differences larger than ``sigma_color`` standard
+    deviations of the noise are considered to be edges
+
+Parameter ``sigma_normal``:
+    Exponent applied to the cosine between the normals of two pixels
+
+Parameter ``sigma_depth``:
+    Tolerance of the depth differences, relative to the depth gradient)doc";
+
+static const char *__doc_mitsuba_Denoiser_class = R"doc()doc";
+
+static const char *__doc_mitsuba_Denoiser_denoise =
+R"doc(Denoise an image
+
+All images must have the same size and use the Struct::Type::Float32
+component format. The guide images are optional.
+
+Parameter ``image``:
+    Linear RGB or RGBA image. The alpha channel is copied unchanged.
+
+Parameter ``albedo``:
+    RGB image storing the albedo of the visible surfaces
+
+Parameter ``normal``:
+    Three-channel image storing the normal of the visible surfaces
+
+Parameter ``depth``:
+    Single-channel image storing the distance to the visible surfaces
+
+Parameter ``variance``:
+    Single-channel image storing the variance of the luminance of
+    every pixel of ``image``
+
+Returns:
+    A new image with the same format as ``image``)doc";
+
+static const char *__doc_mitsuba_Denoiser_iterations = R"doc(Return the number of filtering iterations)doc";
+
+static const char *__doc_mitsuba_Denoiser_m_iterations = R"doc()doc";
+
+static const char *__doc_mitsuba_Denoiser_m_sigma_color = R"doc()doc";
+
+static const char *__doc_mitsuba_Denoiser_m_sigma_depth = R"doc()doc";
+
+static const char *__doc_mitsuba_Denoiser_m_sigma_normal = R"doc()doc";
+
+static const char *__doc_mitsuba_Denoiser_to_string = R"doc(Return a human-readable summary)doc";
+
 static const char *__doc_mitsuba_DirectionSample =
 R"doc(Record for solid-angle based area sampling techniques
 
@@ -2128,6 +2211,15 @@ static const char *__doc_mitsuba_Film_4 = R"doc()doc";
 
 static const char *__doc_mitsuba_Film_Film = R"doc(Create a film)doc";
 
+static const char *__doc_mitsuba_Film_add_splats =
+R"doc(Add the splat buffer to the raw contents of a film
+
+``data`` holds the unnormalized pixels of the crop window with the
+channel layout passed to prepare(), where channel 4 stores the pixel
+weights. The splats are scaled by the weight of each pixel so that
+they remain unaffected by normalization. Pixels without any weight are
+assigned a unit weight instead.)doc";
+
 static const char *__doc_mitsuba_Film_bitmap = R"doc(Return a bitmap object storing the developed contents of the film)doc";
 
 static const char *__doc_mitsuba_Film_class = R"doc()doc";
@@ -2168,10 +2260,28 @@ static const char *__doc_mitsuba_Film_m_high_quality_edges = R"doc()doc";
 
 static const char *__doc_mitsuba_Film_m_size = R"doc()doc";
 
+static const char *__doc_mitsuba_Film_m_splats = R"doc(Accumulated normalized contributions (see put_normalized()))doc";
+
+static const char *__doc_mitsuba_Film_m_splats_mutex = R"doc()doc";
+
 static const char *__doc_mitsuba_Film_prepare = R"doc(Configure the film for rendering a specified set of channels)doc";
 
 static const char *__doc_mitsuba_Film_put = R"doc(Merge an image block into the film)doc";
 
+static const char *__doc_mitsuba_Film_put_normalized =
+R"doc(Add an image block whose pixel values are already normalized
+
+Unlike put(), the values are not divided by the accumulated weight of
+the film when it is developed. This is used to add the contributions
+that integrators splat at arbitrary image positions (e.g. the light
+image of a bidirectional path tracer). The weight channel of ``block``
+is ignored.
+
+The default implementation accumulates ``block`` in a separate splat
+buffer, independently of the pixel weights. Films add it to the
+normalized pixel values when they are developed (see add_splats()) and
+discard it in prepare().)doc";
+
 static const char *__doc_mitsuba_Film_reconstruction_filter = R"doc(Return the image reconstruction filter (const version))doc";
 
 static const char *__doc_mitsuba_Film_set_crop_window = R"doc(Set the size and offset of the crop window.)doc";
@@ -2575,6 +2685,16 @@ Returns:
     negative. A warning is also printed if ``m_warn_negative`` or
     ``m_warn_invalid`` is enabled.)doc";
 
+static const char *__doc_mitsuba_ImageBlock_put_atomic =
+R"doc(Thread-safe version of put(const Point2f &, const Float *, Mask)
+
+Several threads may splat samples into the same block concurrently,
+which is needed when the sample positions are not confined to a part
+of the image (e.g. in light tracing). The values are accumulated using
+atomic operations. The reconstruction weights are always normalized,
+so that every sample adds a unit amount of energy. Not supported in
+GPU variants.)doc";
+
 static const char *__doc_mitsuba_ImageBlock_set_offset =
 R"doc(Set the current block offset.
 
@@ -2826,10 +2946,15 @@ static const char *__doc_mitsuba_Logger_d = R"doc()doc";
 
 static const char *__doc_mitsuba_Logger_error_level = R"doc(Return the current error level)doc";
 
+static const char *__doc_mitsuba_Logger_flush = R"doc(Wait until all queued messages have been processed and emit the
+summaries of suppressed and repeated messages)doc";
+
 static const char *__doc_mitsuba_Logger_formatter = R"doc(Return the logger's formatter implementation)doc";
 
 static const char *__doc_mitsuba_Logger_formatter_2 = R"doc(Return the logger's formatter implementation (const))doc";
 
+static const char *__doc_mitsuba_Logger_is_async = R"doc(Is asynchronous logging enabled?)doc";
+
 static const char *__doc_mitsuba_Logger_log =
 R"doc(Process a log message
 
@@ -2873,8 +2998,14 @@ Parameter ``ptr``:
     progress message. When rendering a scene, it will usually contain
     a pointer to the associated ``RenderJob``.)doc";
 
+static const char *__doc_mitsuba_Logger_log_progress_2 =
+R"doc(Process a progress message with machine-readable progress
+information, which is passed to Appender::log_progress_info())doc";
+
 static const char *__doc_mitsuba_Logger_m_log_level = R"doc()doc";
 
+static const char *__doc_mitsuba_Logger_rate_limit = R"doc(Return the maximum number of messages per call site and second)doc";
+
 static const char *__doc_mitsuba_Logger_read_log =
 R"doc(Return the contents of the log file as a string
 
@@ -2882,6 +3013,18 @@ Throws a runtime exception upon failure)doc";
 
 static const char *__doc_mitsuba_Logger_remove_appender = R"doc(Remove an appender from this logger)doc";
 
+static const char *__doc_mitsuba_Logger_set_async = R"doc(Enable or disable asynchronous logging
+
+When enabled, messages below the error level are queued in a bounded
+ring buffer (multiple producers, single consumer) and processed by a
+background thread. Messages that don't fit into a full buffer are
+dropped and their number is reported. Errors keep synchronous
+semantics: all queued messages are processed before the exception is
+raised.
+
+Note that appenders are invoked on the background thread in this mode.
+Disabling asynchronous logging processes all pending messages.)doc";
+
 static const char *__doc_mitsuba_Logger_set_error_level =
 R"doc(Set the error log level (this level and anything above will throw
 exceptions).
@@ -2894,6 +3037,13 @@ static const char *__doc_mitsuba_Logger_set_formatter = R"doc(Set the logger's f
 
 static const char *__doc_mitsuba_Logger_set_log_level = R"doc(Set the log level (everything below will be ignored))doc";
 
+static const char *__doc_mitsuba_Logger_set_rate_limit = R"doc(Limit the number of messages per call site and second
+
+Messages in excess of ``count`` are suppressed, and repeated identical
+messages are collapsed. Both are summarized by a message stating the
+number of skipped messages. A value of zero (the default) disables
+rate limiting and deduplication.)doc";
+
 static const char *__doc_mitsuba_Logger_static_initialization = R"doc(Initialize logging)doc";
 
 static const char *__doc_mitsuba_Logger_static_shutdown = R"doc(Shutdown logging)doc";
@@ -3121,6 +3271,8 @@ static const char *__doc_mitsuba_Medium_to_string = R"doc(Return a human-readabl
 
 static const char *__doc_mitsuba_Medium_use_emitter_sampling = R"doc(Returns whether this specific medium instance uses emitter sampling)doc";
 
+static const char *__doc_mitsuba_MemoryCategory = R"doc(Categories of tracked allocations)doc";
+
 static const char *__doc_mitsuba_MemoryMappedFile =
 R"doc(Basic cross-platform abstraction for memory mapped files
 
@@ -3258,6 +3410,35 @@ static const char *__doc_mitsuba_MemoryStream_write =
 R"doc(Writes a specified amount of data into the memory buffer. The capacity
 of the memory buffer is extended if necessary.)doc";
 
+static const char *__doc_mitsuba_MemoryTracker =
+R"doc(Process-wide accounting of tracked allocations
+
+Subsystems report their allocations and releases, from which the
+current usage and the peak usage (high-water mark) of every category
+and of all categories combined are maintained using atomic operations.
+The sampling profiler additionally records the peak usage observed
+during each ProfilerPhase.)doc";
+
+static const char *__doc_mitsuba_MemoryTracker_MemoryTracker = R"doc()doc";
+
+static const char *__doc_mitsuba_MemoryTracker_allocate = R"doc(Account for ``size`` bytes allocated in the given category)doc";
+
+static const char *__doc_mitsuba_MemoryTracker_class = R"doc()doc";
+
+static const char *__doc_mitsuba_MemoryTracker_current = R"doc(Return the current usage of a category in bytes)doc";
+
+static const char *__doc_mitsuba_MemoryTracker_current_total = R"doc(Return the current usage of all categories combined in bytes)doc";
+
+static const char *__doc_mitsuba_MemoryTracker_peak = R"doc(Return the peak usage of a category in bytes)doc";
+
+static const char *__doc_mitsuba_MemoryTracker_peak_total = R"doc(Return the peak usage of all categories combined in bytes)doc";
+
+static const char *__doc_mitsuba_MemoryTracker_print_report = R"doc(Print the current and peak usage of all categories to the log)doc";
+
+static const char *__doc_mitsuba_MemoryTracker_release = R"doc(Account for ``size`` bytes released in the given category)doc";
+
+static const char *__doc_mitsuba_MemoryTracker_reset_peak = R"doc(Reset the peak usage of all categories to their current usage)doc";
+
 static const char *__doc_mitsuba_Mesh = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_2 = R"doc()doc";
@@ -3288,8 +3469,34 @@ static const char *__doc_mitsuba_Mesh_bbox_2 = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_bbox_3 = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_buffer_hash =
+R"doc(Return a hash of the vertex and face buffer contents
+
+Two meshes with equal hashes are candidates for deduplication, which
+must then be confirmed using has_identical_buffers().)doc";
+
 static const char *__doc_mitsuba_Mesh_class = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_compact_attributes =
+R"doc(Re-encode the vertex and face buffers using compact encodings
+
+Vertex positions are left untouched, while normals are stored using an
+octahedral encoding (2x16 bit), texture coordinates as half precision
+values, and colors as normalized 8-bit values. Meshes with at most
+65536 vertices furthermore switch to 16-bit face indices (except when
+Embree is used, which requires 32-bit indices). Attributes are decoded
+on the fly by vertex_normal(), vertex_texcoord() and vertex_color().
+The raw buffers returned by vertices() and faces() keep the encoded
+values, see decoded_buffers().)doc";
+
+static const char *__doc_mitsuba_Mesh_decoded_buffers =
+R"doc(Return the vertex and face buffers with full precision attributes and
+32-bit face indices, along with Struct instances describing them
+
+This undoes the encodings of compact_attributes() (the result is a copy
+in this case) and is used to export such meshes. The buffers of other
+meshes are returned as they are.)doc";
+
 static const char *__doc_mitsuba_Mesh_face = R"doc(Return a pointer (or packet of pointers) to a specific face)doc";
 
 static const char *__doc_mitsuba_Mesh_face_2 =
@@ -3312,6 +3519,12 @@ static const char *__doc_mitsuba_Mesh_faces_2 = R"doc(Return a pointer to the ra
 
 static const char *__doc_mitsuba_Mesh_fill_surface_interaction = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_has_compact_attributes = R"doc(Are vertex attributes and/or face indices stored using compact encodings?)doc";
+
+static const char *__doc_mitsuba_Mesh_has_identical_buffers = R"doc(Check whether ``other`` stores byte-identical vertex and face buffers)doc";
+
+static const char *__doc_mitsuba_Mesh_has_shared_buffers = R"doc(Is the vertex/face storage of this mesh shared with another mesh?)doc";
+
 static const char *__doc_mitsuba_Mesh_has_vertex_colors = R"doc(Does this mesh have per-vertex texture colors?)doc";
 
 static const char *__doc_mitsuba_Mesh_has_vertex_normals = R"doc(Does this mesh have per-vertex normals?)doc";
@@ -3356,6 +3569,16 @@ static const char *__doc_mitsuba_Mesh_m_vertices = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_normal_derivative = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_optimize_layout =
+R"doc(Reorder faces and vertices to improve memory locality
+
+Faces are sorted along a Morton (Z-order) curve through their
+centroids, and vertices are subsequently renumbered in the order of
+their first use. Spatially neighboring triangles then reside in nearby
+memory locations, which reduces the number of cache lines touched when
+traversing kd-tree leaves. Must be called before the acceleration data
+structure is built.)doc";
+
 static const char *__doc_mitsuba_Mesh_parameters_changed = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_pdf_position = R"doc()doc";
@@ -3387,6 +3610,17 @@ static const char *__doc_mitsuba_Mesh_recompute_vertex_normals = R"doc(Compute s
 
 static const char *__doc_mitsuba_Mesh_sample_position = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_share_buffers =
+R"doc(Release this mesh's vertex and face buffers and instead reference the
+(identical) storage of ``other``
+
+Shared buffers are treated as immutable: modifying the vertices of one
+mesh (e.g. via recompute_vertex_normals()) after this call would also
+affect all other meshes referencing the same storage.
+
+Returns:
+    The number of bytes that were released)doc";
+
 static const char *__doc_mitsuba_Mesh_surface_area = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_to_string = R"doc(Return a human-readable string representation of the shape contents.)doc";
@@ -3399,6 +3633,12 @@ static const char *__doc_mitsuba_Mesh_vertex_2 =
 R"doc(Return a pointer (or packet of pointers) to a specific vertex (const
 version))doc";
 
+static const char *__doc_mitsuba_Mesh_vertex_color =
+R"doc(Returns the color of the vertex with index ``index``
+
+Remark:
+    Not supported by the GPU variants)doc";
+
 static const char *__doc_mitsuba_Mesh_vertex_count = R"doc(Return the total number of vertices)doc";
 
 static const char *__doc_mitsuba_Mesh_vertex_normal = R"doc(Returns the normal direction of the vertex with index ``index``)doc";
@@ -3411,7 +3651,7 @@ buffer)doc";
 
 static const char *__doc_mitsuba_Mesh_vertex_texcoord = R"doc(Returns the UV texture coordinates of the vertex with index ``index``)doc";
 
-static const char *__doc_mitsuba_Mesh_vertices = R"doc(Return a pointer to the raw vertex buffer)doc";
+static const char *__doc_mitsuba_Mesh_vertices = R"doc(Return a pointer to the raw vertex buffer (see decoded_buffers()))doc";
 
 static const char *__doc_mitsuba_Mesh_vertices_2 = R"doc(Const variant of vertices.)doc";
 
@@ -4092,6 +4332,88 @@ static const char *__doc_mitsuba_ProjectiveCamera_near_clip = R"doc(Return the n
 
 static const char *__doc_mitsuba_ProjectiveCamera_traverse = R"doc()doc";
 
+static const char *__doc_mitsuba_ProgressFileAppender =
+R"doc(%Appender implementation, which periodically replaces the contents of
+a file by the current progress in JSON format
+
+The file is written to a temporary file first and then renamed, so
+that external tools (e.g. a job scheduler) polling it never observe
+partial contents. Log messages are ignored.)doc";
+
+static const char *__doc_mitsuba_ProgressFileAppender_ProgressFileAppender = R"doc(Create a new progress file appender)doc";
+
+static const char *__doc_mitsuba_ProgressFileAppender_append = R"doc(Ignores log messages)doc";
+
+static const char *__doc_mitsuba_ProgressFileAppender_class = R"doc()doc";
+
+static const char *__doc_mitsuba_ProgressFileAppender_log_progress = R"doc(Ignores progress messages without machine-readable information)doc";
+
+static const char *__doc_mitsuba_ProgressFileAppender_log_progress_info = R"doc(Write the progress to the file)doc";
+
+static const char *__doc_mitsuba_ProgressFileAppender_m_filename = R"doc()doc";
+
+static const char *__doc_mitsuba_ProgressFileAppender_m_warned = R"doc()doc";
+
+static const char *__doc_mitsuba_ProgressFileAppender_to_string = R"doc(Return a string representation)doc";
+
+static const char *__doc_mitsuba_ProgressFileAppender_warn = R"doc(Report a failure to update the file on stderr (once))doc";
+
+static const char *__doc_mitsuba_ProgressInfo = R"doc(Machine-readable state of an operation, as delivered to
+Appender::log_progress_info())doc";
+
+static const char *__doc_mitsuba_ProgressInfo_elapsed = R"doc(Elapsed time in seconds)doc";
+
+static const char *__doc_mitsuba_ProgressInfo_eta =
+R"doc(Exponentially smoothed estimate of the remaining time in seconds
+(negative if unknown))doc";
+
+static const char *__doc_mitsuba_ProgressInfo_progress = R"doc(Fraction of the work that has been completed (in [0, 1]))doc";
+
+static const char *__doc_mitsuba_ProgressInfo_rays_per_second =
+R"doc(Average number of rays traced per second (zero if unknown, requires
+MTS_ENABLE_STATS))doc";
+
+static const char *__doc_mitsuba_ProgressInfo_samples = R"doc(Number of samples that have been computed so far)doc";
+
+static const char *__doc_mitsuba_ProgressInfo_samples_per_second = R"doc(Average number of samples computed per second (zero if unknown))doc";
+
+static const char *__doc_mitsuba_ProgressReporter =
+R"doc(General-purpose progress reporter
+
+This class is used to track the progress of various operations that
+might take longer than a second or so. It provides interactive
+feedback when Mitsuba is run on the console, via the OpenGL GUI, or in
+Jupyter Notebook.
+
+Progress can be reported from many threads at once via advance(),
+which only uses atomic operations. Refreshes are limited to two per
+second; threads that find another thread refreshing the display don't
+wait for it.)doc";
+
+static const char *__doc_mitsuba_ProgressReporter_ProgressReporter =
+R"doc(Construct a new progress reporter.
+
+Parameter ``label``:
+    An identifying name for the operation taking place (e.g.
+    "Rendering")
+
+Parameter ``ptr``:
+    Custom pointer payload to be delivered as part of progress
+    messages
+
+Parameter ``total``:
+    Total amount of work (e.g. the number of blocks), see advance())doc";
+
+static const char *__doc_mitsuba_ProgressReporter_advance =
+R"doc(Account for ``work`` completed units of work (out of the total given
+to the constructor), during which ``samples`` samples were computed
+
+This function is thread-safe.)doc";
+
+static const char *__doc_mitsuba_ProgressReporter_class = R"doc()doc";
+
+static const char *__doc_mitsuba_ProgressReporter_update = R"doc(Update the progress to ``progress`` (which should be in the range [0, 1]))doc";
+
 static const char *__doc_mitsuba_Properties =
 R"doc(Associative parameter map for constructing subclasses of Object.
 
@@ -4684,6 +5006,23 @@ In the context of wavefront ray tracing & dynamic arrays, this
 function must be called with a ``seed_value`` matching the size of the
 wavefront.)doc";
 
+static const char *__doc_mitsuba_Sampler_start_sample =
+R"doc(Prepare the generation of a new sample
+
+Parameter ``pixel``:
+    Pixel (in film coordinates) that the sample belongs to
+
+Parameter ``sample_index``:
+    Index of the sample within this pixel, counting the samples of all
+    passes
+
+Samplers based on (randomized) low-discrepancy sequences use this
+information to select the point of their sequence and its
+randomization, so that the result doesn't depend on the order in
+which blocks are scheduled. Subsequent calls to next_1d() and
+next_2d() then return the dimensions of this point in order. The
+default implementation does nothing.)doc";
+
 static const char *__doc_mitsuba_Sampler_wavefront_size = R"doc(Return the size of the wavefront (or 0, if not seeded))doc";
 
 static const char *__doc_mitsuba_SamplingIntegrator =
@@ -4807,6 +5146,13 @@ static const char *__doc_mitsuba_Scene_bbox = R"doc(Return a bounding box surrou
 
 static const char *__doc_mitsuba_Scene_class = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_deduplicate_meshes =
+R"doc(Let meshes with byte-identical vertex and face buffers share their
+storage
+
+Returns:
+    The number of bytes that were released)doc";
+
 static const char *__doc_mitsuba_Scene_emitters = R"doc(Return the list of emitters)doc";
 
 static const char *__doc_mitsuba_Scene_emitters_2 = R"doc(Return the list of emitters (const version))doc";
@@ -8511,6 +8857,21 @@ Parameter ``eta_ti``:
 
 static const char *__doc_mitsuba_round_to_packet_size = R"doc(Round an integer to a multiple of the current packet size)doc";
 
+static const char *__doc_mitsuba_sample_emitter_ray =
+R"doc(Start a light path at a uniformly chosen emitter of the scene
+
+Samples a ray leaving the emitter, which consumes two 1D (emitter and
+wavelength) and two 2D (position and direction) samples of
+``sampler``. The throughput (emitted radiance divided by the sampling
+density) accounts for the probability of choosing the emitter. It is
+zero for inactive lanes and for infinite emitters, which cannot sample
+emitted rays.
+
+The scene must contain at least one emitter.
+
+Returns:
+    A tuple (ray, throughput, emitter))doc";
+
 static const char *__doc_mitsuba_sample_rgb_spectrum =
 R"doc(Importance sample a "importance spectrum" that concentrates the
 computation on wavelengths that are relevant for rendering of RGB data
@@ -8645,6 +9006,19 @@ Parameter ``si``:
 
 \note Defined in scene.h)doc";
 
+static const char *__doc_mitsuba_shading_correction =
+R"doc(Correction factor for the non-symmetric scattering at surfaces with
+shading normals in importance transport [Veach 1997, Sec. 5.3]
+
+Also discards directions on the wrong side of the geometric surface
+(which would cause light leaks).
+
+Parameter ``wo_world``:
+    Outgoing direction in world space
+
+Parameter ``wo``:
+    Outgoing direction in the local shading frame of ``si``)doc";
+
 static const char *__doc_mitsuba_spectrum_from_file = R"doc()doc";
 
 static const char *__doc_mitsuba_spectrum_from_file_2 = R"doc()doc";
@@ -9122,6 +9496,8 @@ static const char *__doc_mitsuba_string_indent_3 = R"doc()doc";
 
 static const char *__doc_mitsuba_string_indent_4 = R"doc()doc";
 
+static const char *__doc_mitsuba_string_json_string = R"doc(Quote and escape a string for inclusion in a JSON document)doc";
+
 static const char *__doc_mitsuba_string_replace_inplace = R"doc()doc";
 
 static const char *__doc_mitsuba_string_starts_with = R"doc(Check if the given string starts with a specified prefix)doc";
@@ -9140,6 +9516,13 @@ compliant))doc";
 
 static const char *__doc_mitsuba_string_trim = R"doc(Remove leading and trailing characters)doc";
 
+static const char *__doc_mitsuba_to_xyz =
+R"doc(Convert an unpolarized spectrum to the XYZ tristimulus values stored
+by films
+
+Parameter ``wavelengths``:
+    Wavelengths of the spectrum (only used in spectral variants))doc";
+
 static const char *__doc_mitsuba_tuple_hasher = R"doc()doc";
 
 static const char *__doc_mitsuba_tuple_hasher_operator_call = R"doc()doc";
@@ -9381,9 +9764,25 @@ Parameter ``variant``:
 
 Parameter ``update_scene``:
     When Mitsuba updates scene to a newer version, should the updated
-    XML file be written back to disk?)doc";
+    XML file be written back to disk?
+
+Parameter ``use_cache``:
+    Store the parsed scene description in a binary cache file next to
+    the scene (``path + ".cache"``) and reuse it on subsequent loads
+    with identical file contents, variant and parameters. This skips
+    XML parsing, parameter substitution and version upgrades.
+
+Parameter ``stream_objects``:
+    Instantiate top-level objects whose references are resolved while
+    the rest of the file is still being parsed, so that plugin
+    construction overlaps with parsing. Errors in later parts of the
+    file may then be reported after earlier objects were created.
+    Ignored when ``use_cache`` is set.)doc";
+
+static const char *__doc_mitsuba_xml_load_string =
+R"doc(Load a Mitsuba scene from an XML string
 
-static const char *__doc_mitsuba_xml_load_string = R"doc(Load a Mitsuba scene from an XML string)doc";
+See load_file() for a description of the ``stream_objects`` parameter.)doc";
 
 static const char *__doc_mitsuba_xyz_to_srgb = R"doc(Convert XYZ tristimulus values to ITU-R Rec. BT.709 linear RGB)doc";
 
@@ -437,6 +437,9 @@ public:
     /// Return a string identifier
     std::string id() const override;
 
+    /// Return the handle used to attribute profiler samples to this instance
+    uint32_t profiler_handle() const { return m_profiler_handle; }
+
     /// Return a human-readable representation of the BSDF
     std::string to_string() const override = 0;
 
@@ -460,8 +463,16 @@ protected:
 
     /// Identifier (if available)
     std::string m_id;
+
+    /// Profiler handle (see \ref profiler_register_object())
+    uint32_t m_profiler_handle;
 };
 
+template <typename Float, typename Spectrum>
+uint32_t profiler_object(const BSDF<Float, Spectrum> *bsdf) {
+    return bsdf->profiler_handle();
+}
+
 // -----------------------------------------------------------------------
 //! @{ \name Misc implementations
 // -----------------------------------------------------------------------
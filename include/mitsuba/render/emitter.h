@@ -70,6 +70,9 @@ public:
     /// Flags for all components combined.
     uint32_t flags(mask_t<Float> /*active*/ = true) const { return m_flags; }
 
+    /// Return the handle used to attribute profiler samples to this instance
+    uint32_t profiler_handle() const { return m_profiler_handle; }
+
 
     ENOKI_CALL_SUPPORT_FRIEND()
     MTS_DECLARE_CLASS()
@@ -81,8 +84,16 @@ protected:
 protected:
     /// Combined flags for all properties of this emitter.
     uint32_t m_flags;
+
+    /// Profiler handle (see \ref profiler_register_object())
+    uint32_t m_profiler_handle;
 };
 
+template <typename Float, typename Spectrum>
+uint32_t profiler_object(const Emitter<Float, Spectrum> *emitter) {
+    return emitter->profiler_handle();
+}
+
 MTS_EXTERN_CLASS_RENDER(Emitter)
 NAMESPACE_END(mitsuba)
 
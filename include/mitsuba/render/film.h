@@ -7,6 +7,7 @@
 #include <mitsuba/core/vector.h>
 #include <mitsuba/render/sampler.h>
 #include <mitsuba/render/fwd.h>
+#include <mutex>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -28,6 +29,22 @@ public:
     /// Merge an image block into the film
     virtual void put(const ImageBlock *block) = 0;
 
+    /**
+     * \brief Add an image block whose pixel values are already normalized
+     *
+     * Unlike \ref put(), the values are not divided by the accumulated
+     * weight of the film when it is developed. This is used to add the
+     * contributions that integrators splat at arbitrary image positions (e.g.
+     * the light image of a bidirectional path tracer). The weight channel of
+     * \c block is ignored.
+     *
+     * The default implementation accumulates \c block in a separate splat
+     * buffer, independently of the pixel weights. Films add it to the
+     * normalized pixel values when they are developed (see \ref
+     * add_splats()) and discard it in \ref prepare().
+     */
+    virtual void put_normalized(const ImageBlock *block);
+
     /// Develop the film and write the result to the previously specified filename
     virtual void develop() = 0;
 
@@ -97,12 +114,27 @@ protected:
     /// Virtual destructor
     virtual ~Film();
 
+    /**
+     * \brief Add the splat buffer to the raw contents of a film
+     *
+     * \c data holds the unnormalized pixels of the crop window with the
+     * channel layout passed to \ref prepare(), where channel 4 stores the
+     * pixel weights. The splats are scaled by the weight of each pixel so
+     * that they remain unaffected by normalization. Pixels without any
+     * weight are assigned a unit weight instead.
+     */
+    void add_splats(ScalarFloat *data, size_t channel_count) const;
+
 protected:
     ScalarVector2i m_size;
     ScalarVector2i m_crop_size;
     ScalarPoint2i m_crop_offset;
     bool m_high_quality_edges;
     ref<ReconstructionFilter> m_filter;
+
+    /// Accumulated normalized contributions (see \ref put_normalized())
+    ref<ImageBlock> m_splats;
+    std::mutex m_splats_mutex;
 };
 
 MTS_EXTERN_CLASS_RENDER(Film)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mitsuba/core/fwd.h>
+#include <mitsuba/core/memtrack.h>
 #include <mitsuba/core/object.h>
 #include <mitsuba/core/vector.h>
 #include <mitsuba/render/fwd.h>
@@ -138,6 +139,17 @@ public:
      */
     Mask put(const Point2f &pos, const Float *value, Mask active = true);
 
+    /**
+     * \brief Thread-safe version of \ref put(const Point2f &, const Float *, Mask)
+     *
+     * Several threads may splat samples into the same block concurrently, which
+     * is needed when the sample positions are not confined to a part of the image
+     * (e.g. in light tracing). The values are accumulated using atomic operations.
+     * The reconstruction weights are always normalized, so that every sample adds
+     * a unit amount of energy. Not supported in GPU variants.
+     */
+    Mask put_atomic(const Point2f &pos, const Float *value, Mask active = true);
+
     /// Clear everything to zero.
     void clear();
 
@@ -200,12 +212,16 @@ public:
 protected:
     /// Virtual destructor
     virtual ~ImageBlock();
+
+    /// Disable lanes with negative or invalid sample values (if requested), printing a warning
+    Mask check_values(const Float *value, Mask active) const;
 protected:
     ScalarPoint2i m_offset;
     ScalarVector2i m_size;
     uint32_t m_channel_count;
     int m_border_size;
     DynamicBuffer<Float> m_data;
+    TrackedAllocation m_memory;
     const ReconstructionFilter *m_filter;
     Float *m_weights_x, *m_weights_y;
     bool m_warn_negative;
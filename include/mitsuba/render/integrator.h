@@ -153,12 +153,30 @@ protected:
     SamplingIntegrator(const Properties &props);
     virtual ~SamplingIntegrator();
 
+    /**
+     * \brief Invoked before every pass over the image blocks
+     *
+     * The passes (see \ref m_samples_per_pass) are rendered one after the
+     * other, hence integrators can use this function to prepare state that
+     * is shared by all blocks of a pass, e.g. estimates learned during the
+     * previous passes. The default implementation does nothing.
+     *
+     * \param pass
+     *    Index of the pass that is about to start
+     *
+     * \param pass_count
+     *    Total number of passes
+     */
+    virtual void prepare_pass(const Scene *scene, const Sensor *sensor,
+                              size_t pass, size_t pass_count);
+
     virtual void render_block(const Scene *scene,
                               const Sensor *sensor,
                               Sampler *sampler,
                               ImageBlock *block,
                               Float *aovs,
-                              size_t sample_count = size_t(-1)) const;
+                              size_t sample_count = size_t(-1),
+                              size_t sample_offset = 0) const;
 
     void render_sample(const Scene *scene,
                        const Sensor *sensor,
@@ -7,6 +7,8 @@
 #include <mitsuba/core/math.h>
 #include <mitsuba/core/object.h>
 #include <mitsuba/core/ray.h>
+#include <mitsuba/core/memtrack.h>
+#include <mitsuba/core/stats.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/tls.h>
 #include <mitsuba/core/util.h>
@@ -428,6 +430,7 @@ protected:
             std::unique_ptr<uint8_t[]> data(new uint8_t[alloc_size]);
             uint8_t *start = data.get(), *cur = start + size;
             m_chunks.emplace_back(std::move(data), cur, alloc_size);
+            m_chunks.back().memory.reset(MemoryCategory::KDTreeBuild, alloc_size);
 
             return reinterpret_cast<T *>(start);
         }
@@ -511,6 +514,7 @@ protected:
             std::unique_ptr<uint8_t[]> start;
             uint8_t *cur;
             size_t size;
+            TrackedAllocation memory;
 
             Chunk(std::unique_ptr<uint8_t[]> &&start, uint8_t *cur, size_t size)
                 : start(std::move(start)), cur(cur), size(size) { }
@@ -1786,6 +1790,7 @@ protected:
         m_index_count = Size(ctx.index_storage.size());
 
         m_indices.reset(new Index[m_index_count]);
+        m_indices_memory.reset(MemoryCategory::KDTreeIndices, m_index_count * sizeof(Index));
         tbb::parallel_for(
             tbb::blocked_range<Size>(0u, m_index_count, MTS_KD_GRAIN_SIZE),
             [&](const tbb::blocked_range<Size> &range) {
@@ -1797,6 +1802,7 @@ protected:
         tbb::concurrent_vector<Index>().swap(ctx.index_storage);
 
         m_nodes.reset(new KDNode[m_node_count]);
+        m_nodes_memory.reset(MemoryCategory::KDTreeNodes, m_node_count * sizeof(KDNode));
         tbb::parallel_for(
             tbb::blocked_range<Size>(0u, m_node_count, MTS_KD_GRAIN_SIZE),
             [&](const tbb::blocked_range<Size> &range) {
@@ -1883,6 +1889,7 @@ protected:
 protected:
     std::unique_ptr<KDNode[]> m_nodes;
     std::unique_ptr<Index[]> m_indices;
+    TrackedAllocation m_nodes_memory, m_indices_memory;
     Size m_node_count = 0;
     Size m_index_count = 0;
 
@@ -2100,9 +2107,18 @@ public:
         Float mint = std::max(ray.mint, std::get<1>(bbox_result));
         Float maxt = std::min(ray.maxt, std::get<2>(bbox_result));
 
+        // Traversal statistics, accumulated locally and committed once
+        MTS_STATS_ONLY(uint64_t stats_nodes = 0; uint64_t stats_prims = 0;)
+        MTS_STATS_ONLY(auto commit_stats = [&]() {
+            MTS_STATS_ADD(KDTreeTraversals, 1);
+            MTS_STATS_ADD(KDTreeNodes, stats_nodes);
+            MTS_STATS_ADD(KDTreePrimitives, stats_prims);
+        };)
+
         const KDNode *node = m_nodes.get();
         while (mint <= maxt) {
             if (likely(!node->leaf())) { // Inner node
+                MTS_STATS_ONLY(stats_nodes++;)
                 const Float split   = node->split();
                 const uint32_t axis = node->axis();
 
@@ -2148,10 +2164,13 @@ public:
                     Float prim_t;
                     std::tie(prim_hit, prim_t) =
                         intersect_prim<ShadowRay>(prim_index, ray, cache, true);
+                    MTS_STATS_ONLY(stats_prims++;)
 
                     if (unlikely(prim_hit)) {
-                        if (ShadowRay)
+                        if (ShadowRay) {
+                            MTS_STATS_ONLY(commit_stats();)
                             return { true, prim_t };
+                        }
 
                         Assert(prim_t >= ray.mint && prim_t <= ray.maxt);
                         ray.maxt = prim_t;
@@ -2170,6 +2189,7 @@ public:
                 break;
             }
         }
+        MTS_STATS_ONLY(commit_stats();)
         return { hit, hit ? ray.maxt : math::Infinity<Float> };
     }
 
@@ -2201,6 +2221,10 @@ public:
         Float mint = enoki::max(ray.mint, std::get<1>(bbox_result));
         Float maxt = enoki::min(ray.maxt, std::get<2>(bbox_result));
 
+        // Traversal statistics (per lane), accumulated locally and committed once
+        MTS_STATS_COUNT(KDTreeTraversals, active);
+        MTS_STATS_ONLY(uint64_t stats_nodes = 0; uint64_t stats_prims = 0;)
+
         while (true) {
             active = active && (maxt >= mint);
             if (ShadowRay)
@@ -2208,6 +2232,7 @@ public:
 
             if (likely(any(active))) {
                 if (likely(!node->leaf())) { // Inner node
+                    MTS_STATS_ONLY(stats_nodes += count(active);)
                     const scalar_t<Float> split = node->split();
                     const uint32_t axis = node->axis();
 
@@ -2274,6 +2299,7 @@ public:
                         Float prim_t;
                         std::tie(prim_hit, prim_t) =
                             intersect_prim<ShadowRay>(prim_index, ray, cache, active);
+                        MTS_STATS_ONLY(stats_prims += count(active);)
 
                         if (!ShadowRay) {
                             Assert(all(!prim_hit || (prim_t >= ray.mint && prim_t <= ray.maxt)));
@@ -2296,6 +2322,8 @@ public:
             }
         }
 
+        MTS_STATS_ONLY(MTS_STATS_ADD(KDTreeNodes, stats_nodes);)
+        MTS_STATS_ONLY(MTS_STATS_ADD(KDTreePrimitives, stats_prims);)
         return { hit, select(hit, ray.maxt, math::Infinity<Float>) };
     }
 
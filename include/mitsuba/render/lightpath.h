@@ -0,0 +1,109 @@
+#pragma once
+
+#include <mitsuba/core/frame.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/scene.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/*
+ * Helper functions shared by the integrators that trace paths starting at
+ * the emitters (particle tracer, bidirectional path tracer, photon mapping).
+ */
+
+/**
+ * \brief Start a light path at a uniformly chosen emitter of the scene
+ *
+ * Samples a ray leaving the emitter, which consumes two 1D (emitter and
+ * wavelength) and two 2D (position and direction) samples of \c sampler. The
+ * throughput (emitted radiance divided by the sampling density) accounts
+ * for the probability of choosing the emitter. It is zero for inactive
+ * lanes and for infinite emitters, which cannot sample emitted rays.
+ *
+ * The scene must contain at least one emitter.
+ *
+ * \return A tuple (ray, throughput, emitter)
+ */
+template <typename Float, typename Spectrum>
+auto sample_emitter_ray(const Scene<Float, Spectrum> *scene,
+                        Sampler<Float, Spectrum> *sampler, Float time,
+                        mask_t<Float> active = true) {
+    MTS_IMPORT_TYPES(EmitterPtr)
+    const auto &emitters = scene->emitters();
+
+    UInt32 index = min(UInt32(sampler->next_1d(active) * (ScalarFloat) emitters.size()),
+                       (uint32_t) emitters.size() - 1);
+    EmitterPtr emitter = gather<EmitterPtr>(emitters.data(), index, active);
+    active &= !has_flag(emitter->flags(), EmitterFlags::Infinite);
+
+    Float wavelength_sample = sampler->next_1d(active);
+    Point2f position_sample  = sampler->next_2d(active),
+            direction_sample = sampler->next_2d(active);
+
+    Ray3f ray = zero<Ray3f>();
+    Spectrum throughput(0.f);
+    if (any_or<true>(active)) {
+        std::tie(ray, throughput) = emitter->sample_ray(
+            time, wavelength_sample, position_sample, direction_sample, active);
+        throughput = select(active, throughput * (ScalarFloat) emitters.size(),
+                            Spectrum(0.f));
+    }
+
+    return std::make_tuple(ray, throughput, emitter);
+}
+
+/**
+ * \brief Correction factor for the non-symmetric scattering at surfaces
+ * with shading normals in importance transport [Veach 1997, Sec. 5.3]
+ *
+ * Also discards directions on the wrong side of the geometric surface
+ * (which would cause light leaks).
+ *
+ * \param wo_world
+ *     Outgoing direction in world space
+ *
+ * \param wo
+ *     Outgoing direction in the local shading frame of \c si
+ */
+template <typename Float, typename Spectrum>
+Float shading_correction(const SurfaceInteraction<Float, Spectrum> &si,
+                         const Vector<Float, 3> &wo_world,
+                         const Vector<Float, 3> &wo) {
+    using Frame3f = Frame<Float>;
+    Float wi_dot_ng = dot(si.to_world(si.wi), si.n),
+          wo_dot_ng = dot(wo_world, si.n),
+          num = abs(Frame3f::cos_theta(si.wi) * wo_dot_ng),
+          den = abs(Frame3f::cos_theta(wo) * wi_dot_ng);
+
+    mask_t<Float> valid = wi_dot_ng * Frame3f::cos_theta(si.wi) > 0.f &&
+                          wo_dot_ng * Frame3f::cos_theta(wo) > 0.f && den > 0.f;
+    return select(valid, num / den, 0.f);
+}
+
+/**
+ * \brief Convert an unpolarized spectrum to the XYZ tristimulus values
+ * stored by films
+ *
+ * \param wavelengths
+ *     Wavelengths of the spectrum (only used in spectral variants)
+ */
+template <typename Spectrum, typename Float = value_t<Spectrum>>
+Color<Float, 3> to_xyz(const Spectrum &value, const wavelength_t<Spectrum> &wavelengths,
+                       mask_t<Float> active = true) {
+    if constexpr (is_monochromatic_v<Spectrum>) {
+        ENOKI_MARK_USED(wavelengths);
+        ENOKI_MARK_USED(active);
+        return Color<Float, 3>(value.x());
+    } else if constexpr (is_rgb_v<Spectrum>) {
+        ENOKI_MARK_USED(wavelengths);
+        return srgb_to_xyz(value, active);
+    } else {
+        static_assert(is_spectral_v<Spectrum>);
+        return spectrum_to_xyz(value, wavelengths, active);
+    }
+}
+
+NAMESPACE_END(mitsuba)
@@ -2,6 +2,7 @@
 
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/shape.h>
+#include <mitsuba/core/memtrack.h>
 #include <mitsuba/core/struct.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/distr_1d.h>
@@ -10,6 +11,52 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+NAMESPACE_BEGIN(detail)
+/**
+ * \brief Decode two IEEE half precision values packed into the lower and
+ * upper 16 bits of \c packed (works for scalars and Enoki arrays)
+ */
+template <typename UInt32, typename Float = float_array_t<UInt32>>
+MTS_INLINE Array<Float, 2> unpack_half2(const UInt32 &packed) {
+    Array<Float, 2> result;
+    for (size_t i = 0; i < 2; ++i) {
+        UInt32 h = (i == 0) ? (packed & 0xFFFFu) : (packed >> 16);
+        /* Move exponent and mantissa into place and rebias the exponent by
+           multiplying with 2^112 (this also handles denormals correctly) */
+        Float value = reinterpret_array<Float>(UInt32((h & 0x7FFFu) << 13)) * 0x1p112f;
+        result[i] = select(neq(h & 0x8000u, 0u), -value, value);
+    }
+    return result;
+}
+
+/**
+ * \brief Decode a unit vector stored using an octahedral mapping with two
+ * signed 16-bit components packed into \c packed
+ *
+ * See "A Survey of Efficient Representations for Independent Unit
+ * Vectors" by Cigolle et al., JCGT 2014.
+ */
+template <typename UInt32, typename Float = float_array_t<UInt32>>
+MTS_INLINE Normal<Float, 3> unpack_oct_normal(const UInt32 &packed) {
+    using Int32 = int32_array_t<UInt32>;
+    Float x = Float(reinterpret_array<Int32>(UInt32(packed << 16)) >> 16) * (1.f / 32767.f),
+          y = Float(reinterpret_array<Int32>(packed) >> 16) * (1.f / 32767.f),
+          z = 1.f - abs(x) - abs(y),
+          t = max(-z, 0.f);
+    x += select(x >= 0.f, -t, t);
+    y += select(y >= 0.f, -t, t);
+    return normalize(Normal<Float, 3>(x, y, z));
+}
+
+/// Decode three normalized 8-bit values stored in the lower 24 bits of \c packed
+template <typename UInt32, typename Float = float_array_t<UInt32>>
+MTS_INLINE Array<Float, 3> unpack_unorm3x8(const UInt32 &packed) {
+    return Array<Float, 3>(Float(packed & 0xFFu),
+                           Float((packed >> 8) & 0xFFu),
+                           Float((packed >> 16) & 0xFFu)) * (1.f / 255.f);
+}
+NAMESPACE_END(detail)
+
 template <typename Float, typename Spectrum>
 class MTS_EXPORT_RENDER Mesh : public Shape<Float, Spectrum> {
 public:
@@ -25,8 +72,15 @@ public:
     using typename Base::ScalarSize;
     using typename Base::ScalarIndex;
 
-    using FaceHolder   = std::unique_ptr<uint8_t[]>;
-    using VertexHolder = std::unique_ptr<uint8_t[]>;
+    /* Vertex and face storage is reference counted so that meshes with
+       byte-identical buffers can share it (see \ref share_buffers()) */
+    using FaceHolder   = std::shared_ptr<uint8_t[]>;
+    using VertexHolder = std::shared_ptr<uint8_t[]>;
+
+    /// Allocate a vertex or face buffer (accounted as \ref MemoryCategory::Geometry)
+    static std::shared_ptr<uint8_t[]> allocate_buffer(size_t size) {
+        return tracked_shared_buffer(MemoryCategory::Geometry, size);
+    }
 
     /// Create a new mesh with the given vertex and face data structures
     Mesh(const std::string &name,
@@ -53,7 +107,7 @@ public:
     /// Return a \c Struct instance describing the contents of the face buffer
     const Struct *face_struct() const { return m_face_struct.get(); }
 
-    /// Return a pointer to the raw vertex buffer
+    /// Return a pointer to the raw vertex buffer (see \ref decoded_buffers())
     uint8_t *vertices() { return m_vertices.get(); }
     /// Const variant of \ref vertices.
     const uint8_t *vertices() const { return m_vertices.get(); }
@@ -94,8 +148,19 @@ public:
         ENOKI_MARK_USED(active);
 
         if constexpr (!is_array_v<Index>) {
+            if (unlikely(m_short_indices)) {
+                const uint16_t *idx = (const uint16_t *) face(index);
+                return Result(idx[0], idx[1], idx[2]);
+            }
             return load<Result>(face(index));
         } else if constexpr (!is_cuda_array_v<Index>) {
+            if (unlikely(m_short_indices)) {
+                /* Fetch 32 bits at 16-bit granularity and discard the upper
+                   half (the face buffer is padded by one entry) */
+                index *= m_face_size / ScalarSize(sizeof(uint16_t));
+                return Result(gather<Result, sizeof(uint16_t)>(
+                    m_faces.get(), Index3(index, index + 1u, index + 2u), active) & 0xFFFFu);
+            }
             index *= m_face_size / ScalarSize(sizeof(ScalarIndex));
             return gather<Result, sizeof(ScalarIndex)>(
                 m_faces.get(), Index3(index, index + 1u, index + 2u), active);
@@ -136,9 +201,15 @@ public:
         ENOKI_MARK_USED(active);
 
         if constexpr (!is_array_v<Index>) {
+            if (unlikely(m_oct_normals))
+                return detail::unpack_oct_normal(
+                    load_unaligned<uint32_t>(vertex(index) + m_normal_offset));
             return load_unaligned<Result>(vertex(index) + m_normal_offset);
         } else if constexpr (!is_cuda_array_v<Index>) {
             index *= m_vertex_size / ScalarSize(sizeof(InputFloat));
+            if (unlikely(m_oct_normals))
+                return detail::unpack_oct_normal(gather<uint32_array_t<Index>, sizeof(uint32_t)>(
+                    m_vertices.get() + m_normal_offset, index, active));
             return gather<Result, sizeof(InputFloat)>(
                 m_vertices.get() + m_normal_offset, Index3(index, index + 1u, index + 2u), active);
         }
@@ -156,9 +227,15 @@ public:
         ENOKI_MARK_USED(active);
 
         if constexpr (!is_array_v<Index>) {
+            if (unlikely(m_half_texcoords))
+                return Result(detail::unpack_half2(
+                    load_unaligned<uint32_t>(vertex(index) + m_texcoord_offset)));
             return load_unaligned<Result>(vertex(index) + m_texcoord_offset);
         } else if constexpr (!is_cuda_array_v<Index>) {
             index *= m_vertex_size / ScalarSize(sizeof(InputFloat));
+            if (unlikely(m_half_texcoords))
+                return Result(detail::unpack_half2(gather<uint32_array_t<Index>, sizeof(uint32_t)>(
+                    m_vertices.get() + m_texcoord_offset, index, active)));
             return gather<Result, sizeof(InputFloat)>(
                 m_vertices.get() + m_texcoord_offset, Array<Index, 2>(index, index + 1u), active);
         }
@@ -169,6 +246,32 @@ public:
 #endif
     }
 
+    /**
+     * \brief Returns the color of the vertex with index \c index
+     *
+     * \remark Not supported by the GPU variants
+     */
+    template <typename Index>
+    MTS_INLINE auto vertex_color(Index index, mask_t<Index> active = true) const {
+        using Index3 = Array<Index, 3>;
+        using Result = Array<replace_scalar_t<Index, InputFloat>, 3>;
+        ENOKI_MARK_USED(active);
+
+        if constexpr (!is_array_v<Index>) {
+            if (unlikely(m_unorm_colors))
+                return detail::unpack_unorm3x8(
+                    load_unaligned<uint32_t>(vertex(index) + m_color_offset));
+            return load_unaligned<Result>(vertex(index) + m_color_offset);
+        } else {
+            index *= m_vertex_size / ScalarSize(sizeof(InputFloat));
+            if (unlikely(m_unorm_colors))
+                return detail::unpack_unorm3x8(gather<uint32_array_t<Index>, sizeof(uint32_t)>(
+                    m_vertices.get() + m_color_offset, index, active));
+            return gather<Result, sizeof(InputFloat)>(
+                m_vertices.get() + m_color_offset, Index3(index, index + 1u, index + 2u), active);
+        }
+    }
+
     /// Returns the surface area of the face with index \c index
     template <typename Index>
     auto face_area(Index index, mask_t<Index> active = true) const {
@@ -190,6 +293,46 @@ public:
     /// Does this mesh have per-vertex texture colors?
     bool has_vertex_colors() const { return m_color_offset != 0; }
 
+    /// Are vertex attributes and/or face indices stored using compact encodings?
+    bool has_compact_attributes() const {
+        return m_oct_normals || m_half_texcoords || m_unorm_colors || m_short_indices;
+    }
+
+    /// @}
+    // =========================================================================
+
+    // =========================================================================
+    //! @{ \name Buffer deduplication
+    // =========================================================================
+
+    /**
+     * \brief Return a hash of the vertex and face buffer contents
+     *
+     * Two meshes with equal hashes are candidates for deduplication, which
+     * must then be confirmed using \ref has_identical_buffers().
+     */
+    size_t buffer_hash() const;
+
+    /// Check whether \c other stores byte-identical vertex and face buffers
+    bool has_identical_buffers(const Mesh *other) const;
+
+    /**
+     * \brief Release this mesh's vertex and face buffers and instead
+     * reference the (identical) storage of \c other
+     *
+     * Shared buffers are treated as immutable: modifying the vertices of one
+     * mesh (e.g. via \ref recompute_vertex_normals()) after this call would
+     * also affect all other meshes referencing the same storage.
+     *
+     * \return The number of bytes that were released
+     */
+    size_t share_buffers(const Mesh *other);
+
+    /// Is the vertex/face storage of this mesh shared with another mesh?
+    bool has_shared_buffers() const {
+        return m_vertices.use_count() > 1 || m_faces.use_count() > 1;
+    }
+
     /// @}
     // =========================================================================
 
@@ -199,6 +342,43 @@ public:
     /// Compute smooth vertex normals and replace the current normal values
     void recompute_vertex_normals();
 
+    /**
+     * \brief Reorder faces and vertices to improve memory locality
+     *
+     * Faces are sorted along a Morton (Z-order) curve through their
+     * centroids, and vertices are subsequently renumbered in the order of
+     * their first use. Spatially neighboring triangles then reside in nearby
+     * memory locations, which reduces the number of cache lines touched when
+     * traversing kd-tree leaves. Must be called before the acceleration data
+     * structure is built.
+     */
+    void optimize_layout();
+
+    /**
+     * \brief Re-encode the vertex and face buffers using compact encodings
+     *
+     * Vertex positions are left untouched, while normals are stored using an
+     * octahedral encoding (2x16 bit), texture coordinates as half precision
+     * values, and colors as normalized 8-bit values. Meshes with at most
+     * 65536 vertices furthermore switch to 16-bit face indices (except when
+     * Embree is used, which requires 32-bit indices). Attributes are decoded
+     * on the fly by \ref vertex_normal(), \ref vertex_texcoord() and \ref
+     * vertex_color(). The raw buffers returned by \ref vertices() and \ref
+     * faces() keep the encoded values, see \ref decoded_buffers().
+     */
+    void compact_attributes();
+
+    /**
+     * \brief Return the vertex and face buffers with full precision
+     * attributes and 32-bit face indices, along with \c Struct instances
+     * describing them
+     *
+     * This undoes the encodings of \ref compact_attributes() (the result is a
+     * copy in this case) and is used to export such meshes. The buffers of
+     * other meshes are returned as they are.
+     */
+    std::tuple<ref<Struct>, VertexHolder, ref<Struct>, FaceHolder> decoded_buffers() const;
+
     /// Recompute the bounding box (e.g. after modifying the vertex positions)
     void recompute_bbox();
 
@@ -367,6 +547,21 @@ protected:
     /// Flag that can be set by the user to disable loading/computation of vertex normals
     bool m_disable_vertex_normals = false;
 
+    /// Flag that can be set by the user to request a cache-friendly face/vertex order
+    bool m_optimize_layout = false;
+
+    /// Flag that can be set by the user to request compact attribute storage
+    bool m_compact_attributes = false;
+
+    /// Normals are stored using an octahedral encoding (2x16 bit)
+    bool m_oct_normals = false;
+    /// Texture coordinates are stored in half precision
+    bool m_half_texcoords = false;
+    /// Colors are stored as normalized 8-bit values
+    bool m_unorm_colors = false;
+    /// Face indices are stored as 16-bit values
+    bool m_short_indices = false;
+
     /* Surface area distribution -- generated on demand when \ref
        prepare_area_distr() is first called. */
     DiscreteDistribution<Float> m_area_distr;
@@ -31,9 +31,35 @@ public:
      *
      * In the context of wavefront ray tracing & dynamic arrays, this function
      * must be called with a \c seed_value matching the size of the wavefront.
+     *
+     * Samplers that implement \ref start_sample() can also be used without
+     * per-sample information (e.g. by integrators that only call this
+     * function). In that case, the seed value (plus the lane index in packet
+     * mode) plays the role of the pixel, wrapped into the tile of the
+     * sampler where applicable, and every pixel starts at sample zero.
      */
     virtual void seed(UInt64 seed_value);
 
+    /**
+     * \brief Prepare the generation of a new sample
+     *
+     * \param pixel
+     *     Pixel (in film coordinates) that the sample belongs to
+     *
+     * \param sample_index
+     *     Index of the sample within this pixel, counting the samples of
+     *     all passes
+     *
+     * Samplers based on (randomized) low-discrepancy sequences use this
+     * information to select the point of their sequence and its
+     * randomization, so that the result doesn't depend on the order in which
+     * blocks are scheduled. Subsequent calls to \ref next_1d() and \ref
+     * next_2d() then return the dimensions of this point in order. The
+     * default implementation does nothing.
+     */
+    virtual void start_sample(const Point2u &pixel, const UInt32 &sample_index,
+                              Mask active = true);
+
     /// Retrieve the next component value from the current sample
     virtual Float next_1d(Mask active = true);
 
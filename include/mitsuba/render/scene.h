@@ -27,7 +27,7 @@ enum class HitComputeMode : uint32_t {
 template <typename Float, typename Spectrum>
 class MTS_EXPORT_RENDER Scene : public Object {
 public:
-    MTS_IMPORT_TYPES(BSDF, Emitter, EmitterPtr, Film, Sampler, Shape, ShapePtr, Sensor, Integrator, Medium, MediumPtr)
+    MTS_IMPORT_TYPES(BSDF, Emitter, EmitterPtr, Film, Sampler, Shape, ShapePtr, Mesh, Sensor, Integrator, Medium, MediumPtr)
 
     /// Instantiate a scene from a \ref Properties object
     Scene(const Properties &props);
@@ -215,6 +215,14 @@ protected:
     void accel_init_cpu(const Properties &props);
     void accel_init_gpu(const Properties &props);
 
+    /**
+     * \brief Let meshes with byte-identical vertex and face buffers share
+     * their storage
+     *
+     * \return The number of bytes that were released
+     */
+    size_t deduplicate_meshes();
+
     /// Release the ray-intersection acceleration data structure
     void accel_release_cpu();
     void accel_release_gpu();
@@ -242,6 +250,9 @@ protected:
     std::vector<ref<Object>> m_children;
     ref<Integrator> m_integrator;
     ref<Emitter> m_environment;
+
+    /// Number of bytes released by \ref deduplicate_meshes()
+    size_t m_dedup_bytes = 0;
 };
 
 /// Dummy function which can be called to ensure that the librender shared library is loaded
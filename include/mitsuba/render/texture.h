@@ -148,6 +148,9 @@ public:
     /// Return a string identifier
     std::string id() const override { return m_id; }
 
+    /// Return the handle used to attribute profiler samples to this instance
+    uint32_t profiler_handle() const { return m_profiler_handle; }
+
     MTS_DECLARE_CLASS()
 
 protected:
@@ -156,8 +159,14 @@ protected:
 
 protected:
     std::string m_id;
+    uint32_t m_profiler_handle;
 };
 
+template <typename Float, typename Spectrum>
+uint32_t profiler_object(const Texture<Float, Spectrum> *texture) {
+    return texture->profiler_handle();
+}
+
 
 /// Abstract base class for spatially-varying 3D textures.
 template <typename Float, typename Spectrum>
@@ -1,4 +1,5 @@
 #include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/denoiser.h>
 #include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/fstream.h>
 #include <mitsuba/core/spectrum.h>
@@ -45,6 +46,22 @@ High dynamic range film (:monosp:`hdrfilm`)
    - If set to |true|, regions slightly outside of the film plane will also be sampled. This may
      improve the image quality at the edges, especially when using very large reconstruction
      filters. In general, this is not needed though. (Default: |false|, i.e. disabled)
+ * - denoise
+   - |bool|
+   - If set to |true|, the developed image is denoised with a feature-guided à-trous wavelet
+     filter (see below). (Default: |false|)
+ * - denoise_iterations
+   - |int|
+   - Number of iterations of the denoising filter. (Default: 5)
+ * - denoise_albedo, denoise_normal, denoise_depth
+   - |string|
+   - Names of the :ref:`aov <integrator-aov>` outputs (of type :monosp:`albedo`,
+     :monosp:`sh_normal` and :monosp:`depth`) that guide the denoising filter. (Default: Unused)
+ * - denoise_variance
+   - |string|
+   - Name of a nested integrator of the :ref:`moment <integrator-moment>` integrator, whose
+     first and second moments provide the variance of every pixel. (Default: Unused, the
+     variance is estimated from the neighborhood of every pixel)
  * - (Nested plugin)
    - :paramtype:`rfilter`
    - Reconstruction filter that should be used by the film. (Default: :monosp:`gaussian`, a windowed
@@ -73,6 +90,33 @@ data. PFM output is restricted to :monosp:`float32`-valued images using the :mon
 :monosp:`luminance` pixel formats. Due to the superior accuracy and adoption of OpenEXR, the use of
 these two alternative formats is discouraged however.
 
+At low sample counts, the film can remove most of the Monte Carlo noise before the image is
+written to disk. The filter averages neighboring pixels, but avoids doing so across the edges of
+the auxiliary buffers produced by the :ref:`aov <integrator-aov>` integrator. Textures are preserved
+when an :monosp:`albedo` AOV is available. The variance of every pixel is best computed using the
+:ref:`moment <integrator-moment>` integrator, which assumes a :monosp:`box` reconstruction filter.
+The following snippet denoises the output of a path tracer:
+
+.. code-block:: xml
+
+    <integrator type="moment">
+        <integrator type="aov" name="m">
+            <string name="aovs" value="albedo:albedo,nn:sh_normal,dd.y:depth"/>
+            <integrator type="path" name="image"/>
+        </integrator>
+    </integrator>
+
+    <film type="hdrfilm">
+        <boolean name="denoise" value="true"/>
+        <string name="denoise_albedo" value="m.albedo"/>
+        <string name="denoise_normal" value="m.nn"/>
+        <string name="denoise_depth" value="m.dd.y"/>
+        <string name="denoise_variance" value="m"/>
+        <rfilter type="box"/>
+    </film>
+
+The same filter is available from Python as :monosp:`mitsuba.core.Denoiser`.
+
 When RGB(A) output is selected, the measured spectral power distributions are
 converted to linear RGB based on the CIE 1931 XYZ color matching curves and
 the ITU-R Rec. BT.709-3 primaries with a D65 white point.
@@ -92,7 +136,8 @@ The following XML snippet discribes a film that writes a full-HD RGBA OpenEXR fi
 template <typename Float, typename Spectrum>
 class HDRFilm final : public Film<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(Film, m_size, m_crop_size, m_crop_offset, m_high_quality_edges, m_filter)
+    MTS_IMPORT_BASE(Film, m_size, m_crop_size, m_crop_offset, m_high_quality_edges, m_filter,
+                    m_splats, add_splats)
     MTS_IMPORT_TYPES(ImageBlock)
 
     HDRFilm(const Properties &props) : Base(props) {
@@ -177,6 +222,18 @@ public:
                 m_component_format = Struct::Type::Float32;
             }
         }
+
+        m_denoise = props.bool_("denoise", false);
+        m_denoise_albedo = props.string("denoise_albedo", "");
+        m_denoise_normal = props.string("denoise_normal", "");
+        m_denoise_depth = props.string("denoise_depth", "");
+        m_denoise_variance = props.string("denoise_variance", "");
+        if (m_denoise) {
+            int iterations = props.int_("denoise_iterations", 5);
+            if (iterations < 0)
+                Throw("The \"denoise_iterations\" parameter must be non-negative!");
+            m_denoiser = new Denoiser((uint32_t) iterations);
+        }
     }
 
     void set_destination_file(const fs::path &dest_file) override {
@@ -198,6 +255,7 @@ public:
         m_storage->set_offset(m_crop_offset);
         m_storage->clear();
         m_channels = channels;
+        m_splats = nullptr;
     }
 
     void put(const ImageBlock *block) override {
@@ -254,9 +312,18 @@ public:
                           struct_type_v<ScalarFloat>, m_storage->size(), m_storage->channel_count(),
                           (uint8_t *) m_storage->data().managed().data());
 
+        // Add the splats to a copy, since the storage keeps accumulating samples
+        if (m_splats) {
+            source = new Bitmap(*source);
+            add_splats((ScalarFloat *) source->data(), source->channel_count());
+        }
+
         if (raw)
             return source;
 
+        if (m_denoise)
+            source = denoise(source);
+
         bool has_aovs = m_channels.size() != 5;
 
         ref<Bitmap> target = new Bitmap(
@@ -316,6 +383,105 @@ public:
         return target;
      };
 
+    /**
+     * \brief Return a copy of the storage bitmap \c source whose color
+     * channels have been denoised
+     */
+    ref<Bitmap> denoise(const Bitmap *source) const {
+        if constexpr (is_cuda_array_v<Float> || is_diff_array_v<Float>) {
+            (void) source;
+            Throw("HDRFilm: denoising is not supported in GPU variants!");
+        } else {
+            ScalarVector2i size = m_storage->size();
+            size_t pixel_count = hprod(size), channels = m_channels.size();
+            const ScalarFloat *data = (const ScalarFloat *) source->data();
+
+            auto channel_index = [&](const std::string &name) {
+                auto it = std::find(m_channels.begin(), m_channels.end(), name);
+                if (it == m_channels.end())
+                    Throw("HDRFilm: could not find the channel \"%s\" required for denoising!",
+                          name);
+                return (size_t) (it - m_channels.begin());
+            };
+
+            // Gather some channels of the image, normalized by the pixel weights
+            auto extract = [&](const std::string &prefix,
+                               const std::vector<std::string> &suffixes) -> ref<Bitmap> {
+                if (prefix.empty())
+                    return nullptr;
+
+                std::vector<size_t> indices;
+                for (const std::string &suffix : suffixes)
+                    indices.push_back(channel_index(prefix + suffix));
+
+                ref<Bitmap> guide = new Bitmap(
+                    suffixes.size() == 1 ? Bitmap::PixelFormat::Y : Bitmap::PixelFormat::RGB,
+                    Struct::Type::Float32, size);
+                float *target = (float *) guide->data();
+
+                for (size_t i = 0; i < pixel_count; ++i) {
+                    const ScalarFloat *s = data + i * channels;
+                    ScalarFloat inv_weight = s[4] > 0.f ? 1.f / s[4] : 0.f;
+                    for (size_t index : indices)
+                        *target++ = (float) (s[index] * inv_weight);
+                }
+
+                return guide;
+            };
+
+            ref<Bitmap> image  = new Bitmap(Bitmap::PixelFormat::RGB, Struct::Type::Float32, size),
+                        albedo = extract(m_denoise_albedo, { ".R", ".G", ".B" }),
+                        normal = extract(m_denoise_normal, { ".X", ".Y", ".Z" }),
+                        depth  = extract(m_denoise_depth,  { "" }),
+                        variance;
+
+            float *image_data = (float *) image->data();
+            for (size_t i = 0; i < pixel_count; ++i) {
+                const ScalarFloat *s = data + i * channels;
+                ScalarFloat inv_weight = s[4] > 0.f ? 1.f / s[4] : 0.f;
+                ScalarColor3f rgb = xyz_to_srgb(ScalarColor3f(s[0], s[1], s[2]) * inv_weight);
+                for (size_t k = 0; k < 3; ++k)
+                    image_data[3 * i + k] = (float) rgb[k];
+            }
+
+            if (!m_denoise_variance.empty()) {
+                /* Variance of the pixel estimates, based on the first and second
+                   moments of the luminance. With a box filter, the pixel weight
+                   is equal to the number of samples. */
+                size_t m1 = channel_index(m_denoise_variance + ".Y"),
+                       m2 = channel_index("m2_" + m_denoise_variance + ".Y");
+
+                variance = new Bitmap(Bitmap::PixelFormat::Y, Struct::Type::Float32, size);
+                float *variance_data = (float *) variance->data();
+                for (size_t i = 0; i < pixel_count; ++i) {
+                    const ScalarFloat *s = data + i * channels;
+                    ScalarFloat inv_weight = s[4] > 0.f ? 1.f / s[4] : 0.f,
+                                mean = s[m1] * inv_weight;
+                    variance_data[i] = (float) (
+                        std::max(s[m2] * inv_weight - sqr(mean), ScalarFloat(0)) * inv_weight);
+                }
+            }
+
+            ref<Bitmap> denoised = m_denoiser->denoise(image, albedo, normal, depth, variance);
+
+            // Write the denoised colors into a copy of the storage
+            ref<Bitmap> result = new Bitmap(*source);
+            ScalarFloat *result_data = (ScalarFloat *) result->data();
+            const float *denoised_data = (const float *) denoised->data();
+
+            for (size_t i = 0; i < pixel_count; ++i) {
+                ScalarFloat *t = result_data + i * channels;
+                ScalarColor3f rgb(denoised_data[3 * i], denoised_data[3 * i + 1],
+                                  denoised_data[3 * i + 2]);
+                ScalarColor3f xyz = srgb_to_xyz(rgb) * t[4];
+                for (size_t k = 0; k < 3; ++k)
+                    t[k] = xyz[k];
+            }
+
+            return result;
+        }
+    }
+
     void develop() override {
         if (m_dest_file.empty())
             Throw("Destination file not specified, cannot develop.");
@@ -367,6 +533,7 @@ public:
             << "  file_format = " << m_file_format << "," << std::endl
             << "  pixel_format = " << m_pixel_format << "," << std::endl
             << "  component_format = " << m_component_format << "," << std::endl
+            << "  denoiser = " << (m_denoise ? string::indent(m_denoiser) : "none") << "," << std::endl
             << "  dest_file = \"" << m_dest_file << "\"" << std::endl
             << "]";
         return oss.str();
@@ -380,6 +547,12 @@ protected:
     fs::path m_dest_file;
     ref<ImageBlock> m_storage;
     std::vector<std::string> m_channels;
+    bool m_denoise;
+    std::string m_denoise_albedo;
+    std::string m_denoise_normal;
+    std::string m_denoise_depth;
+    std::string m_denoise_variance;
+    ref<Denoiser> m_denoiser;
 };
 
 MTS_IMPLEMENT_CLASS_VARIANT(HDRFilm, Film)
@@ -142,3 +142,104 @@ def test03_develop(variant_scalar_rgb, file_format, tmpdir):
             assert ek.allclose(img[:, :, :3], contents[:, :, :3], atol=1e-5)
         # Alpha channel was ignored, alpha and weights should default to 1.0.
         assert ek.allclose(img[:, :, 3:5], 1.0, atol=1e-6)
+
+
+def test04_put_normalized(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+    from mitsuba.core import Bitmap, Struct
+    from mitsuba.render import ImageBlock
+    import numpy as np
+
+    film = load_string("""<film version="2.0.0" type="hdrfilm">
+            <integer name="width" value="7"/>
+            <integer name="height" value="5"/>
+            <rfilter type="box"/>
+        </film>""")
+    size = film.size()
+
+    np.random.seed(1234)
+    contents = np.random.uniform(size=(size[1], size[0], 5))
+    contents[:, :, 4] = np.random.uniform(1, 3, size=(size[1], size[0]))
+    extra = np.random.uniform(size=(size[1], size[0], 5))
+
+    block = ImageBlock(size, 5, film.reconstruction_filter())
+    light = ImageBlock(size, 5, film.reconstruction_filter())
+    block.clear()
+    light.clear()
+    for y in range(size[1]):
+        for x in range(size[0]):
+            # Unnormalized values, which are divided by the weight when developing
+            value = contents[y, x, :].copy()
+            value[:4] *= value[4]
+            block.put([x + 0.5, y + 0.5], value)
+            light.put([x + 0.5, y + 0.5], extra[y, x, :])
+
+    def develop():
+        return np.array(film.bitmap(raw=True).convert(
+            Bitmap.PixelFormat.XYZA, Struct.Type.Float32, srgb_gamma=False))
+
+    # The order of the two kinds of blocks doesn't matter
+    film.prepare(['X', 'Y', 'Z', 'A', 'W'])
+    film.put_normalized(light)
+    film.put(block)
+    assert ek.allclose(develop(), contents[:, :, :4] + extra[:, :, :4], atol=1e-5)
+
+    # Pixels that did not receive any weight keep the normalized values
+    film.prepare(['X', 'Y', 'Z', 'A', 'W'])
+    film.put_normalized(light)
+    assert ek.allclose(develop(), extra[:, :, :4], atol=1e-5)
+
+
+def test05_denoise(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+    from mitsuba.render import ImageBlock
+    import numpy as np
+
+    film = load_string("""<film version="2.0.0" type="hdrfilm">
+            <integer name="width" value="32"/>
+            <integer name="height" value="32"/>
+            <string name="component_format" value="float32"/>
+            <boolean name="denoise" value="true"/>
+            <string name="denoise_normal" value="nn"/>
+            <rfilter type="box"/>
+        </film>""")
+    size = film.size()
+
+    # Noisy image with two constant halves, separated by a normal discontinuity
+    np.random.seed(1234)
+    ref = np.full((size[1], size[0], 3), 0.2)
+    ref[:, 16:] = 0.8
+    normal = np.zeros((size[1], size[0], 3))
+    normal[:, :16, 2] = 1
+    normal[:, 16:, 0] = 1
+    noisy = ref * (1 + np.random.normal(0, 0.2, ref.shape))
+    rgb_to_xyz = np.array([[0.412453, 0.357580, 0.180423],
+                           [0.212671, 0.715160, 0.072169],
+                           [0.019334, 0.119193, 0.950227]])
+    noisy_xyz = noisy @ rgb_to_xyz.T
+
+    block = ImageBlock(size, 8, film.reconstruction_filter())
+    block.clear()
+    for y in range(size[1]):
+        for x in range(size[0]):
+            # Unnormalized values, with a weight of 2
+            value = np.concatenate([noisy_xyz[y, x], [1, 1], normal[y, x]]) * 2
+            block.put([x + 0.5, y + 0.5], value)
+
+    film.prepare(['X', 'Y', 'Z', 'A', 'W', 'nn.X', 'nn.Y', 'nn.Z'])
+    film.put(block)
+
+    # The raw storage is unchanged
+    raw = np.array(film.bitmap(raw=True), copy=False)
+    assert ek.allclose(raw[:, :, :3], 2 * noisy_xyz, atol=1e-5)
+
+    img = np.array(film.bitmap(), copy=True)
+    assert np.sqrt(np.mean((img[:, :, :3] - ref) ** 2)) < \
+        0.5 * np.sqrt(np.mean((noisy - ref) ** 2))
+    assert ek.allclose(np.mean(img[:, 15, :3]), 0.2, rtol=5e-2)
+    assert ek.allclose(np.mean(img[:, 16, :3]), 0.8, rtol=5e-2)
+
+    # Missing guide channels are reported
+    film.prepare(['X', 'Y', 'Z', 'A', 'W'])
+    with pytest.raises(RuntimeError):
+        film.bitmap()
@@ -1,3 +1,4 @@
+#include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/integrator.h>
 #include <mitsuba/render/records.h>
 
@@ -58,6 +59,9 @@ Currently, the following AOVs types are available:
     - :monosp:`sh_normal`: Shading normal.
     - :monosp:`dp_du`, :monosp:`dp_dv`: Position partials wrt. the UV parameterization.
     - :monosp:`duv_dx`, :monosp:`duv_dy`: UV partials wrt. changes in screen-space.
+    - :monosp:`albedo`: Single-sample estimate of the directional albedo of the BSDF (stored as RGB).
+      Together with the *depth* and *sh_normal* AOVs, it can guide the denoiser of the
+      :ref:`hdrfilm <film-hdrfilm>` film.
 
  */
 
@@ -65,7 +69,7 @@ template <typename Float, typename Spectrum>
 class AOVIntegrator final : public SamplingIntegrator<Float, Spectrum> {
 public:
     MTS_IMPORT_BASE(SamplingIntegrator)
-    MTS_IMPORT_TYPES(Scene, Sampler, Medium)
+    MTS_IMPORT_TYPES(Scene, Sampler, Medium, BSDFPtr)
 
     enum class Type {
         Depth,
@@ -77,6 +81,7 @@ public:
         dPdV,
         dUVdx,
         dUVdy,
+        Albedo,
         IntegratorRGBA
     };
 
@@ -129,6 +134,11 @@ public:
                 m_aov_types.push_back(Type::dUVdy);
                 m_aov_names.push_back(item[0] + ".U");
                 m_aov_names.push_back(item[0] + ".V");
+            } else if (item[1] == "albedo") {
+                m_aov_types.push_back(Type::Albedo);
+                m_aov_names.push_back(item[0] + ".R");
+                m_aov_names.push_back(item[0] + ".G");
+                m_aov_names.push_back(item[0] + ".B");
             } else {
                 Throw("Invalid AOV type \"%s\"!", item[1]);
             }
@@ -219,25 +229,27 @@ public:
                     *aovs++ = si.duv_dy.y();
                     break;
 
+                case Type::Albedo: {
+                        Spectrum weight(0.f);
+                        if (any_or<true>(active)) {
+                            BSDFContext ctx;
+                            BSDFPtr bsdf = si.bsdf();
+                            weight = bsdf->sample(ctx, si, sampler->next_1d(active),
+                                                  sampler->next_2d(active), active).second;
+                            masked(weight, !active) = 0.f;
+                        }
+
+                        Color3f rgb = to_rgb(weight, ray, active);
+                        *aovs++ = rgb.r(); *aovs++ = rgb.g(); *aovs++ = rgb.b();
+                    }
+                    break;
+
                 case Type::IntegratorRGBA: {
                         std::pair<Spectrum, Mask> result_sub =
                             m_integrators[ctr].first->sample(scene, sampler, ray, medium, aovs, active);
                         aovs += m_integrators[ctr].second;
 
-                        UnpolarizedSpectrum spec_u = depolarize(result_sub.first);
-
-                        Color3f rgb;
-                        if constexpr (is_monochromatic_v<Spectrum>) {
-                            rgb = spec_u.x();
-                        } else if constexpr (is_rgb_v<Spectrum>) {
-                            rgb = spec_u;
-                        } else {
-                            static_assert(is_spectral_v<Spectrum>);
-                            /// Note: this assumes that sensor used sample_rgb_spectrum() to generate 'ray.wavelengths'
-                            auto pdf = pdf_rgb_spectrum(ray.wavelengths);
-                            spec_u *= select(neq(pdf, 0.f), rcp(pdf), 0.f);
-                            rgb = xyz_to_srgb(spectrum_to_xyz(spec_u, ray.wavelengths, active));
-                        }
+                        Color3f rgb = to_rgb(result_sub.first, ray, active);
 
                         *aovs++ = rgb.r(); *aovs++ = rgb.g(); *aovs++ = rgb.b();
                         *aovs++ = select(result_sub.second, Float(1.f), Float(0.f));
@@ -254,6 +266,23 @@ public:
         return result;
     }
 
+    /// Convert a spectrum carried along \c ray to linear sRGB
+    Color3f to_rgb(const Spectrum &spec, const RayDifferential3f &ray, Mask active) const {
+        UnpolarizedSpectrum spec_u = depolarize(spec);
+
+        if constexpr (is_monochromatic_v<Spectrum>) {
+            return spec_u.x();
+        } else if constexpr (is_rgb_v<Spectrum>) {
+            return spec_u;
+        } else {
+            static_assert(is_spectral_v<Spectrum>);
+            /// Note: this assumes that sensor used sample_rgb_spectrum() to generate 'ray.wavelengths'
+            auto pdf = pdf_rgb_spectrum(ray.wavelengths);
+            spec_u *= select(neq(pdf, 0.f), rcp(pdf), 0.f);
+            return xyz_to_srgb(spectrum_to_xyz(spec_u, ray.wavelengths, active));
+        }
+    }
+
     std::vector<std::string> aov_names() const override {
         return m_aov_names;
     }
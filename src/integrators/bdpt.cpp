@@ -0,0 +1,798 @@
+#include <enoki/stl.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/tls.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/lightpath.h>
+#include <mitsuba/render/records.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/sensor.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-bdpt:
+
+Bidirectional path tracer (:monosp:`bdpt`)
+------------------------------------------
+
+.. pluginparameters::
+
+ * - max_depth
+   - |int|
+   - Specifies the longest path depth in the generated output image (where -1 corresponds to
+     :math:`\infty`). A value of 1 will only render directly visible light sources. 2 will lead
+     to single-bounce (direct-only) illumination, and so on. (Default: -1)
+ * - rr_depth
+   - |int|
+   - Specifies the number of scattering events after which the implementation starts to use
+     Russian roulette to terminate the subpaths. (Default: 5)
+ * - light_image
+   - |bool|
+   - Connect the light subpaths to the sensor and splat the contributions into the image (the
+     strategies with :math:`t=1`). This greatly helps with caustics seen through non-specular
+     surfaces. (Default: |true|)
+ * - hide_emitters
+   - |bool|
+   - Hide directly visible emitters. (Default: |false|)
+
+This plugin implements bidirectional path tracing [Vea97]_. For every sample, it
+traces a *camera subpath* starting at the sensor and a *light subpath* starting
+at a randomly chosen emitter (using ``Emitter::sample_ray()``). It then connects
+every prefix of the light subpath to every prefix of the camera subpath using
+shadow rays. A path with :math:`k` vertices can thus be generated by up to
+:math:`k+1` different strategies: :math:`s` vertices are sampled from the light
+and :math:`t` from the sensor. The strategies are weighted using multiple
+importance sampling (power heuristic), which requires the densities of sampling
+every vertex from either side of the path.
+
+- :math:`s=0`: the camera subpath hits an emitter, like in a path tracer
+  without emitter sampling.
+- :math:`s=1`: the emitter is sampled from the camera subpath using
+  ``Scene::sample_emitter_direction()``, like in the :ref:`path
+  <integrator-path>` tracer.
+- :math:`t=1`: the light subpath is connected to the sensor using
+  ``Sensor::sample_direction()``, and the contribution is splatted into a
+  *light image* like in the :ref:`particle tracer <integrator-ptracer>`.
+- All remaining strategies connect a vertex of the light subpath to a vertex of
+  the camera subpath.
+
+Compared to the :ref:`path <integrator-path>` tracer, this is considerably more
+robust for scenes that are mostly lit indirectly (e.g. interiors lit through a
+small opening, or by emitters pointing at a wall) and for caustics, such as the
+light focused by glass objects onto a diffuse surface. Paths that have a
+specular vertex right next to both the sensor and the emitters (e.g. the
+reflection of a caustic in a mirror) can however not be sampled any better than
+by the path tracer. Each sample is also significantly more expensive, hence the
+path tracer remains preferable for scenes that are mostly lit directly.
+
+The vertices of both subpaths are stored in per-thread arenas that are reused
+from one sample to the next, hence the integrator doesn't allocate any memory
+once every thread has traced its longest path. The light image is shared by all
+threads, which splat into it using atomic operations, and it is added to the
+film once the rendering has completed. It is normalized by the total number of
+light subpaths, i.e. one per sample.
+
+Environment emitters (e.g. :ref:`envmap <emitter-envmap>` or :ref:`directional
+<emitter-directional>`) do not start light subpaths, since they cannot sample
+emitted rays: they are only rendered by the strategies with :math:`s\le 1`,
+i.e. like in the :ref:`path <integrator-path>` tracer. The light image requires
+a sensor that implements ``sample_direction()``, which is currently the case for
+the :ref:`perspective <sensor-perspective>` camera.
+
+This integrator is not supported in spectral, polarized and GPU variants, and
+ignores participating media.
+
+.. [Vea97] Eric Veach. Robust Monte Carlo Methods for Light Transport Simulation.
+   PhD thesis, Stanford University, 1997.
+
+ */
+
+template <typename Float, typename Spectrum>
+class BDPTIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_hide_emitters)
+    MTS_IMPORT_TYPES(Scene, Sensor, Sampler, Film, ImageBlock, Medium, Emitter, EmitterPtr,
+                     BSDF, BSDFPtr)
+
+    BDPTIntegrator(const Properties &props) : Base(props) {
+        m_light_image_enabled = props.bool_("light_image", true);
+
+        if constexpr (is_spectral_v<Spectrum> || is_polarized_v<Spectrum>)
+            Throw("The bidirectional path tracer only supports RGB and monochromatic variants!");
+    }
+
+    bool render(Scene *scene, Sensor *sensor) override {
+        if constexpr (is_cuda_array_v<Float>) {
+            ENOKI_MARK_USED(scene);
+            ENOKI_MARK_USED(sensor);
+            Throw("The bidirectional path tracer is not supported in GPU variants!");
+        } else {
+            if (!m_light_image_enabled)
+                return Base::render(scene, sensor);
+
+            ref<Film> film = sensor->film();
+            ref<ImageBlock> light_image =
+                new ImageBlock(film->crop_size(), 5, film->reconstruction_filter(),
+                               true, true, true, true);
+            light_image->set_offset(film->crop_offset());
+            light_image->clear();
+
+            m_light_image = light_image;
+            m_sensor = sensor;
+
+            bool result = Base::render(scene, sensor);
+
+            m_light_image = nullptr;
+            m_sensor = nullptr;
+
+            /* Normalize by the number of light subpaths per pixel, every
+               camera sample traces one of them */
+            size_t spp = sensor->sampler()->sample_count();
+            if (spp > 0) {
+                ScalarFloat *data = light_image->data().data();
+                ScalarFloat scale = 1.f / (ScalarFloat) spp;
+                size_t pixel_count = hprod(light_image->size() + 2 * light_image->border_size());
+                for (size_t i = 0; i < pixel_count; ++i, data += 5) {
+                    for (size_t k = 0; k < 3; ++k)
+                        data[k] *= scale;
+                }
+                film->put_normalized(light_image);
+            }
+
+            return result;
+        }
+    }
+
+    std::pair<Spectrum, Mask> sample(const Scene *scene,
+                                     Sampler *sampler,
+                                     const RayDifferential3f &ray,
+                                     const Medium * /* medium */,
+                                     Float * /* aovs */,
+                                     Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
+
+        VertexArena &arena = m_arena;
+        Spectrum result(0.f);
+
+        size_t n_camera = trace_camera_subpath(scene, sampler, ray, arena.camera, result, active),
+               n_light  = trace_light_subpath(scene, sampler, ray.time, arena.light, active);
+        Mask valid_ray = n_camera > 1 ? arena.camera[1].valid : Mask(false);
+
+        // ----------------- Connect the two subpaths -----------------
+
+        for (size_t t = 1; t <= n_camera; ++t) {
+            for (size_t s = 0; s <= std::max(n_light, (size_t) 1); ++s) {
+                // The strategies (0, 1) and (1, 1) are not supported
+                if (t == 1 && (s < 2 || !m_light_image))
+                    continue;
+                if (m_max_depth >= 0 && (int) (s + t) - 1 > m_max_depth)
+                    continue;
+                if (s == 0 && t == 2 && m_hide_emitters)
+                    continue;
+
+                Mask valid = active && arena.camera[t - 1].valid;
+                if (s >= 2)
+                    valid &= arena.light[s - 1].valid;
+                if (none_or<false>(valid))
+                    continue;
+
+                if (t == 1)
+                    connect_sensor(scene, sampler, arena, s, valid);
+                else if (s == 0)
+                    result += connect_emitter(scene, arena, t, valid);
+                else if (s == 1)
+                    result += sample_emitter(scene, sampler, arena, t, valid);
+                else
+                    result += connect_vertices(scene, arena, s, t, valid);
+            }
+        }
+
+        return { result, valid_ray };
+    }
+
+    std::string to_string() const override {
+        return tfm::format("BDPTIntegrator[\n"
+            "  max_depth = %i,\n"
+            "  rr_depth = %i,\n"
+            "  light_image = %s\n"
+            "]", m_max_depth, m_rr_depth, m_light_image_enabled);
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    /// Vertex of a camera or light subpath
+    struct Vertex {
+        /// Surface interaction (only the position is set for the pinhole and point lights)
+        SurfaceInteraction3f si;
+        /// Emitter at the vertex, if any
+        EmitterPtr emitter;
+        /// Sampling weight of the subpath up to (but excluding) the vertex
+        Spectrum throughput;
+        /// Density per unit area of sampling the vertex from the same end of the path
+        Float pdf_fwd;
+        /// Density per unit area of sampling the vertex from the other end of the path
+        Float pdf_rev;
+        /// Is the vertex located on a surface (this excludes the pinhole and point lights)?
+        Mask on_surface;
+        /// Was the subpath scattered by a delta BSDF component at this vertex?
+        Mask delta;
+        /// Does the vertex exist?
+        Mask valid;
+    };
+
+    /// Per-thread storage of the two subpaths, which is reused for all samples
+    struct VertexArena {
+        std::vector<Vertex> camera, light;
+    };
+
+    /// Return the vertex \c i of a subpath, growing the arena if necessary
+    static Vertex &vertex(std::vector<Vertex> &path, size_t i) {
+        if (unlikely(i >= path.size()))
+            path.resize(std::max(2 * path.size(), i + 1));
+        return path[i];
+    }
+
+    // =============================================================
+    //! @{ \name Subpath generation
+    // =============================================================
+
+    /**
+     * \brief Trace the camera subpath starting with \c ray
+     *
+     * The contributions of the environment emitters, which are only rendered
+     * by the unidirectional strategies, are added to \c result.
+     *
+     * \return The number of vertices (including the one on the sensor)
+     */
+    size_t trace_camera_subpath(const Scene *scene, Sampler *sampler,
+                                const RayDifferential3f &ray, std::vector<Vertex> &path,
+                                Spectrum &result, Mask active) const {
+        Vertex &z0 = vertex(path, 0);
+        z0.si = zero<SurfaceInteraction3f>();
+        z0.si.p = ray.o;
+        z0.si.time = ray.time;
+        z0.si.wavelengths = ray.wavelengths;
+        z0.emitter = nullptr;
+        z0.throughput = 1.f;
+        z0.pdf_fwd = 1.f;
+        z0.pdf_rev = 0.f;
+        z0.on_surface = false;
+        z0.delta = false;
+        z0.valid = active;
+
+        size_t max_vertices = m_max_depth < 0 ? size_t(-1) : (size_t) m_max_depth + 1;
+        size_t n = random_walk(scene, sampler, ray, Spectrum(1.f), 1.f,
+                               TransportMode::Radiance, path, max_vertices, &result, active);
+
+        /* The density of the first vertex w.r.t. the sensor is only needed
+           by the strategies with t=1 */
+        if (m_light_image && n > 1) {
+            Vertex &z1 = path[1];
+            masked(z1.pdf_fwd, z1.valid) = camera_pdf(z1, z1.valid);
+        }
+
+        return n;
+    }
+
+    /**
+     * \brief Trace a light subpath starting at a randomly chosen emitter
+     *
+     * \return The number of vertices (including the one on the emitter)
+     */
+    size_t trace_light_subpath(const Scene *scene, Sampler *sampler, Float time,
+                               std::vector<Vertex> &path, Mask active) const {
+        const auto &emitters = scene->emitters();
+        size_t max_vertices = m_max_depth < 0 ? size_t(-1) : (size_t) m_max_depth;
+        if (emitters.empty() || max_vertices < 2 || none_or<false>(active))
+            return 0;
+
+        /* Randomly pick an emitter (using the same distribution as the scene).
+           Environment emitters cannot sample emitted rays */
+        auto [ray, throughput, emitter] = sample_emitter_ray(scene, sampler, time, active);
+        active &= any(neq(depolarize(throughput), 0.f));
+        if (none_or<false>(active))
+            return 0;
+
+        Vertex &y0 = vertex(path, 0);
+        y0.si = zero<SurfaceInteraction3f>();
+        y0.si.p = ray.o;
+        y0.si.time = time;
+        y0.si.wavelengths = ray.wavelengths;
+        y0.emitter = emitter;
+        y0.throughput = 1.f;
+        y0.pdf_fwd = 0.f;
+        y0.pdf_rev = 0.f;
+        y0.on_surface = has_flag(emitter->flags(), EmitterFlags::Surface);
+        y0.delta = false;
+
+        /* sample_ray() doesn't provide the surface normal of area emitters,
+           which is recovered by intersecting a short ray through the origin */
+        Mask surface = active && y0.on_surface;
+        if (any_or<true>(surface)) {
+            Float eps = math::RayEpsilon<Float> * (1.f + hmax(abs(ray.o)));
+            Ray3f probe(ray.o - ray.d * eps, ray.d, 0.f, 2.f * eps, time, ray.wavelengths);
+            SurfaceInteraction3f si = scene->ray_intersect(probe, surface);
+            masked(y0.si, surface && si.is_valid()) = si;
+            active &= !surface || si.is_valid();
+        }
+        y0.valid = active;
+
+        size_t n = random_walk(scene, sampler, ray, throughput, emission_pdf(y0, ray.d),
+                               TransportMode::Importance, path, max_vertices, nullptr, active);
+
+        // The positional density of the emitter depends on the next vertex (see emitter_pdf())
+        if (n > 1) {
+            Vertex &y1 = path[1];
+            path[0].pdf_fwd = emitter_pdf(scene, path[0], y1.si, y1.valid);
+        }
+
+        return n;
+    }
+
+    /**
+     * \brief Extend a subpath, whose first vertex has been set up, by tracing
+     * \c ray and sampling the BSDFs
+     *
+     * \param pdf_dir
+     *    Density per unit solid angle of sampling the direction of \c ray
+     *
+     * \param result
+     *    When set, the emission of the environment emitters is added to it
+     *    (camera subpaths)
+     *
+     * \return The number of vertices of the subpath
+     */
+    size_t random_walk(const Scene *scene, Sampler *sampler, RayDifferential3f ray,
+                       Spectrum throughput, Float pdf_dir, TransportMode mode,
+                       std::vector<Vertex> &path, size_t max_vertices, Spectrum *result,
+                       Mask active) const {
+        BSDFContext ctx(mode);
+        const Emitter *environment = result ? scene->environment() : nullptr;
+
+        // Russian roulette compares the throughput to the initial one
+        Float flux = hmax(depolarize(throughput));
+        Float bsdf_pdf = 0.f;
+        Mask bsdf_delta = false;
+
+        SurfaceInteraction3f si = scene->ray_intersect(ray, active);
+        size_t n = 1;
+
+        while (n < max_vertices) {
+            // -------------------- Environment emitters ---------------------
+
+            Mask escaped = active && !si.is_valid();
+            if (environment && any_or<true>(escaped) && !(n == 1 && m_hide_emitters)) {
+                Float weight = 1.f;
+                if (n > 1) {
+                    // MIS with the emitter sampling at the previous vertex (s=1)
+                    DirectionSample3f ds(si, path[n - 1].si);
+                    ds.object = environment;
+                    Float emitter_pdf =
+                        select(bsdf_delta, 0.f,
+                               scene->pdf_emitter_direction(path[n - 1].si, ds, escaped));
+                    weight = select(bsdf_delta, 1.f, power_heuristic(bsdf_pdf, emitter_pdf));
+                }
+                masked(*result, escaped) +=
+                    throughput * environment->eval(si, escaped) * weight;
+            }
+
+            active &= si.is_valid();
+            if (none_or<false>(active))
+                break;
+
+            // ------------------------- New vertex --------------------------
+
+            Vertex &v = vertex(path, n), &prev = path[n - 1];
+            v.si = si;
+            v.emitter = si.emitter(scene, active);
+            v.throughput = throughput;
+            v.pdf_fwd = convert_density(pdf_dir, prev, v);
+            v.pdf_rev = 0.f;
+            v.on_surface = true;
+            v.delta = false;
+            v.valid = active;
+
+            if (++n >= max_vertices)
+                break;
+
+            // ------------------------ BSDF sampling ------------------------
+
+            BSDFPtr bsdf = si.bsdf(ray);
+            auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(active),
+                                               sampler->next_2d(active), active);
+            Vector3f wo = si.to_world(bs.wo);
+            if (mode == TransportMode::Importance)
+                bsdf_val *= shading_correction(si, wo, bs.wo);
+
+            // Density of sampling the previous vertex from this one
+            SurfaceInteraction3f si_rev(si);
+            si_rev.wi = bs.wo;
+            Float pdf_rev = bsdf->pdf(ctx, si_rev, si.wi, active);
+
+            /* Delta components cannot be connected to: their densities are
+               excluded from the MIS weights (see mis_weight()) */
+            v.delta = active && has_flag(bs.sampled_type, BSDFFlags::Delta);
+            pdf_dir = select(v.delta, 0.f, bs.pdf);
+            masked(pdf_rev, v.delta) = 0.f;
+            masked(prev.pdf_rev, active) = convert_density(pdf_rev, v, prev);
+
+            bsdf_pdf = bs.pdf;
+            bsdf_delta = v.delta;
+
+            throughput *= bsdf_val;
+            active &= any(neq(depolarize(throughput), 0.f));
+
+            if ((int) n - 1 >= m_rr_depth) {
+                Float q = min(hmax(depolarize(throughput)) / flux, .95f);
+                active &= sampler->next_1d(active) < q;
+                throughput *= rcp(q);
+            }
+
+            ray = si.spawn_ray(wo);
+            si = scene->ray_intersect(ray, active);
+        }
+
+        return n;
+    }
+
+    //! @}
+    // =============================================================
+
+    // =============================================================
+    //! @{ \name Connection strategies
+    // =============================================================
+
+    /// Strategy s=0: the last vertex of the camera subpath lies on an emitter
+    Spectrum connect_emitter(const Scene *scene, VertexArena &arena, size_t t,
+                             Mask active) const {
+        const Vertex &pt = arena.camera[t - 1];
+        active &= neq(pt.emitter, nullptr);
+        if (none_or<false>(active))
+            return 0.f;
+
+        Spectrum value = pt.throughput * pt.emitter->eval(pt.si, active);
+        active &= any(neq(depolarize(value), 0.f));
+        if (none_or<false>(active))
+            return 0.f;
+
+        return select(active, value * mis_weight(scene, arena, 0, t, nullptr, 0.f, active), 0.f);
+    }
+
+    /// Strategy s=1: sample an emitter from the last vertex of the camera subpath
+    Spectrum sample_emitter(const Scene *scene, Sampler *sampler, VertexArena &arena,
+                            size_t t, Mask active) const {
+        const Vertex &pt = arena.camera[t - 1];
+        Point2f sample = sampler->next_2d(active);
+
+        BSDFPtr bsdf = pt.si.bsdf();
+        active &= has_flag(bsdf->flags(), BSDFFlags::Smooth);
+        if (scene->emitters().empty() || none_or<false>(active))
+            return 0.f;
+
+        auto [ds, emitter_val] = scene->sample_emitter_direction(pt.si, sample, false, active);
+        active &= neq(ds.pdf, 0.f);
+        if (none_or<false>(active))
+            return 0.f;
+
+        BSDFContext ctx;
+        Vector3f wo = pt.si.to_local(ds.d);
+        Spectrum value = pt.throughput * bsdf->eval(ctx, pt.si, wo, active) * emitter_val;
+        active &= any(neq(depolarize(value), 0.f));
+        if (none_or<false>(active))
+            return 0.f;
+
+        Ray3f ray(pt.si.p, ds.d, math::RayEpsilon<Float> * (1.f + hmax(abs(pt.si.p))),
+                  ds.dist * (1.f - math::ShadowEpsilon<Float>), pt.si.time, pt.si.wavelengths);
+        active &= !scene->ray_test(ray, active);
+        if (none_or<false>(active))
+            return 0.f;
+
+        EmitterPtr emitter = reinterpret_array<EmitterPtr>(ds.object);
+        Mask infinite = has_flag(emitter->flags(), EmitterFlags::Infinite);
+
+        // Environment emitters: MIS with BSDF sampling, like in the path tracer
+        Float weight = select(
+            ds.delta, 1.f, power_heuristic(ds.pdf, bsdf->pdf(ctx, pt.si, wo, active)));
+
+        Mask bidir = active && !infinite;
+        if (any_or<true>(bidir)) {
+            Vertex y0;
+            y0.si = zero<SurfaceInteraction3f>();
+            y0.si.p = ds.p;
+            y0.si.n = ds.n;
+            y0.si.sh_frame = Frame3f(ds.n);
+            y0.si.time = pt.si.time;
+            y0.si.wavelengths = pt.si.wavelengths;
+            y0.emitter = emitter;
+            y0.throughput = 1.f;
+            y0.pdf_fwd = select(ds.delta, ds.pdf, ds.pdf * abs(dot(ds.n, ds.d)) / sqr(ds.dist));
+            y0.pdf_rev = 0.f;
+            y0.on_surface = !ds.delta;
+            y0.delta = false;
+            y0.valid = bidir;
+
+            masked(weight, bidir) = mis_weight(scene, arena, 1, t, &y0, 0.f, bidir);
+        }
+
+        return select(active, value * weight, 0.f);
+    }
+
+    /// Connect the vertex \c s-1 of the light subpath to the vertex \c t-1 of the camera subpath
+    Spectrum connect_vertices(const Scene *scene, VertexArena &arena, size_t s, size_t t,
+                              Mask active) const {
+        const Vertex &qs = arena.light[s - 1], &pt = arena.camera[t - 1];
+
+        BSDFPtr bsdf_q = qs.si.bsdf(), bsdf_p = pt.si.bsdf();
+        active &= has_flag(bsdf_q->flags(), BSDFFlags::Smooth) &&
+                  has_flag(bsdf_p->flags(), BSDFFlags::Smooth);
+        if (none_or<false>(active))
+            return 0.f;
+
+        Vector3f d = pt.si.p - qs.si.p;
+        Float dist_sqr = squared_norm(d);
+        d *= rsqrt(dist_sqr);
+
+        Vector3f wo_q = qs.si.to_local(d),
+                 wo_p = pt.si.to_local(-d);
+
+        BSDFContext ctx_q(TransportMode::Importance), ctx_p;
+        Spectrum value = qs.throughput *
+                         bsdf_q->eval(ctx_q, qs.si, wo_q, active) *
+                         shading_correction(qs.si, d, wo_q) *
+                         bsdf_p->eval(ctx_p, pt.si, wo_p, active) *
+                         pt.throughput / dist_sqr;
+
+        active &= any(neq(depolarize(value), 0.f));
+        if (none_or<false>(active))
+            return 0.f;
+
+        active &= !scene->ray_test(qs.si.spawn_ray_to(pt.si.p), active);
+        if (none_or<false>(active))
+            return 0.f;
+
+        return select(active, value * mis_weight(scene, arena, s, t, nullptr, 0.f, active), 0.f);
+    }
+
+    /// Strategy t=1: connect the vertex \c s-1 of the light subpath to the sensor
+    void connect_sensor(const Scene *scene, Sampler *sampler, VertexArena &arena, size_t s,
+                        Mask active) const {
+        const Vertex &qs = arena.light[s - 1];
+        Point2f sample = sampler->next_2d(active);
+
+        BSDFPtr bsdf = qs.si.bsdf();
+        active &= has_flag(bsdf->flags(), BSDFFlags::Smooth);
+        if (none_or<false>(active))
+            return;
+
+        auto [ds, sensor_weight] = m_sensor->sample_direction(qs.si, sample, active);
+        active &= neq(ds.pdf, 0.f);
+
+        BSDFContext ctx(TransportMode::Importance);
+        Vector3f wo = qs.si.to_local(ds.d);
+        Spectrum value = qs.throughput * bsdf->eval(ctx, qs.si, wo, active) *
+                         shading_correction(qs.si, ds.d, wo) * sensor_weight;
+
+        active &= any(neq(depolarize(value), 0.f));
+        if (none_or<false>(active))
+            return;
+
+        active &= !scene->ray_test(qs.si.spawn_ray_to(ds.p), active);
+        if (none_or<false>(active))
+            return;
+
+        // Density of sampling the vertex from the sensor (see camera_pdf())
+        Float pdf = depolarize(sensor_weight).x() * abs(dot(qs.si.n, ds.d));
+        value *= mis_weight(scene, arena, s, 1, nullptr, pdf, active);
+
+        Color3f xyz = to_xyz(depolarize(value), qs.si.wavelengths, active);
+
+        // The light image has no coverage, and its weights are ignored by the film
+        Float values[5] = { xyz.x(), xyz.y(), xyz.z(), 0.f, 0.f };
+        m_light_image->put_atomic(ds.uv + ScalarVector2f(m_sensor->film()->crop_offset()),
+                                  values, active);
+    }
+
+    //! @}
+    // =============================================================
+
+    // =============================================================
+    //! @{ \name Densities and MIS weights
+    // =============================================================
+
+    /**
+     * \brief Multiple importance sampling weight of the strategy that connects
+     * the first \c s vertices of the light subpath to the first \c t vertices
+     * of the camera subpath [Veach 1997, Sec. 10.2]
+     *
+     * The weight uses the power heuristic, and only accounts for the
+     * strategies that are actually used. The vertices next to the connection
+     * are sampled from both sides, hence their reverse densities are
+     * recomputed here.
+     *
+     * \param light_endpoint
+     *    For s=1, the vertex that was sampled on the emitter
+     *
+     * \param pdf_camera
+     *    For t=1, the density of sampling the last light vertex from the sensor
+     */
+    Float mis_weight(const Scene *scene, const VertexArena &arena, size_t s, size_t t,
+                     const Vertex *light_endpoint, Float pdf_camera, Mask active) const {
+        const std::vector<Vertex> &light = arena.light, &camera = arena.camera;
+        auto light_vertex = [&](size_t i) -> const Vertex & {
+            return (i == 0 && s == 1) ? *light_endpoint : light[i];
+        };
+
+        // ------- Reverse densities of the vertices next to the connection -------
+
+        Float pt_rev = 0.f, ptm_rev = 0.f, qs_rev = 0.f, qsm_rev = 0.f;
+
+        if (t >= 2) {
+            const Vertex &pt = camera[t - 1], &ptm = camera[t - 2];
+
+            if (s == 0) {
+                // The camera subpath hit an emitter
+                pt_rev = emitter_pdf(scene, pt, ptm.si, active);
+                if (t >= 3)
+                    ptm_rev = convert_density(
+                        emission_pdf(pt, normalize(ptm.si.p - pt.si.p)), pt, ptm);
+            } else {
+                const Vertex &qs = light_vertex(s - 1);
+                if (s == 1)
+                    pt_rev = emission_pdf(qs, normalize(pt.si.p - qs.si.p));
+                else
+                    pt_rev = bsdf_pdf(qs, light[s - 2].si.p, pt.si.p,
+                                      TransportMode::Importance, active);
+                pt_rev = convert_density(pt_rev, qs, pt);
+
+                if (t >= 3)
+                    ptm_rev = convert_density(
+                        bsdf_pdf(pt, qs.si.p, ptm.si.p, TransportMode::Importance, active),
+                        pt, ptm);
+                qs_rev = convert_density(
+                    bsdf_pdf(pt, ptm.si.p, qs.si.p, TransportMode::Radiance, active), pt, qs);
+            }
+        } else {
+            qs_rev = pdf_camera;
+        }
+
+        // For t=1, the first camera vertex coincides with the pinhole
+        if (s >= 2) {
+            const Vertex &qs = light[s - 1], &qsm = light[s - 2];
+            qsm_rev = convert_density(bsdf_pdf(qs, camera[t - 1].si.p, qsm.si.p,
+                                               TransportMode::Radiance, active),
+                                      qs, qsm);
+        }
+
+        auto camera_rev = [&](size_t i) -> Float {
+            return i == t - 1 ? pt_rev : (i + 2 == t ? ptm_rev : camera[i].pdf_rev);
+        };
+        auto light_rev = [&](size_t i) -> Float {
+            return i + 1 == s ? qs_rev : (i + 2 == s ? qsm_rev : light_vertex(i).pdf_rev);
+        };
+        // The vertices next to the connection are not scattered by a delta component
+        auto camera_delta = [&](size_t i) -> Mask {
+            return i + 1 == t ? Mask(false) : camera[i].delta;
+        };
+        auto light_delta = [&](size_t i) -> Mask {
+            return i + 1 == s ? Mask(false) : light_vertex(i).delta;
+        };
+        auto remap0 = [](const Float &pdf) { return select(neq(pdf, 0.f), pdf, 1.f); };
+
+        // ------------ Ratios of the densities of the other strategies ------------
+
+        Float sum = 0.f, ratio = 1.f;
+
+        // Move the connection towards the sensor: strategy (s + t - i, i)
+        for (size_t i = t - 1; i > 0; --i) {
+            ratio *= remap0(camera_rev(i)) / remap0(camera[i].pdf_fwd);
+            if (i == 1 && (!m_light_image || s + t < 3))
+                continue;
+            masked(sum, !camera_delta(i) && !camera_delta(i - 1)) += sqr(ratio);
+        }
+
+        // Move the connection towards the emitter: strategy (i, s + t - i)
+        ratio = 1.f;
+        for (size_t i = s; i-- > 0; ) {
+            ratio *= remap0(light_rev(i)) / remap0(light_vertex(i).pdf_fwd);
+            Mask delta_emitter = i > 0 ? light_delta(i - 1) : !light_vertex(0).on_surface;
+            masked(sum, !light_delta(i) && !delta_emitter) += sqr(ratio);
+        }
+
+        return rcp(1.f + sum);
+    }
+
+    /**
+     * \brief Density per unit area (including the emitter selection) of the
+     * light subpath endpoint \c v, which is followed by the vertex \c ref
+     *
+     * \c Emitter::sample_ray() doesn't expose its positional density, hence
+     * this uses the density of \c Scene::sample_emitter_direction() from \c ref
+     * (which samples uniformly by area for most shapes). All strategies use
+     * the same density, so that the MIS weights still sum to one.
+     */
+    Float emitter_pdf(const Scene *scene, const Vertex &v, const SurfaceInteraction3f &ref,
+                      Mask active) const {
+        Float pdf = rcp((ScalarFloat) scene->emitters().size());
+
+        Mask surface = active && v.on_surface;
+        if (any_or<true>(surface)) {
+            DirectionSample3f ds(v.si, ref);
+            ds.object = v.emitter;
+            masked(pdf, surface) = scene->pdf_emitter_direction(ref, ds, surface) *
+                                   abs(dot(ds.n, ds.d)) / sqr(ds.dist);
+        }
+
+        return pdf;
+    }
+
+    /**
+     * \brief Density per unit solid angle of emitting a ray from the light
+     * subpath endpoint \c v towards \c d
+     *
+     * This matches the cosine-weighted directions of the area emitters, and
+     * the uniform directions of the point lights.
+     */
+    Float emission_pdf(const Vertex &v, const Vector3f &d) const {
+        return select(v.on_surface, max(dot(v.si.sh_frame.n, d), 0.f) * math::InvPi<Float>,
+                      math::InvFourPi<Float>);
+    }
+
+    /**
+     * \brief Density per unit area of sampling the vertex \c v from the
+     * sensor, which is currently assumed to be a pinhole camera
+     *
+     * The importance returned by \c Sensor::sample_direction() is then equal
+     * to the density of the sensor rays per unit solid angle.
+     */
+    Float camera_pdf(const Vertex &v, Mask active) const {
+        auto [ds, weight] = m_sensor->sample_direction(v.si, Point2f(.5f), active);
+        return select(active, depolarize(weight).x() * abs(dot(v.si.n, ds.d)), 0.f);
+    }
+
+    /**
+     * \brief Density per unit solid angle of sampling the direction towards
+     * \c p_out at the vertex \c v, when arriving from the direction of \c p_in
+     */
+    Float bsdf_pdf(const Vertex &v, const Point3f &p_in, const Point3f &p_out,
+                   TransportMode mode, Mask active) const {
+        SurfaceInteraction3f si(v.si);
+        si.wi = si.to_local(normalize(p_in - si.p));
+        BSDFContext ctx(mode);
+        return si.bsdf()->pdf(ctx, si, si.to_local(normalize(p_out - si.p)), active);
+    }
+
+    /// Convert the density per unit solid angle of sampling \c to from \c from to a density per unit area
+    Float convert_density(Float pdf, const Vertex &from, const Vertex &to) const {
+        Vector3f d = to.si.p - from.si.p;
+        Float inv_dist_sqr = rcp(squared_norm(d));
+        pdf *= inv_dist_sqr;
+        return select(to.on_surface, pdf * abs(dot(to.si.n, d)) * sqrt(inv_dist_sqr), pdf);
+    }
+
+    Float power_heuristic(Float pdf_a, Float pdf_b) const {
+        pdf_a *= pdf_a;
+        pdf_b *= pdf_b;
+        return select(pdf_a > 0.f, pdf_a / (pdf_a + pdf_b), 0.f);
+    }
+
+    //! @}
+    // =============================================================
+
+protected:
+    bool m_light_image_enabled;
+    mutable ThreadLocal<VertexArena> m_arena;
+
+    /// Shared light image and sensor, only set while rendering
+    ImageBlock *m_light_image = nullptr;
+    const Sensor *m_sensor = nullptr;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(BDPTIntegrator, MonteCarloIntegrator)
+MTS_EXPORT_PLUGIN(BDPTIntegrator, "Bidirectional Path Tracer integrator");
+NAMESPACE_END(mitsuba)
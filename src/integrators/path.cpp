@@ -1,7 +1,10 @@
 #include <random>
+#include <atomic>
 #include <enoki/stl.h>
 #include <mitsuba/core/ray.h>
+#include <mitsuba/core/memtrack.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/stats.h>
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/integrator.h>
@@ -30,6 +33,32 @@ Path tracer (:monosp:`path`)
  * - hide_emitters
    - |bool|
    - Hide directly visible emitters. (Default: no, i.e. |false|)
+ * - emitter_samples
+   - |int|
+   - Number of emitter samples (i.e. shadow rays) taken at every path vertex.
+     (Default: 1)
+ * - bsdf_samples
+   - |int|
+   - Number of BSDF samples taken at every path vertex. The path continues
+     along the first one, the others only account for emitters that they hit.
+     (Default: 1)
+ * - shading_samples
+   - |int|
+   - Shorthand for setting both ``emitter_samples`` and ``bsdf_samples``
+     to the same value. (Default: 1)
+ * - rr_mode
+   - |string|
+   - Path termination strategy: ``throughput`` (Russian roulette based on
+     the path throughput) or ``adjoint`` (Russian roulette and splitting
+     based on a learned radiance estimate, see below). (Default: ``throughput``)
+ * - rr_training_passes
+   - |int|
+   - Number of passes used to learn the radiance estimate in the ``adjoint``
+     mode. (Default: 1)
+ * - rr_max_split
+   - |int|
+   - Largest number of paths a path may be split into at a single vertex in
+     the ``adjoint`` mode. (Default: 8)
 
 This integrator implements a basic path tracer and is a **good default choice**
 when there is no strong reason to prefer another method.
@@ -63,6 +92,45 @@ sampling to combine BSDF and emitter samples. The main difference in comparison
 to the former plugin is that it considers light paths of arbitrary length to compute
 both direct and indirect illumination.
 
+In scenes that are dominated by direct illumination from many or large emitters,
+tracing camera paths is expensive compared to shadow rays. The ``emitter_samples``
+and ``bsdf_samples`` parameters then reduce the noise of the direct illumination
+at every path vertex at a lower cost than additional samples per pixel. The
+multiple importance sampling weights account for the number of samples taken
+with each technique. Shadow rays are only traced for emitter samples with a
+nonzero contribution, using one visibility query per emitter sample.
+
+.. _sec-path-adjoint-rr:
+
+Adjoint-driven Russian roulette and splitting
+---------------------------------------------
+
+By default, paths are terminated using Russian roulette once they exceed
+``rr_depth`` bounces, with a survival probability that is proportional to
+their throughput. This ignores how much light actually arrives at the path
+vertices: paths that are about to reach bright regions are terminated just
+as often as paths that carry hardly any energy.
+
+With ``rr_mode`` set to ``adjoint``, the integrator instead estimates the
+expected contribution of a path to its pixel [VK16]_: this is the product of
+its throughput with an estimate of the radiance leaving the current vertex
+towards the previous one, divided by an estimate of the pixel value (the
+radiance leaving the first vertex). Paths whose expected contribution falls
+below a *weight window* around the pixel value are terminated using Russian
+roulette, and paths exceeding it are split into several independent paths.
+Both keep the estimate unbiased.
+
+The radiance estimates are stored in a hashed grid over the scene (keyed by
+position and the dominant axis of the surface normal), which is learned
+during the first ``rr_training_passes`` passes. These passes use the default
+strategy. This mode thus requires rendering in several passes (see the
+``samples_per_pass`` parameter), and the grid is kept until the integrator
+is destroyed.
+
+.. [VK16] Jiří Vorba and Jaroslav Křivánek. Adjoint-Driven Russian Roulette
+   and Splitting in Light Transport Simulation. ACM Transactions on
+   Graphics (Proceedings of SIGGRAPH 2016).
+
 .. _sec-path-strictnormals:
 
 .. Commented out for now
@@ -93,27 +161,82 @@ template <typename Float, typename Spectrum>
 class PathIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
 public:
     MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth)
-    MTS_IMPORT_TYPES(Scene, Sampler, Medium, Emitter, EmitterPtr, BSDF, BSDFPtr)
+    MTS_IMPORT_TYPES(Scene, Sensor, Sampler, Medium, Emitter, EmitterPtr, BSDF, BSDFPtr)
+
+    PathIntegrator(const Properties &props) : Base(props) {
+        if (props.has_property("shading_samples")
+            && (props.has_property("emitter_samples") ||
+                props.has_property("bsdf_samples"))) {
+            Throw("Cannot specify both 'shading_samples' and"
+                  " ('emitter_samples' and/or 'bsdf_samples').");
+        }
+
+        /// Number of shading samples -- this parameter is a shorthand notation
+        /// to set both 'emitter_samples' and 'bsdf_samples' at the same time
+        size_t shading_samples = props.size_("shading_samples", 1);
+
+        /// Number of samples to take using the emitter sampling technique
+        m_emitter_samples = props.size_("emitter_samples", shading_samples);
+
+        /// Number of samples to take using the BSDF sampling technique
+        m_bsdf_samples = props.size_("bsdf_samples", shading_samples);
+
+        if (m_bsdf_samples == 0)
+            Throw("Must have at least 1 BSDF sample to continue paths!");
 
-    PathIntegrator(const Properties &props) : Base(props) { }
+        size_t sum       = m_emitter_samples + m_bsdf_samples;
+        m_weight_bsdf    = 1.f / (ScalarFloat) m_bsdf_samples;
+        m_weight_emitter = m_emitter_samples > 0 ? 1.f / (ScalarFloat) m_emitter_samples : 0.f;
+        m_frac_bsdf      = m_bsdf_samples / (ScalarFloat) sum;
+        m_frac_emitter   = m_emitter_samples / (ScalarFloat) sum;
+
+        std::string rr_mode = props.string("rr_mode", "throughput");
+        if (rr_mode == "adjoint")
+            m_adjoint_rr = true;
+        else if (rr_mode != "throughput")
+            Throw("Invalid \"rr_mode\" value \"%s\", must be \"throughput\" or \"adjoint\"!",
+                  rr_mode);
+
+        if (m_adjoint_rr && is_cuda_array_v<Float>)
+            Throw("The \"adjoint\" Russian roulette mode is not supported in GPU variants!");
+
+        m_rr_training_passes = props.int_("rr_training_passes", 1);
+        if (m_rr_training_passes <= 0)
+            Throw("\"rr_training_passes\" must be set to a value greater than zero!");
+
+        m_rr_max_split = props.int_("rr_max_split", 8);
+        if (m_rr_max_split <= 0)
+            Throw("\"rr_max_split\" must be set to a value greater than zero!");
+    }
+
+    void prepare_pass(const Scene *scene, const Sensor * /* sensor */,
+                      size_t pass, size_t pass_count) override {
+        if (!m_adjoint_rr)
+            return;
+
+        if (pass == 0) {
+            if (pass_count <= (size_t) m_rr_training_passes)
+                Log(Warn, "The \"adjoint\" Russian roulette mode needs more than %i "
+                          "pass%s (see the \"samples_per_pass\" parameter), falling back "
+                          "to throughput-based Russian roulette.",
+                    m_rr_training_passes, m_rr_training_passes == 1 ? "" : "es");
+            reset_cache(scene);
+        }
+
+        m_cache_training = pass < (size_t) m_rr_training_passes;
+        if (pass == (size_t) m_rr_training_passes)
+            update_cache();
+    }
 
     std::pair<Spectrum, Mask> sample(const Scene *scene,
                                      Sampler *sampler,
-                                     const RayDifferential3f &ray_,
+                                     const RayDifferential3f &ray,
                                      const Medium * /* medium */,
                                      Float * /* aovs */,
                                      Mask active) const override {
         MTS_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
 
-        RayDifferential3f ray = ray_;
-
-        // Tracks radiance scaling due to index of refraction changes
-        Float eta(1.f);
-
-        // MIS weight for intersected emitters (set by prev. iteration)
-        Float emission_weight(1.f);
-
-        Spectrum throughput(1.f), result(0.f);
+        Spectrum result(0.f);
 
         // ---------------------- First intersection ----------------------
 
@@ -121,54 +244,200 @@ public:
         Mask valid_ray = si.is_valid();
         EmitterPtr emitter = si.emitter(scene);
 
-        for (int depth = 1;; ++depth) {
+        if (any_or<true>(neq(emitter, nullptr)))
+            result[active] += emitter->eval(si, active);
 
-            // ---------------- Intersection with emitters ----------------
+        active &= si.is_valid();
 
-            if (any_or<true>(neq(emitter, nullptr)))
-                result[active] += emission_weight * throughput * emitter->eval(si, active);
-
-            active &= si.is_valid();
-
-            /* Russian roulette: try to keep path weights equal to one,
-               while accounting for the solid angle compression at refractive
-               index boundaries. Stop with at least some probability to avoid
-               getting stuck (e.g. due to total internal reflection) */
-            if (depth > m_rr_depth) {
-                Float q = min(hmax(depolarize(throughput)) * sqr(eta), .95f);
-                active &= sampler->next_1d(active) < q;
-                throughput *= rcp(q);
-            }
+        // Number of surface interactions per path (for the statistics)
+        UInt32 path_length(0);
 
-            // Stop if we've exceeded the number of requested bounces, or
-            // if there are no more active lanes. Only do this latter check
-            // in GPU mode when the number of requested bounces is infinite
-            // since it causes a costly synchronization.
-            if ((uint32_t) depth >= (uint32_t) m_max_depth ||
-                ((!is_cuda_array_v<Float> || m_max_depth < 0) && none(active)))
-                break;
+        result += trace(scene, sampler, ray, si, Spectrum(1.f), Float(1.f),
+                        Float(-1.f), 1, false, active, path_length);
 
-            // --------------------- Emitter sampling ---------------------
+        MTS_STATS_ONLY(MTS_STATS_HISTOGRAM(PathLength, path_length, valid_ray);)
+        return { result, valid_ray };
+    }
 
-            BSDFContext ctx;
-            BSDFPtr bsdf = si.bsdf(ray);
-            Mask active_e = active && has_flag(bsdf->flags(), BSDFFlags::Smooth);
+    //! @}
+    // =============================================================
+
+    std::string to_string() const override {
+        return tfm::format("PathIntegrator[\n"
+            "  max_depth = %i,\n"
+            "  rr_depth = %i,\n"
+            "  emitter_samples = %i,\n"
+            "  bsdf_samples = %i,\n"
+            "  rr_mode = %s\n"
+            "]", m_max_depth, m_rr_depth, m_emitter_samples, m_bsdf_samples,
+            m_adjoint_rr ? "adjoint" : "throughput");
+    }
+
+    Float mis_weight(Float pdf_a, Float pdf_b) const {
+        pdf_a *= pdf_a;
+        pdf_b *= pdf_b;
+        return select(pdf_a > 0.f, pdf_a / (pdf_a + pdf_b), 0.f);
+    }
 
-            if (likely(any_or<true>(active_e))) {
-                auto [ds, emitter_val] = scene->sample_emitter_direction(
-                    si, sampler->next_2d(active_e), true, active_e);
-                active_e &= neq(ds.pdf, 0.f);
+    /**
+     * \brief MIS weight of a BSDF sample \c bs taken at \c si that hit the
+     * emitter \c emitter at \c si_emitter, including the normalization by
+     * the number of BSDF samples
+     */
+    Float emission_weight(const Scene *scene, const SurfaceInteraction3f &si,
+                          const SurfaceInteraction3f &si_emitter, const BSDFSample3f &bs,
+                          EmitterPtr emitter, Mask active) const {
+        /* Determine probability of having sampled that same
+           direction using emitter sampling. */
+        DirectionSample3f ds(si_emitter, si);
+        ds.object = emitter;
+
+        Float emitter_pdf =
+            select(neq(emitter, nullptr) && !has_flag(bs.sampled_type, BSDFFlags::Delta),
+                   scene->pdf_emitter_direction(si, ds, active),
+                   0.f);
+
+        return mis_weight(bs.pdf * m_frac_bsdf, emitter_pdf * m_frac_emitter) * m_weight_bsdf;
+    }
 
-                // Query the BSDF for that emitter-sampled direction
-                Vector3f wo = si.to_local(ds.d);
-                Spectrum bsdf_val = bsdf->eval(ctx, si, wo, active_e);
-                bsdf_val = si.to_world_mueller(bsdf_val, -wo, si.wi);
+    MTS_DECLARE_CLASS()
+protected:
+    /**
+     * \brief Continue a path from the surface interaction \c si at the given
+     * depth, whose emission has already been accounted for
+     *
+     * Returns the contribution of the remainder of the path. When \c split is
+     * set, the path was just created by splitting, and Russian roulette and
+     * splitting are skipped at the first vertex.
+     */
+    Spectrum trace(const Scene *scene, Sampler *sampler, RayDifferential3f ray,
+                   SurfaceInteraction3f si, Spectrum throughput, Float eta,
+                   Float pixel_estimate, int depth, bool split, Mask active,
+                   UInt32 &path_length) const {
+        Spectrum result(0.f);
+
+        bool adjoint  = m_adjoint_rr && m_cache_ready,
+             training = m_adjoint_rr && m_cache_training && m_cache_sum;
+
+        // Vertices whose outgoing radiance is learned (training passes only)
+        UInt32 record_index[RRMaxRecords];
+        Float record_throughput[RRMaxRecords], record_result[RRMaxRecords];
+        Mask record_active[RRMaxRecords];
+        int record_count = 0;
+
+        for (;; ++depth) {
+            if (!split) {
+                MTS_STATS_ONLY(masked(path_length, active) = max(path_length, UInt32(depth));)
+
+                Mask throughput_rr = true;
+                Float split_count(1.f);
+
+                if (adjoint) {
+                    /* Adjoint-driven Russian roulette and splitting: compare
+                       the expected contribution of the path (its throughput
+                       times the radiance leaving the vertex) to the pixel
+                       estimate, and keep it within a window around it */
+                    Float estimate = cache_lookup(si, active);
+                    if (depth == 1)
+                        pixel_estimate = estimate;
+
+                    Mask known = active && estimate >= 0.f && pixel_estimate > 0.f;
+                    Float ratio = hmean(depolarize(throughput)) * estimate / pixel_estimate;
+                    throughput_rr = !known;
+
+                    Mask roulette = known && ratio < RRWindowMin;
+                    Float q = max(ratio, .05f);
+                    active &= !roulette || sampler->next_1d(active) < q;
+                    throughput = select(roulette, throughput * rcp(q), throughput);
+
+                    Mask splitting = known && ratio > RRWindowMax;
+                    Float n = floor(min(ratio, (ScalarFloat) m_rr_max_split) +
+                                    sampler->next_1d(active));
+                    split_count = select(splitting, max(n, 1.f), 1.f);
+                }
+
+                /* Russian roulette: try to keep path weights equal to one,
+                   while accounting for the solid angle compression at refractive
+                   index boundaries. Stop with at least some probability to avoid
+                   getting stuck (e.g. due to total internal reflection) */
+                if (depth > m_rr_depth) {
+                    Float q = min(hmax(depolarize(throughput)) * sqr(eta), .95f);
+                    active &= !throughput_rr || sampler->next_1d(active) < q;
+                    throughput = select(throughput_rr, throughput * rcp(q), throughput);
+                }
+
+                // Stop if we've exceeded the number of requested bounces, or
+                // if there are no more active lanes. Only do this latter check
+                // in GPU mode when the number of requested bounces is infinite
+                // since it causes a costly synchronization.
+                if ((uint32_t) depth >= (uint32_t) m_max_depth ||
+                    ((!is_cuda_array_v<Float> || m_max_depth < 0) && none(active)))
+                    break;
+
+                if (training && record_count < RRMaxRecords) {
+                    record_index[record_count]      = cache_index(si);
+                    record_throughput[record_count] = hmean(depolarize(throughput));
+                    record_result[record_count]     = hmean(depolarize(result));
+                    record_active[record_count]     = active;
+                    record_count++;
+                }
+
+                // Splitting: trace the additional paths, then continue with this one
+                uint32_t split_max = adjoint ? (uint32_t) hmax(split_count) : 1u;
+                if (split_max > 1) {
+                    throughput /= split_count;
+                    for (uint32_t i = 1; i < split_max; ++i)
+                        result += trace(scene, sampler, ray, si, throughput, eta,
+                                        pixel_estimate, depth, true,
+                                        active && split_count > (ScalarFloat) i, path_length);
+                }
+            }
+            split = false;
 
-                // Determine density of sampling that same direction using BSDF sampling
-                Float bsdf_pdf = bsdf->pdf(ctx, si, wo, active_e);
+            // --------------------- Emitter sampling ---------------------
 
-                Float mis = select(ds.delta, 1.f, mis_weight(ds.pdf, bsdf_pdf));
-                result[active_e] += mis * throughput * bsdf_val * emitter_val;
+            BSDFContext ctx;
+            BSDFPtr bsdf = si.bsdf(ray);
+            Mask sample_emitter = active && has_flag(bsdf->flags(), BSDFFlags::Smooth);
+
+            /* The shadow rays of the emitter samples are not merged into a
+               single query: Scene::ray_test() takes rays of the variant's own
+               width (Embree and the kd-tree trace 1/4/8/16-wide packets, and
+               GPU variants already launch one query over the wavefront).
+               Merging would therefore only regroup the same traversals while
+               keeping every sample's records alive until the end. */
+            if (m_emitter_samples > 0 && likely(any_or<true>(sample_emitter))) {
+                for (size_t i = 0; i < m_emitter_samples; ++i) {
+                    // Visibility is tested below, once the contribution is known
+                    Mask active_e = sample_emitter;
+                    auto [ds, emitter_val] = scene->sample_emitter_direction(
+                        si, sampler->next_2d(active_e), false, active_e);
+                    active_e &= neq(ds.pdf, 0.f);
+
+                    // Query the BSDF for that emitter-sampled direction
+                    Vector3f wo = si.to_local(ds.d);
+                    Spectrum bsdf_val = bsdf->eval(ctx, si, wo, active_e);
+                    bsdf_val = si.to_world_mueller(bsdf_val, -wo, si.wi);
+
+                    // Determine density of sampling that same direction using BSDF sampling
+                    Float bsdf_pdf = bsdf->pdf(ctx, si, wo, active_e);
+
+                    Float mis = select(ds.delta, Float(1.f),
+                                       mis_weight(ds.pdf * m_frac_emitter,
+                                                  bsdf_pdf * m_frac_bsdf)) * m_weight_emitter;
+                    Spectrum contrib = mis * throughput * bsdf_val * emitter_val;
+
+                    // Only trace shadow rays for samples that contribute
+                    active_e &= any(neq(depolarize(contrib), 0.f));
+                    if (any_or<true>(active_e)) {
+                        Ray3f shadow_ray(si.p, ds.d,
+                                         math::RayEpsilon<Float> * (1.f + hmax(abs(si.p))),
+                                         ds.dist * (1.f - math::ShadowEpsilon<Float>),
+                                         si.time, si.wavelengths);
+                        active_e &= !scene->ray_test(shadow_ray, active_e);
+                        result[active_e] += contrib;
+                    }
+                }
             }
 
             // ----------------------- BSDF sampling ----------------------
@@ -177,6 +446,25 @@ public:
             auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(active),
                                                sampler->next_2d(active), active);
             bsdf_val = si.to_world_mueller(bsdf_val, -bs.wo, si.wi);
+            MTS_STATS_COUNT(BSDFSamples, active);
+            MTS_STATS_COUNT(BSDFSamplesZero, active && all(eq(depolarize(bsdf_val), 0.f)));
+
+            // Additional BSDF samples only account for the emitters that they hit
+            for (size_t i = 1; i < m_bsdf_samples; ++i) {
+                auto [bs_i, bsdf_val_i] = bsdf->sample(ctx, si, sampler->next_1d(active),
+                                                       sampler->next_2d(active), active);
+                bsdf_val_i = si.to_world_mueller(bsdf_val_i, -bs_i.wo, si.wi);
+                Mask active_b = active && any(neq(depolarize(bsdf_val_i), 0.f));
+
+                SurfaceInteraction3f si_i =
+                    scene->ray_intersect(si.spawn_ray(si.to_world(bs_i.wo)), active_b);
+                EmitterPtr emitter = si_i.emitter(scene, active_b);
+                active_b &= neq(emitter, nullptr);
+
+                if (any_or<true>(active_b))
+                    result[active_b] += emission_weight(scene, si, si_i, bs_i, emitter, active_b) *
+                                        throughput * bsdf_val_i * emitter->eval(si_i, active_b);
+            }
 
             throughput = throughput * bsdf_val;
             active &= any(neq(depolarize(throughput), 0.f));
@@ -189,44 +477,143 @@ public:
             ray = si.spawn_ray(si.to_world(bs.wo));
             SurfaceInteraction3f si_bsdf = scene->ray_intersect(ray, active);
 
-            /* Determine probability of having sampled that same
-               direction using emitter sampling. */
-            emitter = si_bsdf.emitter(scene, active);
-            DirectionSample3f ds(si_bsdf, si);
-            ds.object = emitter;
+            EmitterPtr emitter = si_bsdf.emitter(scene, active);
+            if (any_or<true>(neq(emitter, nullptr)))
+                result[active] += emission_weight(scene, si, si_bsdf, bs, emitter, active) *
+                                  throughput * emitter->eval(si_bsdf, active);
 
-            if (any_or<true>(neq(emitter, nullptr))) {
-                Float emitter_pdf =
-                    select(neq(emitter, nullptr) && !has_flag(bs.sampled_type, BSDFFlags::Delta),
-                           scene->pdf_emitter_direction(si, ds),
-                           0.f);
+            active &= si_bsdf.is_valid();
+            si = std::move(si_bsdf);
+        }
 
-                emission_weight = mis_weight(bs.pdf, emitter_pdf);
+        // Learn the radiance leaving the recorded vertices from the rest of the path
+        if (training) {
+            Float total = hmean(depolarize(result));
+            for (int i = 0; i < record_count; ++i) {
+                Mask valid = record_active[i] && record_throughput[i] > 0.f;
+                cache_add(record_index[i],
+                          select(valid, (total - record_result[i]) / record_throughput[i], 0.f),
+                          valid);
             }
-
-            si = std::move(si_bsdf);
         }
 
-        return { result, valid_ray };
+        ENOKI_MARK_USED(path_length);
+        return result;
     }
 
-    //! @}
+    // =============================================================
+    //! @{ \name Radiance estimates of the adjoint-driven Russian roulette
     // =============================================================
 
-    std::string to_string() const override {
-        return tfm::format("PathIntegrator[\n"
-            "  max_depth = %i,\n"
-            "  rr_depth = %i\n"
-            "]", m_max_depth, m_rr_depth);
+    /// Allocate or clear the grid, and fit it to the scene
+    void reset_cache(const Scene *scene) {
+        if (!m_cache_sum) {
+            m_cache_sum.reset(new std::atomic<float>[RRCacheSize]);
+            m_cache_count.reset(new std::atomic<uint32_t>[RRCacheSize]);
+            m_cache_estimate.reset(new ScalarFloat[RRCacheSize]);
+            m_cache_memory.reset(MemoryCategory::Integrator,
+                                 RRCacheSize * (sizeof(float) + sizeof(uint32_t) +
+                                                sizeof(ScalarFloat)));
+        }
+
+        for (uint32_t i = 0; i < RRCacheSize; ++i) {
+            m_cache_sum[i].store(0.f, std::memory_order_relaxed);
+            m_cache_count[i].store(0, std::memory_order_relaxed);
+        }
+
+        ScalarBoundingBox3f bbox = scene->bbox();
+        m_cache_origin = bbox.min;
+        m_cache_scale = (ScalarFloat) RRCacheResolution /
+                        std::max(hmax(bbox.extents()), ScalarFloat(1e-4f));
+        m_cache_ready = false;
     }
 
-    Float mis_weight(Float pdf_a, Float pdf_b) const {
-        pdf_a *= pdf_a;
-        pdf_b *= pdf_b;
-        return select(pdf_a > 0.f, pdf_a / (pdf_a + pdf_b), 0.f);
+    /// Turn the accumulated samples into estimates (negative where there are none)
+    void update_cache() {
+        for (uint32_t i = 0; i < RRCacheSize; ++i) {
+            uint32_t count = m_cache_count[i].load(std::memory_order_relaxed);
+            m_cache_estimate[i] =
+                count > 0 ? m_cache_sum[i].load(std::memory_order_relaxed) / count : -1.f;
+        }
+        m_cache_ready = true;
     }
 
-    MTS_DECLARE_CLASS()
+    /// Hash of the grid cell containing \c si and of the dominant axis of its normal
+    UInt32 cache_index(const SurfaceInteraction3f &si) const {
+        Vector3f p = clamp((si.p - m_cache_origin) * m_cache_scale, 0.f,
+                           (ScalarFloat) (RRCacheResolution - 1));
+        Vector3f n = abs(si.n);
+        Float side = select(n.x() > n.y() && n.x() > n.z(), select(si.n.x() < 0.f, 1.f, 0.f),
+                     select(n.y() > n.z(),                  select(si.n.y() < 0.f, 3.f, 2.f),
+                                                            select(si.n.z() < 0.f, 5.f, 4.f)));
+
+        UInt32 hash = (UInt32(p.x()) * 73856093u) ^ (UInt32(p.y()) * 19349663u) ^
+                      (UInt32(p.z()) * 83492791u) ^ (UInt32(side) * 2654435761u);
+        return hash & (RRCacheSize - 1);
+    }
+
+    Float cache_lookup(const SurfaceInteraction3f &si, Mask active) const {
+        if constexpr (!is_cuda_array_v<Float>)
+            return select(active, gather<Float>(m_cache_estimate.get(), cache_index(si), active),
+                          -1.f);
+        else
+            return Float(-1.f);
+    }
+
+    void cache_add(const UInt32 &index, const Float &value, Mask active) const {
+        auto add = [&](uint32_t i, float v) {
+            float sum = m_cache_sum[i].load(std::memory_order_relaxed);
+            while (!m_cache_sum[i].compare_exchange_weak(sum, sum + v,
+                                                         std::memory_order_relaxed))
+                ;
+            m_cache_count[i].fetch_add(1, std::memory_order_relaxed);
+        };
+
+        if constexpr (!is_array_v<Float>) {
+            if (active)
+                add(index, (float) value);
+        } else if constexpr (!is_cuda_array_v<Float>) {
+            for (size_t i = 0; i < slices(index); ++i)
+                if (slice(active, i))
+                    add(slice(index, i), (float) slice(value, i));
+        } else {
+            ENOKI_MARK_USED(index);
+            ENOKI_MARK_USED(value);
+            ENOKI_MARK_USED(active);
+            ENOKI_MARK_USED(add);
+        }
+    }
+
+    //! @}
+    // =============================================================
+
+protected:
+    /// Number of cells of the hashed grid
+    static constexpr uint32_t RRCacheSize = 1u << 20;
+    /// Number of grid cells along the largest dimension of the scene
+    static constexpr uint32_t RRCacheResolution = 128;
+    /// Max. number of vertices per path whose radiance is learned
+    static constexpr int RRMaxRecords = 16;
+    /// Weight window relative to the pixel estimate (with a ratio of 5 between the bounds)
+    static constexpr float RRWindowMin = 2.f / 6.f, RRWindowMax = 10.f / 6.f;
+
+    size_t m_emitter_samples;
+    size_t m_bsdf_samples;
+    ScalarFloat m_frac_bsdf, m_frac_emitter;
+    ScalarFloat m_weight_bsdf, m_weight_emitter;
+
+    bool m_adjoint_rr = false;
+    int m_rr_training_passes;
+    int m_rr_max_split;
+
+    std::unique_ptr<std::atomic<float>[]> m_cache_sum;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_cache_count;
+    std::unique_ptr<ScalarFloat[]> m_cache_estimate;
+    TrackedAllocation m_cache_memory;
+    ScalarPoint3f m_cache_origin;
+    ScalarFloat m_cache_scale = 0.f;
+    bool m_cache_training = false;
+    bool m_cache_ready = false;
 };
 
 MTS_IMPLEMENT_CLASS_VARIANT(PathIntegrator, MonteCarloIntegrator)
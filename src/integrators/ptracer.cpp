@@ -0,0 +1,319 @@
+#include <atomic>
+#include <enoki/stl.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/progress.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/lightpath.h>
+#include <mitsuba/render/records.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/sensor.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-ptracer:
+
+Particle tracer (:monosp:`ptracer`)
+-----------------------------------
+
+.. pluginparameters::
+
+ * - max_depth
+   - |int|
+   - Specifies the longest path depth in the generated output image (where -1 corresponds to
+     :math:`\infty`). A value of 2 only renders direct illumination, like for the
+     :ref:`path <integrator-path>` plugin. (Default: -1)
+ * - rr_depth
+   - |int|
+   - Specifies the number of scattering events after which the implementation starts to use
+     Russian roulette to terminate light paths. (Default: 5)
+ * - granularity
+   - |int|
+   - Number of light paths per work unit. The work units are distributed over all
+     cores. (Default: 16384)
+ * - timeout
+   - |float|
+   - Maximum rendering time in seconds (excluding scene parsing). A negative value
+     disables the timeout. (Default: -1)
+
+This plugin implements an adjoint particle tracer, also known as *light tracing*.
+It is the dual of the :ref:`path <integrator-path>` tracer: light paths start at
+a randomly chosen emitter (using ``Emitter::sample_ray()``) and are scattered by
+the BSDFs in importance transport mode. Every vertex with a non-specular BSDF is
+connected to the sensor (using ``Sensor::sample_direction()``), and the
+contribution is splatted into the image at the position where the vertex
+projects.
+
+This is useful for effects that are difficult to render starting from the
+sensor, in particular caustics from small emitters seen through specular
+surfaces, such as a point light shining through a glass object. On the other
+hand, paths whose last scattering event (before they reach the sensor) is
+specular cannot be rendered at all. Directly visible emitters are not rendered
+either, hence the image corresponds to that of the :ref:`path <integrator-path>`
+tracer with ``hide_emitters`` enabled (except for specular reflections of the
+emitters).
+
+The integrator traces as many light paths as the :ref:`path <integrator-path>`
+tracer traces camera paths, i.e. the pixel count times the sample count of the
+sensor's sampler. The image is normalized by the number of light paths that
+were actually traced, which is smaller when the rendering is stopped (e.g.
+by the ``timeout``). The light paths are
+processed in parallel work units of ``granularity`` paths. All threads splat into
+a single image using atomic operations, so that the memory usage doesn't grow
+with the number of cores. The samples of every light path only depend on its
+index, hence the image doesn't depend on the scheduling of the work units.
+
+The sensor must implement ``sample_direction()``, which is currently the case
+for the :ref:`perspective <sensor-perspective>` camera. This integrator is not
+supported in GPU variants, and ignores participating media.
+
+ */
+
+template <typename Float, typename Spectrum>
+class ParticleTracerIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_stop, m_timeout,
+                    m_render_timer, should_stop)
+    MTS_IMPORT_TYPES(Scene, Sensor, Sampler, Film, ImageBlock, BSDF, BSDFPtr)
+
+    ParticleTracerIntegrator(const Properties &props) : Base(props) {
+        m_granularity = props.size_("granularity", 16384);
+        if (m_granularity == 0)
+            Throw("\"granularity\" must be set to a value greater than zero!");
+
+        if constexpr (is_polarized_v<Spectrum>)
+            Throw("The particle tracer does not support polarized variants!");
+    }
+
+    bool render(Scene *scene, Sensor *sensor) override {
+        ScopedPhase sp(ProfilerPhase::Render);
+        m_stop = false;
+
+        if constexpr (is_cuda_array_v<Float>) {
+            ENOKI_MARK_USED(scene);
+            ENOKI_MARK_USED(sensor);
+            Throw("The particle tracer is not supported in GPU variants!");
+        } else {
+            ref<Film> film = sensor->film();
+            ScalarVector2i film_size = film->crop_size();
+            film->prepare({ "X", "Y", "Z", "A", "W" });
+
+            size_t spp        = sensor->sampler()->sample_count(),
+                   path_count = (size_t) hprod(film_size) * spp,
+                   work_count = (path_count + m_granularity - 1) / m_granularity,
+                   n_threads  = __global_thread_count;
+
+            Log(Info, "Starting render job (%ix%i, %i light path%s, %i thread%s)",
+                film_size.x(), film_size.y(), path_count, path_count == 1 ? "" : "s",
+                n_threads, n_threads == 1 ? "" : "s");
+
+            if (m_timeout > 0.f)
+                Log(Info, "Timeout specified: %.2f seconds.", m_timeout);
+
+            // Light paths may contribute anywhere, hence all threads share the image
+            ref<ImageBlock> block = new ImageBlock(film_size, 5, film->reconstruction_filter(),
+                                                   true, true, true, true);
+            block->set_offset(film->crop_offset());
+            block->clear();
+
+            ThreadEnvironment env;
+            std::atomic<size_t> traced { 0 };
+            ref<ProgressReporter> progress = new ProgressReporter("Rendering", nullptr, work_count);
+            m_render_timer.reset();
+
+            if (!scene->emitters().empty()) {
+                tbb::parallel_for(
+                    tbb::blocked_range<size_t>(0, work_count, 1),
+                    [&](const tbb::blocked_range<size_t> &range) {
+                        ScopedSetThreadEnvironment set_env(env);
+                        ref<Sampler> sampler = sensor->sampler()->clone();
+                        scoped_flush_denormals flush_denormals(true);
+
+                        for (auto i = range.begin(); i != range.end() && !should_stop(); ++i) {
+                            size_t offset = i * m_granularity,
+                                   count  = std::min(m_granularity, path_count - offset);
+
+                            // Ensure that the sample generation is fully deterministic
+                            sampler->seed(i);
+
+                            traced += render_work_unit(scene, sensor, sampler, block,
+                                                       offset, count);
+                            progress->advance(1, count);
+                        }
+                    }
+                );
+            }
+
+            /* Normalize by the number of light paths that were traced per
+               pixel (fewer than 'spp' if the rendering was stopped). All
+               pixels are considered to be covered. */
+            if (traced > 0) {
+                ScalarFloat *data = block->data().data();
+                ScalarFloat scale = (ScalarFloat) hprod(film_size) / (ScalarFloat) traced;
+                size_t pixel_count = hprod(block->size() + 2 * block->border_size());
+                for (size_t i = 0; i < pixel_count; ++i, data += 5) {
+                    for (size_t k = 0; k < 3; ++k)
+                        data[k] *= scale;
+                    data[3] = 1.f;
+                }
+                film->put_normalized(block);
+            }
+
+            if (!m_stop)
+                Log(Info, "Rendering finished. (took %s)",
+                    util::time_string(m_render_timer.value(), true));
+        }
+
+        return !m_stop;
+    }
+
+    std::string to_string() const override {
+        return tfm::format("ParticleTracerIntegrator[\n"
+            "  max_depth = %i,\n"
+            "  rr_depth = %i,\n"
+            "  granularity = %i\n"
+            "]", m_max_depth, m_rr_depth, m_granularity);
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    /**
+     * \brief Trace the light paths <tt>[offset, offset + count)</tt>
+     *
+     * Light path \c i plays the role of sample <tt>i % spp</tt> of the pixel
+     * <tt>i / spp</tt>, so that samplers based on low-discrepancy sequences
+     * stratify the light paths.
+     *
+     * \return The number of light paths that were traced before the
+     *    rendering was stopped
+     */
+    size_t render_work_unit(const Scene *scene, const Sensor *sensor, Sampler *sampler,
+                            ImageBlock *block, size_t offset, size_t count) const {
+        uint32_t spp   = (uint32_t) sampler->sample_count(),
+                 width = (uint32_t) sensor->film()->crop_size().x();
+
+        size_t traced = 0;
+        if constexpr (!is_array_v<Float>) {
+            for (size_t i = 0; i < count && !should_stop(); ++i) {
+                size_t index = offset + i;
+                uint32_t pixel_index = (uint32_t) (index / spp);
+                sampler->start_sample(Point2u(pixel_index % width, pixel_index / width),
+                                      (uint32_t) (index % spp));
+                trace_light_path(scene, sensor, sampler, block);
+                traced++;
+            }
+        } else {
+            for (auto [index, active] : range<UInt64>(count)) {
+                if (should_stop())
+                    break;
+                index += (uint64_t) offset;
+                UInt32 pixel_index = UInt32(index / (uint64_t) spp),
+                       sample_index = UInt32(index - UInt64(pixel_index) * (uint64_t) spp);
+                sampler->start_sample(Point2u(pixel_index % width, pixel_index / width),
+                                      sample_index, active);
+                trace_light_path(scene, sensor, sampler, block, active);
+                traced += enoki::count(active);
+            }
+        }
+        return traced;
+    }
+
+    void trace_light_path(const Scene *scene, const Sensor *sensor, Sampler *sampler,
+                          ImageBlock *block, Mask active = true) const {
+        Float time = sensor->shutter_open();
+        if (sensor->shutter_open_time() > 0.f)
+            time += sampler->next_1d(active) * sensor->shutter_open_time();
+
+        // Sample a ray leaving a randomly chosen emitter
+        auto [ray, throughput, emitter] = sample_emitter_ray(scene, sampler, time, active);
+        active &= any(neq(depolarize(throughput), 0.f));
+
+        // Russian roulette compares the throughput to the emitted power
+        Float flux = hmax(depolarize(throughput));
+
+        BSDFContext ctx(TransportMode::Importance);
+        SurfaceInteraction3f si = scene->ray_intersect(ray, active);
+
+        for (int depth = 1;; ++depth) {
+            active &= si.is_valid();
+            if ((uint32_t) depth >= (uint32_t) m_max_depth || none_or<false>(active))
+                break;
+
+            BSDFPtr bsdf = si.bsdf();
+
+            // ---------------------- Sensor connection ----------------------
+
+            // The connection adds one more segment to the path
+            Mask connect = active && has_flag(bsdf->flags(), BSDFFlags::Smooth);
+            if (likely(any_or<true>(connect)))
+                connect_sensor(scene, sensor, si, bsdf, throughput, sampler, block, connect);
+
+            if ((uint32_t) depth + 1 >= (uint32_t) m_max_depth)
+                break;
+
+            // ----------------------- BSDF sampling ----------------------
+
+            auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(active),
+                                               sampler->next_2d(active), active);
+            Vector3f wo = si.to_world(bs.wo);
+            throughput *= bsdf_val * shading_correction(si, wo, bs.wo);
+            active &= any(neq(depolarize(throughput), 0.f));
+
+            // Russian roulette: try to keep the path weights equal to the emitted power
+            if (depth >= m_rr_depth) {
+                Float q = min(hmax(depolarize(throughput)) / flux, .95f);
+                active &= sampler->next_1d(active) < q;
+                throughput *= rcp(q);
+            }
+
+            ray = si.spawn_ray(wo);
+            si = scene->ray_intersect(ray, active);
+        }
+    }
+
+    /// Connect the light path vertex \c si to the sensor, and splat the contribution
+    void connect_sensor(const Scene *scene, const Sensor *sensor,
+                        const SurfaceInteraction3f &si, const BSDFPtr &bsdf,
+                        const Spectrum &throughput, Sampler *sampler, ImageBlock *block,
+                        Mask active) const {
+        auto [ds, sensor_weight] = sensor->sample_direction(si, sampler->next_2d(active), active);
+        active &= neq(ds.pdf, 0.f);
+
+        // Evaluate the BSDF in importance transport mode towards the sensor
+        BSDFContext ctx(TransportMode::Importance);
+        Vector3f wo = si.to_local(ds.d);
+        Spectrum bsdf_val = bsdf->eval(ctx, si, wo, active);
+        Spectrum value = throughput * bsdf_val * sensor_weight *
+                         shading_correction(si, ds.d, wo);
+
+        active &= any(neq(depolarize(value), 0.f));
+        if (none_or<false>(active))
+            return;
+
+        active &= !scene->ray_test(si.spawn_ray_to(ds.p), active);
+
+        Color3f xyz = to_xyz(depolarize(value), si.wavelengths, active);
+
+        // The alpha and weight channels are set once all paths have been traced
+        Float values[5] = { xyz.x(), xyz.y(), xyz.z(), 0.f, 0.f };
+        block->put_atomic(ds.uv + ScalarVector2f(sensor->film()->crop_offset()), values, active);
+    }
+
+protected:
+    size_t m_granularity;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(ParticleTracerIntegrator, MonteCarloIntegrator)
+MTS_EXPORT_PLUGIN(ParticleTracerIntegrator, "Particle Tracer integrator");
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,666 @@
+#include <enoki/stl.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/progress.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/lightpath.h>
+#include <mitsuba/render/records.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/sensor.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-sppm:
+
+Stochastic progressive photon mapper (:monosp:`sppm`)
+-----------------------------------------------------
+
+.. pluginparameters::
+
+ * - max_depth
+   - |int|
+   - Specifies the longest path depth in the generated output image (where -1 corresponds to
+     :math:`\infty`). A value of 2 only renders direct illumination, like for the
+     :ref:`path <integrator-path>` plugin. (Default: -1)
+ * - rr_depth
+   - |int|
+   - Specifies the number of scattering events after which the implementation starts to use
+     Russian roulette to terminate light paths. (Default: 5)
+ * - photon_count
+   - |int|
+   - Number of light paths that are traced in every pass. (Default: 250000)
+ * - initial_radius
+   - |float|
+   - Initial radius of the photon lookups. A value of 0 uses five times the size of a
+     pixel when the whole scene fills the image. (Default: 0)
+ * - alpha
+   - |float|
+   - Fraction of the photons that are kept when the lookup radius of a pixel is
+     reduced, which must be in :math:`(0, 1)`. Lower values reduce the bias faster, at
+     the cost of more noise. (Default: 0.7)
+ * - max_pixels
+   - |int|
+   - Maximum number of pixels that are gathered and passed to the film at once. Larger
+     films are processed in horizontal bands. This only limits the size of the image
+     blocks, and not the per-pixel state of the integrator (see below).
+     (Default: 4194304)
+ * - hide_emitters
+   - |bool|
+   - Hide directly visible emitters. (Default: |false|)
+ * - timeout
+   - |float|
+   - Maximum rendering time in seconds (excluding scene parsing). A negative value
+     disables the timeout. (Default: -1)
+
+This plugin implements stochastic progressive photon mapping [HJ09]_, which
+renders the light transport that unbiased techniques can hardly sample, in
+particular caustics seen through specular surfaces (e.g. an emitter enclosed in
+a glass lamp housing that lights a diffuse wall, seen in a mirror).
+
+The integrator performs one pass per sample of the sensor's sampler. Every pass
+first traces ``photon_count`` light paths from randomly chosen emitters (using
+``Emitter::sample_ray()``), in parallel work units. The photons deposited on
+non-specular surfaces are stored in a kd-tree, which is also built in parallel.
+Every pixel then traces a camera path through the specular surfaces until it
+reaches a non-specular surface (the *visible point*), and estimates the
+reflected radiance using the photons within its lookup radius. The radius and
+the accumulated flux of each pixel are updated after every pass, such that the
+bias vanishes as the number of passes grows [KZ11]_. Emitters are only
+rendered when they are seen directly or through specular surfaces.
+
+Every pass traces its photons and builds the kd-tree once, and then gathers
+all pixels of the film against it, in horizontal bands of at most
+``max_pixels`` pixels. The visible points are not stored, since they are only
+used within a pass, and the photons of a pass are proportional to
+``photon_count``. The lookup radius, photon count and flux of every pixel are
+kept for the whole film during the entire render, which costs about 32 bytes
+per pixel (in RGB variants) in addition to the film. The memory usage of this
+integrator is therefore *not* bounded by ``max_pixels``: it grows linearly with
+the number of pixels (e.g. about 32 GiB of per-pixel state for a gigapixel
+film), and such films must fit into memory together with the film itself. The
+emission seen by the camera paths is directly added to the film in every pass.
+The resulting image doesn't depend on ``max_pixels``.
+
+The reconstruction filter of the film is ignored, i.e. each pixel only
+accounts for the camera paths starting within it. This integrator is only
+supported in scalar RGB and monochromatic variants, and ignores participating
+media.
+
+.. [HJ09] Toshiya Hachisuka and Henrik Wann Jensen. Stochastic Progressive
+   Photon Mapping. ACM Transactions on Graphics (Proceedings of SIGGRAPH
+   Asia), 28(5), 2009.
+.. [KZ11] Claude Knaus and Matthias Zwicker. Progressive Photon Mapping: A
+   Probabilistic Approach. ACM Transactions on Graphics, 30(3), 2011.
+
+ */
+
+template <typename Float, typename Spectrum>
+class SPPMIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_hide_emitters, m_stop,
+                    m_timeout, m_render_timer, should_stop)
+    MTS_IMPORT_TYPES(Scene, Sensor, Sampler, Film, ImageBlock, Emitter, EmitterPtr, BSDF, BSDFPtr)
+
+    SPPMIntegrator(const Properties &props) : Base(props) {
+        if constexpr (is_array_v<Float>)
+            Throw("The progressive photon mapper only supports scalar variants!");
+        if constexpr (is_spectral_v<Spectrum> || is_polarized_v<Spectrum>)
+            Throw("The progressive photon mapper only supports RGB and monochromatic variants!");
+
+        m_photon_count = props.size_("photon_count", 250000);
+        if (m_photon_count == 0)
+            Throw("\"photon_count\" must be set to a value greater than zero!");
+
+        m_initial_radius = props.float_("initial_radius", 0.f);
+        if (m_initial_radius < 0.f)
+            Throw("\"initial_radius\" must be positive (or zero to use the heuristic)!");
+
+        m_alpha = props.float_("alpha", .7f);
+        if (!(m_alpha > 0.f && m_alpha < 1.f))
+            Throw("\"alpha\" must be in the range (0, 1)!");
+
+        m_max_pixels = props.size_("max_pixels", 1 << 22);
+        if (m_max_pixels == 0)
+            Throw("\"max_pixels\" must be set to a value greater than zero!");
+
+        // The photons are generated independently of the sensor's sampler
+        m_photon_sampler =
+            PluginManager::instance()->create_object<Sampler>(Properties("independent"));
+    }
+
+    bool render(Scene *scene, Sensor *sensor) override {
+        ScopedPhase sp(ProfilerPhase::Render);
+        m_stop = false;
+
+        if constexpr (is_array_v<Float> || is_spectral_v<Spectrum> ||
+                      is_polarized_v<Spectrum>) {
+            ENOKI_MARK_USED(scene);
+            ENOKI_MARK_USED(sensor);
+            Throw("The progressive photon mapper only supports scalar RGB and monochromatic "
+                  "variants!");
+        } else {
+            ref<Film> film = sensor->film();
+            ScalarVector2i film_size = film->crop_size();
+            film->prepare({ "X", "Y", "Z", "A", "W" });
+
+            size_t pass_count  = sensor->sampler()->sample_count(),
+                   band_height = std::min((size_t) film_size.y(),
+                                          std::max(m_max_pixels / film_size.x(), (size_t) 1)),
+                   band_count  = (film_size.y() + band_height - 1) / band_height,
+                   n_threads   = __global_thread_count;
+
+            ScalarFloat radius = m_initial_radius;
+            if (radius == 0.f) {
+                // Five times the size of a pixel, if the scene exactly fills the image
+                radius = 5.f * scene->bbox().bounding_sphere().radius / hmax(film->size());
+            }
+
+            Log(Info, "Starting render job (%ix%i, %i pass%s, %i photons per pass, %i band%s, "
+                "%i thread%s)", film_size.x(), film_size.y(), pass_count,
+                pass_count == 1 ? "" : "es", m_photon_count, band_count,
+                band_count == 1 ? "" : "s", n_threads, n_threads == 1 ? "" : "s");
+
+            if (m_timeout > 0.f)
+                Log(Info, "Timeout specified: %.2f seconds.", m_timeout);
+
+            // The per-pixel state is kept for the whole film, regardless of "max_pixels"
+            Log(Info, "Allocating %s of per-pixel state.",
+                util::mem_string(hprod(film_size) * sizeof(PixelState)));
+
+            ThreadEnvironment env;
+            ref<ProgressReporter> progress =
+                new ProgressReporter("Rendering", nullptr, band_count * pass_count);
+            m_render_timer.reset();
+
+            PixelState initial_state;
+            initial_state.radius = radius;
+            initial_state.photons = 0.f;
+            initial_state.flux = 0.f;
+            std::vector<PixelState> pixels(hprod(film_size), initial_state);
+
+            // Emission seen by the camera paths of a band during the current pass
+            ref<ImageBlock> block =
+                new ImageBlock(ScalarVector2i(film_size.x(), (int) band_height), 5,
+                               nullptr, true, true, false, false);
+
+            for (size_t pass = 0; pass < pass_count && !should_stop(); ++pass) {
+                trace_photons(scene, sensor, env, pass);
+                build_photon_map();
+
+                for (size_t band = 0; band < band_count && !should_stop(); ++band) {
+                    ScalarPoint2i offset(0, (int) (band * band_height));
+                    ScalarVector2i size(film_size.x(),
+                                        std::min((int) band_height, film_size.y() - offset.y()));
+
+                    block->set_size(size);
+                    block->set_offset(film->crop_offset() + offset);
+                    block->clear();
+                    gather(scene, sensor, env, block, pass,
+                           pixels.data() + (size_t) offset.y() * film_size.x());
+                    film->put(block);
+                    progress->advance(1, (uint64_t) hprod(size));
+                }
+            }
+
+            put_flux(film, block, (int) band_height, pixels.data());
+
+            // Release the photons, which are no longer needed
+            m_photons = std::vector<Photon>();
+            m_unit_photons = std::vector<std::vector<Photon>>();
+
+            if (!m_stop)
+                Log(Info, "Rendering finished. (took %s)",
+                    util::time_string(m_render_timer.value(), true));
+        }
+
+        return !m_stop;
+    }
+
+    std::string to_string() const override {
+        return tfm::format("SPPMIntegrator[\n"
+            "  max_depth = %i,\n"
+            "  rr_depth = %i,\n"
+            "  photon_count = %i,\n"
+            "  initial_radius = %f,\n"
+            "  alpha = %f,\n"
+            "  max_pixels = %i\n"
+            "]", m_max_depth, m_rr_depth, m_photon_count, m_initial_radius, m_alpha,
+            m_max_pixels);
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    /// Photon deposited on a non-specular surface
+    struct Photon {
+        /// Position of the photon
+        ScalarPoint3f p;
+        /// Direction towards the previous vertex of the light path
+        ScalarVector3f wi;
+        /// Throughput of the light path (not yet divided by the number of light paths)
+        Spectrum power;
+        /// Number of segments of the light path
+        uint32_t depth : 30;
+        /// Split axis of the kd-tree node (see build_photon_map())
+        uint32_t axis : 2;
+    };
+
+    /**
+     * \brief Statistics of a pixel, which are accumulated over all passes
+     *
+     * The emission seen directly or through specular surfaces is directly
+     * added to the film, whose weight channel counts the passes of a pixel.
+     */
+    struct PixelState {
+        /// Current lookup radius
+        ScalarFloat radius;
+        /// Number of photons found so far, taking the radius reduction into account
+        ScalarFloat photons;
+        /// Flux of the photons found within the current radius (weighted by the camera paths)
+        Spectrum flux;
+    };
+
+    /// Number of light paths per work unit of the photon pass
+    static constexpr size_t PhotonWorkUnit = 4096;
+
+    /// Subtrees smaller than this are built by the thread that built their parent
+    static constexpr size_t ParallelBuildThreshold = 65536;
+
+    // =============================================================
+    //! @{ \name Photon pass
+    // =============================================================
+
+    /// Trace the light paths of the pass \c pass and collect their photons in \ref m_photons
+    void trace_photons(const Scene *scene, const Sensor *sensor, ThreadEnvironment &env,
+                       size_t pass) {
+        size_t unit_count = (m_photon_count + PhotonWorkUnit - 1) / PhotonWorkUnit;
+        m_unit_photons.resize(unit_count);
+
+        if (!scene->emitters().empty()) {
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(0, unit_count, 1),
+                [&](const tbb::blocked_range<size_t> &range) {
+                    ScopedSetThreadEnvironment set_env(env);
+                    ref<Sampler> sampler = m_photon_sampler->clone();
+                    scoped_flush_denormals flush_denormals(true);
+
+                    for (auto i = range.begin(); i != range.end(); ++i) {
+                        std::vector<Photon> &photons = m_unit_photons[i];
+                        photons.clear();
+                        if (should_stop())
+                            continue;
+
+                        /* The photons only depend on the pass and the work unit,
+                           and not on the scheduling of the work units */
+                        sampler->seed(sample_tea_64((uint32_t) pass, (uint32_t) i));
+
+                        size_t count = std::min(PhotonWorkUnit, m_photon_count - i * PhotonWorkUnit);
+                        for (size_t j = 0; j < count; ++j)
+                            trace_light_path(scene, sensor, sampler, photons);
+                    }
+                }
+            );
+        } else {
+            for (auto &photons : m_unit_photons)
+                photons.clear();
+        }
+
+        // Concatenate the photons of all work units (reusing the previous allocation)
+        std::vector<size_t> offsets(unit_count + 1, 0);
+        for (size_t i = 0; i < unit_count; ++i)
+            offsets[i + 1] = offsets[i] + m_unit_photons[i].size();
+        m_photons.resize(offsets[unit_count]);
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, unit_count, 1),
+            [&](const tbb::blocked_range<size_t> &range) {
+                for (auto i = range.begin(); i != range.end(); ++i)
+                    std::copy(m_unit_photons[i].begin(), m_unit_photons[i].end(),
+                              m_photons.begin() + offsets[i]);
+            }
+        );
+    }
+
+    /// Trace a light path, and deposit a photon at every non-specular surface it hits
+    void trace_light_path(const Scene *scene, const Sensor *sensor, Sampler *sampler,
+                          std::vector<Photon> &photons) const {
+        Float time = sensor->shutter_open();
+        if (sensor->shutter_open_time() > 0.f)
+            time += sampler->next_1d() * sensor->shutter_open_time();
+
+        // Sample a ray leaving a randomly chosen emitter
+        auto [ray, throughput, emitter] = sample_emitter_ray(scene, sampler, time);
+
+        // Russian roulette compares the throughput to the emitted power
+        Float flux = hmax(throughput);
+        if (!(flux > 0.f))
+            return;
+
+        BSDFContext ctx(TransportMode::Importance);
+
+        // The camera paths add at least one segment
+        for (int depth = 1; (uint32_t) depth < (uint32_t) m_max_depth; ++depth) {
+            SurfaceInteraction3f si = scene->ray_intersect(ray);
+            if (!si.is_valid())
+                break;
+
+            BSDFPtr bsdf = si.bsdf();
+            if (has_flag(bsdf->flags(), BSDFFlags::Smooth))
+                photons.push_back({ si.p, -ray.d, throughput, (uint32_t) depth, 0 });
+
+            if ((uint32_t) depth + 1 >= (uint32_t) m_max_depth)
+                break;
+
+            auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(), sampler->next_2d());
+            Vector3f wo = si.to_world(bs.wo);
+            throughput *= bsdf_val * shading_correction(si, wo, bs.wo);
+            if (all(eq(throughput, 0.f)))
+                break;
+
+            // Russian roulette: try to keep the path weights equal to the emitted power
+            if (depth >= m_rr_depth) {
+                Float q = min(hmax(throughput) / flux, .95f);
+                if (sampler->next_1d() >= q)
+                    break;
+                throughput *= rcp(q);
+            }
+
+            ray = si.spawn_ray(wo);
+        }
+    }
+
+    //! @}
+    // =============================================================
+
+    // =============================================================
+    //! @{ \name Photon kd-tree
+    // =============================================================
+
+    /**
+     * \brief Reorder \ref m_photons into a balanced kd-tree
+     *
+     * The tree is stored implicitly: the node of a range of photons is its
+     * median element, and the two halves of the range store the children.
+     * Every subtree thus occupies a contiguous range of memory, and no
+     * additional storage is needed except for the split axis.
+     */
+    void build_photon_map() {
+        if (m_photons.empty())
+            return;
+
+        ScalarBoundingBox3f bbox;
+        for (const Photon &photon : m_photons)
+            bbox.expand(photon.p);
+
+        build_node(m_photons.data(), m_photons.data() + m_photons.size(), bbox);
+    }
+
+    static void build_node(Photon *begin, Photon *end, const ScalarBoundingBox3f &bbox) {
+        size_t size = end - begin;
+        if (size <= 1)
+            return;
+
+        uint32_t axis = bbox.major_axis();
+        Photon *mid = begin + size / 2;
+        std::nth_element(begin, mid, end, [axis](const Photon &a, const Photon &b) {
+            return a.p[axis] < b.p[axis];
+        });
+        mid->axis = axis;
+
+        ScalarBoundingBox3f bbox_left(bbox), bbox_right(bbox);
+        bbox_left.max[axis] = bbox_right.min[axis] = mid->p[axis];
+
+        if (size > ParallelBuildThreshold) {
+            tbb::parallel_invoke(
+                [&] { build_node(begin, mid, bbox_left); },
+                [&] { build_node(mid + 1, end, bbox_right); }
+            );
+        } else {
+            build_node(begin, mid, bbox_left);
+            build_node(mid + 1, end, bbox_right);
+        }
+    }
+
+    /// Invoke \c func for all photons within distance \c radius of \c p
+    template <typename Func>
+    void lookup(const ScalarPoint3f &p, ScalarFloat radius, Func &&func) const {
+        if (m_photons.empty())
+            return;
+
+        ScalarFloat radius_sqr = sqr(radius);
+        std::pair<size_t, size_t> stack[64];
+        size_t stack_size = 0,
+               begin = 0,
+               end = m_photons.size();
+
+        while (true) {
+            size_t mid = begin + (end - begin) / 2;
+            const Photon &photon = m_photons[mid];
+
+            if (squared_norm(photon.p - p) <= radius_sqr)
+                func(photon);
+
+            if (end - begin > 1) {
+                ScalarFloat dist = p[photon.axis] - photon.p[photon.axis];
+                std::pair<size_t, size_t> left(begin, mid), right(mid + 1, end);
+                if (dist > 0.f)
+                    std::swap(left, right);
+
+                // Visit the child that contains the query point first
+                if (sqr(dist) <= radius_sqr && right.first < right.second)
+                    stack[stack_size++] = right;
+                if (left.first < left.second) {
+                    std::tie(begin, end) = left;
+                    continue;
+                }
+            }
+
+            if (stack_size == 0)
+                break;
+            std::tie(begin, end) = stack[--stack_size];
+        }
+    }
+
+    //! @}
+    // =============================================================
+
+    // =============================================================
+    //! @{ \name Camera pass
+    // =============================================================
+
+    /**
+     * \brief Trace a camera path through every pixel of the band covered by
+     * \c block, and update its statistics
+     *
+     * The emission seen by the camera paths is stored in \c block, with a
+     * unit weight for every pixel that was processed.
+     */
+    void gather(const Scene *scene, const Sensor *sensor, ThreadEnvironment &env,
+                ImageBlock *block, size_t pass, PixelState *pixels) const {
+        ScalarPoint2i crop_offset = sensor->film()->crop_offset(),
+                      offset = block->offset() - crop_offset;
+        ScalarVector2i size = block->size();
+        int film_height = sensor->film()->crop_size().y();
+        ScalarFloat *data = block->data().data();
+
+        tbb::parallel_for(
+            tbb::blocked_range<int>(0, size.y(), 1),
+            [&](const tbb::blocked_range<int> &range) {
+                ScopedSetThreadEnvironment set_env(env);
+                ref<Sampler> sampler = sensor->sampler()->clone();
+                scoped_flush_denormals flush_denormals(true);
+
+                for (int y = range.begin(); y != range.end() && !should_stop(); ++y) {
+                    // Ensure that the sample generation is fully deterministic
+                    sampler->seed((uint64_t) pass * film_height + offset.y() + y);
+
+                    for (int x = 0; x < size.x(); ++x) {
+                        ScalarPoint2i pixel = crop_offset + offset + ScalarVector2i(x, y);
+                        size_t index = (size_t) y * size.x() + x;
+                        sampler->start_sample(Point2u(pixel), (uint32_t) pass);
+                        Spectrum emitted =
+                            gather_pixel(scene, sensor, sampler, pixel, pixels[index]);
+
+                        Color3f xyz = to_xyz(emitted, Wavelength());
+                        ScalarFloat *values = data + index * 5;
+                        values[0] = xyz.x();
+                        values[1] = xyz.y();
+                        values[2] = xyz.z();
+                        values[3] = values[4] = 1.f;
+                    }
+                }
+            }
+        );
+    }
+
+    /// Update the statistics of a pixel, and return the emission seen by its camera path
+    Spectrum gather_pixel(const Scene *scene, const Sensor *sensor, Sampler *sampler,
+                          const ScalarPoint2i &pixel, PixelState &state) const {
+        const Film *film = sensor->film();
+        Vector2f position_sample = Vector2f(pixel) + sampler->next_2d();
+
+        Point2f aperture_sample(.5f);
+        if (sensor->needs_aperture_sample())
+            aperture_sample = sampler->next_2d();
+
+        Float time = sensor->shutter_open();
+        if (sensor->shutter_open_time() > 0.f)
+            time += sampler->next_1d() * sensor->shutter_open_time();
+
+        Float wavelength_sample = sampler->next_1d();
+
+        Vector2f adjusted_position =
+            (position_sample - film->crop_offset()) / film->crop_size();
+
+        auto [ray, throughput] = sensor->sample_ray_differential(
+            time, wavelength_sample, adjusted_position, aperture_sample);
+
+        Spectrum flux(0.f), emitted(0.f);
+        size_t found = 0;
+        BSDFContext ctx;
+
+        SurfaceInteraction3f si = scene->ray_intersect(ray);
+        for (int depth = 1;; ++depth) {
+            // -------------- Emitters seen through specular surfaces --------------
+
+            EmitterPtr emitter = si.emitter(scene);
+            if (emitter && !(depth == 1 && m_hide_emitters))
+                emitted += throughput * emitter->eval(si);
+
+            if (!si.is_valid() || (uint32_t) depth >= (uint32_t) m_max_depth)
+                break;
+
+            BSDFPtr bsdf = si.bsdf(ray);
+
+            // ------------------ Density estimation ------------------
+
+            if (has_flag(bsdf->flags(), BSDFFlags::Smooth)) {
+                lookup(si.p, state.radius, [&](const Photon &photon) {
+                    if ((uint32_t) (depth + photon.depth) > (uint32_t) m_max_depth)
+                        return;
+
+                    // The photon density already accounts for the foreshortening
+                    Vector3f wo = si.to_local(photon.wi);
+                    Float cos_theta = abs(Frame3f::cos_theta(wo));
+                    if (cos_theta > 0.f)
+                        flux += photon.power * bsdf->eval(ctx, si, wo) / cos_theta;
+                    found++;
+                });
+                break;
+            }
+
+            // ------------ Continue through specular surfaces ------------
+
+            auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(), sampler->next_2d());
+            throughput *= bsdf_val;
+            if (all(eq(throughput, 0.f)))
+                break;
+
+            if (depth >= m_rr_depth) {
+                Float q = min(hmax(throughput), .95f);
+                if (sampler->next_1d() >= q)
+                    break;
+                throughput *= rcp(q);
+            }
+
+            ray = si.spawn_ray(si.to_world(bs.wo));
+            si = scene->ray_intersect(ray);
+        }
+
+        // ---------------- Progressive radius reduction ----------------
+
+        if (found > 0) {
+            ScalarFloat photons = state.photons + m_alpha * found,
+                        ratio   = photons / (state.photons + found);
+            state.flux = (state.flux + throughput * flux) * ratio;
+            state.radius *= std::sqrt(ratio);
+            state.photons = photons;
+        }
+
+        return emitted;
+    }
+
+    /**
+     * \brief Add the density estimates of all pixels to the film
+     *
+     * The estimates are added with a zero weight, so that the film divides
+     * them by the number of passes of every pixel along with the emission
+     * (see \ref gather()). \c block is reused for every band.
+     */
+    void put_flux(Film *film, ImageBlock *block, int band_height,
+                  const PixelState *pixels) const {
+        ScalarVector2i film_size = film->crop_size();
+        for (int y = 0; y < film_size.y(); y += band_height) {
+            ScalarVector2i size(film_size.x(), std::min(band_height, film_size.y() - y));
+            block->set_size(size);
+            block->set_offset(film->crop_offset() + ScalarVector2i(0, y));
+            block->clear();
+
+            ScalarFloat *data = block->data().data();
+            const PixelState *state = pixels + (size_t) y * film_size.x();
+            for (size_t i = 0, n = hprod(size); i < n; ++i, ++state, data += 5) {
+                Spectrum value = state->flux * math::InvPi<ScalarFloat> /
+                                 (sqr(state->radius) * (ScalarFloat) m_photon_count);
+
+                Color3f xyz = to_xyz(value, Wavelength());
+                data[0] = xyz.x();
+                data[1] = xyz.y();
+                data[2] = xyz.z();
+            }
+
+            film->put(block);
+        }
+    }
+
+    //! @}
+    // =============================================================
+
+protected:
+    size_t m_photon_count;
+    ScalarFloat m_initial_radius;
+    ScalarFloat m_alpha;
+    size_t m_max_pixels;
+    ref<Sampler> m_photon_sampler;
+
+    /// Photons of the current pass, ordered as a kd-tree (see build_photon_map())
+    std::vector<Photon> m_photons;
+    /// Photons of each work unit of the current pass
+    std::vector<std::vector<Photon>> m_unit_photons;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(SPPMIntegrator, MonteCarloIntegrator)
+MTS_EXPORT_PLUGIN(SPPMIntegrator, "Stochastic Progressive Photon Mapping integrator");
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,71 @@
+import mitsuba
+import pytest
+import enoki as ek
+import numpy as np
+
+from mitsuba.python.test.scenes import make_corner_scene, render_scene, check_corner_scene
+
+
+def test01_create(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+
+    integrator = load_string("""<integrator version="2.0.0" type="bdpt">
+            <integer name="max_depth" value="4"/>
+            <boolean name="light_image" value="false"/>
+        </integrator>""")
+    assert integrator is not None
+
+
+@pytest.mark.parametrize('emitter', ['point', 'area'])
+@pytest.mark.parametrize('max_depth', [2, -1])
+@pytest.mark.parametrize('light_image', [True, False])
+def test02_compare_path(variants_cpu_rgb, emitter, max_depth, light_image):
+    """Bidirectional and unidirectional path tracing converge to the same image"""
+
+    xml = """<integrator type="{}">
+            <integer name="max_depth" value="{}"/>
+            {}
+        </integrator>"""
+
+    image = render_scene(make_corner_scene(xml.format('bdpt', max_depth,
+        '<boolean name="light_image" value="{}"/>'.format(
+            'true' if light_image else 'false')), emitter))
+    ref = render_scene(make_corner_scene(xml.format('path', max_depth, ''), emitter))
+    check_corner_scene(image, ref)
+
+
+def test03_caustic(variants_cpu_rgb):
+    """The caustic of a glass sphere matches the path tracer"""
+
+    image = render_scene(make_corner_scene('<integrator type="bdpt"/>', glass=True))
+    ref = render_scene(make_corner_scene('<integrator type="path"/>', spp=1024, glass=True))
+
+    assert ek.allclose(np.mean(image), np.mean(ref), rtol=5e-2)
+
+
+@pytest.mark.slow
+def test04_equal_time(variant_scalar_rgb):
+    """At equal render time, the bidirectional path tracer has a lower error
+    than the path tracer on a caustic lit by a small emitter"""
+
+    import time
+
+    def timed_render(integrator, spp):
+        scene = make_corner_scene('<integrator type="%s"/>' % integrator, 'small_area',
+                                  spp=spp, glass=True)
+        start = time.time()
+        image = render_scene(scene)
+        return image, time.time() - start
+
+    ref, _ = timed_render('bdpt', 8192)
+    image_bdpt, time_bdpt = timed_render('bdpt', 64)
+
+    # Calibrate the sample count of the path tracer to the same render time
+    _, time_path = timed_render('path', 256)
+    spp_path = max(int(256 * time_bdpt / time_path), 1)
+    image_path, _ = timed_render('path', spp_path)
+
+    def rmse(image):
+        return np.sqrt(np.mean((image - ref) ** 2))
+
+    assert rmse(image_bdpt) < rmse(image_path)
@@ -0,0 +1,50 @@
+import mitsuba
+import pytest
+import enoki as ek
+
+from mitsuba.python.test.scenes import make_corner_scene, render_scene, check_corner_scene
+
+
+def test01_create(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+
+    integrator = load_string("""<integrator version="2.0.0" type="ptracer">
+            <integer name="max_depth" value="4"/>
+            <integer name="granularity" value="1000"/>
+        </integrator>""")
+    assert integrator is not None
+
+    with pytest.raises(RuntimeError):
+        load_string("""<integrator version="2.0.0" type="ptracer">
+                <integer name="granularity" value="0"/>
+            </integrator>""")
+
+
+@pytest.mark.parametrize('emitter', ['point', 'area'])
+@pytest.mark.parametrize('max_depth', [2, -1])
+def test02_compare_path(variants_cpu_rgb, emitter, max_depth):
+    """Light tracing and path tracing converge to the same image (except for
+    directly visible emitters)"""
+
+    xml = """<integrator type="{}">
+            <integer name="max_depth" value="{}"/>
+            {}
+        </integrator>"""
+
+    image = render_scene(make_corner_scene(xml.format('ptracer', max_depth,
+        '<integer name="granularity" value="5000"/>'), emitter))
+    ref = render_scene(make_corner_scene(xml.format('path', max_depth,
+        '<boolean name="hide_emitters" value="true"/>'), emitter))
+    check_corner_scene(image, ref)
+
+
+def test03_deterministic(variant_scalar_rgb):
+    """The image doesn't depend on the scheduling of the work units"""
+
+    xml = """<integrator type="ptracer">
+            <integer name="granularity" value="777"/>
+        </integrator>"""
+
+    image1 = render_scene(make_corner_scene(xml))
+    image2 = render_scene(make_corner_scene(xml))
+    assert ek.allclose(image1, image2, rtol=1e-5, atol=1e-6)
@@ -0,0 +1,53 @@
+import mitsuba
+import pytest
+import enoki as ek
+
+from mitsuba.python.test.scenes import make_corner_scene, render_scene, check_corner_scene
+
+
+def test01_create(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+
+    integrator = load_string("""<integrator version="2.0.0" type="sppm">
+            <integer name="photon_count" value="1000"/>
+            <float name="initial_radius" value="0.1"/>
+            <float name="alpha" value="0.5"/>
+        </integrator>""")
+    assert integrator is not None
+
+    for value in ['<integer name="photon_count" value="0"/>',
+                  '<float name="alpha" value="1"/>',
+                  '<float name="initial_radius" value="-1"/>']:
+        with pytest.raises(RuntimeError):
+            load_string("""<integrator version="2.0.0" type="sppm">
+                    {}
+                </integrator>""".format(value))
+
+
+@pytest.mark.parametrize('emitter', ['point', 'area'])
+@pytest.mark.parametrize('max_depth', [2, -1])
+def test02_compare_path(variant_scalar_rgb, emitter, max_depth):
+    """Progressive photon mapping converges to the same image as path tracing"""
+
+    xml = """<integrator type="{}">
+            <integer name="max_depth" value="{}"/>
+            {}
+        </integrator>"""
+
+    image = render_scene(make_corner_scene(xml.format('sppm', max_depth,
+        '<integer name="photon_count" value="20000"/>'), emitter))
+    ref = render_scene(make_corner_scene(xml.format('path', max_depth, ''), emitter))
+    check_corner_scene(image, ref)
+
+
+def test03_bands(variant_scalar_rgb):
+    """The image doesn't depend on the number of bands"""
+
+    xml = """<integrator type="sppm">
+            <integer name="photon_count" value="5000"/>
+            <integer name="max_pixels" value="{}"/>
+        </integrator>"""
+
+    image1 = render_scene(make_corner_scene(xml.format(1 << 20), spp=8))
+    image2 = render_scene(make_corner_scene(xml.format(100), spp=8))
+    assert ek.allclose(image1, image2, rtol=1e-5, atol=1e-6)
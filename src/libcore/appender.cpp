@@ -1,6 +1,9 @@
 #include <mitsuba/core/appender.h>
+#include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/logger.h>
+#include <mitsuba/core/progress.h>
 #include <fstream>
+#include <iostream>
 #include <sstream>
 
 #if defined(__WINDOWS__)
@@ -9,6 +12,12 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+void Appender::log_progress_info(float progress, const std::string &name,
+    const std::string &formatted, const std::string &eta, const ProgressInfo &,
+    const void *ptr) {
+    log_progress(progress, name, formatted, eta, ptr);
+}
+
 StreamAppender::StreamAppender(std::ostream *stream)
  : m_stream(stream), m_is_file(false) {
     m_last_message_was_progress = false;
@@ -114,7 +123,66 @@ StreamAppender::~StreamAppender() {
     }
 }
 
+ProgressFileAppender::ProgressFileAppender(const std::string &filename)
+    : m_filename(filename) { }
+
+void ProgressFileAppender::append(LogLevel, const std::string &) { }
+
+void ProgressFileAppender::log_progress(float, const std::string &,
+    const std::string &, const std::string &, const void *) { }
+
+void ProgressFileAppender::log_progress_info(float, const std::string &name,
+    const std::string &, const std::string &, const ProgressInfo &info,
+    const void *) {
+    std::string escaped;
+    for (char c : name) {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+
+    fs::path filename(m_filename), temp(m_filename + ".tmp");
+    /* write */ {
+        std::ofstream os(temp.native());
+        if (!os.good()) {
+            warn("could not open \"" + temp.string() + "\"");
+            return;
+        }
+        os << "{\n"
+           << "  \"name\": \"" << escaped << "\",\n"
+           << "  \"progress\": " << info.progress << ",\n"
+           << "  \"elapsed\": " << info.elapsed << ",\n"
+           << "  \"eta\": " << info.eta << ",\n"
+           << "  \"samples\": " << info.samples << ",\n"
+           << "  \"samples_per_second\": " << info.samples_per_second << ",\n"
+           << "  \"rays_per_second\": " << info.rays_per_second << ",\n"
+           << "  \"done\": " << (info.progress >= 1.f ? "true" : "false") << "\n"
+           << "}\n";
+    }
+    if (!fs::rename(temp, filename)) {
+        warn("could not rename \"" + temp.string() + "\" to \"" +
+             filename.string() + "\"");
+        fs::remove(temp);
+    }
+}
+
+void ProgressFileAppender::warn(const std::string &message) {
+    /* Failing to report progress is not critical, hence the rendering
+       continues. This is called while the logger is locked, so the
+       warning can't be logged. */
+    if (m_warned)
+        return;
+    std::cerr << "ProgressFileAppender: " << message
+              << " (further failures are not reported)." << std::endl;
+    m_warned = true;
+}
+
+std::string ProgressFileAppender::to_string() const {
+    return "ProgressFileAppender[filename=\"" + m_filename + "\"]";
+}
+
 MTS_IMPLEMENT_CLASS(Appender, Object)
 MTS_IMPLEMENT_CLASS(StreamAppender, Appender)
+MTS_IMPLEMENT_CLASS(ProgressFileAppender, Appender)
 
 NAMESPACE_END(mitsuba)
@@ -0,0 +1,266 @@
+#include <mitsuba/core/denoiser.h>
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+#include <tbb/tbb.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Color (in the first three lanes) and variance of a pixel
+using Value4 = Array<float, 4>;
+using Vector3f = Vector<float, 3>;
+
+/// Weights of the luminance of linear sRGB colors (the variance lane is ignored)
+static const Value4 LuminanceWeights(0.212671f, 0.715160f, 0.072169f, 0.f);
+
+/// Coefficients of the 5x5 B3-spline kernel, indexed by the distance to the center
+static const float KernelWeights[3] = { 3.f / 8.f, 1.f / 4.f, 1.f / 16.f };
+
+/// Coefficients of the 3x3 Gaussian kernel that prefilters the variance
+static const float GaussianWeights[2] = { 1.f / 2.f, 1.f / 4.f };
+
+/// Albedo values below this threshold are not divided out
+static const float AlbedoEpsilon = 1e-3f;
+
+/// Check that a guide image is compatible with the image being denoised
+static void check_guide(const Bitmap *image, const Bitmap *guide, size_t channel_count,
+                        const char *name) {
+    if (!guide)
+        return;
+    if (guide->width() != image->width() || guide->height() != image->height())
+        Throw("Denoiser::denoise(): the %s image must have the same size as the image!", name);
+    if (guide->component_format() != Struct::Type::Float32 ||
+        guide->channel_count() != channel_count)
+        Throw("Denoiser::denoise(): the %s image must have %i float32 channel%s!", name,
+              channel_count, channel_count == 1 ? "" : "s");
+}
+
+/// Process the rows of an image in parallel
+template <typename Func> static void parallel_rows(int height, Func func) {
+    tbb::parallel_for(
+        tbb::blocked_range<int>(0, height, 8),
+        [&](const tbb::blocked_range<int> &range) {
+            for (int y = range.begin(); y != range.end(); ++y)
+                func(y);
+        }
+    );
+}
+
+Denoiser::Denoiser(uint32_t iterations, float sigma_color, float sigma_normal,
+                   float sigma_depth)
+    : m_iterations(iterations), m_sigma_color(sigma_color), m_sigma_normal(sigma_normal),
+      m_sigma_depth(sigma_depth) {
+    if (!(sigma_color > 0.f) || !(sigma_normal >= 0.f) || !(sigma_depth > 0.f))
+        Throw("Denoiser: the sigma parameters must be positive!");
+}
+
+Denoiser::~Denoiser() { }
+
+ref<Bitmap> Denoiser::denoise(const Bitmap *image, const Bitmap *albedo, const Bitmap *normal,
+                              const Bitmap *depth, const Bitmap *variance) const {
+    size_t channel_count = image->channel_count();
+    if (image->component_format() != Struct::Type::Float32 ||
+        (channel_count != 3 && channel_count != 4))
+        Throw("Denoiser::denoise(): the image must have 3 or 4 float32 channels (RGB(A))!");
+
+    check_guide(image, albedo, 3, "albedo");
+    check_guide(image, normal, 3, "normal");
+    check_guide(image, depth, 1, "depth");
+    check_guide(image, variance, 1, "variance");
+
+    Timer timer;
+    int width = (int) image->width(), height = (int) image->height();
+    size_t pixel_count = image->pixel_count();
+
+    auto index = [width](int x, int y) { return (size_t) y * width + x; };
+    auto clamp_x = [width](int x) { return std::min(std::max(x, 0), width - 1); };
+    auto clamp_y = [height](int y) { return std::min(std::max(y, 0), height - 1); };
+
+    const float *image_data    = (const float *) image->data(),
+                *albedo_data   = albedo   ? (const float *) albedo->data()   : nullptr,
+                *normal_data   = normal   ? (const float *) normal->data()   : nullptr,
+                *depth_data    = depth    ? (const float *) depth->data()    : nullptr,
+                *variance_data = variance ? (const float *) variance->data() : nullptr;
+
+    std::vector<Value4> current(pixel_count), next(pixel_count);
+    std::vector<Vector3f> normals(normal ? pixel_count : 0);
+    std::vector<float> depth_gradients(depth ? pixel_count : 0);
+
+    auto demodulate = [&](size_t i, const Value4 &value) {
+        if (!albedo_data)
+            return value;
+        Value4 a(albedo_data[3 * i], albedo_data[3 * i + 1], albedo_data[3 * i + 2], 1.f);
+        return select(a > AlbedoEpsilon, value / a, value);
+    };
+
+    // ------------------- Initialize the color and guides -------------------
+
+    parallel_rows(height, [&](int y) {
+        for (int x = 0; x < width; ++x) {
+            size_t i = index(x, y);
+            const float *c = image_data + i * channel_count;
+            current[i] = demodulate(i, Value4(c[0], c[1], c[2], 0.f));
+
+            if (variance_data) {
+                float v = variance_data[i];
+                if (albedo_data) {
+                    // Account for the division by the albedo (to first order)
+                    float a = dot(demodulate(i, Value4(1.f, 1.f, 1.f, 0.f)), LuminanceWeights);
+                    v *= sqr(a);
+                }
+                current[i].w() = v;
+            }
+
+            if (normal_data) {
+                Vector3f n = load_unaligned<Vector3f>(normal_data + 3 * i);
+                float length = norm(n);
+                normals[i] = length > 0.f ? n / length : Vector3f(0.f);
+            }
+
+            if (depth_data) {
+                float dx = depth_data[index(clamp_x(x + 1), y)] - depth_data[index(clamp_x(x - 1), y)],
+                      dy = depth_data[index(x, clamp_y(y + 1))] - depth_data[index(x, clamp_y(y - 1))];
+                depth_gradients[i] = .5f * std::max(std::abs(dx), std::abs(dy));
+            }
+        }
+    });
+
+    // Estimate the variance from the 5x5 neighborhood of every pixel
+    if (!variance_data) {
+        parallel_rows(height, [&](int y) {
+            for (int x = 0; x < width; ++x) {
+                float mean = 0.f, mean_sqr = 0.f;
+                int count = 0;
+                for (int yy = std::max(y - 2, 0); yy <= std::min(y + 2, height - 1); ++yy) {
+                    for (int xx = std::max(x - 2, 0); xx <= std::min(x + 2, width - 1); ++xx) {
+                        float lum = dot(current[index(xx, yy)], LuminanceWeights);
+                        mean += lum;
+                        mean_sqr += sqr(lum);
+                        count++;
+                    }
+                }
+                mean /= count;
+                mean_sqr /= count;
+
+                size_t i = index(x, y);
+                next[i] = current[i];
+                next[i].w() = std::max(mean_sqr - sqr(mean), 0.f);
+            }
+        });
+        std::swap(current, next);
+    }
+
+    // ------------------------- Filter iterations -------------------------
+
+    for (uint32_t it = 0; it < m_iterations; ++it) {
+        int step = 1 << it;
+
+        parallel_rows(height, [&](int y) {
+            for (int x = 0; x < width; ++x) {
+                size_t i = index(x, y);
+                const Value4 &center = current[i];
+
+                // Prefilter the variance, which is itself noisy
+                float var = 0.f;
+                for (int dy = -1; dy <= 1; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx)
+                        var += GaussianWeights[std::abs(dx)] * GaussianWeights[std::abs(dy)] *
+                               current[index(clamp_x(x + dx), clamp_y(y + dy))].w();
+
+                float lum = dot(center, LuminanceWeights),
+                      inv_lum_scale = 1.f / (m_sigma_color * std::sqrt(std::max(var, 0.f)) + 1e-10f);
+
+                Value4 sum(0.f);
+                float weight_sum = 0.f;
+
+                for (int dy = -2; dy <= 2; ++dy) {
+                    int yy = y + dy * step;
+                    if (yy < 0 || yy >= height)
+                        continue;
+
+                    for (int dx = -2; dx <= 2; ++dx) {
+                        int xx = x + dx * step;
+                        if (xx < 0 || xx >= width)
+                            continue;
+
+                        size_t j = index(xx, yy);
+                        const Value4 &value = current[j];
+                        float weight = KernelWeights[std::abs(dx)] * KernelWeights[std::abs(dy)];
+
+                        if (j != i) {
+                            weight *= std::exp(-std::abs(lum - dot(value, LuminanceWeights)) *
+                                               inv_lum_scale);
+
+                            if (normal_data) {
+                                const Vector3f &n1 = normals[i], &n2 = normals[j];
+                                // Pixels that don't see any surface are only combined with each other
+                                bool empty1 = squared_norm(n1) == 0.f,
+                                     empty2 = squared_norm(n2) == 0.f;
+                                if (empty1 || empty2)
+                                    weight *= empty1 == empty2 ? 1.f : 0.f;
+                                else
+                                    weight *= std::pow(std::max(dot(n1, n2), 0.f), m_sigma_normal);
+                            }
+
+                            if (depth_data) {
+                                float dist = step * std::sqrt((float) (dx * dx + dy * dy));
+                                weight *= std::exp(-std::abs(depth_data[i] - depth_data[j]) /
+                                                   (m_sigma_depth * depth_gradients[i] * dist + 1e-10f));
+                            }
+                        }
+
+                        // The variance is filtered with the squared weights
+                        sum = fmadd(value, Value4(weight, weight, weight, sqr(weight)), sum);
+                        weight_sum += weight;
+                    }
+                }
+
+                next[i] = sum / Value4(weight_sum, weight_sum, weight_sum, sqr(weight_sum));
+            }
+        });
+
+        std::swap(current, next);
+    }
+
+    // ------------------ Multiply by the albedo again ------------------
+
+    ref<Bitmap> result = new Bitmap(*image);
+    float *result_data = (float *) result->data();
+
+    parallel_rows(height, [&](int y) {
+        for (int x = 0; x < width; ++x) {
+            size_t i = index(x, y);
+            Value4 value = current[i];
+            if (albedo_data) {
+                Value4 a(albedo_data[3 * i], albedo_data[3 * i + 1], albedo_data[3 * i + 2], 1.f);
+                value = select(a > AlbedoEpsilon, value * a, value);
+            }
+
+            // The alpha channel (if any) was copied along with the image
+            float *c = result_data + i * channel_count;
+            c[0] = value.x();
+            c[1] = value.y();
+            c[2] = value.z();
+        }
+    });
+
+    Log(Debug, "Denoised a %ix%i image in %s", width, height,
+        util::time_string(timer.value(), true));
+
+    return result;
+}
+
+std::string Denoiser::to_string() const {
+    std::ostringstream oss;
+    oss << "Denoiser[" << std::endl
+        << "  iterations = " << m_iterations << "," << std::endl
+        << "  sigma_color = " << m_sigma_color << "," << std::endl
+        << "  sigma_normal = " << m_sigma_normal << "," << std::endl
+        << "  sigma_depth = " << m_sigma_depth << std::endl
+        << "]";
+    return oss.str();
+}
+
+MTS_IMPLEMENT_CLASS(Denoiser, Object)
+NAMESPACE_END(mitsuba)
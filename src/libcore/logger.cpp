@@ -8,21 +8,235 @@
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
 #include <mutex>
 
+/// Capacity of the ring buffer used in asynchronous mode (power of two)
+#define MTS_LOG_QUEUE_SIZE 4096
+
 NAMESPACE_BEGIN(mitsuba)
 
+using LogClock = std::chrono::steady_clock;
+
+/// Is the calling thread the background thread of an asynchronous logger?
+static thread_local bool log_worker_thread = false;
+
+/// A log message, as queued in asynchronous mode
+struct LogEntry {
+    LogLevel level;
+    const Class *class_;
+    ref<Thread> thread;
+    std::string file;
+    int line;
+    std::string message;
+};
+
+/// Slot of the ring buffer, see D. Vyukov's bounded MPMC queue
+struct LogCell {
+    std::atomic<size_t> sequence;
+    LogEntry entry;
+};
+
+/// Rate limiting state of a call site
+struct LogCallSite {
+    LogClock::time_point window_start;
+    uint32_t count = 0;
+    size_t suppressed = 0;
+    LogLevel level = Info;
+};
+
 struct Logger::LoggerPrivate {
     std::mutex mutex;
     LogLevel error_level = Error;
     std::vector<ref<Appender>> appenders;
     ref<Formatter> formatter;
+
+    // Rate limiting and deduplication (protected by 'mutex')
+    std::atomic<uint32_t> rate_limit { 0 };
+    std::map<std::pair<std::string, int>, LogCallSite> sites;
+    size_t sites_suppressed = 0;
+    LogEntry last { Info, nullptr, nullptr, std::string(), 0, std::string() };
+    bool has_last = false;
+    size_t repeated = 0;
+    LogClock::time_point repeat_start;
+
+    // Asynchronous mode
+    std::unique_ptr<LogCell[]> queue;
+    alignas(64) std::atomic<size_t> head { 0 };
+    alignas(64) size_t tail = 0;
+    std::atomic<size_t> processed { 0 }, dropped { 0 };
+    /// Number of threads that are currently enqueuing a message
+    std::atomic<size_t> producers { 0 };
+    std::atomic<bool> running { false }, sleeping { false };
+    std::thread worker;
+    std::mutex async_mutex, wait_mutex;
+    std::condition_variable wait_cv, flush_cv;
+
+    /// Format a message and send it to all appenders ('mutex' must be held)
+    void append(LogLevel level, const Class *class_, const Thread *thread,
+                const char *file, int line, const std::string &message) {
+        std::string text = formatter->format(level, class_, thread, file, line, message);
+        for (auto entry : appenders)
+            entry->append(level, text);
+    }
+
+    /// Process a message subject to rate limiting ('mutex' must be held)
+    void process(LogEntry &entry, LogClock::time_point now) {
+        if (rate_limit > 0) {
+            if (has_last && entry.line == last.line && entry.level == last.level &&
+                entry.message == last.message && entry.file == last.file) {
+                if (repeated++ == 0)
+                    repeat_start = now;
+                return;
+            }
+            emit_repeated();
+
+            auto key = std::make_pair(entry.file, entry.line);
+            LogCallSite &site = sites[key];
+            if (now - site.window_start >= std::chrono::seconds(1)) {
+                emit_suppressed(key, site);
+                site.window_start = now;
+                site.count = 0;
+            }
+            site.level = entry.level;
+            if (site.count >= rate_limit) {
+                site.suppressed++;
+                sites_suppressed++;
+                return;
+            }
+            site.count++;
+            last = entry;
+            has_last = true;
+        }
+
+        append(entry.level, entry.class_, entry.thread, entry.file.c_str(),
+               entry.line, entry.message);
+    }
+
+    void emit_repeated() {
+        if (repeated > 0)
+            append(last.level, last.class_, last.thread, last.file.c_str(), last.line,
+                   tfm::format("Last message repeated %zu times.", repeated));
+        repeated = 0;
+    }
+
+    void emit_suppressed(const std::pair<std::string, int> &key, LogCallSite &site) {
+        if (site.suppressed > 0)
+            append(site.level, nullptr, nullptr, key.first.c_str(), key.second,
+                   tfm::format("Suppressed %zu further messages from this location.",
+                               site.suppressed));
+        sites_suppressed -= site.suppressed;
+        site.suppressed = 0;
+    }
+
+    /// Emit pending summaries that are older than a second, or all of them if \c force is set
+    void emit_summaries(LogClock::time_point now, bool force) {
+        if (repeated > 0 && (force || now - repeat_start >= std::chrono::seconds(1))) {
+            emit_repeated();
+            has_last = false;
+        }
+        if (sites_suppressed > 0) {
+            for (auto &kv : sites) {
+                if (kv.second.suppressed > 0 &&
+                    (force || now - kv.second.window_start >= std::chrono::seconds(1)))
+                    emit_suppressed(kv.first, kv.second);
+            }
+        }
+        size_t count = dropped.exchange(0);
+        if (count > 0)
+            append(Warn, nullptr, nullptr, __FILE__, __LINE__,
+                   tfm::format("Log queue overflow: %zu messages were dropped.", count));
+    }
+
+    /// Try to append a message to the ring buffer (any thread)
+    bool enqueue(LogEntry &&entry) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        LogCell *cell;
+        while (true) {
+            cell = &queue[pos & (MTS_LOG_QUEUE_SIZE - 1)];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false; // Full
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+        cell->entry = std::move(entry);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        if (sleeping.load(std::memory_order_relaxed))
+            wait_cv.notify_one();
+        return true;
+    }
+
+    /// Is a message available for consumption? (worker thread only)
+    bool available() const {
+        const LogCell &cell = queue[tail & (MTS_LOG_QUEUE_SIZE - 1)];
+        return cell.sequence.load(std::memory_order_acquire) == tail + 1;
+    }
+
+    /// Process all available messages ('mutex' must be held, worker thread only)
+    size_t drain(LogClock::time_point now) {
+        size_t count = 0;
+        while (available()) {
+            LogCell &cell = queue[tail & (MTS_LOG_QUEUE_SIZE - 1)];
+            LogEntry entry = std::move(cell.entry);
+            cell.entry.thread = nullptr;
+            cell.sequence.store(tail + MTS_LOG_QUEUE_SIZE, std::memory_order_release);
+            tail++;
+            try {
+                process(entry, now);
+            } catch (const std::exception &e) {
+                // Appenders run on the worker thread, which can't propagate exceptions
+                std::cerr << "Exception while processing a log message: " << e.what()
+                          << std::endl;
+            }
+            count++;
+        }
+        return count;
+    }
+
+    void run() {
+        log_worker_thread = true;
+        while (true) {
+            size_t count;
+            bool stop = !running.load();
+            /* critical section */ {
+                std::lock_guard<std::mutex> guard(mutex);
+                auto now = LogClock::now();
+                count = drain(now);
+                emit_summaries(now, false);
+            }
+            if (count > 0) {
+                std::lock_guard<std::mutex> guard(wait_mutex);
+                processed += count;
+                flush_cv.notify_all();
+            }
+            if (stop)
+                break;
+            if (count == 0) {
+                std::unique_lock<std::mutex> guard(wait_mutex);
+                sleeping = true;
+                wait_cv.wait_for(guard, std::chrono::milliseconds(50),
+                                 [&] { return !running.load() || available(); });
+                sleeping = false;
+            }
+        }
+    }
 };
 
 Logger::Logger(LogLevel log_level)
     : m_log_level(log_level), d(new LoggerPrivate()) { }
 
-Logger::~Logger() { }
+Logger::~Logger() {
+    set_async(false);
+}
 
 void Logger::set_formatter(Formatter *formatter) {
     std::lock_guard<std::mutex> guard(d->mutex);
@@ -58,27 +272,117 @@ void Logger::log(LogLevel level, const Class *class_, const char *file,
 
     if (level < m_log_level)
         return;
-    else if (level >= d->error_level)
+    else if (level >= d->error_level) {
+        flush();
         detail::Throw(level, class_, file, line, msg);
+    }
 
     if (!d->formatter) {
         std::cerr << "PANIC: Logging has not been properly initialized!" << std::endl;
         abort();
     }
 
-    std::string text = d->formatter->format(level, class_,
-        Thread::thread(), file, line, msg);
+    /* Announce the producer before checking 'running', so that set_async(false)
+       can wait for messages that are still being enqueued */
+    d->producers++;
+    if (d->running) {
+        if (!d->enqueue(LogEntry{ level, class_, Thread::thread(), file, line, msg }))
+            d->dropped++;
+        d->producers--;
+        return;
+    }
+    d->producers--;
 
     std::lock_guard<std::mutex> guard(d->mutex);
-    for (auto entry : d->appenders)
-        entry->append(level, text);
+    if (d->rate_limit == 0) {
+        d->append(level, class_, Thread::thread(), file, line, msg);
+    } else {
+        LogEntry entry{ level, class_, Thread::thread(), file, line, msg };
+        auto now = LogClock::now();
+        d->process(entry, now);
+        d->emit_summaries(now, false);
+    }
+}
+
+void Logger::set_async(bool value) {
+    std::lock_guard<std::mutex> guard(d->async_mutex);
+    if (value == d->running)
+        return;
+
+    if (value) {
+        if (!d->queue) {
+            d->queue.reset(new LogCell[MTS_LOG_QUEUE_SIZE]);
+            for (size_t i = 0; i < MTS_LOG_QUEUE_SIZE; ++i)
+                d->queue[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        d->running = true;
+        d->worker = std::thread([this]() { d->run(); });
+    } else {
+        d->running = false;
+
+        // Wait for producers that saw the logger in asynchronous mode
+        while (d->producers > 0)
+            std::this_thread::yield();
+
+        /* critical section */ {
+            std::lock_guard<std::mutex> guard2(d->mutex);
+            auto now = LogClock::now();
+            d->processed += d->drain(now);
+            d->emit_summaries(now, true);
+        }
+
+        d->wait_cv.notify_one();
+        d->worker.join();
+
+        // Wake up threads in flush() that waited for the worker
+        std::lock_guard<std::mutex> guard3(d->wait_mutex);
+        d->flush_cv.notify_all();
+    }
+}
+
+bool Logger::is_async() const {
+    return d->running;
+}
+
+void Logger::set_rate_limit(uint32_t count) {
+    flush();
+    d->rate_limit = count;
+}
+
+uint32_t Logger::rate_limit() const {
+    return d->rate_limit;
+}
+
+void Logger::flush() {
+    /* Appenders that log from the worker thread must neither wait for it nor
+       lock 'mutex', which is held while messages are processed */
+    if (log_worker_thread)
+        return;
+
+    if (d->running) {
+        size_t target = d->head.load();
+        std::unique_lock<std::mutex> guard(d->wait_mutex);
+        d->wait_cv.notify_one();
+        d->flush_cv.wait(guard, [&]() { return d->processed >= target || !d->running; });
+    }
+
+    std::lock_guard<std::mutex> guard(d->mutex);
+    d->emit_summaries(LogClock::now(), true);
 }
 
 void Logger::log_progress(float progress, const std::string &name,
     const std::string &formatted, const std::string &eta, const void *ptr) {
+    ProgressInfo info;
+    info.progress = progress;
+    log_progress(progress, name, formatted, eta, info, ptr);
+}
+
+void Logger::log_progress(float progress, const std::string &name,
+    const std::string &formatted, const std::string &eta,
+    const ProgressInfo &info, const void *ptr) {
     std::lock_guard<std::mutex> guard(d->mutex);
     for (auto entry : d->appenders)
-        entry->log_progress(progress, name, formatted, eta, ptr);
+        entry->log_progress_info(progress, name, formatted, eta, info, ptr);
 }
 
 void Logger::add_appender(Appender *appender) {
@@ -93,6 +397,7 @@ void Logger::remove_appender(Appender *appender) {
 }
 
 std::string Logger::read_log() {
+    flush();
     std::lock_guard<std::mutex> guard(d->mutex);
     for (auto appender: d->appenders) {
         if (appender->class_()->derives_from(MTS_CLASS(StreamAppender))) {
@@ -125,6 +430,11 @@ void Logger::static_initialization() {
 }
 
 void Logger::static_shutdown() {
+    Logger *logger = Thread::thread()->logger();
+    if (logger) {
+        logger->set_async(false);
+        logger->flush();
+    }
     Thread::thread()->set_logger(nullptr);
 }
 
@@ -149,6 +459,11 @@ void Throw(LogLevel level, const Class *theClass, const char *file,
     util::trap_debugger();
     #endif
 
+    // Process queued messages first, so that they precede the error
+    Thread *thread = Thread::thread();
+    if (thread && thread->logger())
+        thread->logger()->flush();
+
     DefaultFormatter formatter;
     formatter.set_has_date(false);
     formatter.set_has_log_level(false);
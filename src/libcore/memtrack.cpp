@@ -0,0 +1,75 @@
+#include <mitsuba/core/memtrack.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/util.h>
+#include <atomic>
+
+NAMESPACE_BEGIN(mitsuba)
+
+static constexpr int memory_category_count = int(MemoryCategory::MemoryCategoryCount);
+
+/* Index 'memory_category_count' holds the total of all categories. The values
+   are read by the profiler's signal handler, hence only lock-free atomic
+   operations are used here. */
+static std::atomic<size_t> memory_current[memory_category_count + 1];
+static std::atomic<size_t> memory_peak[memory_category_count + 1];
+
+static void memory_update_peak(int index, size_t value) {
+    size_t peak = memory_peak[index].load(std::memory_order_relaxed);
+    while (value > peak &&
+           !memory_peak[index].compare_exchange_weak(peak, value, std::memory_order_relaxed))
+        ;
+}
+
+void MemoryTracker::allocate(MemoryCategory category, size_t size) {
+    int index = int(category);
+    memory_update_peak(index, memory_current[index] += size);
+    memory_update_peak(memory_category_count, memory_current[memory_category_count] += size);
+}
+
+void MemoryTracker::release(MemoryCategory category, size_t size) {
+    memory_current[int(category)] -= size;
+    memory_current[memory_category_count] -= size;
+}
+
+size_t MemoryTracker::current(MemoryCategory category) {
+    return memory_current[int(category)].load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::peak(MemoryCategory category) {
+    return memory_peak[int(category)].load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::current_total() {
+    return memory_current[memory_category_count].load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::peak_total() {
+    return memory_peak[memory_category_count].load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::reset_peak() {
+    for (int i = 0; i <= memory_category_count; ++i)
+        memory_peak[i] = memory_current[i].load();
+}
+
+void MemoryTracker::print_report() {
+    size_t width = 0;
+    for (auto const &name : memory_category_id)
+        width = std::max(width, strlen(name));
+    width += 4;
+
+    Log(Info, "Memory usage by subsystem (current / peak):");
+    for (int i = 0; i < memory_category_count; ++i) {
+        if (memory_peak[i] == 0)
+            continue;
+        Log(Info, "    %s%s%s / %s", memory_category_id[i],
+            std::string(width - strlen(memory_category_id[i]), ' '),
+            util::mem_string(memory_current[i]), util::mem_string(memory_peak[i]));
+    }
+    Log(Info, "    total%s%s / %s (process peak: %s)", std::string(width - 5, ' '),
+        util::mem_string(current_total()), util::mem_string(peak_total()),
+        util::mem_string(util::peak_memory_usage()));
+}
+
+MTS_IMPLEMENT_CLASS(MemoryTracker, Object)
+NAMESPACE_END(mitsuba)
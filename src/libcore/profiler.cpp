@@ -1,6 +1,42 @@
 #include <mitsuba/core/profiler.h>
+#include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/logger.h>
+#include <mitsuba/core/memtrack.h>
+#include <mitsuba/core/string.h>
 #include <mitsuba/core/util.h>
+#include <atomic>
+#include <mutex>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/* Registry of scene objects that can be attributed profiler samples and
+   statistics. It is used by both subsystems, hence it is always compiled. */
+static std::mutex profiler_registry_mutex;
+static std::vector<std::string> profiler_registry;
+static std::atomic<bool> profiler_registry_enabled { false };
+
+void profiler_enable_objects() {
+    profiler_registry_enabled = true;
+}
+
+uint32_t profiler_register_object(ProfilerObjectType type, const std::string &plugin,
+                                  const std::string &id) {
+    if (!profiler_registry_enabled)
+        return 0;
+    std::lock_guard<std::mutex> guard(profiler_registry_mutex);
+    profiler_registry.push_back(id.empty() ? plugin : tfm::format("%s [%s]", id, plugin));
+    return ((uint32_t) profiler_registry.size() << 2) | (uint32_t) type;
+}
+
+std::string profiler_object_name(uint32_t handle) {
+    std::lock_guard<std::mutex> guard(profiler_registry_mutex);
+    size_t index = handle >> 2;
+    if (index == 0 || index > profiler_registry.size())
+        return "unknown";
+    return profiler_registry[index - 1];
+}
+
+NAMESPACE_END(mitsuba)
 
 #if defined(MTS_ENABLE_PROFILER)
 #include <sys/time.h>
@@ -8,51 +44,337 @@
 #include <stdio.h>
 #include <tbb/tbb.h>
 #include <array>
+#include <fstream>
 #include <map>
+#include <memory>
+#include <time.h>
+
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
 
 NAMESPACE_BEGIN(mitsuba)
 
 static thread_local uint64_t profiler_flags_storage = 0;
-uint64_t *profiler_flags() { return &profiler_flags_storage; }
+static thread_local uint32_t profiler_objects_storage[4] { };
+
+/// Sampling frequency of the profiler (in Hz)
+static constexpr uint64_t profiler_frequency = 100;
+
+static constexpr int profiler_counter_count = int(ProfilerCounter::ProfilerCounterCount);
+static constexpr int profiler_phase_count = int(ProfilerPhase::ProfilerPhaseCount);
+static constexpr int profiler_memory_count = int(MemoryCategory::MemoryCategoryCount);
 
 struct ProfilerSample {
     uint64_t flags = (uint64_t) -1;
     uint64_t count = 0;
+    /// Hardware counter increments attributed to this set of phases
+    uint64_t counters[profiler_counter_count] { };
+};
+
+/// Samples attributed to a registered scene object
+struct ProfilerObjectSample {
+    uint32_t object = 0;
+    uint64_t count = 0;
+};
+
+/// Run-length encoded entry of a per-thread timeline (times in microseconds)
+struct ProfilerEvent {
+    uint64_t flags;
+    uint64_t start, end;
 };
 
-static std::array<ProfilerSample, MTS_PROFILE_HASH_SIZE> profiler_samples;
+/**
+ * Per-thread sample storage. Only the owning thread writes to it (from its
+ * own SIGPROF handler), hence no synchronization is required while sampling.
+ * Instances are never destroyed so that samples of threads that have already
+ * exited remain available for the report.
+ */
+struct ProfilerThread {
+    size_t index;
+    std::array<ProfilerSample, MTS_PROFILE_HASH_SIZE> samples;
+    std::array<ProfilerObjectSample, MTS_PROFILE_OBJECT_HASH_SIZE> objects;
+    /// Phase timeline (only allocated when tracing was enabled)
+    std::unique_ptr<ProfilerEvent[]> timeline;
+    size_t timeline_size = 0;
+    bool timeline_overflow = false;
+    bool hash_overflow = false;
+    bool object_overflow = false;
+
+    /* Peak tracked memory usage per category (and in total, last entry)
+       observed while the innermost phase was active (last row: idle) */
+    size_t memory_peak[profiler_phase_count + 1][profiler_memory_count + 1] { };
+
+    /* Hardware performance counters: the file descriptors of a perf_event
+       group (the first one is the group leader), the position of each
+       counter in the group's read buffer (-1 if unavailable), and the
+       values at the time of the previous sample */
+    int counter_fd[profiler_counter_count];
+    int counter_slot[profiler_counter_count];
+    int counter_group_size = 0;
+    uint64_t counter_last[profiler_counter_count] { };
+    std::atomic<bool> counters_active { false };
+
+    ProfilerThread(size_t index) : index(index) {
+        for (int i = 0; i < profiler_counter_count; ++i)
+            counter_fd[i] = counter_slot[i] = -1;
+    }
+};
+
+static std::mutex profiler_threads_mutex;
+static std::vector<std::unique_ptr<ProfilerThread>> profiler_threads;
+static thread_local ProfilerThread *profiler_thread = nullptr;
+
+/// Samples taken on threads that never entered a profiler phase
+static std::atomic<uint64_t> profiler_samples_unregistered { 0 };
+
+static uint64_t profiler_start_time = 0;
+
+/// Attribute samples to scene objects? (and the number of objects to report)
+static std::atomic<bool> profiler_objects_enabled { false };
+static size_t profiler_objects_top_n = 10;
+
+/// Should threads allocate a phase timeline when they register?
+static std::atomic<bool> profiler_trace_enabled { false };
+
+/// Should threads open hardware performance counters when they register?
+static std::atomic<bool> profiler_counters_enabled { false };
+
+/// Bit mask of the hardware counters that could be opened on any thread
+static std::atomic<uint32_t> profiler_counters_available { 0 };
+
+/// Read the hardware counters of the calling thread (async signal safe)
+static bool profiler_read_counters(const ProfilerThread *thread, uint64_t *values) {
+#if defined(__linux__)
+    // Layout of a group read with PERF_FORMAT_GROUP: { nr, values[nr] }
+    uint64_t buf[1 + profiler_counter_count];
+    ssize_t size = (ssize_t) ((1 + thread->counter_group_size) * sizeof(uint64_t));
+    if (read(thread->counter_fd[0], buf, (size_t) size) != size)
+        return false;
+    for (int i = 0; i < profiler_counter_count; ++i) {
+        int slot = thread->counter_slot[i];
+        values[i] = slot >= 0 ? buf[1 + slot] : 0;
+    }
+    return true;
+#else
+    (void) thread; (void) values;
+    return false;
+#endif
+}
+
+/**
+ * Open the hardware counters of the calling thread. All counters are placed
+ * in a single group so that they are scheduled onto the PMU together, which
+ * keeps their ratios meaningful even when the kernel multiplexes events.
+ */
+static bool profiler_open_counters(ProfilerThread *thread) {
+#if defined(__linux__)
+    static std::atomic<bool> warned { false };
+    const uint64_t config[profiler_counter_count] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_STALLED_CYCLES_BACKEND
+    };
+
+    int leader = -1, slot = 0;
+    for (int i = 0; i < profiler_counter_count; ++i) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config[i];
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.disabled = leader == -1 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        int fd = (int) syscall(SYS_perf_event_open, &attr, 0 /* calling thread */,
+                               -1 /* any CPU */, leader, 0);
+        if (fd < 0) {
+            // Cycles act as group leader, the remaining counters are optional
+            if (leader == -1) {
+                if (!warned.exchange(true))
+                    Log(Warn, "Hardware performance counters are unavailable (%s) -- "
+                              "check /proc/sys/kernel/perf_event_paranoid.",
+                        strerror(errno));
+                return false;
+            }
+            continue;
+        }
+
+        if (leader == -1)
+            leader = fd;
+        thread->counter_fd[i] = fd;
+        thread->counter_slot[i] = slot++;
+        profiler_counters_available |= 1u << i;
+    }
+    thread->counter_group_size = slot;
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    if (!profiler_read_counters(thread, thread->counter_last))
+        return false;
+
+    // The signal handler runs on this thread, a compiler barrier suffices
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    thread->counters_active.store(true, std::memory_order_relaxed);
+    return true;
+#else
+    (void) thread;
+    return false;
+#endif
+}
+
+/// Monotonic time in microseconds (async signal safe)
+static uint64_t profiler_time() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + (uint64_t) ts.tv_nsec / 1000;
+}
+
+/// Allocate the timeline of the calling thread (must hold profiler_threads_mutex)
+static void profiler_allocate_timeline(ProfilerThread *thread) {
+    if (thread->timeline)
+        return;
+    std::unique_ptr<ProfilerEvent[]> timeline(new ProfilerEvent[MTS_PROFILE_TIMELINE_SIZE]);
+    // The signal handler runs on this thread, a compiler barrier suffices
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    thread->timeline = std::move(timeline);
+}
+
+/// Return the storage of the calling thread, registering it on first use
+static MTS_NOINLINE ProfilerThread *profiler_register_thread() {
+    if (profiler_thread)
+        return profiler_thread;
+    std::lock_guard<std::mutex> guard(profiler_threads_mutex);
+    profiler_threads.emplace_back(new ProfilerThread(profiler_threads.size()));
+    ProfilerThread *thread = profiler_threads.back().get();
+    if (profiler_trace_enabled)
+        profiler_allocate_timeline(thread);
+    if (profiler_counters_enabled)
+        profiler_open_counters(thread);
+    profiler_thread = thread;
+    return thread;
+}
+
+uint64_t *profiler_flags() {
+    if (unlikely(!profiler_thread))
+        profiler_register_thread();
+    return &profiler_flags_storage;
+}
+
+uint32_t *profiler_objects() {
+    if (unlikely(!profiler_thread))
+        profiler_register_thread();
+    return profiler_objects_storage;
+}
+
+/// Add a sample to the per-thread table of the given object (async signal safe)
+static void profiler_record_object(ProfilerThread *thread, uint32_t object) {
+    auto &objects = thread->objects;
+    size_t bucket_id = object % objects.size();
+
+    // Hash table with linear probing
+    for (size_t tries = 0; tries < objects.size(); ++tries) {
+        ProfilerObjectSample &bucket = objects[bucket_id];
+        if (bucket.object == 0 || bucket.object == object) {
+            bucket.object = object;
+            bucket.count++;
+            return;
+        }
+        if (++bucket_id == objects.size())
+            bucket_id = 0;
+    }
+    thread->object_overflow = true;
+}
 
 static void profiler_callback(int, siginfo_t *, void *) {
-    uint64_t flags = *profiler_flags();
+    ProfilerThread *thread = profiler_thread;
+    if (!thread) {
+        profiler_samples_unregistered++;
+        return;
+    }
+
+    uint64_t flags = profiler_flags_storage;
+    auto &samples = thread->samples;
 
     uint64_t bucket_id =
-        std::hash<uint64_t>{}(flags) % (profiler_samples.size() - 1);
+        std::hash<uint64_t>{}(flags) % (samples.size() - 1);
 
     // Hash table with linear probing
     size_t tries = 0;
-    while (tries < profiler_samples.size()) {
-        ProfilerSample &bucket = profiler_samples[bucket_id];
+    while (tries < samples.size()) {
+        ProfilerSample &bucket = samples[bucket_id];
         if (bucket.flags == (uint64_t) -1 || bucket.flags == flags)
             break;
-        if (++bucket_id == profiler_samples.size())
+        if (++bucket_id == samples.size())
             bucket_id = 0;
         ++tries;
     }
 
-    if (tries == profiler_samples.size()) {
-        Log(Warn, "Profiler hash table filled up -- you may need to increase "
-                  "MTS_PROFILE_HASH_SIZE.");
-        return;
+    ProfilerSample *bucket = nullptr;
+    if (tries == samples.size()) {
+        // Logging is not async signal safe, this is reported by print_report()
+        thread->hash_overflow = true;
+    } else {
+        bucket = &samples[bucket_id];
+        bucket->flags = flags;
+        bucket->count++;
+    }
+
+    /* Attribute the counter increments since the previous sample to the
+       current phases (statistically, just like the sampled time) */
+    if (thread->counters_active.load(std::memory_order_relaxed)) {
+        int saved_errno = errno;
+        uint64_t values[profiler_counter_count];
+        if (profiler_read_counters(thread, values)) {
+            for (int i = 0; i < profiler_counter_count; ++i) {
+                if (bucket)
+                    bucket->counters[i] += values[i] - thread->counter_last[i];
+                thread->counter_last[i] = values[i];
+            }
+        }
+        errno = saved_errno;
+    }
+
+    // Atomic loads are async signal safe
+    size_t *memory_peak = thread->memory_peak[flags ? 63 - __builtin_clzll(flags)
+                                                    : profiler_phase_count];
+    for (int i = 0; i < profiler_memory_count; ++i)
+        memory_peak[i] = std::max(memory_peak[i], MemoryTracker::current(MemoryCategory(i)));
+    memory_peak[profiler_memory_count] =
+        std::max(memory_peak[profiler_memory_count], MemoryTracker::current_total());
+
+    if (profiler_objects_enabled.load(std::memory_order_relaxed)) {
+        for (uint32_t object : profiler_objects_storage) {
+            if (object != 0)
+                profiler_record_object(thread, object);
+        }
     }
 
-    ProfilerSample &bucket = profiler_samples[bucket_id];
-    bucket.flags = flags;
-    bucket.count++;
+    if (!thread->timeline)
+        return;
+
+    uint64_t time = profiler_time() - profiler_start_time;
+    if (thread->timeline_size > 0 &&
+        thread->timeline[thread->timeline_size - 1].flags == flags) {
+        thread->timeline[thread->timeline_size - 1].end = time;
+    } else if (thread->timeline_size < MTS_PROFILE_TIMELINE_SIZE) {
+        thread->timeline[thread->timeline_size++] = ProfilerEvent{ flags, time, time };
+    } else {
+        thread->timeline_overflow = true;
+    }
 }
 
 void Profiler::static_initialization() {
     if (!util::detect_debugger()) {
-        (void) profiler_flags();
+        profiler_register_thread();
+        profiler_start_time = profiler_time();
 
         struct sigaction sa;
         memset(&sa, 0, sizeof(sa));
@@ -64,7 +386,7 @@ void Profiler::static_initialization() {
 
         itimerval timer;
         timer.it_interval.tv_sec = 0;
-        timer.it_interval.tv_usec = 1000000 / 100; // 100 Hz sampling
+        timer.it_interval.tv_usec = 1000000 / profiler_frequency;
         timer.it_value = timer.it_interval;
 
         if (setitimer(ITIMER_PROF, &timer, nullptr))
@@ -72,6 +394,34 @@ void Profiler::static_initialization() {
     }
 }
 
+bool Profiler::enable_counters() {
+#if defined(__linux__)
+    profiler_counters_enabled = true;
+    ProfilerThread *thread = profiler_register_thread();
+    if (!thread->counters_active) {
+        std::lock_guard<std::mutex> guard(profiler_threads_mutex);
+        profiler_open_counters(thread);
+    }
+    return thread->counters_active;
+#else
+    Log(Warn, "Hardware performance counters are only supported on Linux.");
+    return false;
+#endif
+}
+
+void Profiler::enable_objects(size_t top_n) {
+    profiler_enable_objects();
+    profiler_objects_top_n = top_n;
+    profiler_objects_enabled = true;
+}
+
+void Profiler::enable_trace() {
+    profiler_trace_enabled = true;
+    ProfilerThread *thread = profiler_register_thread();
+    std::lock_guard<std::mutex> guard(profiler_threads_mutex);
+    profiler_allocate_timeline(thread);
+}
+
 void Profiler::static_shutdown() {
     if (util::detect_debugger())
         return;
@@ -85,70 +435,179 @@ void Profiler::static_shutdown() {
         Throw("profiler_stop(): failure in setitimer(): %s", strerror(errno));
 }
 
-void Profiler::print_report() {
-    using SampleMap = std::map<std::string, uint64_t>;
+/// Samples and hardware counter values of a phase
+struct ProfilerTotals {
+    uint64_t samples = 0;
+    std::array<uint64_t, profiler_counter_count> counters { };
 
-    uint64_t event_count_total = 0,
-             buckets_used = 0;
-
-    SampleMap leaf_results, hierarchical_results;
+    void add(uint64_t count, const uint64_t *values) {
+        samples += count;
+        for (int i = 0; i < profiler_counter_count; ++i)
+            counters[i] += values[i];
+    }
+};
 
-    size_t prefix_length = 0;
-    size_t max_indent = 0;
+using SampleMap = std::map<std::string, ProfilerTotals>;
 
-    for (auto const &sample: profiler_samples) {
-        if (sample.count == 0)
-            continue;
-        uint64_t sample_flags = sample.flags;
+/// Sample counts aggregated by (hierarchical) phase names
+struct ProfilerSummary {
+    SampleMap hierarchical, leaf;
+    uint64_t total = 0;
+    size_t prefix_length = 0, max_indent = 0;
 
-        event_count_total += sample.count;
-        buckets_used++;
+    void add(uint64_t flags, uint64_t count, const uint64_t *counters) {
+        total += count;
 
         size_t indent = 0;
         std::string name_hierarchical;
         for (int i = 0; i < int(ProfilerPhase::ProfilerPhaseCount); ++i) {
             uint64_t flag = 1ull << i;
-            if (sample_flags & flag) {
+            if (flags & flag) {
                 const char *name = profiler_phase_id[i];
                 if (!name_hierarchical.empty())
                     name_hierarchical += "/";
                 name_hierarchical += name;
                 prefix_length = std::max(prefix_length, strlen(name));
-                hierarchical_results[name_hierarchical] += sample.count;
-                sample_flags &= ~flag;
-                if (sample_flags == 0)
-                    leaf_results[name] += sample.count;
+                hierarchical[name_hierarchical].add(count, counters);
+                flags &= ~flag;
+                if (flags == 0)
+                    leaf[name].add(count, counters);
                 indent += 1;
             }
             max_indent = std::max(indent, max_indent);
         }
 
         if (name_hierarchical.empty()) {
-            hierarchical_results["Idle"] += sample.count;
-            leaf_results["Idle"] += sample.count;
+            hierarchical["Idle"].add(count, counters);
+            leaf["Idle"].add(count, counters);
+        }
+    }
+
+    void add(const ProfilerThread &thread) {
+        for (auto const &sample : thread.samples) {
+            if (sample.count > 0)
+                add(sample.flags, sample.count, sample.counters);
+        }
+    }
+
+    void add_unregistered() {
+        const uint64_t counters[profiler_counter_count] { };
+        if (profiler_samples_unregistered > 0)
+            add(0, profiler_samples_unregistered, counters);
+    }
+};
+
+/**
+ * Samples attributed to each scene object (inclusive of nested calls), and
+ * the \c top_n most expensive objects of each type in decreasing order
+ */
+static std::vector<std::vector<std::pair<uint32_t, uint64_t>>> profiler_object_summary(size_t top_n) {
+    std::map<uint32_t, uint64_t> totals;
+    for (auto const &thread : profiler_threads) {
+        for (auto const &sample : thread->objects) {
+            if (sample.object != 0)
+                totals[sample.object] += sample.count;
         }
     }
 
-    Log(Info, "Recorded %i samples, used %i/%i hash table entries.",
-        event_count_total, buckets_used, profiler_samples.size());
+    std::vector<std::vector<std::pair<uint32_t, uint64_t>>> result(
+        (size_t) ProfilerObjectType::ProfilerObjectTypeCount);
+    for (auto const &kv : totals)
+        result[kv.first & 3].push_back(kv);
+
+    for (auto &list : result) {
+        std::sort(list.begin(), list.end(),
+                  [](const auto &a, const auto &b) { return a.second > b.second; });
+        if (list.size() > top_n)
+            list.resize(top_n);
+    }
+    return result;
+}
+
+/// Peak tracked memory usage per (innermost) phase, merged over all threads
+static std::vector<std::array<size_t, profiler_memory_count + 1>> profiler_memory_summary() {
+    std::vector<std::array<size_t, profiler_memory_count + 1>> result(profiler_phase_count + 1);
+    for (auto const &thread : profiler_threads)
+        for (int i = 0; i <= profiler_phase_count; ++i)
+            for (int j = 0; j <= profiler_memory_count; ++j)
+                result[i][j] = std::max(result[i][j], thread->memory_peak[i][j]);
+    return result;
+}
+
+static const char *profiler_phase_name(int phase) {
+    return phase < profiler_phase_count ? profiler_phase_id[phase] : "Idle";
+}
+
+static bool profiler_counter_available(ProfilerCounter counter) {
+    return (profiler_counters_available & (1u << int(counter))) != 0;
+}
+
+/**
+ * Summarize the hardware counters of a phase: instructions per cycle, cache
+ * and branch misses per 1000 instructions, and the fraction of stalled cycles
+ */
+static std::string profiler_counter_summary(const ProfilerTotals &totals) {
+    auto value = [&](ProfilerCounter c) { return (double) totals.counters[int(c)]; };
+    double cycles = value(ProfilerCounter::Cycles),
+           instructions = value(ProfilerCounter::Instructions);
+    auto ratio = [](double a, double b) {
+        return b > 0 ? tfm::format("%.2f", a / b) : std::string("-");
+    };
+
+    std::string result = "IPC " + (profiler_counter_available(ProfilerCounter::Instructions)
+        ? ratio(instructions, cycles) : std::string("n/a"));
+    if (profiler_counter_available(ProfilerCounter::CacheMisses))
+        result += ", cache MPKI " + ratio(value(ProfilerCounter::CacheMisses) * 1000, instructions);
+    if (profiler_counter_available(ProfilerCounter::BranchMisses))
+        result += ", branch MPKI " + ratio(value(ProfilerCounter::BranchMisses) * 1000, instructions);
+    if (profiler_counter_available(ProfilerCounter::StalledCycles))
+        result += ", stalled " + ratio(value(ProfilerCounter::StalledCycles) * 100, cycles) + "%";
+    return result;
+}
+
+void Profiler::print_report() {
+    std::lock_guard<std::mutex> guard(profiler_threads_mutex);
+    ProfilerSummary summary;
+    size_t buckets_used = 0;
+    bool hash_overflow = false;
+
+    for (auto const &thread : profiler_threads) {
+        summary.add(*thread);
+        for (auto const &sample : thread->samples)
+            buckets_used += sample.count > 0 ? 1 : 0;
+        hash_overflow |= thread->hash_overflow;
+    }
+    summary.add_unregistered();
+
+    uint64_t event_count_total = summary.total;
+    size_t prefix_length = summary.prefix_length,
+           max_indent = summary.max_indent;
+
+    Log(Info, "Recorded %i samples on %i threads, used %i/%i hash table entries.",
+        event_count_total, profiler_threads.size(), buckets_used,
+        profiler_threads.size() * MTS_PROFILE_HASH_SIZE);
+
+    if (hash_overflow)
+        Log(Warn, "Profiler hash table filled up -- you may need to increase "
+                  "MTS_PROFILE_HASH_SIZE.");
 
     if (event_count_total < 250)
         Log(Warn, "Collected very few samples -- perform a longer "
                   "rendering to obtain more reliable profile data.");
 
-    std::vector<std::pair<std::string, uint64_t>> leaf_results_sorted;
-    leaf_results_sorted.reserve(leaf_results.size());
-    for (const auto &r : leaf_results)
+    std::vector<std::pair<std::string, ProfilerTotals>> leaf_results_sorted;
+    leaf_results_sorted.reserve(summary.leaf.size());
+    for (const auto &r : summary.leaf)
         leaf_results_sorted.push_back(r);
 
     std::sort(
         leaf_results_sorted.begin(), leaf_results_sorted.end(),
-        [](auto a, auto b) { return a.second > b.second; });
+        [](const auto &a, const auto &b) { return a.second.samples > b.second.samples; });
 
     prefix_length += max_indent * 2 + 10;
 
     Log(Info, "\U000023F1  Profile (hierarchical):");
-    for (auto kv : hierarchical_results) {
+    for (auto kv : summary.hierarchical) {
         int indent = 4;
         auto slash_index = kv.first.find_last_of("/");
 
@@ -163,15 +622,242 @@ void Profiler::print_report() {
             std::string(indent, ' '),
             suffix,
             std::string(prefix_length - suffix.length() - indent, ' '),
-            kv.second / float(event_count_total) * 100.f);
+            kv.second.samples / float(event_count_total) * 100.f);
     }
 
     Log(Info, "\U000023F1  Profile (flat):");
     for (auto kv : leaf_results_sorted) {
         Log(Info, "    %s%s%.2f%%", kv.first,
             std::string(prefix_length - kv.first.length() - 4, ' '),
-            kv.second / float(event_count_total) * 100.f);
+            kv.second.samples / float(event_count_total) * 100.f);
+    }
+
+    auto memory = profiler_memory_summary();
+    if (MemoryTracker::peak_total() > 0) {
+        Log(Info, "\U000023F1  Peak tracked memory (by innermost phase):");
+        for (int i = 0; i <= profiler_phase_count; ++i) {
+            size_t total = memory[i][profiler_memory_count];
+            if (total == 0)
+                continue;
+            int largest = 0;
+            for (int j = 1; j < profiler_memory_count; ++j)
+                if (memory[i][j] > memory[i][largest])
+                    largest = j;
+            std::string name = profiler_phase_name(i);
+            Log(Info, "    %s%s%s (largest: %s, %s)", name,
+                std::string(std::max(prefix_length, name.length() + 5) - name.length() - 4, ' '),
+                util::mem_string(total), memory_category_id[largest],
+                util::mem_string(memory[i][largest]));
+        }
     }
+
+    if (profiler_counters_available != 0) {
+        Log(Info, "\U000023F1  Hardware counters (flat):");
+        for (auto kv : leaf_results_sorted) {
+            Log(Info, "    %s%s%s", kv.first,
+                std::string(prefix_length - kv.first.length() - 4, ' '),
+                profiler_counter_summary(kv.second));
+        }
+    }
+
+    if (!profiler_objects_enabled)
+        return;
+
+    bool object_overflow = false;
+    for (auto const &thread : profiler_threads)
+        object_overflow |= thread->object_overflow;
+    if (object_overflow)
+        Log(Warn, "Profiler object table filled up -- you may need to increase "
+                  "MTS_PROFILE_OBJECT_HASH_SIZE.");
+
+    auto objects = profiler_object_summary(profiler_objects_top_n);
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (objects[i].empty())
+            continue;
+        std::vector<std::string> names;
+        size_t width = 0;
+        for (auto const &kv : objects[i]) {
+            names.push_back(profiler_object_name(kv.first));
+            width = std::max(width, names.back().length());
+        }
+        Log(Info, "\U000023F1  Most expensive %s (inclusive):", profiler_object_type_id[i]);
+        for (size_t j = 0; j < names.size(); ++j)
+            Log(Info, "    %s%s%.2f%%", names[j], std::string(width - names[j].length() + 4, ' '),
+                objects[i][j].second / float(event_count_total) * 100.f);
+    }
+}
+
+using string::json_string;
+
+static void write_json_phases(std::ostream &os, const SampleMap &map,
+                              uint64_t total, const std::string &indent) {
+    os << "[";
+    bool first = true;
+    for (auto const &kv : map) {
+        os << (first ? "\n" : ",\n") << indent << "  { \"name\": " << json_string(kv.first)
+           << ", \"samples\": " << kv.second.samples
+           << ", \"cpu_time_ms\": " << kv.second.samples * 1000 / profiler_frequency
+           << ", \"percent\": " << kv.second.samples / double(total) * 100.0;
+        if (profiler_counters_available != 0) {
+            os << ", \"counters\": {";
+            bool first_counter = true;
+            for (int i = 0; i < profiler_counter_count; ++i) {
+                if (!profiler_counter_available(ProfilerCounter(i)))
+                    continue;
+                os << (first_counter ? " " : ", ") << "\"" << profiler_counter_id[i]
+                   << "\": " << kv.second.counters[i];
+                first_counter = false;
+            }
+            os << " }";
+        }
+        os << " }";
+        first = false;
+    }
+    os << "\n" << indent << "]";
+}
+
+void Profiler::write_json(const fs::path &filename) {
+    std::lock_guard<std::mutex> guard(profiler_threads_mutex);
+    std::ofstream os(filename.native());
+    if (!os.good())
+        Throw("Profiler::write_json(): could not open \"%s\"", filename);
+
+    ProfilerSummary summary;
+    for (auto const &thread : profiler_threads)
+        summary.add(*thread);
+    summary.add_unregistered();
+
+    os << "{\n"
+       << "  \"frequency_hz\": " << profiler_frequency << ",\n"
+       << "  \"samples\": " << summary.total << ",\n"
+       << "  \"hierarchical\": ";
+    write_json_phases(os, summary.hierarchical, summary.total, "  ");
+    os << ",\n  \"flat\": ";
+    write_json_phases(os, summary.leaf, summary.total, "  ");
+    os << ",\n  \"threads\": [";
+
+    for (size_t i = 0; i < profiler_threads.size(); ++i) {
+        ProfilerSummary ts;
+        ts.add(*profiler_threads[i]);
+        os << (i == 0 ? "\n" : ",\n")
+           << "    {\n"
+           << "      \"index\": " << profiler_threads[i]->index << ",\n"
+           << "      \"samples\": " << ts.total << ",\n"
+           << "      \"hierarchical\": ";
+        write_json_phases(os, ts.hierarchical, ts.total, "      ");
+        os << ",\n      \"flat\": ";
+        write_json_phases(os, ts.leaf, ts.total, "      ");
+        os << "\n    }";
+    }
+    os << "\n  ],\n  \"memory_peak_bytes\": [";
+
+    auto memory = profiler_memory_summary();
+    bool first = true;
+    for (int i = 0; i <= profiler_phase_count; ++i) {
+        if (memory[i][profiler_memory_count] == 0)
+            continue;
+        os << (first ? "\n" : ",\n") << "    { \"name\": "
+           << json_string(profiler_phase_name(i))
+           << ", \"total\": " << memory[i][profiler_memory_count];
+        for (int j = 0; j < profiler_memory_count; ++j)
+            os << ", \"" << memory_category_id[j] << "\": " << memory[i][j];
+        os << " }";
+        first = false;
+    }
+    os << (first ? "]" : "\n  ]");
+
+    if (profiler_objects_enabled) {
+        auto objects = profiler_object_summary(profiler_objects_top_n);
+        os << ",\n  \"objects\": {";
+        for (size_t i = 0; i < objects.size(); ++i) {
+            os << (i == 0 ? "\n" : ",\n") << "    \"" << profiler_object_type_id[i] << "\": [";
+            for (size_t j = 0; j < objects[i].size(); ++j) {
+                uint64_t count = objects[i][j].second;
+                os << (j == 0 ? "\n" : ",\n") << "      { \"name\": "
+                   << json_string(profiler_object_name(objects[i][j].first))
+                   << ", \"samples\": " << count
+                   << ", \"cpu_time_ms\": " << count * 1000 / profiler_frequency
+                   << ", \"percent\": " << count / double(summary.total) * 100.0 << " }";
+            }
+            os << (objects[i].empty() ? "]" : "\n    ]");
+        }
+        os << "\n  }";
+    }
+
+    os << "\n}\n";
+    Log(Info, "Wrote profile to \"%s\"", filename);
+}
+
+void Profiler::write_chrome_trace(const fs::path &filename) {
+    std::lock_guard<std::mutex> guard(profiler_threads_mutex);
+    std::ofstream os(filename.native());
+    if (!os.good())
+        Throw("Profiler::write_chrome_trace(): could not open \"%s\"", filename);
+
+    /* Consecutive samples more than two sampling intervals apart are
+       considered to be separated by a period of inactivity */
+    const uint64_t interval = 1000000 / profiler_frequency,
+                   max_gap  = 2 * interval;
+
+    bool first = true;
+    auto emit = [&](const char *name, size_t tid, uint64_t start, uint64_t end) {
+        os << (first ? "\n" : ",\n")
+           << "    { \"name\": " << json_string(name) << ", \"cat\": \"mitsuba\", "
+           << "\"ph\": \"X\", \"pid\": 0, \"tid\": " << tid << ", \"ts\": " << start
+           << ", \"dur\": " << end - start << " }";
+        first = false;
+    };
+
+    os << "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [";
+
+    for (auto const &thread : profiler_threads) {
+        size_t tid = thread->index;
+        os << (first ? "\n" : ",\n")
+           << "    { \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": "
+           << tid << ", \"args\": { \"name\": \"Thread " << tid << "\" } }";
+        first = false;
+
+        if (thread->timeline_overflow)
+            Log(Warn, "Profiler timeline of thread %i is truncated -- you may need "
+                      "to increase MTS_PROFILE_TIMELINE_SIZE.", tid);
+
+        // Currently open phases (in nesting order) and their start times
+        std::vector<std::pair<int, uint64_t>> stack;
+        uint64_t last_end = 0;
+
+        auto close = [&](size_t depth, uint64_t end) {
+            while (stack.size() > depth) {
+                emit(profiler_phase_id[stack.back().first], tid,
+                     stack.back().second, end);
+                stack.pop_back();
+            }
+        };
+
+        for (size_t j = 0; j < thread->timeline_size; ++j) {
+            const ProfilerEvent &event = thread->timeline[j];
+            uint64_t end = std::min(last_end + interval, event.start);
+            if (event.start > last_end + max_gap)
+                close(0, end);
+
+            // Phases are nested according to their order in 'ProfilerPhase'
+            size_t depth = 0;
+            for (int i = 0; i < int(ProfilerPhase::ProfilerPhaseCount); ++i) {
+                if (!(event.flags & (1ull << i)))
+                    continue;
+                if (depth < stack.size() && stack[depth].first != i)
+                    close(depth, end);
+                if (depth == stack.size())
+                    stack.emplace_back(i, event.start);
+                depth++;
+            }
+            close(depth, end);
+            last_end = event.end;
+        }
+        close(0, last_end + interval);
+    }
+
+    os << "\n  ]\n}\n";
+    Log(Info, "Wrote profiler trace to \"%s\"", filename);
 }
 
 MTS_IMPLEMENT_CLASS(Profiler, Object)
@@ -1,18 +1,44 @@
 #include <mitsuba/core/progress.h>
 #include <mitsuba/core/logger.h>
+#include <mitsuba/core/stats.h>
 #include <cmath>
+#include <thread>
+
+/// Max. length of the time and throughput string following the progress bar
+#define MTS_PROGRESS_SUFFIX_LENGTH 40
 
 NAMESPACE_BEGIN(mitsuba)
 
-ProgressReporter::ProgressReporter(const std::string &label, void *payload)
+/// Weight of the most recent rate measurement in the smoothed ETA
+static constexpr float progress_smoothing = 0.3f;
+
+static uint64_t progress_ray_count() {
+    return Statistics::counter(StatsCounter::IntersectRays) +
+           Statistics::counter(StatsCounter::ShadowRays);
+}
+
+/// Turn a throughput into a short human-readable string (e.g. "12.3M")
+static std::string rate_string(double value) {
+    const char *suffixes[] = { "", "K", "M", "G", "T" };
+    int i = 0;
+    while (value >= 1000.0 && i < 4) {
+        value /= 1000.0;
+        ++i;
+    }
+    return tfm::format(i == 0 ? "%.0f%s" : "%.1f%s", value, suffixes[i]);
+}
+
+ProgressReporter::ProgressReporter(const std::string &label, void *payload,
+                                   size_t total)
     : m_label(label), m_line(util::terminal_width() + 1, ' '),
-      m_bar_start(label.length() + 3), m_bar_size(0), m_payload(payload) {
+      m_bar_start(label.length() + 3), m_bar_size(0), m_payload(payload),
+      m_total(total), m_rays_start(progress_ray_count()), m_rate(0.f) {
     m_line[0] = '\r'; // Carriage return
 
     ssize_t bar_size = (ssize_t) m_line.length()
         - (ssize_t) m_bar_start /* CR, Label, space, leading bracket */
         - 2 /* Trailing bracket and space */
-        - 22 /* Max length for ETA string */;
+        - MTS_PROGRESS_SUFFIX_LENGTH /* Max length for time/throughput string */;
 
     if (bar_size > 0) { /* Is there even space to draw a progress bar? */
         m_bar_size = bar_size;
@@ -28,6 +54,32 @@ ProgressReporter::ProgressReporter(const std::string &label, void *payload)
 ProgressReporter::~ProgressReporter() { }
 
 void ProgressReporter::update(float progress) {
+    report(progress, progress >= 1.f);
+}
+
+void ProgressReporter::advance(size_t work, uint64_t samples) {
+    size_t done = m_done.fetch_add(work, std::memory_order_relaxed) + work;
+    if (samples > 0)
+        m_samples.fetch_add(samples, std::memory_order_relaxed);
+    if (m_total > 0)
+        report(done / (float) m_total, done >= m_total);
+}
+
+void ProgressReporter::report(float progress, bool final) {
+    if (!final && m_timer.value() < m_next_update.load(std::memory_order_relaxed))
+        return; // Don't refresh too often
+
+    // Only one thread refreshes at a time. The final update must not be lost.
+    while (m_refreshing.exchange(true, std::memory_order_acquire)) {
+        if (!final)
+            return;
+        std::this_thread::yield();
+    }
+    refresh(progress);
+    m_refreshing.store(false, std::memory_order_release);
+}
+
+void ProgressReporter::refresh(float progress) {
     progress = std::min(std::max(progress, 0.f), 1.f);
 
     if (progress == m_last_progress)
@@ -38,22 +90,55 @@ void ProgressReporter::update(float progress) {
                             std::abs(progress - m_last_progress) < 0.01f))
         return; // Don't refresh too often
 
-    float remaining = elapsed / progress * (1 - progress);
-    std::string eta = "(" + util::time_string(elapsed) + ", ETA: " + util::time_string(remaining) + ")";
-    if (eta.length() > 22)
-        eta.resize(22);
+    ProgressInfo info;
+    info.progress = progress;
+    info.elapsed  = elapsed / 1000.f;
+    info.samples  = m_samples.load(std::memory_order_relaxed);
+    if (elapsed > 0) {
+        info.samples_per_second = info.samples / (double) info.elapsed;
+        info.rays_per_second = (progress_ray_count() - m_rays_start) / (double) info.elapsed;
+    }
+
+    // Exponentially smoothed rate of progress per second
+    float dt = (elapsed - m_last_update) / 1000.f;
+    if (m_last_progress < 0.f || m_rate == 0.f) {
+        if (info.elapsed > 0.f)
+            m_rate = progress / info.elapsed;
+    } else if (dt > 0.f) {
+        float rate = (progress - m_last_progress) / dt;
+        m_rate = progress_smoothing * rate + (1.f - progress_smoothing) * m_rate;
+    }
+    if (progress == 1.f)
+        info.eta = 0.f;
+    else if (m_rate > 0.f)
+        info.eta = (1.f - progress) / m_rate;
+
+    std::string eta = "(" + util::time_string(elapsed) + ", ETA: " +
+                      (info.eta >= 0.f ? util::time_string(info.eta * 1000.f) : "?") + ")";
+
+    std::string suffix = eta;
+    if (info.samples_per_second > 0.0) {
+        suffix.pop_back();
+        suffix += ", " + rate_string(info.samples_per_second) + " samples/s)";
+    }
+    if (suffix.length() > MTS_PROGRESS_SUFFIX_LENGTH)
+        suffix = eta;
+    if (suffix.length() > MTS_PROGRESS_SUFFIX_LENGTH)
+        suffix.resize(MTS_PROGRESS_SUFFIX_LENGTH);
 
     if (m_bar_size > 0) {
         size_t filled = std::min(m_bar_size, (size_t) std::round(m_bar_size * progress)),
-               eta_pos = m_bar_start + m_bar_size + 2;
+               suffix_pos = m_bar_start + m_bar_size + 2;
         memset((char *) m_line.data() + m_bar_start, '=', filled);
-        memset((char *) m_line.data() + eta_pos, ' ', m_line.size() - eta_pos - 1);
-        memcpy((char *) m_line.data() + eta_pos, eta.data(), eta.length());
+        memset((char *) m_line.data() + suffix_pos, ' ', m_line.size() - suffix_pos - 1);
+        memcpy((char *) m_line.data() + suffix_pos, suffix.data(), suffix.length());
     }
 
     Thread::thread()->logger()->log_progress(progress, m_label, m_line,
-                                             eta, m_payload);
+                                             eta, info, m_payload);
     m_last_update = elapsed;
+    m_last_progress = progress;
+    m_next_update.store(elapsed + 500, std::memory_order_relaxed);
 }
 
 MTS_IMPLEMENT_CLASS(ProgressReporter, Object)
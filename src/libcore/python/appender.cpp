@@ -1,4 +1,5 @@
 #include <mitsuba/core/appender.h>
+#include <mitsuba/core/progress.h>
 #include <mitsuba/python/python.h>
 
 // Trampoline for derived types implemented in Python
@@ -21,10 +22,22 @@ public:
         PYBIND11_OVERLOAD_PURE(
             void,          // Return value
             Appender,      // Parent class
-            append,        // Function
+            log_progress,  // Function
             progress, name, formatted, eta, ptr // Arguments
         );
     }
+
+    virtual void log_progress_info(float progress, const std::string &name,
+                                   const std::string &formatted,
+                                   const std::string &eta, const ProgressInfo &info,
+                                   const void *ptr) override {
+        PYBIND11_OVERLOAD(
+            void,              // Return value
+            Appender,          // Parent class
+            log_progress_info, // Function
+            progress, name, formatted, eta, info, ptr // Arguments
+        );
+    }
 };
 
 MTS_PY_EXPORT(Appender) {
@@ -35,14 +48,28 @@ MTS_PY_EXPORT(Appender) {
         .value("Warn", Warn, D(LogLevel, Warn))
         .value("Error", Error, D(LogLevel, Error));
 
+    py::class_<ProgressInfo>(m, "ProgressInfo", D(ProgressInfo))
+        .def(py::init<>())
+        .def_field(ProgressInfo, progress, D(ProgressInfo, progress))
+        .def_field(ProgressInfo, elapsed, D(ProgressInfo, elapsed))
+        .def_field(ProgressInfo, eta, D(ProgressInfo, eta))
+        .def_field(ProgressInfo, samples, D(ProgressInfo, samples))
+        .def_field(ProgressInfo, samples_per_second, D(ProgressInfo, samples_per_second))
+        .def_field(ProgressInfo, rays_per_second, D(ProgressInfo, rays_per_second));
+
     MTS_PY_TRAMPOLINE_CLASS(PyAppender, Appender, Object)
         .def(py::init<>())
         .def_method(Appender, append, "level"_a, "text"_a)
         .def_method(Appender, log_progress, "progress"_a, "name"_a,
-            "formatted"_a, "eta"_a, "ptr"_a = py::none());
+            "formatted"_a, "eta"_a, "ptr"_a = py::none())
+        .def_method(Appender, log_progress_info, "progress"_a, "name"_a,
+            "formatted"_a, "eta"_a, "info"_a, "ptr"_a = py::none());
 
     MTS_PY_CLASS(StreamAppender, Appender)
         .def(py::init<const std::string &>(), D(StreamAppender, StreamAppender))
         .def_method(StreamAppender, logs_to_file)
         .def_method(StreamAppender, read_log);
+
+    MTS_PY_CLASS(ProgressFileAppender, Appender)
+        .def(py::init<const std::string &>(), D(ProgressFileAppender, ProgressFileAppender));
 }
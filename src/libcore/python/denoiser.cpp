@@ -0,0 +1,14 @@
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/denoiser.h>
+#include <mitsuba/python/python.h>
+
+MTS_PY_EXPORT(Denoiser) {
+    MTS_PY_CLASS(Denoiser, Object)
+        .def(py::init<uint32_t, float, float, float>(), "iterations"_a = 5,
+             "sigma_color"_a = 4.f, "sigma_normal"_a = 128.f, "sigma_depth"_a = 1.f,
+             D(Denoiser, Denoiser))
+        .def("denoise", &Denoiser::denoise, "image"_a, "albedo"_a = py::none(),
+             "normal"_a = py::none(), "depth"_a = py::none(), "variance"_a = py::none(),
+             D(Denoiser, denoise), py::call_guard<py::gil_scoped_release>())
+        .def_method(Denoiser, iterations);
+}
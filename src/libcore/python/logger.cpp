@@ -1,6 +1,7 @@
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/appender.h>
 #include <mitsuba/core/formatter.h>
+#include <mitsuba/core/progress.h>
 #include <mitsuba/python/python.h>
 
 /// Submit a log message to the Mitusba logging system and tag it with the Python caller
@@ -17,6 +18,9 @@ static void PyLog(LogLevel level, const std::string &msg) {
     if (!name.empty() && name[0] != '<')
         fmt.insert(2, "()");
 
+    /* Release the GIL: in asynchronous mode, errors wait for the logging
+       thread, which may need to invoke appenders implemented in Python */
+    py::gil_scoped_release release;
     Thread::thread()->logger()->log(
         level, nullptr /* class_ */,
         filename.c_str(), lineno,
@@ -26,12 +30,29 @@ static void PyLog(LogLevel level, const std::string &msg) {
 MTS_PY_EXPORT(Logger) {
     MTS_PY_CLASS(Logger, Object)
         .def(py::init<LogLevel>(), D(Logger, Logger))
-        .def_method(Logger, log_progress, "progress"_a, "name"_a,
-            "formatted"_a, "eta"_a, "ptr"_a = py::none())
+        // The overload taking 'info' is registered first, 'ptr' accepts any object
+        .def("log_progress",
+            py::overload_cast<float, const std::string &, const std::string &,
+                              const std::string &, const ProgressInfo &, const void *>(
+                &Logger::log_progress),
+            "progress"_a, "name"_a, "formatted"_a, "eta"_a, "info"_a,
+            "ptr"_a = py::none(), D(Logger, log_progress, 2))
+        .def("log_progress",
+            py::overload_cast<float, const std::string &, const std::string &,
+                              const std::string &, const void *>(&Logger::log_progress),
+            "progress"_a, "name"_a, "formatted"_a, "eta"_a, "ptr"_a = py::none(),
+            D(Logger, log_progress))
         .def_method(Logger, set_log_level)
         .def_method(Logger, log_level)
         .def_method(Logger, set_error_level)
         .def_method(Logger, error_level)
+        .def_method(Logger, set_async, "value"_a,
+                    py::call_guard<py::gil_scoped_release>())
+        .def_method(Logger, is_async)
+        .def_method(Logger, set_rate_limit, "count"_a,
+                    py::call_guard<py::gil_scoped_release>())
+        .def_method(Logger, rate_limit)
+        .def_method(Logger, flush, py::call_guard<py::gil_scoped_release>())
         .def_method(Logger, add_appender, py::keep_alive<1, 2>())
         .def_method(Logger, remove_appender)
         .def_method(Logger, clear_appenders)
@@ -15,10 +15,12 @@ MTS_PY_DECLARE(Struct);
 MTS_PY_DECLARE(Appender);
 MTS_PY_DECLARE(ArgParser);
 MTS_PY_DECLARE(Bitmap);
+MTS_PY_DECLARE(Denoiser);
 MTS_PY_DECLARE(Formatter);
 MTS_PY_DECLARE(FileResolver);
 MTS_PY_DECLARE(Logger);
 MTS_PY_DECLARE(MemoryMappedFile);
+MTS_PY_DECLARE(MemoryTracker);
 MTS_PY_DECLARE(Stream);
 MTS_PY_DECLARE(DummyStream);
 MTS_PY_DECLARE(FileStream);
@@ -60,6 +62,18 @@ PYBIND11_MODULE(core_ext, m) {
     m.attr("MTS_ENABLE_EMBREE") = false;
 #endif
 
+#if defined(MTS_ENABLE_PROFILER)
+    m.attr("MTS_ENABLE_PROFILER") = true;
+#else
+    m.attr("MTS_ENABLE_PROFILER") = false;
+#endif
+
+#if defined(MTS_ENABLE_STATS)
+    m.attr("MTS_ENABLE_STATS") = true;
+#else
+    m.attr("MTS_ENABLE_STATS") = false;
+#endif
+
     Jit::static_initialization();
     Class::static_initialization();
     Thread::static_initialization();
@@ -109,10 +123,12 @@ PYBIND11_MODULE(core_ext, m) {
     MTS_PY_IMPORT(rfilter);
     MTS_PY_IMPORT(Stream);
     MTS_PY_IMPORT(Bitmap);
+    MTS_PY_IMPORT(Denoiser);
     MTS_PY_IMPORT(Formatter);
     MTS_PY_IMPORT(FileResolver);
     MTS_PY_IMPORT(Logger);
     MTS_PY_IMPORT(MemoryMappedFile);
+    MTS_PY_IMPORT(MemoryTracker);
     MTS_PY_IMPORT(DummyStream);
     MTS_PY_IMPORT(FileStream);
     MTS_PY_IMPORT(MemoryStream);
@@ -0,0 +1,31 @@
+#include <mitsuba/core/memtrack.h>
+#include <mitsuba/python/python.h>
+
+MTS_PY_EXPORT(MemoryTracker) {
+    auto e = py::enum_<MemoryCategory>(m, "MemoryCategory", D(MemoryCategory));
+    for (int i = 0; i < int(MemoryCategory::MemoryCategoryCount); ++i)
+        e.value(memory_category_id[i], MemoryCategory(i));
+
+    MTS_PY_CLASS(MemoryTracker, Object)
+        .def_static("allocate", &MemoryTracker::allocate, "category"_a, "size"_a,
+                    D(MemoryTracker, allocate))
+        .def_static("release", &MemoryTracker::release, "category"_a, "size"_a,
+                    D(MemoryTracker, release))
+        .def_static("current", &MemoryTracker::current, "category"_a,
+                    D(MemoryTracker, current))
+        .def_static("peak", &MemoryTracker::peak, "category"_a, D(MemoryTracker, peak))
+        .def_static("current_total", &MemoryTracker::current_total,
+                    D(MemoryTracker, current_total))
+        .def_static("peak_total", &MemoryTracker::peak_total, D(MemoryTracker, peak_total))
+        .def_static("reset_peak", &MemoryTracker::reset_peak, D(MemoryTracker, reset_peak))
+        .def_static("print_report", &MemoryTracker::print_report,
+                    D(MemoryTracker, print_report))
+        .def_static("usage", []() {
+            py::dict result;
+            for (int i = 0; i < int(MemoryCategory::MemoryCategoryCount); ++i)
+                result[memory_category_id[i]] =
+                    py::make_tuple(MemoryTracker::current(MemoryCategory(i)),
+                                   MemoryTracker::peak(MemoryCategory(i)));
+            return result;
+        }, "Return a dictionary mapping category names to (current, peak) usage in bytes");
+}
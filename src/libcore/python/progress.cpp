@@ -54,11 +54,24 @@ public:
     virtual void log_progress(float progress, const std::string &name,
         const std::string & /* formatted */, const std::string &eta,
         const void * /* ptr */) override {
+        update_progress_bar(progress, escape_html(name) + " " + eta);
+    }
+
+    virtual void log_progress_info(float progress, const std::string &name,
+        const std::string & /* formatted */, const std::string &eta,
+        const ProgressInfo &info, const void * /* ptr */) override {
+        std::string label = escape_html(name) + " " + eta;
+        if (info.samples_per_second > 0)
+            label += tfm::format(" %.3g samples/s", info.samples_per_second);
+        update_progress_bar(progress, label);
+    }
+
+    void update_progress_bar(float progress, const std::string &label) {
         py::gil_scoped_acquire gil;
         if (m_label.is_none() || m_bar.is_none())
             make_progress_bar();
         m_bar.attr("value") = progress;
-        m_label.attr("value") = escape_html(name) + " " + eta;
+        m_label.attr("value") = label;
         if (progress == 1.f) {
             m_bar.attr("bar_style") = "success";
             m_label = m_bar = py::none();
@@ -89,6 +102,12 @@ private:
 };
 
 MTS_PY_EXPORT(ProgressReporter) {
+    MTS_PY_CLASS(ProgressReporter, Object)
+        .def(py::init<const std::string &, void *, size_t>(), "label"_a,
+             "payload"_a = py::none(), "total"_a = 0, D(ProgressReporter, ProgressReporter))
+        .def_method(ProgressReporter, update, "progress"_a)
+        .def_method(ProgressReporter, advance, "work"_a = 1, "samples"_a = 0);
+
     /* Install a custom appender for log + progress messages if Mitsuba is
      * running within Jupyter notebook */
     py::object modules = py::module::import("sys").attr("modules");
@@ -98,5 +117,4 @@ MTS_PY_EXPORT(ProgressReporter) {
     Logger *logger = Thread::thread()->logger();
     logger->clear_appenders();
     logger->add_appender(new JupyterNotebookAppender());
-    (void) m;
 }
@@ -10,7 +10,8 @@ MTS_PY_EXPORT(xml) {
 
     m.def(
         "load_file",
-        [](const std::string &name, bool update_scene, py::kwargs kwargs) {
+        [](const std::string &name, bool update_scene, bool use_cache,
+           bool stream_objects, py::kwargs kwargs) {
             xml::ParameterList param;
             if (kwargs) {
                 for (auto [k, v] : kwargs)
@@ -22,13 +23,16 @@ MTS_PY_EXPORT(xml) {
             py::gil_scoped_release release;
             return cast_object(
                 xml::load_file(
-                    name, mitsuba::detail::get_variant<Float, Spectrum>(), param, update_scene));
+                    name, mitsuba::detail::get_variant<Float, Spectrum>(), param, update_scene,
+                    use_cache, stream_objects));
         },
-        "path"_a, "update_scene"_a = false, D(xml, load_file));
+        "path"_a, "update_scene"_a = false, "use_cache"_a = false,
+        "stream_objects"_a = false,
+        D(xml, load_file));
 
     m.def(
         "load_string",
-        [](const std::string &name, py::kwargs kwargs) {
+        [](const std::string &name, bool stream_objects, py::kwargs kwargs) {
             xml::ParameterList param;
             if (kwargs) {
                 for (auto [k, v] : kwargs)
@@ -39,7 +43,8 @@ MTS_PY_EXPORT(xml) {
             }
             py::gil_scoped_release release;
             return cast_object(
-                xml::load_string(name, mitsuba::detail::get_variant<Float, Spectrum>(), param));
+                xml::load_string(name, mitsuba::detail::get_variant<Float, Spectrum>(), param,
+                                 stream_objects));
         },
-        "string"_a, D(xml, load_string));
+        "string"_a, "stream_objects"_a = false, D(xml, load_string));
 }
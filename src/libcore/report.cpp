@@ -0,0 +1,104 @@
+#include <mitsuba/core/report.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/memtrack.h>
+#include <mitsuba/core/util.h>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+NAMESPACE_BEGIN(mitsuba)
+
+using Clock = std::chrono::steady_clock;
+
+/// Accumulated timings of a stage
+struct ReportStageData {
+    /// Number of threads currently within the stage
+    size_t active = 0;
+    /// Wall clock and process CPU time when the stage was last entered
+    Clock::time_point wall_start;
+    double cpu_start = 0.0;
+    /// Accumulated wall clock and CPU time in seconds
+    double wall = 0.0, cpu = 0.0;
+    /// Number of times the stage was entered
+    size_t count = 0;
+};
+
+/* Stages are coarse-grained (a handful of events per loaded object), so a
+   single lock is adequate here */
+static std::mutex report_mutex;
+static ReportStageData report_stages[int(ReportStage::ReportStageCount)];
+static std::map<std::string, double> report_values;
+
+void RenderReport::reset() {
+    std::lock_guard<std::mutex> guard(report_mutex);
+    for (auto &stage : report_stages) {
+        size_t active = stage.active;
+        stage = ReportStageData();
+        // Stages that are in progress keep running from now on
+        if (active > 0) {
+            stage.active = active;
+            stage.wall_start = Clock::now();
+            stage.cpu_start = util::process_cpu_time();
+        }
+    }
+    report_values.clear();
+    MemoryTracker::reset_peak();
+}
+
+void RenderReport::begin_stage(ReportStage stage) {
+    std::lock_guard<std::mutex> guard(report_mutex);
+    ReportStageData &data = report_stages[int(stage)];
+    data.count++;
+    if (data.active++ == 0) {
+        data.wall_start = Clock::now();
+        data.cpu_start = util::process_cpu_time();
+    }
+}
+
+void RenderReport::end_stage(ReportStage stage) {
+    std::lock_guard<std::mutex> guard(report_mutex);
+    ReportStageData &data = report_stages[int(stage)];
+    if (data.active == 0)
+        return; // reset() was called in between
+    if (--data.active == 0) {
+        data.wall += std::chrono::duration<double>(Clock::now() - data.wall_start).count();
+        data.cpu += util::process_cpu_time() - data.cpu_start;
+    }
+}
+
+void RenderReport::set_value(const std::string &name, double value) {
+    std::lock_guard<std::mutex> guard(report_mutex);
+    report_values[name] = value;
+}
+
+void RenderReport::write_json(const fs::path &filename) {
+    std::ofstream os(filename.native());
+    if (!os.good())
+        Throw("RenderReport::write_json(): could not open \"%s\"", filename);
+
+    std::lock_guard<std::mutex> guard(report_mutex);
+    os << "{\n  \"stages\": {";
+    for (int i = 0; i < int(ReportStage::ReportStageCount); ++i) {
+        const ReportStageData &data = report_stages[i];
+        os << (i == 0 ? "\n" : ",\n") << "    \"" << report_stage_id[i]
+           << "\": { \"wall_s\": " << data.wall << ", \"cpu_s\": " << data.cpu
+           << ", \"count\": " << data.count << " }";
+    }
+
+    os << "\n  },\n  \"peak_rss_bytes\": " << util::peak_memory_usage()
+       << ",\n  \"memory_bytes\": {";
+    for (int i = 0; i < int(MemoryCategory::MemoryCategoryCount); ++i)
+        os << (i == 0 ? "\n" : ",\n") << "    \"" << memory_category_id[i]
+           << "\": " << MemoryTracker::peak(MemoryCategory(i));
+    os << "\n  },\n  \"memory_total_bytes\": " << MemoryTracker::peak_total();
+
+    for (auto const &[name, value] : report_values)
+        os << ",\n  \"" << name << "\": " << value;
+    os << "\n}\n";
+    Log(Info, "Wrote render report to \"%s\"", filename);
+}
+
+MTS_IMPLEMENT_CLASS(RenderReport, Object)
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,231 @@
+#include <mitsuba/core/stats.h>
+
+#if defined(MTS_ENABLE_STATS)
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/string.h>
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/* Every thread increments its own (zero-initialized) block of counters,
+   hence no atomic operations are required. The blocks are never released so
+   that counts of threads that have already exited remain available. */
+static std::mutex stats_mutex;
+static std::vector<std::unique_ptr<StatsData>> stats_threads;
+static thread_local StatsData *stats_thread = nullptr;
+
+StatsData *stats_data() {
+    if (unlikely(!stats_thread)) {
+        std::lock_guard<std::mutex> guard(stats_mutex);
+        stats_threads.emplace_back(new StatsData());
+        stats_thread = stats_threads.back().get();
+    }
+    return stats_thread;
+}
+
+void stats_count_object(uint32_t handle) {
+    std::vector<uint64_t> &calls = stats_data()->objects[handle & 3];
+    size_t index = handle >> 2;
+    if (unlikely(index >= calls.size()))
+        calls.resize(index + 1);
+    calls[index]++;
+}
+
+/// Sum of the per-thread counters and histograms
+static StatsData stats_merge() {
+    std::lock_guard<std::mutex> guard(stats_mutex);
+    StatsData result {};
+    for (auto const &data : stats_threads) {
+        for (int i = 0; i < int(StatsCounter::StatsCounterCount); ++i)
+            result.counters[i] += data->counters[i];
+        for (int i = 0; i < int(StatsHistogram::StatsHistogramCount); ++i)
+            for (int j = 0; j < MTS_STATS_HISTOGRAM_BINS; ++j)
+                result.histograms[i][j] += data->histograms[i][j];
+        for (int i = 0; i < int(ProfilerObjectType::ProfilerObjectTypeCount); ++i) {
+            const std::vector<uint64_t> &calls = data->objects[i];
+            std::vector<uint64_t> &total = result.objects[i];
+            if (total.size() < calls.size())
+                total.resize(calls.size());
+            for (size_t j = 0; j < calls.size(); ++j)
+                total[j] += calls[j];
+        }
+    }
+    return result;
+}
+
+/// Most frequently invoked objects of the given type: (name, invocations)
+static std::vector<std::pair<std::string, uint64_t>>
+stats_top_objects(const StatsData &data, int type) {
+    std::vector<std::pair<uint32_t, uint64_t>> list;
+    const std::vector<uint64_t> &calls = data.objects[type];
+    for (size_t j = 0; j < calls.size(); ++j) {
+        if (calls[j] > 0)
+            list.emplace_back(((uint32_t) j << 2) | (uint32_t) type, calls[j]);
+    }
+    std::sort(list.begin(), list.end(),
+              [](const auto &a, const auto &b) { return a.second > b.second; });
+    if (list.size() > MTS_STATS_TOP_OBJECTS)
+        list.resize(MTS_STATS_TOP_OBJECTS);
+
+    std::vector<std::pair<std::string, uint64_t>> result;
+    for (auto const &[handle, count] : list)
+        result.emplace_back(profiler_object_name(handle), count);
+    return result;
+}
+
+/// Quantities derived from the raw counters: (description, value, unit)
+static std::vector<std::tuple<std::string, double, std::string>>
+stats_derived(const StatsData &data, double render_time) {
+    auto counter = [&](StatsCounter c) { return (double) data.counters[int(c)]; };
+    auto ratio = [](double a, double b) { return b > 0 ? a / b : 0.0; };
+
+    std::vector<std::tuple<std::string, double, std::string>> result;
+    double rays = counter(StatsCounter::IntersectRays) + counter(StatsCounter::ShadowRays);
+
+    if (render_time > 0) {
+        result.emplace_back("Rays per second", rays / render_time, "rays/s");
+        result.emplace_back("Camera rays per second",
+                            counter(StatsCounter::CameraRays) / render_time, "rays/s");
+    }
+
+    result.emplace_back("Intersection hit ratio",
+                        100 * ratio(counter(StatsCounter::IntersectHits),
+                                    counter(StatsCounter::IntersectRays)), "%");
+    result.emplace_back("Shadow ray occlusion ratio",
+                        100 * ratio(counter(StatsCounter::ShadowRaysOccluded),
+                                    counter(StatsCounter::ShadowRays)), "%");
+    result.emplace_back("kd-tree nodes per ray",
+                        ratio(counter(StatsCounter::KDTreeNodes),
+                              counter(StatsCounter::KDTreeTraversals)), "");
+    result.emplace_back("kd-tree primitives per ray",
+                        ratio(counter(StatsCounter::KDTreePrimitives),
+                              counter(StatsCounter::KDTreeTraversals)), "");
+    result.emplace_back("BSDF samples with zero weight",
+                        100 * ratio(counter(StatsCounter::BSDFSamplesZero),
+                                    counter(StatsCounter::BSDFSamples)), "%");
+
+    const uint64_t *path_length = data.histograms[int(StatsHistogram::PathLength)];
+    double paths = 0, vertices = 0;
+    for (int i = 0; i < MTS_STATS_HISTOGRAM_BINS; ++i) {
+        paths += (double) path_length[i];
+        vertices += (double) path_length[i] * i;
+    }
+    result.emplace_back("Average path length", ratio(vertices, paths), "");
+
+    return result;
+}
+
+void Statistics::reset() {
+    std::lock_guard<std::mutex> guard(stats_mutex);
+    for (auto &data : stats_threads)
+        *data = StatsData{};
+}
+
+uint64_t Statistics::counter(StatsCounter counter) {
+    /* Other threads may concurrently increment their counters, which is
+       benign here since the result only serves as an estimate */
+    std::lock_guard<std::mutex> guard(stats_mutex);
+    uint64_t result = 0;
+    for (auto const &data : stats_threads)
+        result += data->counters[int(counter)];
+    return result;
+}
+
+void Statistics::print_report(double render_time) {
+    StatsData data = stats_merge();
+
+    size_t width = 0;
+    for (auto const &name : stats_counter_id)
+        width = std::max(width, strlen(name));
+    auto derived = stats_derived(data, render_time);
+    for (auto const &d : derived)
+        width = std::max(width, std::get<0>(d).length());
+    width += 4;
+
+    Log(Info, "\U0001F4CA Statistics:");
+    for (int i = 0; i < int(StatsCounter::StatsCounterCount); ++i)
+        Log(Info, "    %s%s%i", stats_counter_id[i],
+            std::string(width - strlen(stats_counter_id[i]), ' '), data.counters[i]);
+
+    for (auto const &[name, value, unit] : derived)
+        Log(Info, "    %s%s%.2f %s", name, std::string(width - name.length(), ' '),
+            value, unit);
+
+    for (int i = 0; i < int(StatsHistogram::StatsHistogramCount); ++i) {
+        const uint64_t *bins = data.histograms[i];
+        uint64_t total = 0;
+        for (int j = 0; j < MTS_STATS_HISTOGRAM_BINS; ++j)
+            total += bins[j];
+        if (total == 0)
+            continue;
+        Log(Info, "    %s histogram:", stats_histogram_id[i]);
+        for (int j = 0; j < MTS_STATS_HISTOGRAM_BINS; ++j) {
+            if (bins[j] == 0)
+                continue;
+            Log(Info, "      %s%i: %.2f%% (%i)",
+                j == MTS_STATS_HISTOGRAM_BINS - 1 ? ">= " : "", j,
+                bins[j] * 100.0 / total, bins[j]);
+        }
+    }
+
+    for (int i = 0; i < int(ProfilerObjectType::ProfilerObjectTypeCount); ++i) {
+        auto objects = stats_top_objects(data, i);
+        if (objects.empty())
+            continue;
+        size_t name_width = 0;
+        for (auto const &kv : objects)
+            name_width = std::max(name_width, kv.first.length());
+        Log(Info, "    Most frequently invoked %s:", profiler_object_type_id[i]);
+        for (auto const &[name, count] : objects)
+            Log(Info, "      %s%s%i", name,
+                std::string(name_width - name.length() + 4, ' '), count);
+    }
+}
+
+void Statistics::write_json(const fs::path &filename, double render_time) {
+    StatsData data = stats_merge();
+    std::ofstream os(filename.native());
+    if (!os.good())
+        Throw("Statistics::write_json(): could not open \"%s\"", filename);
+
+    os << "{\n  \"render_time_s\": " << render_time << ",\n  \"counters\": {";
+    for (int i = 0; i < int(StatsCounter::StatsCounterCount); ++i)
+        os << (i == 0 ? "\n" : ",\n") << "    \"" << stats_counter_id[i]
+           << "\": " << data.counters[i];
+
+    os << "\n  },\n  \"derived\": {";
+    bool first = true;
+    for (auto const &[name, value, unit] : stats_derived(data, render_time)) {
+        os << (first ? "\n" : ",\n") << "    \"" << name << "\": " << value;
+        first = false;
+    }
+
+    os << "\n  },\n  \"histograms\": {";
+    for (int i = 0; i < int(StatsHistogram::StatsHistogramCount); ++i) {
+        os << (i == 0 ? "\n" : ",\n") << "    \"" << stats_histogram_id[i] << "\": [";
+        for (int j = 0; j < MTS_STATS_HISTOGRAM_BINS; ++j)
+            os << (j == 0 ? "" : ", ") << data.histograms[i][j];
+        os << "]";
+    }
+
+    os << "\n  },\n  \"objects\": {";
+    for (int i = 0; i < int(ProfilerObjectType::ProfilerObjectTypeCount); ++i) {
+        os << (i == 0 ? "\n" : ",\n") << "    \"" << profiler_object_type_id[i] << "\": [";
+        auto objects = stats_top_objects(data, i);
+        for (size_t j = 0; j < objects.size(); ++j)
+            os << (j == 0 ? "\n" : ",\n") << "      { \"name\": "
+               << string::json_string(objects[j].first)
+               << ", \"invocations\": " << objects[j].second << " }";
+        os << (objects.empty() ? "]" : "\n    ]");
+    }
+    os << "\n  }\n}\n";
+    Log(Info, "Wrote statistics to \"%s\"", filename);
+}
+
+MTS_IMPLEMENT_CLASS(Statistics, Object)
+NAMESPACE_END(mitsuba)
+#endif
@@ -1,5 +1,6 @@
 #include <mitsuba/core/string.h>
 #include <mitsuba/core/object.h>
+#include <cstdio>
 
 NAMESPACE_BEGIN(mitsuba)
 NAMESPACE_BEGIN(string)
@@ -52,5 +53,29 @@ std::string trim(const std::string &s, const std::string &whitespace) {
     return s.substr(it1, it2 - it1 + 1);
 }
 
+std::string json_string(const std::string &s) {
+    std::string result = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\b': result += "\\b"; break;
+            case '\f': result += "\\f"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if ((unsigned char) c < 0x20) {
+                    char buf[7];
+                    snprintf(buf, sizeof(buf), "\\u%04x", (unsigned int) c);
+                    result += buf;
+                } else {
+                    result += c;
+                }
+        }
+    }
+    return result + "\"";
+}
+
 NAMESPACE_END(string)
 NAMESPACE_END(mitsuba)
@@ -4,6 +4,7 @@
 #include <mitsuba/core/stream.h>
 #include <mitsuba/core/hash.h>
 #include <mitsuba/core/jit.h>
+#include <mitsuba/core/qmc.h>
 #include <enoki/array.h>
 #include <enoki/half.h>
 #include <enoki/color.h>
@@ -18,9 +19,6 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
-// Defined in dither-matrix256.cpp
-extern const float dither_matrix256[65536];
-
 NAMESPACE_BEGIN(detail)
 
 #if defined(DOUBLE_PRECISION)
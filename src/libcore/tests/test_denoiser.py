@@ -0,0 +1,95 @@
+import pytest
+import enoki as ek
+import numpy as np
+
+
+def make_bitmap(array):
+    from mitsuba.core import Bitmap
+    return Bitmap(np.ascontiguousarray(array, dtype=np.float32))
+
+
+def denoise(denoiser, image, **kwargs):
+    guides = { k: make_bitmap(v) for k, v in kwargs.items() }
+    return np.array(denoiser.denoise(make_bitmap(image), **guides), copy=True)
+
+
+def rmse(a, b):
+    return np.sqrt(np.mean((a - b) ** 2))
+
+
+def test01_create(variant_scalar_rgb):
+    from mitsuba.core import Denoiser
+
+    denoiser = Denoiser(iterations=3)
+    assert denoiser.iterations() == 3
+    assert 'sigma_color' in str(denoiser)
+
+    with pytest.raises(RuntimeError):
+        Denoiser(sigma_color=0)
+
+
+def test02_constant(variant_scalar_rgb):
+    """A constant image is left unchanged, including its alpha channel"""
+    from mitsuba.core import Denoiser
+
+    image = np.zeros((16, 20, 4))
+    image[:, :, :3] = [0.2, 0.4, 0.6]
+    image[:, :, 3] = np.linspace(0, 1, 20)
+
+    result = denoise(Denoiser(), image)
+    assert result.shape == image.shape
+    assert ek.allclose(result, image, atol=1e-6)
+
+
+def test03_noise(variant_scalar_rgb):
+    """The error of a noisy gradient is reduced"""
+    from mitsuba.core import Denoiser
+
+    np.random.seed(1234)
+    ref = np.zeros((64, 64, 3))
+    ref[:, :, :] = np.linspace(0.4, 0.6, 64)[None, :, None]
+    noisy = ref + np.random.normal(0, 0.1, ref.shape)
+
+    result = denoise(Denoiser(iterations=3), noisy)
+    assert rmse(result, ref) < 0.3 * rmse(noisy, ref)
+
+    # Providing the (known) variance of the luminance gives a similar result
+    variance = np.full((64, 64, 1), 0.01 * (0.212671 ** 2 + 0.715160 ** 2 + 0.072169 ** 2))
+    result = denoise(Denoiser(iterations=3), noisy, variance=variance)
+    assert rmse(result, ref) < 0.3 * rmse(noisy, ref)
+
+
+def test04_edges(variant_scalar_rgb):
+    """The edges of the normal and albedo guides are preserved"""
+    from mitsuba.core import Denoiser
+
+    np.random.seed(1234)
+    albedo = np.zeros((32, 32, 3))
+    albedo[:, :16] = 0.2
+    albedo[:, 16:] = 0.8
+    normal = np.zeros((32, 32, 3))
+    normal[:, :16, 2] = 1
+    normal[:, 16:, 0] = 1
+
+    ref = albedo.copy()
+    noisy = ref * (1 + np.random.normal(0, 0.2, ref.shape))
+
+    for guides in [{ 'albedo': albedo }, { 'normal': normal }]:
+        result = denoise(Denoiser(), noisy, **guides)
+        assert rmse(result, ref) < 0.5 * rmse(noisy, ref)
+
+        # The columns next to the edge don't bleed into each other
+        assert ek.allclose(np.mean(result[:, 15]), 0.2, rtol=5e-2)
+        assert ek.allclose(np.mean(result[:, 16]), 0.8, rtol=5e-2)
+
+
+def test05_mismatch(variant_scalar_rgb):
+    from mitsuba.core import Denoiser
+
+    image = np.ones((8, 8, 3))
+    with pytest.raises(RuntimeError):
+        denoise(Denoiser(), image, albedo=np.ones((8, 4, 3)))
+    with pytest.raises(RuntimeError):
+        denoise(Denoiser(), image, depth=np.ones((8, 8, 3)))
+    with pytest.raises(RuntimeError):
+        denoise(Denoiser(), np.ones((8, 8, 2)))
@@ -41,3 +41,129 @@ def test01_custom(variant_scalar_rgb):
         for app in appenders:
             logger.add_appender(app)
         logger.set_formatter(formatter)
+
+
+def test02_rate_limit_async(variant_scalar_rgb):
+    from mitsuba.core import Thread, Appender, Formatter, Log, LogLevel
+
+    messages = []
+
+    logger = Thread.thread().logger()
+    formatter = logger.formatter()
+    appenders = []
+    while logger.appender_count() > 0:
+        app = logger.appender(0)
+        appenders.append(app)
+        logger.remove_appender(app)
+
+    try:
+        class MyFormatter(Formatter):
+            def format(self, level, theClass, thread, filename, line, msg):
+                return msg
+
+        class MyAppender(Appender):
+            def append(self, level, text):
+                messages.append(text)
+
+        logger.set_formatter(MyFormatter())
+        logger.add_appender(MyAppender())
+
+        # Repeated messages are collapsed, others limited per call site
+        logger.set_rate_limit(2)
+        for i in range(5):
+            Log(LogLevel.Info, "repeated")
+        for i in range(5):
+            Log(LogLevel.Info, "message %i" % i)
+        logger.flush()
+        assert len(messages) == 5
+        assert messages[0].endswith("repeated")
+        assert messages[1] == "Last message repeated 4 times."
+        assert messages[2].endswith("message 0")
+        assert messages[3].endswith("message 1")
+        assert messages[4] == "Suppressed 3 further messages from this location."
+
+        # Messages are processed by a background thread in asynchronous mode
+        messages.clear()
+        logger.set_rate_limit(0)
+        logger.set_async(True)
+        assert logger.is_async()
+        for i in range(100):
+            Log(LogLevel.Info, "message %i" % i)
+        logger.flush()
+        assert len(messages) == 100
+        assert all(m.endswith("message %i" % i) for i, m in enumerate(messages))
+
+        # Errors logged by appenders on the background thread don't deadlock it
+        class FailingAppender(Appender):
+            def append(self, level, text):
+                if text.endswith("fail"):
+                    Log(LogLevel.Error, "appender failure")
+
+        messages.clear()
+        logger.add_appender(FailingAppender())
+        Log(LogLevel.Info, "fail")
+        Log(LogLevel.Info, "after")
+
+        # Disabling asynchronous mode processes all pending messages
+        logger.set_async(False)
+        assert len(messages) == 2
+        assert messages[0].endswith("fail") and messages[1].endswith("after")
+    finally:
+        logger.set_async(False)
+        logger.set_rate_limit(0)
+        logger.clear_appenders()
+        for app in appenders:
+            logger.add_appender(app)
+        logger.set_formatter(formatter)
+
+
+def test03_progress(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import (Thread, Appender, ProgressReporter,
+                              ProgressFileAppender)
+    import json
+
+    infos, updates = [], []
+
+    class MyAppender(Appender):
+        def append(self, level, text):
+            pass
+
+        def log_progress(self, progress, name, formatted, eta, ptr=None):
+            pass
+
+        def log_progress_info(self, progress, name, formatted, eta, info, ptr=None):
+            infos.append((name, info.progress, info.samples, info.eta))
+
+    # Appenders that only implement log_progress() still receive the updates
+    class LegacyAppender(Appender):
+        def append(self, level, text):
+            pass
+
+        def log_progress(self, progress, name, formatted, eta, ptr=None):
+            updates.append((name, progress))
+
+    logger = Thread.thread().logger()
+    appenders = [MyAppender(), LegacyAppender()]
+    filename = str(tmpdir.join('progress.json'))
+    file_appender = ProgressFileAppender(filename)
+    for appender in appenders + [file_appender]:
+        logger.add_appender(appender)
+
+    try:
+        progress = ProgressReporter("Test", total=4)
+        for i in range(4):
+            progress.advance(1, 10)
+    finally:
+        for appender in appenders + [file_appender]:
+            logger.remove_appender(appender)
+
+    # The final update is never skipped by the rate limiting
+    assert infos[-1] == ("Test", 1.0, 40, 0.0)
+    assert updates[-1] == ("Test", 1.0)
+
+    with open(filename) as f:
+        data = json.load(f)
+    assert data['name'] == "Test"
+    assert data['progress'] == 1.0
+    assert data['samples'] == 40
+    assert data['done']
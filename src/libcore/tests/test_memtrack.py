@@ -0,0 +1,43 @@
+import pytest
+import mitsuba
+
+
+def test01_allocate_release(variant_scalar_rgb):
+    from mitsuba.core import MemoryTracker, MemoryCategory
+
+    category = MemoryCategory.python
+    current = MemoryTracker.current(category)
+    total = MemoryTracker.current_total()
+
+    MemoryTracker.reset_peak()
+    MemoryTracker.allocate(category, 1000)
+    assert MemoryTracker.current(category) == current + 1000
+    assert MemoryTracker.current_total() == total + 1000
+    MemoryTracker.release(category, 600)
+    assert MemoryTracker.current(category) == current + 400
+    assert MemoryTracker.peak(category) == current + 1000
+    assert MemoryTracker.peak_total() >= total + 1000
+
+    usage = MemoryTracker.usage()
+    assert usage['python'] == (current + 400, current + 1000)
+
+    MemoryTracker.release(category, 400)
+    MemoryTracker.reset_peak()
+    assert MemoryTracker.peak(category) == current
+
+
+def test02_bitmap_texture(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import Bitmap, MemoryTracker, MemoryCategory
+    from mitsuba.core.xml import load_string
+    import numpy as np
+
+    filename = str(tmpdir.join('texture.exr'))
+    Bitmap(np.ones((16, 32, 3), dtype=np.float32)).write(filename)
+
+    before = MemoryTracker.current(MemoryCategory.textures)
+    texture = load_string("""<texture type="bitmap" version="2.0.0">
+        <string name="filename" value="%s"/>
+    </texture>""" % filename)
+    assert MemoryTracker.current(MemoryCategory.textures) > before
+    del texture
+    assert MemoryTracker.current(MemoryCategory.textures) == before
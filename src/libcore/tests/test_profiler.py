@@ -0,0 +1,66 @@
+import json
+import pytest
+import mitsuba
+
+from mitsuba.python.test.util import render_executable
+
+
+def test01_json(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import MTS_ENABLE_PROFILER
+    if not MTS_ENABLE_PROFILER:
+        pytest.skip('Mitsuba was compiled without MTS_ENABLE_PROFILER')
+
+    filename = str(tmpdir.join('profile.json'))
+    render_executable(tmpdir, ['-t', 2, '--profile-json', filename])
+
+    with open(filename) as f:
+        profile = json.load(f)
+
+    assert profile['frequency_hz'] > 0
+    assert profile['samples'] > 0
+
+    # Phases are nested in the hierarchical profile, and listed individually in the flat one
+    names = [p['name'] for p in profile['hierarchical']]
+    assert 'Integrator::render()' in names
+    assert any(n.startswith('Integrator::render()/') for n in names)
+    assert sum(p['samples'] for p in profile['flat']) == profile['samples']
+
+    # Per-thread breakdown: samples of registered threads don't exceed the total
+    threads = profile['threads']
+    assert len(threads) >= 1
+    assert len(set(t['index'] for t in threads)) == len(threads)
+    assert sum(t['samples'] for t in threads) <= profile['samples']
+    for t in threads:
+        assert sum(p['samples'] for p in t['flat']) == t['samples']
+    assert any(any(p['name'].startswith('Integrator::render()') for p in t['hierarchical'])
+               for t in threads)
+
+
+def test02_chrome_trace(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import MTS_ENABLE_PROFILER
+    if not MTS_ENABLE_PROFILER:
+        pytest.skip('Mitsuba was compiled without MTS_ENABLE_PROFILER')
+
+    filename = str(tmpdir.join('profile.trace.json'))
+    render_executable(tmpdir, ['-t', 2, '--profile-trace', filename])
+
+    with open(filename) as f:
+        trace = json.load(f)
+
+    events = trace['traceEvents']
+    thread_ids = set(e['tid'] for e in events if e['ph'] == 'M')
+    intervals = [e for e in events if e['ph'] == 'X']
+    assert len(thread_ids) >= 1
+
+    assert any(e['name'] == 'Integrator::render()' for e in intervals)
+    for e in intervals:
+        assert e['tid'] in thread_ids
+        assert e['ts'] >= 0 and e['dur'] >= 0
+
+    # Nested phases lie within the enclosing render phase of the same thread
+    renders = [e for e in intervals if e['name'] == 'Integrator::render()']
+    for e in intervals:
+        if e['name'] != 'SamplingIntegrator::sample()':
+            continue
+        assert any(r['tid'] == e['tid'] and r['ts'] <= e['ts'] and
+                   e['ts'] + e['dur'] <= r['ts'] + r['dur'] for r in renders)
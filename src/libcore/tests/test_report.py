@@ -0,0 +1,37 @@
+import json
+import os
+import pytest
+import mitsuba
+
+from mitsuba.python.test.util import render_executable
+
+
+def test01_json(variant_scalar_rgb, tmpdir):
+    output = render_executable(tmpdir, ['-t', 2, '-r'])
+
+    # The report is written next to the output image
+    filename = os.path.splitext(output)[0] + '.json'
+    assert os.path.exists(output)
+    assert os.path.exists(filename)
+
+    with open(filename) as f:
+        report = json.load(f)
+
+    stages = report['stages']
+    assert set(stages.keys()) == {'parse', 'geometry', 'textures', 'accel_build',
+                                  'render', 'develop'}
+    for name, stage in stages.items():
+        assert set(stage.keys()) == {'wall_s', 'cpu_s', 'count'}
+        assert stage['wall_s'] >= 0 and stage['cpu_s'] >= 0
+    for name in ['parse', 'geometry', 'accel_build', 'render', 'develop']:
+        assert stages[name]['count'] >= 1
+    assert stages['render']['wall_s'] > 0
+
+    assert report['peak_rss_bytes'] > 0
+    memory = report['memory_bytes']
+    assert memory['geometry'] > 0 and memory['film'] > 0
+    assert report['memory_total_bytes'] >= max(memory.values())
+
+    assert report['thread_count'] == 2
+    assert report['spp'] == 16
+    assert report['samples_per_second'] > 0
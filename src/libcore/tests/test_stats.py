@@ -0,0 +1,59 @@
+import json
+import pytest
+import mitsuba
+
+from mitsuba.python.test.util import render_executable
+
+
+def test01_json(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import MTS_ENABLE_STATS, MTS_ENABLE_EMBREE
+    if not MTS_ENABLE_STATS:
+        pytest.skip('Mitsuba was compiled without MTS_ENABLE_STATS')
+
+    filename = str(tmpdir.join('stats.json'))
+    render_executable(tmpdir, ['-t', 2, '--stats-json', filename])
+
+    with open(filename) as f:
+        stats = json.load(f)
+
+    assert stats['render_time_s'] > 0
+    counters = stats['counters']
+
+    # One camera ray per sample (128x128 pixels, 16 samples per pixel)
+    assert counters['Camera rays'] == 128 * 128 * 16
+    for name in ['Intersection rays', 'Intersection rays (hit)', 'Shadow rays', 'BSDF samples']:
+        assert counters[name] > 0
+    assert counters['Intersection rays (hit)'] <= counters['Intersection rays']
+    assert counters['Shadow rays (occluded)'] <= counters['Shadow rays']
+    if not MTS_ENABLE_EMBREE:
+        assert counters['kd-tree traversals'] > 0
+        assert counters['kd-tree nodes visited'] > 0
+
+    derived = stats['derived']
+    assert derived['Rays per second'] > 0
+    assert derived['Average path length'] > 0
+
+    # Paths of camera rays that hit the scene
+    path_lengths = stats['histograms']['Path length']
+    assert 0 < sum(path_lengths) <= counters['Camera rays']
+
+
+def test02_json_objects(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import MTS_ENABLE_STATS
+    if not MTS_ENABLE_STATS:
+        pytest.skip('Mitsuba was compiled without MTS_ENABLE_STATS')
+
+    # Without --profile-objects, no per-object counts are recorded
+    filename = str(tmpdir.join('stats.json'))
+    render_executable(tmpdir, ['-t', 2, '--stats-json', filename])
+    with open(filename) as f:
+        assert all(len(v) == 0 for v in json.load(f)['objects'].values())
+
+    render_executable(tmpdir, ['-t', 2, '--stats-json', filename,
+                               '--profile-objects', 5])
+    with open(filename) as f:
+        objects = json.load(f)['objects']
+    assert len(objects['materials']) > 0
+    for entry in objects['materials']:
+        assert isinstance(entry['name'], str)
+        assert entry['invocations'] > 0
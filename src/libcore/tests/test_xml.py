@@ -1,3 +1,4 @@
+import os
 import enoki as ek
 import pytest
 import mitsuba
@@ -297,3 +298,109 @@ def test20_upgrade_tree(variant_scalar_rgb):
                                <float name="intIOR" value="1.33"/>
                            </bsdf>
                        </scene>""")
+
+
+def test21_scene_cache(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import xml
+
+    filename = str(tmpdir.join('bsdf.xml'))
+    with open(filename, 'w') as f:
+        f.write("""<bsdf version="2.0.0" type="roughconductor">
+                       <float name="alpha" value="$alpha"/>
+                       <rgb name="specular_reflectance" value="0.1 0.2 0.3"/>
+                   </bsdf>""")
+
+    bsdf1 = xml.load_file(filename, alpha=0.25, use_cache=True)
+    assert os.path.exists(filename + '.cache')
+    bsdf2 = xml.load_file(filename, alpha=0.25, use_cache=True)
+    assert str(bsdf1) == str(bsdf2)
+
+    # Different parameters must not reuse the cached description
+    bsdf3 = xml.load_file(filename, alpha=0.5, use_cache=True)
+    assert str(bsdf3) == str(xml.load_file(filename, alpha=0.5))
+    assert str(bsdf3) != str(bsdf1)
+
+    # Unused parameters are still reported for cached scenes
+    with open(filename, 'w') as f:
+        f.write("""<bsdf version="2.0.0" type="diffuse">
+                       <float name="alpha" value="$alpha"/>
+                   </bsdf>""")
+    for i in range(2):
+        with pytest.raises(Exception) as e:
+            xml.load_file(filename, alpha=0.25, use_cache=True)
+        e.match('unreferenced property')
+
+    # The search paths of the file resolver are part of the cache key
+    from mitsuba.core import Thread, FileResolver
+
+    for name, value in [('a', 0.1), ('b', 0.2)]:
+        tmpdir.mkdir(name).join('inc.xml').write(
+            """<scene version="2.0.0">
+                   <shape type="sphere">
+                       <float name="radius" value="%f"/>
+                   </shape>
+               </scene>""" % value)
+    filename = str(tmpdir.join('scene.xml'))
+    with open(filename, 'w') as f:
+        f.write("""<scene version="2.0.0">
+                       <include filename="inc.xml"/>
+                   </scene>""")
+
+    thread = Thread.thread()
+    fres_old = thread.file_resolver()
+    try:
+        results = []
+        for name in ['a', 'b']:
+            fres = FileResolver(fres_old)
+            fres.prepend(str(tmpdir.join(name)))
+            thread.set_file_resolver(fres)
+            scene = xml.load_file(filename, use_cache=True)
+            results.append(str(scene.shapes()[0]))
+        assert results[0] != results[1]
+    finally:
+        thread.set_file_resolver(fres_old)
+
+
+@pytest.mark.parametrize('stream_objects', [False, True])
+def test22_streaming_references(variant_scalar_rgb, stream_objects):
+    from mitsuba.core import xml
+
+    # Mix of objects that can be instantiated while parsing (backward
+    # references) and ones that must wait for the end of the file
+    shapes = ''.join(["""<shape type="sphere" id="s{i}">
+                             <ref id="{ref}"/>
+                         </shape>""".format(i=i, ref='mat1' if i % 2 == 0 else 'mat2')
+                      for i in range(20)])
+    scene = xml.load_string("""<scene version="2.0.0">
+                                   <bsdf type="diffuse" id="mat1"/>
+                                   {shapes}
+                                   <bsdf type="conductor" id="mat2"/>
+                               </scene>""".format(shapes=shapes), stream_objects=stream_objects)
+    ids = sorted(s.id() for s in scene.shapes())
+    assert ids == sorted('s%i' % i for i in range(20))
+
+    with pytest.raises(Exception) as e:
+        xml.load_string("""<scene version="2.0.0">
+                               <shape type="sphere"><float name="foo" value="1"/></shape>
+                               <shape type="sphere"/>
+                           </scene>""", stream_objects=stream_objects)
+    e.match('unreferenced property')
+
+
+def test23_loader_option_names(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import xml
+
+    # The options of the loader don't shadow scene parameters of the same name
+    scene = """<bsdf version="2.0.0" type="roughconductor">
+                   <float name="alpha" value="$cache"/>
+                   <string name="distribution" value="$streaming"/>
+               </bsdf>"""
+    bsdf = xml.load_string(scene, cache=0.25, streaming='ggx')
+    ref = xml.load_string(scene.replace('$cache', '0.25').replace('$streaming', 'ggx'))
+    assert str(bsdf) == str(ref)
+
+    filename = str(tmpdir.join('bsdf.xml'))
+    with open(filename, 'w') as f:
+        f.write(scene)
+    bsdf2 = xml.load_file(filename, cache=0.25, streaming='ggx', use_cache=True)
+    assert str(bsdf) == str(bsdf2)
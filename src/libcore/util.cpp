@@ -12,13 +12,18 @@
 #  include <unistd.h>
 #  include <limits.h>
 #  include <sys/ioctl.h>
+#  include <sys/resource.h>
+#  include <time.h>
 #elif defined(__OSX__)
 #  include <sys/sysctl.h>
 #  include <mach-o/dyld.h>
 #  include <unistd.h>
 #  include <sys/ioctl.h>
+#  include <sys/resource.h>
+#  include <time.h>
 #elif defined(__WINDOWS__)
 #  include <windows.h>
+#  include <psapi.h>
 #endif
 
 NAMESPACE_BEGIN(mitsuba)
@@ -201,6 +206,41 @@ std::string mem_string(size_t size, bool precise) {
     return tfm::format(precise ? "%.5g %s" : "%.3g %s", value, orders[i]);
 }
 
+size_t peak_memory_usage() {
+#if defined(__WINDOWS__)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return (size_t) counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#  if defined(__OSX__)
+    return (size_t) usage.ru_maxrss; // bytes
+#  else
+    return (size_t) usage.ru_maxrss * 1024; // kilobytes
+#  endif
+#endif
+}
+
+double process_cpu_time() {
+#if defined(__WINDOWS__)
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0.0;
+    auto to_seconds = [](const FILETIME &t) {
+        return ((uint64_t(t.dwHighDateTime) << 32) | t.dwLowDateTime) * 1e-7;
+    };
+    return to_seconds(kernel) + to_seconds(user);
+#else
+    struct timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0)
+        return 0.0;
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
 #if defined(__WINDOWS__) || defined(__LINUX__)
     void MTS_EXPORT __dummySymbol() { }
 #endif
@@ -1,5 +1,6 @@
 #include <cctype>
 #include <fstream>
+#include <iterator>
 #include <set>
 #include <unordered_map>
 
@@ -7,15 +8,18 @@
 #include <mitsuba/core/config.h>
 #include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/fstream.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/math.h>
 #include <mitsuba/core/object.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/profiler.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/report.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
 #include <mitsuba/core/transform.h>
+#include <mitsuba/core/util.h>
 #include <mitsuba/core/vector.h>
 #include <mitsuba/core/xml.h>
 #include <pugixml.hpp>
@@ -226,6 +230,8 @@ struct XMLObject {
     size_t location = 0;
     ref<Object> object;
     tbb::spin_mutex mutex;
+    /// Are all (transitively) referenced objects known? Used by the streaming mode
+    bool resolved = false;
 };
 
 enum class ColorMode {
@@ -259,9 +265,19 @@ struct XMLParseContext {
     std::unordered_map<std::string, XMLObject> instances;
     Transform4f transform;
     size_t id_counter = 0;
+    size_t inline_counter = 0;
+    /// Auxiliary files (<include>, spectrum data) that the parsed result depends on
+    std::vector<fs::path> dependencies;
     bool parallelize;
     ColorMode color_mode;
 
+    /* In streaming mode, resolved top-level objects are instantiated by tasks
+       in this group while the parser keeps adding entries to 'instances'.
+       Insertions hold 'instances_mutex' exclusively, lookups performed by
+       instantiate_node() hold it in shared mode. */
+    tbb::task_group *tasks = nullptr;
+    tbb::spin_rw_mutex instances_mutex;
+
     XMLParseContext(const std::string &variant) : variant(variant) {
         color_mode = MTS_INVOKE_VARIANT(variant, variant_to_color_mode);
 
@@ -271,6 +287,11 @@ struct XMLParseContext {
     }
 
     std::string variant;
+
+    XMLObject &add_instance(const std::string &id) {
+        tbb::spin_rw_mutex::scoped_lock lock(instances_mutex, true);
+        return instances[id];
+    }
 };
 
 /// Helper function to check if attributes are fully specified
@@ -289,6 +310,38 @@ static void check_attributes(XMLSource &src, const pugi::xml_node &node,
 }
 
 
+static ref<Object> instantiate_node(XMLParseContext &ctx, const std::string &id);
+
+/// Streaming mode: instantiate the given object asynchronously while parsing continues
+static void dispatch_node(XMLParseContext &ctx, const std::string &id) {
+    ThreadEnvironment env;
+    ctx.tasks->run([&ctx, id, env]() mutable {
+        ScopedSetThreadEnvironment set_env(env);
+        // Isolate to prevent this thread from picking up unrelated objects while it holds a lock
+        tbb::this_task_arena::isolate([&]() { instantiate_node(ctx, id); });
+    });
+}
+
+/**
+ * Register an inline texture (e.g. created by an <rgb> or <spectrum> tag) as
+ * an anonymous instance. It is created along with all other objects by
+ * \ref instantiate_node(), which keeps the parsed representation free of
+ * object references.
+ */
+static std::string add_inline_texture(XMLSource &src, XMLParseContext &ctx,
+                                      const pugi::xml_node &node,
+                                      const Properties &props) {
+    std::string id = tfm::format("_inline_%i", ctx.inline_counter++);
+    auto &inst = ctx.add_instance(id);
+    inst.props = props;
+    inst.class_ = Class::for_name("Texture", ctx.variant);
+    inst.offset = src.offset;
+    inst.src_id = src.id;
+    inst.location = node.offset_debug();
+    inst.resolved = true;
+    return id;
+}
+
 /// Helper function to split the 'value' attribute into X/Y/Z components
 void expand_value_to_xyz(XMLSource &src, pugi::xml_node &node) {
     if (node.attribute("value")) {
@@ -566,12 +619,25 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                             props_nested.set_named_reference(arg_name, nested_id);
                     }
 
-                    auto &inst = ctx.instances[id];
+                    bool resolved = true;
+                    for (const auto &kv : props_nested.named_references()) {
+                        auto it_ref = ctx.instances.find(kv.second);
+                        resolved &= it_ref != ctx.instances.end() && it_ref->second.resolved;
+                    }
+
+                    auto &inst = ctx.add_instance(id);
                     inst.props = props_nested;
                     inst.class_ = it2->second;
                     inst.offset = src.offset;
                     inst.src_id = src.id;
                     inst.location = node.offset_debug();
+                    inst.resolved = resolved;
+
+                    /* Streaming mode: start instantiating top-level objects
+                       right away if nothing they refer to is still missing */
+                    if (ctx.tasks && resolved && depth == 1)
+                        dispatch_node(ctx, id);
+
                     return std::make_pair(name, id);
                 }
                 break;
@@ -596,11 +662,12 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                     if (it_alias_src == ctx.instances.end())
                         src.throw_error(node, "referenced id \"%s\" not found", alias_src);
 
-                    auto &inst = ctx.instances[alias_dst];
+                    auto &inst = ctx.add_instance(alias_dst);
                     inst.alias = alias_src;
                     inst.offset = src.offset;
                     inst.src_id = src.id;
                     inst.location = node.offset_debug();
+                    inst.resolved = it_alias_src->second.resolved;
 
                     return std::make_pair("", "");
                 }
@@ -631,6 +698,7 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                         src.throw_error(node, "included file \"%s\" not found", filename);
 
                     Log(Info, "Loading included XML file \"%s\" ..", filename);
+                    ctx.dependencies.push_back(filename);
 
                     pugi::xml_document doc;
                     pugi::xml_parse_result result = doc.load_file(filename.native().c_str());
@@ -778,9 +846,7 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                         if (!within_emitter && is_ior)
                             props2.set_bool("unbounded", true);
 
-                        ref<Object> obj = PluginManager::instance()->create_object(
-                            props2, Class::for_name("Texture", ctx.variant));
-                        props.set_object(node.attribute("name").value(), obj);
+                        props.set_named_reference(name, add_inline_texture(src, ctx, node, props2));
                     } else {
                         props.set_color("color", col);
                     }
@@ -814,13 +880,8 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                             props2.set_float("value", value);
                         }
 
-                        ref<Object> obj = PluginManager::instance()->create_object(
-                            props2, Class::for_name("Texture", ctx.variant));
-                        auto expanded = obj->expand();
-                        Assert(expanded.size() <= 1);
-                        if (!expanded.empty())
-                            obj = expanded[0];
-                        props.set_object(node.attribute("name").value(), obj);
+                        props.set_named_reference(node.attribute("name").value(),
+                                                  add_inline_texture(src, ctx, node, props2));
                     } else {
                         /* Parse wavelength:value pairs, either inlined or from an external file.
                            Wavelengths are expected to be specified in increasing order. */
@@ -845,7 +906,10 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                                 values.push_back(value);
                             }
                         } else if (has_filename) {
-                            spectrum_from_file(node.attribute("filename").value(), wavelengths, values);
+                            std::string filename = node.attribute("filename").value();
+                            spectrum_from_file(filename, wavelengths, values);
+                            ctx.dependencies.push_back(
+                                Thread::thread()->file_resolver()->resolve(filename));
                         }
 
                         /* Values are scaled so that integrating the spectrum against the CIE curves
@@ -876,24 +940,29 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
 
                         Properties props2;
 
-                        if (is_regular) {
-                            props2.set_plugin_name("regular");
-                            props2.set_long("size", wavelengths.size());
-                            props2.set_float("lambda_min", wavelengths.front());
-                            props2.set_float("lambda_max", wavelengths.back());
-                            props2.set_pointer("values", values.data());
+                        if (ctx.color_mode == ColorMode::Spectral) {
+                            /* Spectral data is passed on in textual form so that the
+                               parsed representation does not reference local buffers */
+                            auto join = [](const std::vector<Float> &v) {
+                                std::ostringstream oss;
+                                oss.precision(9);
+                                for (size_t n = 0; n < v.size(); ++n)
+                                    oss << (n > 0 ? ", " : "") << v[n];
+                                return oss.str();
+                            };
+
+                            if (is_regular) {
+                                props2.set_plugin_name("regular");
+                                props2.set_float("lambda_min", wavelengths.front());
+                                props2.set_float("lambda_max", wavelengths.back());
+                                props2.set_string("values", join(values));
+                            } else {
+                                props2.set_plugin_name("irregular");
+                                props2.set_string("wavelengths", join(wavelengths));
+                                props2.set_string("values", join(values));
+                            }
                         } else {
-                            props2.set_plugin_name("irregular");
-                            props2.set_long("size", wavelengths.size());
-                            props2.set_pointer("wavelengths", wavelengths.data());
-                            props2.set_pointer("values", values.data());
-                        }
-
-                        ref<Object> obj = PluginManager::instance()->create_object(
-                            props2, Class::for_name("Texture", ctx.variant));
-
-                        // In non-spectral mode, pre-integrate against the CIE matching curves
-                        if (ctx.color_mode != ColorMode::Spectral) {
+                            // In non-spectral mode, pre-integrate against the CIE matching curves
 
                             /// Spectral IOR values are unbounded and require special handling
                             std::string name = node.attribute("name").value();
@@ -902,23 +971,20 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
 
                             Color3f color = spectrum_to_rgb(wavelengths, values, !(within_emitter || is_ior));
 
-                            Properties props3;
                             if (ctx.color_mode == ColorMode::Monochromatic) {
-                                props3 = Properties("uniform");
-                                props3.set_float("value", luminance(color));
+                                props2.set_plugin_name("uniform");
+                                props2.set_float("value", luminance(color));
                             } else {
-                                props3 = Properties(within_emitter ? "srgb_d65" : "srgb");
-                                props3.set_color("color", color);
+                                props2.set_plugin_name(within_emitter ? "srgb_d65" : "srgb");
+                                props2.set_color("color", color);
 
                                 if (!within_emitter && is_ior)
-                                    props3.set_bool("unbounded", true);
+                                    props2.set_bool("unbounded", true);
                             }
-
-                            obj = PluginManager::instance()->create_object(
-                                props3, Class::for_name("Texture", ctx.variant));
                         }
 
-                        props.set_object(node.attribute("name").value(), obj);
+                        props.set_named_reference(node.attribute("name").value(),
+                                                  add_inline_texture(src, ctx, node, props2));
                     }
                 }
                 break;
@@ -1029,11 +1095,16 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
 }
 
 static ref<Object> instantiate_node(XMLParseContext &ctx, const std::string &id) {
-    auto it = ctx.instances.find(id);
-    if (it == ctx.instances.end())
-        Throw("reference to unknown object \"%s\"!", id);
+    XMLObject *inst_ptr;
+    /* acquire lock */ {
+        tbb::spin_rw_mutex::scoped_lock lock(ctx.instances_mutex, false);
+        auto it = ctx.instances.find(id);
+        if (it == ctx.instances.end())
+            Throw("reference to unknown object \"%s\"!", id);
+        inst_ptr = &it->second;
+    }
 
-    auto &inst = it->second;
+    auto &inst = *inst_ptr;
     tbb::spin_mutex::scoped_lock lock(inst.mutex);
 
     if (inst.object) {
@@ -1125,11 +1196,383 @@ static ref<Object> instantiate_node(XMLParseContext &ctx, const std::string &id)
     return inst.object;
 }
 
+// =============================================================
+//! @{ \name Binary cache of the parsed scene description
+// =============================================================
+
+/* The cache stores the contents of \ref XMLParseContext::instances after
+   parsing, i.e. the Properties of every object with all parameters
+   substituted, version upgrades applied and references resolved to
+   identifiers. Loading it skips the XML stage entirely and proceeds
+   directly to \ref instantiate_node(). */
+
+static const char *cache_magic = "MTS_XML_CACHE";
+
+/// Bump whenever the cache layout or the output of \ref parse_xml() changes
+static const uint32_t cache_version = 1;
+
+/// 64-bit FNV-1a hash (stable across platforms and builds)
+static uint64_t fnv1a(const void *ptr, size_t size,
+                      uint64_t hash = 0xcbf29ce484222325ull) {
+    const uint8_t *data = (const uint8_t *) ptr;
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ data[i]) * 0x100000001b3ull;
+    return hash;
+}
+
+static uint64_t fnv1a_string(const std::string &str,
+                             uint64_t hash = 0xcbf29ce484222325ull) {
+    uint64_t length = str.length();
+    hash = fnv1a(&length, sizeof(uint64_t), hash);
+    return fnv1a(str.data(), str.length(), hash);
+}
+
+static std::string read_file(const fs::path &filename) {
+    std::ifstream is(filename.native(), std::ios::binary);
+    if (!is.good())
+        Throw("\"%s\": could not open file!", filename);
+    return std::string(std::istreambuf_iterator<char>(is),
+                       std::istreambuf_iterator<char>());
+}
+
+/**
+ * Compute the cache key of a scene file given its contents, the variant,
+ * parameters, and the search paths of the file resolver (which determine
+ * the targets of <tt>\<include\></tt> tags)
+ */
+static uint64_t cache_key(const std::string &contents, const std::string &variant,
+                          const ParameterList &param) {
+    uint64_t hash = fnv1a_string(MTS_VERSION);
+    hash = fnv1a_string(variant, hash);
+    hash = fnv1a_string(contents, hash);
+    for (const auto &kv : param) {
+        hash = fnv1a_string(kv.first, hash);
+        hash = fnv1a_string(kv.second, hash);
+    }
+    const FileResolver *resolver = Thread::thread()->file_resolver();
+    uint64_t path_count = resolver->size();
+    hash = fnv1a(&path_count, sizeof(uint64_t), hash);
+    for (const fs::path &path : *resolver)
+        hash = fnv1a_string(path.string(), hash);
+    return hash;
+}
+
+static void write_properties(Stream *stream, const Properties &props_) {
+    // Work on a copy: querying entries must not affect the check for unused parameters
+    Properties props(props_);
+    std::vector<std::string> names = props.property_names();
+
+    stream->write(props.plugin_name());
+    stream->write(props.id());
+    stream->write((uint32_t) names.size());
+
+    for (const std::string &name : names) {
+        Properties::Type type = props.type(name);
+        stream->write(name);
+        stream->write((uint8_t) type);
+
+        switch (type) {
+            case Properties::Type::Bool:
+                stream->write((uint8_t) props.bool_(name));
+                break;
+
+            case Properties::Type::Long:
+                stream->write(props.long_(name));
+                break;
+
+            case Properties::Type::Float:
+                stream->write(props.float_(name));
+                break;
+
+            case Properties::Type::String:
+                stream->write(props.string(name));
+                break;
+
+            case Properties::Type::NamedReference:
+                stream->write((const std::string &) props.named_reference(name));
+                break;
+
+            case Properties::Type::Point3f: {
+                    Point3f p = props.point3f(name);
+                    for (size_t i = 0; i < 3; ++i)
+                        stream->write(p[i]);
+                }
+                break;
+
+            case Properties::Type::Vector3f: {
+                    Vector3f v = props.vector3f(name);
+                    for (size_t i = 0; i < 3; ++i)
+                        stream->write(v[i]);
+                }
+                break;
+
+            case Properties::Type::Color: {
+                    Color3f c = props.color(name);
+                    for (size_t i = 0; i < 3; ++i)
+                        stream->write(c[i]);
+                }
+                break;
+
+            case Properties::Type::Transform: {
+                    const Transform4f &t = props.transform(name);
+                    for (size_t i = 0; i < 4; ++i)
+                        for (size_t j = 0; j < 4; ++j)
+                            stream->write(t.matrix(i, j));
+                    for (size_t i = 0; i < 4; ++i)
+                        for (size_t j = 0; j < 4; ++j)
+                            stream->write(t.inverse_transpose(i, j));
+                }
+                break;
+
+            default:
+                Throw("property \"%s\" has a type that cannot be cached", name);
+        }
+    }
+}
+
+static Properties read_properties(Stream *stream) {
+    std::string plugin_name, id;
+    uint32_t count;
+    stream->read(plugin_name);
+    stream->read(id);
+    stream->read(count);
+
+    Properties props(plugin_name);
+    if (!id.empty())
+        props.set_id(id);
+
+    for (uint32_t k = 0; k < count; ++k) {
+        std::string name;
+        uint8_t type;
+        stream->read(name);
+        stream->read(type);
+
+        switch ((Properties::Type) type) {
+            case Properties::Type::Bool: {
+                    uint8_t value;
+                    stream->read(value);
+                    props.set_bool(name, value != 0);
+                }
+                break;
+
+            case Properties::Type::Long: {
+                    int64_t value;
+                    stream->read(value);
+                    props.set_long(name, value);
+                }
+                break;
+
+            case Properties::Type::Float: {
+                    Float value;
+                    stream->read(value);
+                    props.set_float(name, value);
+                }
+                break;
+
+            case Properties::Type::String: {
+                    std::string value;
+                    stream->read(value);
+                    props.set_string(name, value);
+                }
+                break;
+
+            case Properties::Type::NamedReference: {
+                    std::string value;
+                    stream->read(value);
+                    props.set_named_reference(name, value);
+                }
+                break;
+
+            case Properties::Type::Point3f:
+            case Properties::Type::Vector3f:
+            case Properties::Type::Color: {
+                    Vector3f v;
+                    for (size_t i = 0; i < 3; ++i)
+                        stream->read(v[i]);
+                    if ((Properties::Type) type == Properties::Type::Point3f)
+                        props.set_point3f(name, v);
+                    else if ((Properties::Type) type == Properties::Type::Vector3f)
+                        props.set_vector3f(name, v);
+                    else
+                        props.set_color(name, Color3f(v.x(), v.y(), v.z()));
+                }
+                break;
+
+            case Properties::Type::Transform: {
+                    Matrix4f matrix, inverse_transpose;
+                    for (size_t i = 0; i < 4; ++i)
+                        for (size_t j = 0; j < 4; ++j)
+                            stream->read(matrix(i, j));
+                    for (size_t i = 0; i < 4; ++i)
+                        for (size_t j = 0; j < 4; ++j)
+                            stream->read(inverse_transpose(i, j));
+                    props.set_transform(name, Transform4f(matrix, inverse_transpose));
+                }
+                break;
+
+            default:
+                Throw("invalid property type %i", (int) type);
+        }
+    }
+
+    return props;
+}
+
+/// Write the parsed scene description to \c cache_path
+static void write_cache(const fs::path &cache_path, uint64_t key,
+                        const XMLParseContext &ctx, const std::string &scene_id) {
+    fs::path tmp_path = cache_path.string() + ".tmp";
+    try {
+        ref<FileStream> stream = new FileStream(tmp_path, FileStream::ETruncReadWrite);
+        stream->write(std::string(cache_magic));
+        stream->write(cache_version);
+        stream->write(key);
+
+        stream->write((uint32_t) ctx.dependencies.size());
+        for (const fs::path &path : ctx.dependencies) {
+            stream->write(path.string());
+            stream->write(fnv1a_string(read_file(path)));
+        }
+
+        stream->write(scene_id);
+        stream->write((uint64_t) ctx.instances.size());
+        for (const auto &kv : ctx.instances) {
+            const XMLObject &inst = kv.second;
+            stream->write(kv.first);
+            stream->write(inst.class_ ? inst.class_->name() : std::string());
+            stream->write(inst.alias);
+            stream->write(inst.src_id);
+            stream->write((uint64_t) inst.location);
+            if (inst.class_)
+                write_properties(stream, inst.props);
+        }
+        size_t size = stream->size();
+        stream->close();
+
+        fs::remove(cache_path);
+        if (!fs::rename(tmp_path, cache_path))
+            Throw("unable to rename \"%s\" to \"%s\"", tmp_path, cache_path);
+        Log(Info, "Wrote scene cache \"%s\" (%s)", cache_path, util::mem_string(size));
+    } catch (const std::exception &e) {
+        Log(Warn, "Could not write scene cache \"%s\": %s", cache_path, e.what());
+        if (fs::exists(tmp_path))
+            fs::remove(tmp_path);
+    }
+}
+
+/**
+ * Try to populate \c ctx from the cache at \c cache_path. Returns the scene
+ * identifier, or an empty string if the cache is missing or stale.
+ */
+static std::string read_cache(const fs::path &cache_path, uint64_t key,
+                              XMLParseContext &ctx) {
+    if (!fs::exists(cache_path))
+        return "";
+
+    try {
+        ref<FileStream> stream = new FileStream(cache_path);
+        std::string magic;
+        uint32_t version;
+        uint64_t key_cached;
+        stream->read(magic);
+        stream->read(version);
+        stream->read(key_cached);
+        if (magic != cache_magic || version != cache_version || key != key_cached)
+            return "";
+
+        uint32_t dependency_count;
+        stream->read(dependency_count);
+        for (uint32_t i = 0; i < dependency_count; ++i) {
+            std::string path;
+            uint64_t hash;
+            stream->read(path);
+            stream->read(hash);
+            if (!fs::exists(path) ||
+                fnv1a_string(read_file(path)) != hash) {
+                Log(Debug, "Scene cache \"%s\" is stale (\"%s\" changed)", cache_path, path);
+                return "";
+            }
+        }
+
+        std::string scene_id;
+        uint64_t instance_count;
+        stream->read(scene_id);
+        stream->read(instance_count);
+        for (uint64_t i = 0; i < instance_count; ++i) {
+            std::string id, class_name;
+            uint64_t location;
+            stream->read(id);
+            stream->read(class_name);
+
+            auto &inst = ctx.instances[id];
+            stream->read(inst.alias);
+            stream->read(inst.src_id);
+            stream->read(location);
+            inst.location = (size_t) location;
+            fs::path src_path = inst.src_id;
+            inst.offset = [src_path](ptrdiff_t pos) { return file_offset(src_path, pos); };
+
+            if (!class_name.empty()) {
+                inst.class_ = Class::for_name(class_name, ctx.variant);
+                if (!inst.class_)
+                    Throw("unknown class \"%s\"", class_name);
+                inst.props = read_properties(stream);
+            }
+        }
+
+        if (ctx.instances.find(scene_id) == ctx.instances.end())
+            Throw("scene object \"%s\" is missing", scene_id);
+
+        return scene_id;
+    } catch (const std::exception &e) {
+        Log(Warn, "Ignoring invalid scene cache \"%s\": %s", cache_path, e.what());
+        ctx.instances.clear();
+        return "";
+    }
+}
+
+//! @}
+// =============================================================
+
+/**
+ * Owns the task group used by the streaming mode (see \ref dispatch_node()).
+ * If parsing or instantiation fails, the destructor cancels outstanding
+ * tasks and waits for running ones before the parse context goes away.
+ */
+struct StreamingScope {
+    XMLParseContext &ctx;
+    tbb::task_group tasks;
+
+    StreamingScope(XMLParseContext &ctx, bool enable) : ctx(ctx) {
+        if (enable && ctx.parallelize)
+            ctx.tasks = &tasks;
+    }
+
+    /// Wait for all dispatched objects, re-throws their exceptions
+    void finish() {
+        if (ctx.tasks) {
+            ctx.tasks = nullptr;
+            tasks.wait();
+        }
+    }
+
+    ~StreamingScope() {
+        if (ctx.tasks) {
+            ctx.tasks = nullptr;
+            tasks.cancel();
+            try {
+                tasks.wait();
+            } catch (...) { }
+        }
+    }
+};
+
 NAMESPACE_END(detail)
 
 ref<Object> load_string(const std::string &string, const std::string &variant,
-                        ParameterList param) {
+                        ParameterList param, bool stream_objects) {
     ScopedPhase sp(ProfilerPhase::InitScene);
+    ScopedStage stage(ReportStage::Parse);
     pugi::xml_document doc;
     pugi::xml_parse_result result = doc.load_buffer(string.c_str(), string.length(),
                                                     pugi::parse_default |
@@ -1145,20 +1588,40 @@ ref<Object> load_string(const std::string &string, const std::string &variant,
 
     pugi::xml_node root = doc.document_element();
     detail::XMLParseContext ctx(variant);
+    detail::StreamingScope streaming_scope(ctx, stream_objects);
     Properties prop;
     size_t arg_counter; // Unused
     auto scene_id = detail::parse_xml(src, ctx, root, Tag::Invalid, prop,
                                       param, arg_counter, 0).second;
-    return detail::instantiate_node(ctx, scene_id);
+    stage.finish();
+    ref<Object> object = detail::instantiate_node(ctx, scene_id);
+    streaming_scope.finish();
+    return object;
 }
 
 ref<Object> load_file(const fs::path &filename_, const std::string &variant,
-                      ParameterList param, bool write_update) {
+                      ParameterList param, bool write_update, bool use_cache,
+                      bool stream_objects) {
     ScopedPhase sp(ProfilerPhase::InitScene);
+    ScopedStage stage(ReportStage::Parse);
     fs::path filename = filename_;
     if (!fs::exists(filename))
         Throw("\"%s\": file does not exist!", filename);
 
+    fs::path cache_path = filename.string() + ".cache";
+    uint64_t key = 0;
+    if (use_cache) {
+        key = detail::cache_key(detail::read_file(filename), variant, param);
+        detail::XMLParseContext ctx(variant);
+        std::string scene_id = detail::read_cache(cache_path, key, ctx);
+        if (!scene_id.empty()) {
+            Log(Info, "Loading cached scene description \"%s\" ..", cache_path);
+            Log(Info, "Using variant \"%s\"", variant);
+            stage.finish();
+            return detail::instantiate_node(ctx, scene_id);
+        }
+    }
+
     Log(Info, "Loading XML file \"%s\" ..", filename);
     Log(Info, "Using variant \"%s\"", variant);
 
@@ -1179,6 +1642,9 @@ ref<Object> load_file(const fs::path &filename_, const std::string &variant,
     pugi::xml_node root = doc.document_element();
 
     detail::XMLParseContext ctx(variant);
+    /* Streaming instantiation modifies the parsed properties in place, which
+       is incompatible with writing them to the cache afterwards */
+    detail::StreamingScope streaming_scope(ctx, stream_objects && !use_cache);
     Properties prop;
     size_t arg_counter = 0; // Unused
     auto scene_id = detail::parse_xml(src, ctx, root, Tag::Invalid, prop,
@@ -1206,9 +1672,16 @@ ref<Object> load_file(const fs::path &filename_, const std::string &variant,
 
         // Update for detail::file_offset
         filename = backup;
+    } else if (use_cache) {
+        /* Skipped when the file was just rewritten: its contents no
+           longer match the key, the next run will create the cache. */
+        detail::write_cache(cache_path, key, ctx, scene_id);
     }
+    stage.finish();
 
-    return detail::instantiate_node(ctx, scene_id);
+    ref<Object> object = detail::instantiate_node(ctx, scene_id);
+    streaming_scope.finish();
+    return object;
 }
 
 NAMESPACE_END(xml)
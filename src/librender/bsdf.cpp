@@ -4,7 +4,9 @@
 NAMESPACE_BEGIN(mitsuba)
 
 MTS_VARIANT BSDF<Float, Spectrum>::BSDF(const Properties &props)
-    : m_flags(+BSDFFlags::None), m_id(props.id()) { }
+    : m_flags(+BSDFFlags::None), m_id(props.id()),
+      m_profiler_handle(profiler_register_object(ProfilerObjectType::Material,
+                                                 props.plugin_name(), props.id())) { }
 
 MTS_VARIANT BSDF<Float, Spectrum>::~BSDF() { }
 
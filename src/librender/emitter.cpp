@@ -4,7 +4,10 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
-MTS_VARIANT Emitter<Float, Spectrum>::Emitter(const Properties &props) : Base(props) { }
+MTS_VARIANT Emitter<Float, Spectrum>::Emitter(const Properties &props)
+    : Base(props),
+      m_profiler_handle(profiler_register_object(ProfilerObjectType::Emitter,
+                                                 props.plugin_name(), props.id())) { }
 MTS_VARIANT Emitter<Float, Spectrum>::~Emitter() { }
 
 MTS_IMPLEMENT_CLASS_VARIANT(Emitter, Endpoint, "emitter")
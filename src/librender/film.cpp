@@ -1,4 +1,5 @@
 #include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/properties.h>
 
@@ -63,6 +64,43 @@ MTS_VARIANT void Film<Float, Spectrum>::set_crop_window(const ScalarPoint2i &cro
     m_crop_offset = crop_offset;
 }
 
+MTS_VARIANT void Film<Float, Spectrum>::put_normalized(const ImageBlock *block) {
+    std::lock_guard<std::mutex> guard(m_splats_mutex);
+    if (!m_splats) {
+        m_splats = new ImageBlock(m_crop_size, block->channel_count());
+        m_splats->set_offset(m_crop_offset);
+        m_splats->clear();
+    }
+    m_splats->put(block);
+}
+
+MTS_VARIANT void Film<Float, Spectrum>::add_splats(ScalarFloat *data,
+                                                   size_t channel_count) const {
+    if (!m_splats)
+        return;
+    if (unlikely(channel_count < 5 || m_splats->channel_count() != channel_count))
+        Throw("Film::add_splats(): mismatched channel counts!");
+
+    if constexpr (is_cuda_array_v<Float>) {
+        cuda_eval();
+        cuda_sync();
+    }
+
+    const ScalarFloat *splats = m_splats->data().managed().data();
+    size_t pixel_count = (size_t) hprod(m_crop_size);
+    for (size_t i = 0; i < pixel_count; ++i) {
+        ScalarFloat &weight = data[4];
+        if (weight == 0.f)
+            weight = 1.f;
+        for (size_t k = 0; k < channel_count; ++k) {
+            if (k != 4)
+                data[k] += splats[k] * weight;
+        }
+        data += channel_count;
+        splats += channel_count;
+    }
+}
+
 MTS_VARIANT std::string Film<Float, Spectrum>::to_string() const {
     std::ostringstream oss;
     oss << "Film[" << std::endl
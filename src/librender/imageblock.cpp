@@ -1,4 +1,5 @@
 #include <mitsuba/render/imageblock.h>
+#include <mitsuba/core/atomic.h>
 #include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/profiler.h>
 
@@ -44,6 +45,7 @@ MTS_VARIANT void ImageBlock<Float, Spectrum>::set_size(const ScalarVector2i &siz
     m_size = size;
     m_data = empty<DynamicBuffer<Float>>(
         m_channel_count * hprod(size + 2 * m_border_size));
+    m_memory.reset(MemoryCategory::Film, m_data.size() * sizeof(ScalarFloat));
 }
 
 MTS_VARIANT void ImageBlock<Float, Spectrum>::put(const ImageBlock *block) {
@@ -77,10 +79,7 @@ MTS_VARIANT void ImageBlock<Float, Spectrum>::put(const ImageBlock *block) {
 }
 
 MTS_VARIANT typename ImageBlock<Float, Spectrum>::Mask
-ImageBlock<Float, Spectrum>::put(const Point2f &pos_, const Float *value, Mask active) {
-    ScopedPhase sp(ProfilerPhase::ImageBlockPut);
-    Assert(m_filter != nullptr);
-
+ImageBlock<Float, Spectrum>::check_values(const Float *value, Mask active) const {
     // Check if all sample values are valid
     if (likely(m_warn_negative || m_warn_invalid)) {
         Mask is_valid = true;
@@ -107,6 +106,15 @@ ImageBlock<Float, Spectrum>::put(const Point2f &pos_, const Float *value, Mask a
             active &= is_valid;
         }
     }
+    return active;
+}
+
+MTS_VARIANT typename ImageBlock<Float, Spectrum>::Mask
+ImageBlock<Float, Spectrum>::put(const Point2f &pos_, const Float *value, Mask active) {
+    ScopedPhase sp(ProfilerPhase::ImageBlockPut);
+    Assert(m_filter != nullptr);
+
+    active = check_values(value, active);
 
     ScalarFloat filter_radius = m_filter->radius();
     ScalarVector2i size = m_size + 2 * m_border_size;
@@ -171,6 +179,85 @@ ImageBlock<Float, Spectrum>::put(const Point2f &pos_, const Float *value, Mask a
     return active;
 }
 
+MTS_VARIANT typename ImageBlock<Float, Spectrum>::Mask
+ImageBlock<Float, Spectrum>::put_atomic(const Point2f &pos_, const Float *value, Mask active) {
+    ScopedPhase sp(ProfilerPhase::ImageBlockPut);
+    Assert(m_filter != nullptr);
+
+    if constexpr (is_cuda_array_v<Float>) {
+        ENOKI_MARK_USED(pos_);
+        ENOKI_MARK_USED(value);
+        Throw("ImageBlock::put_atomic(): not supported in GPU variants!");
+    } else {
+        active = check_values(value, active);
+
+        ScalarFloat filter_radius = m_filter->radius();
+        ScalarVector2i size = m_size + 2 * m_border_size;
+
+        // Convert to pixel coordinates within the image block
+        Point2f pos = pos_ - (m_offset - m_border_size + .5f);
+
+        // Atomically add 'v' to channel 'k' of the pixels starting at 'offset'
+        auto add = [&](const UInt32 &offset, uint32_t k, const Float &v, const Mask &enabled) {
+            ScalarFloat *data = m_data.data() + k;
+            if constexpr (!is_array_v<Float>) {
+                if (enabled)
+                    *reinterpret_cast<AtomicFloat<ScalarFloat> *>(data + offset) += v;
+            } else {
+                for (size_t i = 0; i < slices(offset); ++i) {
+                    if (slice(enabled, i))
+                        *reinterpret_cast<AtomicFloat<ScalarFloat> *>(data + slice(offset, i)) +=
+                            slice(v, i);
+                }
+            }
+        };
+
+        if (filter_radius > 1) {
+            // Determine the affected range of pixels
+            Point2i lo = max(ceil2int <Point2i>(pos - filter_radius), 0),
+                    hi = min(floor2int<Point2i>(pos + filter_radius), size - 1);
+
+            uint32_t n = ceil2int<uint32_t>((filter_radius - 2.f * math::RayEpsilon<ScalarFloat>) * 2.f);
+
+            /* The weights are evaluated on the fly (rather than stored in the
+               temporary buffers of put()), since several threads use the block */
+            Float wx(0.f), wy(0.f);
+            for (uint32_t i = 0; i < n; ++i) {
+                Int32 x = lo.x() + (int32_t) i, y = lo.y() + (int32_t) i;
+                wx += select(x <= hi.x(), m_filter->eval_discretized(Float(x) - pos.x(), active), 0.f);
+                wy += select(y <= hi.y(), m_filter->eval_discretized(Float(y) - pos.y(), active), 0.f);
+            }
+            Float factor = rcp(wx * wy);
+            active &= wx * wy > 0.f;
+
+            ENOKI_NOUNROLL for (uint32_t yr = 0; yr < n; ++yr) {
+                Int32 y = lo.y() + (int32_t) yr;
+                Mask enabled_y = active && y <= hi.y();
+                Float weight_y = m_filter->eval_discretized(Float(y) - pos.y(), enabled_y) * factor;
+
+                ENOKI_NOUNROLL for (uint32_t xr = 0; xr < n; ++xr) {
+                    Int32 x = lo.x() + (int32_t) xr;
+                    Mask enabled = enabled_y && x <= hi.x();
+                    UInt32 offset = m_channel_count * UInt32(y * size.x() + x);
+                    Float weight = weight_y * m_filter->eval_discretized(Float(x) - pos.x(), enabled);
+
+                    ENOKI_NOUNROLL for (uint32_t k = 0; k < m_channel_count; ++k)
+                        add(offset, k, value[k] * weight, enabled);
+                }
+            }
+        } else {
+            Point2i p = ceil2int<Point2i>(pos - .5f);
+            UInt32 offset = m_channel_count * UInt32(p.y() * size.x() + p.x());
+
+            Mask enabled = active && all(p >= 0 && p < size);
+            ENOKI_NOUNROLL for (uint32_t k = 0; k < m_channel_count; ++k)
+                add(offset, k, value[k], enabled);
+        }
+    }
+
+    return active;
+}
+
 MTS_VARIANT std::string ImageBlock<Float, Spectrum>::to_string() const {
     std::ostringstream oss;
     oss << "ImageBlock[" << std::endl
@@ -5,6 +5,7 @@
 #include <mitsuba/core/profiler.h>
 #include <mitsuba/core/progress.h>
 #include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/stats.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/warp.h>
@@ -87,48 +88,52 @@ MTS_VARIANT bool SamplingIntegrator<Float, Spectrum>::render(Scene *scene, Senso
         Spiral spiral(film, m_block_size, n_passes);
 
         ThreadEnvironment env;
-        ref<ProgressReporter> progress = new ProgressReporter("Rendering");
-        std::mutex mutex;
 
         // Total number of blocks to be handled, including multiple passes.
-        size_t total_blocks = spiral.block_count() * n_passes,
-               blocks_done = 0;
+        size_t total_blocks = spiral.block_count() * n_passes;
+        ref<ProgressReporter> progress =
+            new ProgressReporter("Rendering", nullptr, total_blocks);
 
         m_render_timer.reset();
-        tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, total_blocks, 1),
-            [&](const tbb::blocked_range<size_t> &range) {
-                ScopedSetThreadEnvironment set_env(env);
-                ref<Sampler> sampler = sensor->sampler()->clone();
-                ref<ImageBlock> block = new ImageBlock(m_block_size, channels.size(),
-                                                       film->reconstruction_filter(),
-                                                       !has_aovs);
-                scoped_flush_denormals flush_denormals(true);
-                std::unique_ptr<Float[]> aovs(new Float[channels.size()]);
-
-                // For each block
-                for (auto i = range.begin(); i != range.end() && !should_stop(); ++i) {
-                    auto [offset, size, block_id] = spiral.next_block();
-                    Assert(hprod(size) != 0);
-                    block->set_size(size);
-                    block->set_offset(offset);
-
-                    // Ensure that the sample generation is fully deterministic
-                    sampler->seed(block_id);
-
-                    render_block(scene, sensor, sampler, block,
-                                 aovs.get(), samples_per_pass);
-
-                    film->put(block);
-
-                    /* Critical section: update progress bar */ {
-                        std::lock_guard<std::mutex> lock(mutex);
-                        blocks_done++;
-                        progress->update(blocks_done / (ScalarFloat) total_blocks);
+
+        // Passes are rendered one after the other (see prepare_pass())
+        for (size_t pass = 0; pass < n_passes && !should_stop(); ++pass) {
+            prepare_pass(scene, sensor, pass, n_passes);
+
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(0, spiral.block_count(), 1),
+                [&](const tbb::blocked_range<size_t> &range) {
+                    ScopedSetThreadEnvironment set_env(env);
+                    ref<Sampler> sampler = sensor->sampler()->clone();
+                    ref<ImageBlock> block = new ImageBlock(m_block_size, channels.size(),
+                                                           film->reconstruction_filter(),
+                                                           !has_aovs);
+                    scoped_flush_denormals flush_denormals(true);
+                    std::unique_ptr<Float[]> aovs(new Float[channels.size()]);
+
+                    // For each block
+                    for (auto i = range.begin(); i != range.end() && !should_stop(); ++i) {
+                        auto [offset, size, block_id] = spiral.next_block();
+                        Assert(hprod(size) != 0);
+                        block->set_size(size);
+                        block->set_offset(offset);
+
+                        // Ensure that the sample generation is fully deterministic
+                        sampler->seed(block_id);
+
+                        // Index of the first sample of this pass within each pixel
+                        size_t sample_offset = (block_id / spiral.block_count()) * samples_per_pass;
+
+                        render_block(scene, sensor, sampler, block,
+                                     aovs.get(), samples_per_pass, sample_offset);
+
+                        film->put(block);
+
+                        progress->advance(1, hprod(size) * samples_per_pass);
                     }
                 }
-            }
-        );
+            );
+        }
     } else {
         ref<Sampler> sampler = sensor->sampler();
 
@@ -140,18 +145,22 @@ MTS_VARIANT bool SamplingIntegrator<Float, Spectrum>::render(Scene *scene, Senso
         UInt32 idx = arange<UInt32>(total_sample_count);
         if (samples_per_pass != 1)
             idx /= (uint32_t) samples_per_pass;
+        UInt32 sample_index = arange<UInt32>(total_sample_count) - idx * (uint32_t) samples_per_pass;
+        Point2u pixel(idx % uint32_t(film_size[0]), idx / uint32_t(film_size[0]));
 
         ref<ImageBlock> block = new ImageBlock(film_size, channels.size(),
                                                film->reconstruction_filter(),
                                                !has_aovs);
         block->clear();
-        Vector2f pos = Vector2f(Float(idx % uint32_t(film_size[0])),
-                                Float(idx / uint32_t(film_size[0])));
+        Vector2f pos = Vector2f(Float(pixel.x()), Float(pixel.y()));
         std::vector<Float> aovs(channels.size());
 
-        for (size_t i = 0; i < n_passes; i++)
+        for (size_t i = 0; i < n_passes; i++) {
+            prepare_pass(scene, sensor, i, n_passes);
+            sampler->start_sample(pixel, sample_index + uint32_t(i * samples_per_pass));
             render_sample(scene, sensor, sampler, block, aovs.data(),
                           pos, diff_scale_factor);
+        }
 
         film->put(block);
     }
@@ -163,12 +172,18 @@ MTS_VARIANT bool SamplingIntegrator<Float, Spectrum>::render(Scene *scene, Senso
     return !m_stop;
 }
 
+MTS_VARIANT void SamplingIntegrator<Float, Spectrum>::prepare_pass(const Scene * /* scene */,
+                                                                   const Sensor * /* sensor */,
+                                                                   size_t /* pass */,
+                                                                   size_t /* pass_count */) { }
+
 MTS_VARIANT void SamplingIntegrator<Float, Spectrum>::render_block(const Scene *scene,
                                                                    const Sensor *sensor,
                                                                    Sampler *sampler,
                                                                    ImageBlock *block,
                                                                    Float *aovs,
-                                                                   size_t sample_count_) const {
+                                                                   size_t sample_count_,
+                                                                   size_t sample_offset) const {
     block->clear();
     uint32_t pixel_count  = (uint32_t)(m_block_size * m_block_size),
              sample_count = (uint32_t)(sample_count_ == (size_t) -1
@@ -185,6 +200,7 @@ MTS_VARIANT void SamplingIntegrator<Float, Spectrum>::render_block(const Scene *
 
             pos += block->offset();
             for (uint32_t j = 0; j < sample_count && !should_stop(); ++j) {
+                sampler->start_sample(pos, (uint32_t) sample_offset + j);
                 render_sample(scene, sensor, sampler, block, aovs,
                               pos, diff_scale_factor);
             }
@@ -193,9 +209,12 @@ MTS_VARIANT void SamplingIntegrator<Float, Spectrum>::render_block(const Scene *
         for (auto [index, active] : range<UInt32>(pixel_count * sample_count)) {
             if (should_stop())
                 break;
-            Point2u pos = enoki::morton_decode<Point2u>(index / UInt32(sample_count));
+            UInt32 pixel_index = index / UInt32(sample_count);
+            Point2u pos = enoki::morton_decode<Point2u>(pixel_index);
             active &= !any(pos >= block->size());
             pos += block->offset();
+            sampler->start_sample(pos, index - pixel_index * sample_count +
+                                           (uint32_t) sample_offset, active);
             render_sample(scene, sensor, sampler, block, aovs, pos, diff_scale_factor, active);
         }
     } else {
@@ -205,6 +224,7 @@ MTS_VARIANT void SamplingIntegrator<Float, Spectrum>::render_block(const Scene *
         ENOKI_MARK_USED(diff_scale_factor);
         ENOKI_MARK_USED(pixel_count);
         ENOKI_MARK_USED(sample_count);
+        ENOKI_MARK_USED(sample_offset);
         Throw("Not implemented for CUDA arrays.");
     }
 }
@@ -232,6 +252,7 @@ MTS_VARIANT void SamplingIntegrator<Float, Spectrum>::render_sample(
         time, wavelength_sample, adjusted_position, aperture_sample);
 
     ray.scale_differential(diff_scale_factor);
+    MTS_STATS_COUNT(CameraRays, active);
 
     const Medium *medium = sensor->medium();
     std::pair<Spectrum, Mask> result = sample(scene, sampler, ray, medium, aovs + 5, active);
@@ -1,4 +1,5 @@
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/hash.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/transform.h>
@@ -7,6 +8,10 @@
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/mesh.h>
 #include <mitsuba/render/records.h>
+#include <enoki/half.h>
+#include <enoki/morton.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
 #include "blender_types.h"
 #include <mutex>
 
@@ -28,6 +33,13 @@ MTS_VARIANT Mesh<Float, Spectrum>::Mesh(const Properties &props) : Base(props) {
        appearance. Default: ``false`` */
     if (props.bool_("face_normals", false))
         m_disable_vertex_normals = true;
+    /* When set to ``true``, vertex normals, texture coordinates, colors and
+       (for small meshes) face indices are stored using compact encodings
+       to reduce the memory footprint. Default: ``false`` */
+    m_compact_attributes = props.bool_("compact_attributes", false);
+    /* When set to ``true``, faces and vertices are reordered along a
+       space-filling curve to improve memory locality. Default: ``false`` */
+    m_optimize_layout = props.bool_("optimize_layout", false);
     m_to_world = props.transform("to_world", ScalarTransform4f());
     m_mesh = true;
 }
@@ -83,8 +95,8 @@ MTS_VARIANT Mesh<Float, Spectrum>::Mesh(const std::string &name, Struct *vertex_
     m_vertex_size = (ScalarSize) m_vertex_struct->size();
     m_face_size   = (ScalarSize) m_face_struct->size();
 
-    m_vertices = VertexHolder(new uint8_t[(vertex_count + 1) * m_vertex_size]);
-    m_faces    = VertexHolder(new uint8_t[(face_count + 1) * m_face_size]);
+    m_vertices = allocate_buffer((vertex_count + 1) * m_vertex_size);
+    m_faces    = allocate_buffer((face_count + 1) * m_face_size);
 
     m_mesh = true;
 }
@@ -299,8 +311,8 @@ MTS_VARIANT Mesh<Float, Spectrum>::Mesh(
     m_vertex_size = (ScalarSize) m_vertex_struct->size();
     m_face_size   = (ScalarSize) m_face_struct->size();
     m_vertices =
-        VertexHolder(new uint8_t[(m_vertex_count + 1) * m_vertex_size]);
-    m_faces = FaceHolder(new uint8_t[(m_face_count + 1) * m_face_size]);
+        allocate_buffer((m_vertex_count + 1) * m_vertex_size);
+    m_faces = allocate_buffer((m_face_count + 1) * m_face_size);
     memcpy(m_faces.get(), tmp_triangles.data(), m_face_count * m_face_size);
 
     for (ScalarIndex id = 0; id < vertex_ctr; id++) {
@@ -327,7 +339,7 @@ MTS_VARIANT typename Mesh<Float, Spectrum>::ScalarBoundingBox3f
 Mesh<Float, Spectrum>::bbox(ScalarIndex index) const {
     Assert(index <= m_face_count);
 
-    auto idx = (const ScalarIndex *) face(index);
+    auto idx = face_indices(index);
     Assert(idx[0] < m_vertex_count &&
            idx[1] < m_vertex_count &&
            idx[2] < m_vertex_count);
@@ -373,41 +385,44 @@ MTS_VARIANT void Mesh<Float, Spectrum>::write_ply(Stream *stream) const {
     else
         stream->write_line("format binary_little_endian 1.0");
 
-    if (m_vertex_struct->field_count() > 0) {
+    // Compact encodings (e.g. octahedral normals) can't be represented in PLY files
+    auto [vertex_struct, vertices, face_struct, faces] = decoded_buffers();
+
+    if (vertex_struct->field_count() > 0) {
         stream->write_line(tfm::format("element vertex %i", m_vertex_count));
-        for (auto const &f : *m_vertex_struct)
+        for (auto const &f : *vertex_struct)
             stream->write_line(
                 tfm::format("property %s %s", type_name(f.type), f.name));
     }
 
-    if (m_face_struct->field_count() > 0) {
+    if (face_struct->field_count() > 0) {
         stream->write_line(tfm::format("element face %i", m_face_count));
         stream->write_line(tfm::format("property list uchar %s vertex_indices",
-            type_name((*m_face_struct)[0].type)));
+            type_name((*face_struct)[0].type)));
     }
 
     stream->write_line("end_header");
 
-    if (m_vertex_struct->field_count() > 0) {
+    if (vertex_struct->field_count() > 0) {
         stream->write(
-            m_vertices.get(),
-            m_vertex_struct->size() * m_vertex_count
+            vertices.get(),
+            vertex_struct->size() * m_vertex_count
         );
     }
 
-    if (m_face_struct->field_count() > 0) {
+    if (face_struct->field_count() > 0) {
         ref<Struct> face_struct_out = new Struct(true);
 
         face_struct_out->append("__size", Struct::Type::UInt8, +Struct::Flags::Default,3.0);
-        for (auto f: *m_face_struct)
+        for (auto f: *face_struct)
             face_struct_out->append(f.name, f.type);
 
         ref<StructConverter> conv =
-            new StructConverter(m_face_struct, face_struct_out);
+            new StructConverter(face_struct, face_struct_out);
 
         FaceHolder temp(new uint8_t[face_struct_out->size() * m_face_count]);
 
-        if (!conv->convert(m_face_count, m_faces.get(), temp.get()))
+        if (!conv->convert(m_face_count, faces.get(), temp.get()))
             Throw("PLYMesh::write(): internal error during conversion");
 
         stream->write(
@@ -418,12 +433,30 @@ MTS_VARIANT void Mesh<Float, Spectrum>::write_ply(Stream *stream) const {
 
     Log(Info, "\"%s\": wrote %i faces, %i vertices (%s in %s)",
         m_name, m_face_count, m_vertex_count,
-        util::mem_string(m_face_count * m_face_struct->size() +
-                         m_vertex_count * m_vertex_struct->size()),
+        util::mem_string(m_face_count * face_struct->size() +
+                         m_vertex_count * vertex_struct->size()),
         util::time_string(timer.value())
     );
 }
 
+namespace {
+/// Encode a unit vector using an octahedral mapping with 2x16 bit precision
+template <typename Normal3> uint32_t pack_oct_normal(Normal3 n) {
+    using Value = value_t<Normal3>;
+    n /= std::abs(n.x()) + std::abs(n.y()) + std::abs(n.z());
+    Value x = n.x(), y = n.y();
+    if (n.z() < 0) {
+        Value tx = (1 - std::abs(y)) * (x >= 0 ? 1 : -1),
+              ty = (1 - std::abs(x)) * (y >= 0 ? 1 : -1);
+        x = tx; y = ty;
+    }
+    auto quantize = [](Value v) {
+        return (uint32_t) (uint16_t) (int16_t) std::round(clamp(v, Value(-1), Value(1)) * 32767);
+    };
+    return quantize(x) | (quantize(y) << 16);
+}
+}  // end namespace
+
 MTS_VARIANT void Mesh<Float, Spectrum>::recompute_vertex_normals() {
     if (!has_vertex_normals())
         Throw("Storing new normals in a Mesh that didn't have normals at "
@@ -436,7 +469,7 @@ MTS_VARIANT void Mesh<Float, Spectrum>::recompute_vertex_normals() {
     /* Weighting scheme based on "Computing Vertex Normals from Polygonal Facets"
        by Grit Thuermer and Charles A. Wuethrich, JGT 1998, Vol 3 */
     for (ScalarSize i = 0; i < m_face_count; ++i) {
-        const ScalarIndex *idx = (const ScalarIndex *) face(i);
+        auto idx = face_indices(i);
         Assert(idx[0] < m_vertex_count && idx[1] < m_vertex_count && idx[2] < m_vertex_count);
         InputPoint3f v[3]{ vertex_position(idx[0]),
                            vertex_position(idx[1]),
@@ -469,7 +502,12 @@ MTS_VARIANT void Mesh<Float, Spectrum>::recompute_vertex_normals() {
             invalid_counter++;
         }
 
-        store(vertex(i) + m_normal_offset, n);
+        if (m_oct_normals) {
+            uint32_t packed = pack_oct_normal(n);
+            memcpy(vertex(i) + m_normal_offset, &packed, sizeof(uint32_t));
+        } else {
+            store(vertex(i) + m_normal_offset, n);
+        }
     }
 
     if (invalid_counter == 0)
@@ -480,12 +518,324 @@ MTS_VARIANT void Mesh<Float, Spectrum>::recompute_vertex_normals() {
             m_name, util::time_string(timer.value()), invalid_counter);
 }
 
+MTS_VARIANT void Mesh<Float, Spectrum>::optimize_layout() {
+    if (m_face_count == 0)
+        return;
+    if (has_shared_buffers() || m_short_indices)
+        Throw("Mesh::optimize_layout(): must be called before the mesh buffers "
+              "are shared or compacted!");
+
+    Timer timer;
+
+    // Bounding box of the face centroids
+    ScalarBoundingBox3f centroid_bbox;
+    for (ScalarSize i = 0; i < m_face_count; ++i)
+        centroid_bbox.expand(bbox(i).center());
+
+    /* Quantize centroids to 21 bits per axis and compute their 63-bit
+       Morton codes in parallel */
+    using MortonIndex = Array<uint64_t, 3>;
+    constexpr ScalarFloat resolution = ScalarFloat((1u << 21) - 1);
+    ScalarVector3f extents = centroid_bbox.extents(),
+                   scale = select(extents > 0.f, resolution / extents, 0.f);
+
+    std::vector<std::pair<uint64_t, ScalarIndex>> keys(m_face_count);
+    tbb::parallel_for(
+        tbb::blocked_range<ScalarSize>(0, m_face_count, 4096),
+        [&](const tbb::blocked_range<ScalarSize> &range) {
+            for (ScalarSize i = range.begin(); i != range.end(); ++i) {
+                ScalarVector3f p = (bbox(i).center() - centroid_bbox.min) * scale;
+                MortonIndex q = MortonIndex(clamp(p, 0.f, resolution));
+                keys[i] = { enoki::morton_encode(q), i };
+            }
+        }
+    );
+    tbb::parallel_sort(keys.begin(), keys.end());
+
+    /* Emit faces in Morton order, while renumbering vertices in the order
+       of their first use */
+    constexpr ScalarIndex invalid = (ScalarIndex) -1;
+    std::vector<ScalarIndex> vertex_map(m_vertex_count, invalid);
+    ScalarIndex vertex_ctr = 0;
+
+    FaceHolder faces = allocate_buffer((m_face_count + 1) * m_face_size);
+    memcpy(faces.get() + m_face_count * m_face_size, face(m_face_count), m_face_size);
+
+    for (ScalarSize i = 0; i < m_face_count; ++i) {
+        uint8_t *dst = faces.get() + i * m_face_size;
+        memcpy(dst, face(keys[i].second), m_face_size);
+
+        ScalarIndex *idx = (ScalarIndex *) dst;
+        for (size_t j = 0; j < 3; ++j) {
+            ScalarIndex &target = vertex_map[idx[j]];
+            if (target == invalid)
+                target = vertex_ctr++;
+            idx[j] = target;
+        }
+    }
+
+    // Unreferenced vertices (if any) are moved to the end
+    for (ScalarSize i = 0; i < m_vertex_count; ++i) {
+        if (vertex_map[i] == invalid)
+            vertex_map[i] = vertex_ctr++;
+    }
+
+    VertexHolder vertices = allocate_buffer((m_vertex_count + 1) * m_vertex_size);
+    memcpy(vertices.get() + m_vertex_count * m_vertex_size, vertex(m_vertex_count),
+           m_vertex_size);
+    for (ScalarSize i = 0; i < m_vertex_count; ++i)
+        memcpy(vertices.get() + vertex_map[i] * m_vertex_size, vertex(i), m_vertex_size);
+
+    m_faces    = std::move(faces);
+    m_vertices = std::move(vertices);
+
+    // Per-face sampling tables refer to the old face order
+    if (!m_area_distr.empty()) {
+        std::lock_guard<tbb::spin_mutex> lock(m_mutex);
+        m_area_distr = DiscreteDistribution<Float>();
+    }
+
+    Log(Debug, "\"%s\": reordered %i faces and %i vertices (took %s)", m_name,
+        m_face_count, m_vertex_count, util::time_string(timer.value()));
+}
+
+MTS_VARIANT void Mesh<Float, Spectrum>::compact_attributes() {
+    if (has_compact_attributes())
+        return;
+    if (has_shared_buffers())
+        Throw("Mesh::compact_attributes(): cannot re-encode shared buffers!");
+
+    Timer timer;
+    size_t size_before = (m_vertex_count + 1) * m_vertex_size +
+                         (m_face_count + 1) * m_face_size;
+
+    ref<Struct> vertex_struct = new Struct();
+    for (auto name : { "x", "y", "z" })
+        vertex_struct->append(name, struct_type_v<InputFloat>);
+
+    ScalarIndex normal_offset = 0, texcoord_offset = 0, color_offset = 0;
+    if (has_vertex_normals()) {
+        for (auto name : { "nx_oct", "ny_oct" })
+            vertex_struct->append(name, Struct::Type::Int16);
+        normal_offset = (ScalarIndex) vertex_struct->field("nx_oct").offset;
+    }
+    if (has_vertex_texcoords()) {
+        for (auto name : { "u", "v" })
+            vertex_struct->append(name, Struct::Type::Float16);
+        texcoord_offset = (ScalarIndex) vertex_struct->field("u").offset;
+    }
+    if (has_vertex_colors()) {
+        for (auto name : { "r", "g", "b" })
+            vertex_struct->append(name, Struct::Type::UInt8, +Struct::Flags::Normalized);
+        color_offset = (ScalarIndex) vertex_struct->field("r").offset;
+    }
+
+    /* Decoders fetch 32 bit words, hence the vertex size must remain a
+       multiple of 4 bytes (this is guaranteed by the float positions) */
+    ScalarSize vertex_size = (ScalarSize) vertex_struct->size();
+    Assert(vertex_size % sizeof(uint32_t) == 0);
+
+    VertexHolder vertices = allocate_buffer((m_vertex_count + 1) * vertex_size);
+    memset(vertices.get(), 0, (m_vertex_count + 1) * vertex_size);
+
+    for (ScalarSize i = 0; i < m_vertex_count; ++i) {
+        const uint8_t *src = vertex(i);
+        uint8_t *dst = vertices.get() + i * vertex_size;
+        memcpy(dst, src, sizeof(InputFloat) * 3);
+
+        if (normal_offset != 0) {
+            uint32_t n = pack_oct_normal(
+                load_unaligned<InputNormal3f>(src + m_normal_offset));
+            memcpy(dst + normal_offset, &n, sizeof(uint32_t));
+        }
+
+        if (texcoord_offset != 0) {
+            InputVector2f uv = load_unaligned<InputVector2f>(src + m_texcoord_offset);
+            uint16_t h[2] = { enoki::half(uv.x()).value, enoki::half(uv.y()).value };
+            memcpy(dst + texcoord_offset, h, sizeof(h));
+        }
+
+        if (color_offset != 0) {
+            InputVector3f c = load_unaligned<InputVector3f>(src + m_color_offset);
+            uint8_t c8[3];
+            for (size_t j = 0; j < 3; ++j)
+                c8[j] = (uint8_t) std::round(clamp(c[j], 0.f, 1.f) * 255.f);
+            memcpy(dst + color_offset, c8, sizeof(c8));
+        }
+    }
+
+    m_vertices        = std::move(vertices);
+    m_vertex_struct   = vertex_struct;
+    m_vertex_size     = vertex_size;
+    m_normal_offset   = normal_offset;
+    m_texcoord_offset = texcoord_offset;
+    m_color_offset    = color_offset;
+    m_oct_normals     = normal_offset != 0;
+    m_half_texcoords  = texcoord_offset != 0;
+    m_unorm_colors    = color_offset != 0;
+
+#if !defined(MTS_ENABLE_EMBREE)
+    // Embree only supports 32-bit indices
+    if (m_vertex_count <= 0x10000u) {
+        ref<Struct> face_struct = new Struct();
+        for (size_t i = 0; i < 3; ++i)
+            face_struct->append(tfm::format("i%i", i), Struct::Type::UInt16);
+        ScalarSize face_size = (ScalarSize) face_struct->size();
+
+        /* Allocate one extra (zeroed) entry, since face_indices() fetches
+           32 bits at a time */
+        FaceHolder faces = allocate_buffer((m_face_count + 1) * face_size);
+        memset(faces.get(), 0, (m_face_count + 1) * face_size);
+        uint16_t *dst = (uint16_t *) faces.get();
+        for (ScalarSize i = 0; i < m_face_count; ++i) {
+            auto idx = face_indices(i);
+            for (size_t j = 0; j < 3; ++j)
+                dst[i * 3 + j] = (uint16_t) idx[j];
+        }
+
+        m_faces         = std::move(faces);
+        m_face_struct   = face_struct;
+        m_face_size     = face_size;
+        m_short_indices = true;
+    }
+#endif
+
+    size_t size_after = (m_vertex_count + 1) * m_vertex_size +
+                        (m_face_count + 1) * m_face_size;
+
+    Log(Debug, "\"%s\": compacted vertex attributes (%s -> %s, took %s)", m_name,
+        util::mem_string(size_before), util::mem_string(size_after),
+        util::time_string(timer.value()));
+}
+
+MTS_VARIANT std::tuple<ref<Struct>, typename Mesh<Float, Spectrum>::VertexHolder,
+                        ref<Struct>, typename Mesh<Float, Spectrum>::FaceHolder>
+Mesh<Float, Spectrum>::decoded_buffers() const {
+    if (!has_compact_attributes())
+        return { m_vertex_struct, m_vertices, m_face_struct, m_faces };
+
+    ref<Struct> vertex_struct = new Struct();
+    for (auto name : { "x", "y", "z" })
+        vertex_struct->append(name, struct_type_v<InputFloat>);
+    if (has_vertex_normals()) {
+        for (auto name : { "nx", "ny", "nz" })
+            vertex_struct->append(name, struct_type_v<InputFloat>);
+    }
+    if (has_vertex_texcoords()) {
+        for (auto name : { "u", "v" })
+            vertex_struct->append(name, struct_type_v<InputFloat>);
+    }
+    if (has_vertex_colors()) {
+        for (auto name : { "r", "g", "b" })
+            vertex_struct->append(name, struct_type_v<InputFloat>);
+    }
+
+    size_t vertex_size = vertex_struct->size();
+    VertexHolder vertices = allocate_buffer((m_vertex_count + 1) * vertex_size);
+    memset(vertices.get(), 0, (m_vertex_count + 1) * vertex_size);
+    for (ScalarSize i = 0; i < m_vertex_count; ++i) {
+        InputFloat *dst = (InputFloat *) (vertices.get() + i * vertex_size);
+        store_unaligned(dst, vertex_position(i));
+        dst += 3;
+        if (has_vertex_normals()) {
+            store_unaligned(dst, vertex_normal(i));
+            dst += 3;
+        }
+        if (has_vertex_texcoords()) {
+            store_unaligned(dst, vertex_texcoord(i));
+            dst += 2;
+        }
+        if (has_vertex_colors())
+            store_unaligned(dst, vertex_color(i));
+    }
+
+    ref<Struct> face_struct = new Struct();
+    for (size_t i = 0; i < 3; ++i)
+        face_struct->append(tfm::format("i%i", i), struct_type_v<ScalarIndex>);
+
+    FaceHolder faces = allocate_buffer((m_face_count + 1) * face_struct->size());
+    memset(faces.get(), 0, (m_face_count + 1) * face_struct->size());
+    for (ScalarSize i = 0; i < m_face_count; ++i)
+        store_unaligned((ScalarIndex *) faces.get() + 3 * i, face_indices(i));
+
+    return { vertex_struct, vertices, face_struct, faces };
+}
+
 MTS_VARIANT void Mesh<Float, Spectrum>::recompute_bbox() {
     m_bbox.reset();
     for (ScalarSize i = 0; i < m_vertex_count; ++i)
         m_bbox.expand(vertex_position(i));
 }
 
+namespace {
+/// Hash a raw memory region one 64-bit word at a time
+size_t hash_buffer(const uint8_t *ptr, size_t size, size_t value) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, ptr + i, sizeof(uint64_t));
+        value = hash_combine(value, (size_t) (word * 0x9E3779B97F4A7C15ull));
+    }
+    for (; i < size; ++i)
+        value = hash_combine(value, (size_t) ptr[i]);
+    return value;
+}
+}  // end namespace
+
+MTS_VARIANT size_t Mesh<Float, Spectrum>::buffer_hash() const {
+    size_t value = hash_combine(hash(m_vertex_count), hash(m_face_count));
+    value = hash_combine(value, hash(*m_vertex_struct));
+    value = hash_combine(value, hash(*m_face_struct));
+    value = hash_buffer(m_vertices.get(), m_vertex_count * m_vertex_size, value);
+    value = hash_buffer(m_faces.get(), m_face_count * m_face_size, value);
+    return value;
+}
+
+MTS_VARIANT bool Mesh<Float, Spectrum>::has_identical_buffers(const Mesh *other) const {
+    if (m_vertex_count != other->m_vertex_count ||
+        m_face_count != other->m_face_count ||
+        m_vertex_size != other->m_vertex_size ||
+        m_face_size != other->m_face_size ||
+        *m_vertex_struct != *other->m_vertex_struct ||
+        *m_face_struct != *other->m_face_struct)
+        return false;
+
+    if (m_vertices == other->m_vertices && m_faces == other->m_faces)
+        return true;
+
+    return memcmp(m_vertices.get(), other->m_vertices.get(),
+                  m_vertex_count * m_vertex_size) == 0 &&
+           memcmp(m_faces.get(), other->m_faces.get(),
+                  m_face_count * m_face_size) == 0;
+}
+
+MTS_VARIANT size_t Mesh<Float, Spectrum>::share_buffers(const Mesh *other) {
+    Assert(has_identical_buffers(other));
+
+    size_t released = 0;
+    if (m_vertices != other->m_vertices) {
+        if (m_vertices.use_count() == 1)
+            released += (m_vertex_count + 1) * m_vertex_size;
+        m_vertices = other->m_vertices;
+    }
+    if (m_faces != other->m_faces) {
+        if (m_faces.use_count() == 1)
+            released += (m_face_count + 1) * m_face_size;
+        m_faces = other->m_faces;
+    }
+
+    // Identical structs imply identical offsets, but be explicit about it
+    m_normal_offset   = other->m_normal_offset;
+    m_texcoord_offset = other->m_texcoord_offset;
+    m_color_offset    = other->m_color_offset;
+    m_oct_normals     = other->m_oct_normals;
+    m_half_texcoords  = other->m_half_texcoords;
+    m_unorm_colors    = other->m_unorm_colors;
+    m_short_indices   = other->m_short_indices;
+
+    return released;
+}
+
 MTS_VARIANT void Mesh<Float, Spectrum>::area_distr_build() {
     if (m_face_count == 0)
         Throw("Cannot create sampling table for an empty mesh: %s", to_string());
@@ -799,7 +1149,7 @@ Mesh<Float, Spectrum>::bbox(ScalarIndex index, const ScalarBoundingBox3f &clip)
 
     Assert(index <= m_face_count);
 
-    auto idx = (const ScalarIndex *) face(index);
+    auto idx = face_indices(index);
     Assert(idx[0] < m_vertex_count);
     Assert(idx[1] < m_vertex_count);
     Assert(idx[2] < m_vertex_count);
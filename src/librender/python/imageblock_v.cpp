@@ -24,6 +24,13 @@ MTS_PY_EXPORT(ImageBlock) {
                     throw std::runtime_error("Incompatible channel count!");
                 ib.put(pos, data.data(), mask);
             }, "pos"_a, "data"_a, "active"_a = true)
+        .def("put_atomic",
+            [](ImageBlock &ib, const Point2f &pos,
+                const std::vector<Float> &data, Mask mask) {
+                if (data.size() != ib.channel_count())
+                    throw std::runtime_error("Incompatible channel count!");
+                ib.put_atomic(pos, data.data(), mask);
+            }, "pos"_a, "data"_a, "active"_a = true, D(ImageBlock, put_atomic))
         .def_method(ImageBlock, clear)
         .def_method(ImageBlock, set_offset, "offset"_a)
         .def_method(ImageBlock, offset)
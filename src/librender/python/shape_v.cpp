@@ -62,16 +62,37 @@ MTS_PY_EXPORT(Shape) {
         .def_method(Mesh, has_vertex_normals)
         .def_method(Mesh, has_vertex_texcoords)
         .def_method(Mesh, has_vertex_colors)
+        .def_method(Mesh, has_compact_attributes)
         .def_method(Mesh, recompute_vertex_normals)
         .def_method(Mesh, recompute_bbox)
+        .def_method(Mesh, optimize_layout)
+        .def_method(Mesh, compact_attributes)
+        .def_method(Mesh, buffer_hash)
+        .def_method(Mesh, has_identical_buffers, "other"_a)
+        .def_method(Mesh, has_shared_buffers)
         .def("write_ply", &Mesh::write_ply, "stream"_a, "Export mesh as a binary PLY file")
         .def("vertices", [](py::object &o) {
             Mesh &m = py::cast<Mesh&>(o);
+            if (m.has_compact_attributes()) {
+                // Return a read-only copy with decoded attributes
+                auto buffers = m.decoded_buffers();
+                py::dtype dtype = py::cast(std::get<0>(buffers)).attr("dtype")();
+                py::array result(dtype, m.vertex_count(), std::get<1>(buffers).get());
+                result.attr("flags").attr("writeable") = false;
+                return result;
+            }
             py::dtype dtype = o.attr("vertex_struct")().attr("dtype")();
             return py::array(dtype, m.vertex_count(), m.vertices(), o);
         }, D(Mesh, vertices))
         .def("faces", [](py::object &o) {
             Mesh &m = py::cast<Mesh&>(o);
+            if (m.has_compact_attributes()) {
+                auto buffers = m.decoded_buffers();
+                py::dtype dtype = py::cast(std::get<2>(buffers)).attr("dtype")();
+                py::array result(dtype, m.face_count(), std::get<3>(buffers).get());
+                result.attr("flags").attr("writeable") = false;
+                return result;
+            }
             py::dtype dtype = o.attr("face_struct")().attr("dtype")();
             return py::array(dtype, m.face_count(), m.faces(), o);
         }, D(Mesh, faces))
@@ -1,7 +1,12 @@
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/plugin.h>
+#include <mitsuba/core/report.h>
+#include <mitsuba/core/stats.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/medium.h>
+#include <mitsuba/render/mesh.h>
 #include <mitsuba/render/scene.h>
 #include <mitsuba/render/kdtree.h>
 #include <mitsuba/render/integrator.h>
@@ -88,16 +93,62 @@ MTS_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props) {
             create_object<Integrator>(Properties("path"));
     }
 
-    if constexpr (is_cuda_array_v<Float>)
-        accel_init_gpu(props);
-    else
-        accel_init_cpu(props);
+    /* Meshes containing byte-identical geometry can share a single copy of
+       their vertex and face data. Since meshes are stored in world space,
+       this only applies to copies with the same transformation, hence it is
+       opt-in: otherwise, every scene load would hash all geometry. */
+    if (props.bool_("deduplicate_meshes", false))
+        deduplicate_meshes();
+
+    /* Build the acceleration data structure */ {
+        ScopedStage stage(ReportStage::AccelBuild);
+        if constexpr (is_cuda_array_v<Float>)
+            accel_init_gpu(props);
+        else
+            accel_init_cpu(props);
+    }
 
     // Create emitters' shapes (environment luminaires)
     for (Emitter *emitter: m_emitters)
         emitter->set_scene(this);
 }
 
+MTS_VARIANT size_t Scene<Float, Spectrum>::deduplicate_meshes() {
+    Timer timer;
+    std::unordered_map<size_t, std::vector<Mesh *>> registry;
+    size_t mesh_count = 0, shared_count = 0, released = 0;
+
+    for (Shape *shape : m_shapes) {
+        if (!shape->is_mesh())
+            continue;
+        Mesh *mesh = static_cast<Mesh *>(shape);
+        if (mesh->vertex_count() == 0 || mesh->face_count() == 0)
+            continue;
+        mesh_count++;
+
+        std::vector<Mesh *> &candidates = registry[mesh->buffer_hash()];
+        bool found = false;
+        for (Mesh *other : candidates) {
+            if (mesh->has_identical_buffers(other)) {
+                released += mesh->share_buffers(other);
+                shared_count++;
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            candidates.push_back(mesh);
+    }
+
+    if (shared_count > 0)
+        Log(Info, "Mesh deduplication: %i of %i meshes share storage, saved %s (took %s)",
+            shared_count, mesh_count, util::mem_string(released),
+            util::time_string(timer.value()));
+
+    m_dedup_bytes = released;
+    return released;
+}
+
 MTS_VARIANT Scene<Float, Spectrum>::~Scene() {
     if constexpr (is_cuda_array_v<Float>)
         accel_release_gpu();
@@ -108,21 +159,31 @@ MTS_VARIANT Scene<Float, Spectrum>::~Scene() {
 MTS_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
 Scene<Float, Spectrum>::ray_intersect(const Ray3f &ray, Mask active) const {
     MTS_MASKED_FUNCTION(ProfilerPhase::RayIntersect, active);
+    MTS_STATS_COUNT(IntersectRays, active);
 
+    SurfaceInteraction3f si;
     if constexpr (is_cuda_array_v<Float>)
-        return ray_intersect_gpu(ray, HitComputeMode::Default, active);
+        si = ray_intersect_gpu(ray, HitComputeMode::Default, active);
     else
-        return ray_intersect_cpu(ray, active);
+        si = ray_intersect_cpu(ray, active);
+
+    MTS_STATS_COUNT(IntersectHits, active && si.is_valid());
+    return si;
 }
 
 MTS_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
 Scene<Float, Spectrum>::ray_intersect(const Ray3f &ray, HitComputeMode mode, Mask active) const {
     MTS_MASKED_FUNCTION(ProfilerPhase::RayIntersect, active);
+    MTS_STATS_COUNT(IntersectRays, active);
 
+    SurfaceInteraction3f si;
     if constexpr (is_cuda_array_v<Float>)
-        return ray_intersect_gpu(ray, mode, active);
+        si = ray_intersect_gpu(ray, mode, active);
     else
-        return ray_intersect_cpu(ray, active);
+        si = ray_intersect_cpu(ray, active);
+
+    MTS_STATS_COUNT(IntersectHits, active && si.is_valid());
+    return si;
 }
 
 MTS_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
@@ -141,11 +202,16 @@ Scene<Float, Spectrum>::ray_intersect_naive(const Ray3f &ray, Mask active) const
 MTS_VARIANT typename Scene<Float, Spectrum>::Mask
 Scene<Float, Spectrum>::ray_test(const Ray3f &ray, Mask active) const {
     MTS_MASKED_FUNCTION(ProfilerPhase::RayTest, active);
+    MTS_STATS_COUNT(ShadowRays, active);
 
+    Mask hit;
     if constexpr (is_cuda_array_v<Float>)
-        return ray_test_gpu(ray, active);
+        hit = ray_test_gpu(ray, active);
     else
-        return ray_test_cpu(ray, active);
+        hit = ray_test_cpu(ray, active);
+
+    MTS_STATS_COUNT(ShadowRaysOccluded, active && hit);
+    return hit;
 }
 
 MTS_VARIANT std::pair<typename Scene<Float, Spectrum>::EmitterPtr, Float>
@@ -265,7 +331,8 @@ MTS_VARIANT std::string Scene<Float, Spectrum>::to_string() const {
             oss << ",";
         oss << std::endl;
     }
-    oss << "  ]"<< std::endl
+    oss << "  ]," << std::endl
+        << "  deduplicated_mesh_storage = " << util::mem_string(m_dedup_bytes) << std::endl
         << "]";
     return oss.str();
 }
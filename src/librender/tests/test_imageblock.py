@@ -247,4 +247,30 @@ def test06_put_values_basic(variant_scalar_spectral):
             # we'll just add one sample right in the center of each pixel.
             im.put([j + 0.5, i + 0.5], wavelengths, spectrum, alpha=1.0)
 
-    check_value(im, ref, atol=1e-6)
\ No newline at end of file
+    check_value(im, ref, atol=1e-6)
+
+@pytest.mark.parametrize('filter_name', ['box', 'gaussian'])
+def test07_put_atomic(variant_scalar_rgb, filter_name):
+    from mitsuba.core.xml import load_string
+    from mitsuba.render import ImageBlock
+
+    rfilter = load_string("""<rfilter version="2.0.0" type="%s"/>""" % filter_name)
+    im = ImageBlock([12, 10], 2, filter=rfilter)
+    im.set_offset([3, 4])
+    im.clear()
+
+    # Every splat adds a unit amount of energy, also at the image edges
+    positions = [[9.2, 8.7], [3.1, 4.9], [14.9, 13.9], [7.5, 9.5]]
+    for pos in positions:
+        im.put_atomic(pos, [1.0, 2.0])
+    values = np.array(im.data(), copy=False).reshape(-1, 2)
+    assert ek.allclose(np.sum(values, axis=0), [len(positions), 2 * len(positions)])
+
+    # With a box filter, this matches a regular put() at the pixel centers
+    if filter_name == 'box':
+        im2 = ImageBlock([12, 10], 2, filter=rfilter)
+        im2.set_offset([3, 4])
+        im2.clear()
+        for pos in positions:
+            im2.put(pos, [1.0, 2.0])
+        assert ek.allclose(np.array(im.data()), np.array(im2.data()))
@@ -103,6 +103,21 @@ def test01_create(variants_all_rgb, int_name):
             integrator = make_integrator(int_name, xml="""
                 <integer name="max_depth" value="-2"/>
             """)
+        integrator = make_integrator(int_name, xml="""
+            <integer name="emitter_samples" value="0"/>
+            <integer name="bsdf_samples" value="4"/>
+        """)
+        # Cannot specify both shading_samples and (emitter_samples | bsdf_samples)
+        with pytest.raises(RuntimeError):
+            integrator = make_integrator(int_name, xml="""
+                <integer name="shading_samples" value="3"/>
+                <integer name="bsdf_samples" value="5"/>
+            """)
+        # Paths are continued along a BSDF sample
+        with pytest.raises(RuntimeError):
+            integrator = make_integrator(int_name, xml="""
+                <integer name="bsdf_samples" value="0"/>
+            """)
 
 
 @pytest.mark.parametrize(*integrators)
@@ -148,6 +163,65 @@ def test06_render_timeout(variants_cpu_rgb, int_name):
     assert ek.allclose(timeout, effective, atol=0.5)
 
 
+def render_furnace(xml):
+    """Render the inside of a closed sphere with uniform emission L_e = 1 and
+    albedo a = 0.5, where L = L_e / (1 - a) = 2, and return the mean value"""
+    from mitsuba.core.xml import load_string
+    from mitsuba.core import Bitmap, Struct
+
+    scene = load_string("""<scene version='2.0.0'>
+        <integrator type="path">
+            {}
+            <integer name="samples_per_pass" value="8"/>
+        </integrator>
+        <sensor type="perspective">
+            <film type="hdrfilm">
+                <integer name="width" value="16"/>
+                <integer name="height" value="16"/>
+                <rfilter type="box"/>
+            </film>
+            <sampler type="independent">
+                <integer name="sample_count" value="64"/>
+            </sampler>
+        </sensor>
+        <shape type="sphere">
+            <boolean name="flip_normals" value="true"/>
+            <bsdf type="diffuse">
+                <rgb name="reflectance" value="0.5"/>
+            </bsdf>
+            <emitter type="area">
+                <rgb name="radiance" value="1"/>
+            </emitter>
+        </shape>
+    </scene>""".format(xml))
+
+    sensor = scene.sensors()[0]
+    assert scene.integrator().render(scene, sensor)
+    converted = sensor.film().bitmap(raw=True).convert(
+        Bitmap.PixelFormat.RGB, Struct.Type.Float32, False)
+    return np.mean(np.array(converted, copy=False))
+
+
+@pytest.mark.parametrize('rr_mode', ['throughput', 'adjoint'])
+def test07_render_furnace_rr(variants_cpu_rgb, rr_mode):
+    """Russian roulette (and splitting) must not introduce bias"""
+    mean = render_furnace("""
+        <string name="rr_mode" value="{}"/>
+        <integer name="rr_depth" value="2"/>
+    """.format(rr_mode))
+    assert ek.allclose(mean, 2.0, rtol=3e-2)
+
+
+@pytest.mark.parametrize('emitter_samples, bsdf_samples', [(0, 1), (3, 1), (2, 4)])
+def test08_render_furnace_shading_samples(variants_cpu_rgb, emitter_samples, bsdf_samples):
+    """The MIS weights must account for the number of samples per technique"""
+    mean = render_furnace("""
+        <integer name="emitter_samples" value="{}"/>
+        <integer name="bsdf_samples" value="{}"/>
+    """.format(emitter_samples, bsdf_samples))
+    assert ek.allclose(mean, 2.0, rtol=3e-2)
+
+
 def make_reference_renders():
     mitsuba.set_variant('scalar_rgb')
     from mitsuba.core import Bitmap, Struct
@@ -228,3 +228,97 @@ def test06_load_various_features(variant_scalar_rgb, mesh_format, features, face
                 assert ek.allclose(v[3:6], [0.0, 1.0, 0.0])
 
     return fresolver_append_path(test)()
+
+
+@pytest.mark.parametrize('mesh_format', ['obj', 'ply', 'serialized'])
+def test07_compact_attributes(variant_scalar_rgb, mesh_format):
+    """Compares a mesh stored using compact attribute encodings against the
+    full precision version."""
+    from mitsuba.core import Vector2f, MemoryStream
+    from mitsuba.core.xml import load_string
+
+    def test():
+        def load(compact):
+            return load_string("""
+                <shape type="{0}" version="2.0.0">
+                    <string name="filename" value="resources/data/tests/{0}/rectangle_normals_uv.{0}" />
+                    <boolean name="compact_attributes" value="{1}" />
+                </shape>
+            """.format(mesh_format, compact))
+
+        ref, compact = load('false'), load('true')
+        assert not ref.has_compact_attributes()
+        assert compact.has_compact_attributes()
+        assert compact.vertex_count() == ref.vertex_count()
+        assert compact.face_count() == ref.face_count()
+        assert compact.vertex_struct().size() < ref.vertex_struct().size()
+        # Embree only supports 32-bit indices
+        if not mitsuba.core.MTS_ENABLE_EMBREE:
+            assert compact.face_struct().size() == 6
+        assert ek.allclose(compact.surface_area(), ref.surface_area())
+
+        # Python receives decoded copies of the buffers, positions are exact
+        v_ref, v_compact = ref.vertices(), compact.vertices()
+        for c in ['x', 'y', 'z']:
+            assert ek.allclose(v_ref[c], v_compact[c])
+        for c in ['nx', 'ny', 'nz']:
+            assert ek.allclose(v_ref[c], v_compact[c], atol=1e-4)
+        for c in ['u', 'v']:
+            assert ek.allclose(v_ref[c], v_compact[c], atol=1e-3)
+        assert ek.allclose(ref.faces().tolist(), compact.faces().tolist())
+
+        # Exported PLY files contain the decoded attributes
+        stream = MemoryStream()
+        compact.write_ply(stream)
+        stream.seek(0)
+        data = stream.read(stream.size())
+        assert b'property float nx' in data and b'property float u' in data
+        assert b'property list uchar uint vertex_indices' in data
+
+        for sample in [(0.1, 0.2), (0.5, 0.5), (0.9, 0.3)]:
+            ps_ref = ref.sample_position(0, Vector2f(sample))
+            ps_compact = compact.sample_position(0, Vector2f(sample))
+            assert ek.allclose(ps_ref.p, ps_compact.p)
+            assert ek.allclose(ps_ref.n, ps_compact.n, atol=1e-4)
+            assert ek.allclose(ps_ref.uv, ps_compact.uv, atol=1e-3)
+
+    return fresolver_append_path(test)()
+
+
+@fresolver_append_path
+def test08_optimize_layout(variant_scalar_rgb):
+    """Checks that reordering faces and vertices preserves the geometry."""
+    from mitsuba.core.xml import load_string
+
+    def load(optimize):
+        return load_string("""
+            <shape type="ply" version="2.0.0">
+                <string name="filename" value="resources/data/tests/ply/cbox_smallbox.ply"/>
+                <boolean name="optimize_layout" value="{}"/>
+            </shape>
+        """.format(optimize))
+
+    ref, opt = load('false'), load('true')
+    assert opt.vertex_count() == ref.vertex_count()
+    assert opt.face_count() == ref.face_count()
+    assert ek.allclose(opt.surface_area(), ref.surface_area())
+    assert ek.allclose(opt.bbox().min, ref.bbox().min)
+    assert ek.allclose(opt.bbox().max, ref.bbox().max)
+
+    def triangles(mesh):
+        v, f = mesh.vertices(), mesh.faces()
+        result = []
+        for face in f.tolist():
+            result.append(tuple(sorted(
+                tuple(round(x, 4) for x in v[i].tolist()) for i in face)))
+        return sorted(result)
+
+    assert triangles(ref) == triangles(opt)
+
+    # Vertices are numbered in the order of their first use
+    seen = []
+    for face in opt.faces().tolist():
+        for i in face:
+            if i not in seen:
+                assert i == len(seen)
+                seen.append(i)
@@ -48,3 +48,53 @@ def test01_emitter_checks(variant_scalar_rgb):
                 + shape_xml.format('<emitter type="area" id="my_inner_emitter"/>')
                 + shape_xml.format('<ref id="my_emitter"/>'), 4)
 
+
+
+@fresolver_append_path
+def test02_mesh_deduplication(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+
+    shape_xml = """<shape type="ply">
+        <string name="filename" value="resources/data/tests/ply/cbox_smallbox.ply"/>
+        <bsdf type="{}"/>
+    </shape>"""
+
+    def make_scene(dedup):
+        return load_string("""<scene version="2.0.0">
+            <boolean name="deduplicate_meshes" value="{}"/>
+            {}
+            {}
+            <shape type="obj">
+                <string name="filename" value="resources/data/tests/obj/rectangle_uv.obj"/>
+            </shape>
+        </scene>""".format(dedup, shape_xml.format('diffuse'),
+                           shape_xml.format('conductor')))
+
+    # Identical geometry with different materials shares its storage
+    shapes = make_scene('true').shapes()
+    assert shapes[0].buffer_hash() == shapes[1].buffer_hash()
+    assert shapes[0].has_identical_buffers(shapes[1])
+    assert shapes[0].has_shared_buffers() and shapes[1].has_shared_buffers()
+    assert not shapes[2].has_shared_buffers()
+    assert not shapes[2].has_identical_buffers(shapes[0])
+
+    shapes = make_scene('false').shapes()
+    assert shapes[0].has_identical_buffers(shapes[1])
+    assert not shapes[0].has_shared_buffers()
+
+
+def test03_benchmark_scene(variant_scalar_rgb, tmpdir):
+    from mitsuba.core.xml import load_file
+    from mitsuba.python.benchmark import generate_scene
+
+    for layout in ['random', 'clustered']:
+        fname = generate_scene(str(tmpdir.join(layout)), triangles=100,
+                               layout=layout, emitters=3, repeat=4, medium=True)
+        scene = load_file(fname)
+
+        # 4 mesh copies, 3 spherical emitters and the medium bounding box
+        assert len(scene.shapes()) == 8
+        # Area lights and the environment emitter
+        assert len(scene.emitters()) == 4
+        shapes = [s for s in scene.shapes() if s.primitive_count() == 100]
+        assert len(shapes) == 4
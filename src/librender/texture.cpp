@@ -11,7 +11,9 @@ NAMESPACE_BEGIN(mitsuba)
 // =======================================================================
 
 MTS_VARIANT Texture<Float, Spectrum>::Texture(const Properties &props)
-    : m_id(props.id()) { }
+    : m_id(props.id()),
+      m_profiler_handle(profiler_register_object(ProfilerObjectType::Texture,
+                                                 props.plugin_name(), props.id())) { }
 
 MTS_VARIANT Texture<Float, Spectrum>::~Texture() { }
 
@@ -1,3 +1,4 @@
+#include <mitsuba/core/appender.h>
 #include <mitsuba/core/argparser.h>
 #include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/filesystem.h>
@@ -5,13 +6,18 @@
 #include <mitsuba/core/fstream.h>
 #include <mitsuba/core/jit.h>
 #include <mitsuba/core/logger.h>
+#include <mitsuba/core/memtrack.h>
 #include <mitsuba/core/profiler.h>
+#include <mitsuba/core/report.h>
+#include <mitsuba/core/stats.h>
 #include <mitsuba/core/thread.h>
+#include <mitsuba/core/timer.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/vector.h>
 #include <mitsuba/core/xml.h>
 #include <mitsuba/render/integrator.h>
 #include <mitsuba/render/records.h>
+#include <mitsuba/render/sampler.h>
 #include <mitsuba/render/scene.h>
 #include <tbb/task_scheduler_init.h>
 
@@ -61,6 +67,63 @@ Options:
 
     -o <filename>, --output <filename>
         Write the output image to the file "filename".
+
+    -r, --report
+        Write a JSON report next to the output image ("<filename>.json")
+        with the wall clock and CPU time of the parsing, geometry and
+        texture loading, acceleration data structure construction,
+        rendering and development stages, the peak memory usage,
+        memory usage by subsystem, thread count, sample count, and
+        rendering throughput.
+
+    -c, --cache
+        Cache the parsed scene description in a binary file next to
+        the scene ("<filename>.cache") and reuse it on subsequent runs
+        with the same scene, parameters and mode.
+
+    --streaming
+        Instantiate objects of the scene while the rest of the file is
+        still being parsed. Errors in later parts of the file may then
+        be reported after earlier objects were created.
+
+    --profile-json <filename>
+        Write the sampling profiler's results (hierarchical phases
+        with a per-thread breakdown) to a JSON file.
+
+    --profile-trace <filename>
+        Write the per-thread timeline of profiler phases in the Chrome
+        trace event format (chrome://tracing, Perfetto, speedscope).
+
+    --profile-counters
+        Attribute hardware performance counters (cycles, instructions,
+        cache and branch misses, stalled cycles) to the profiler phases.
+        Linux only, requires access to perf_event_open().
+
+    --profile-objects <count>
+        Attribute profiler samples to individual material, texture and
+        emitter instances (identified by their ID in the scene file)
+        and report the <count> most expensive ones of each type.
+        Also enables per-object invocation counts in --stats-json.
+
+    --stats-json <filename>
+        Write render statistics (ray counts, path lengths, kd-tree
+        traversal costs, ..) to a JSON file. Requires a build with
+        the MTS_ENABLE_STATS CMake option.
+
+    --progress-file <filename>
+        Periodically replace the contents of the given file by the
+        rendering progress, elapsed time, estimated remaining time,
+        and sample and ray throughput in JSON format (for polling by
+        job schedulers).
+
+    --log-limit <count>
+        Log at most <count> messages per source location and second,
+        and collapse repeated messages. Default: 0 (no limit).
+
+    --log-async
+        Write log messages from a background thread, so that warning
+        storms from worker threads don't serialize rendering. Errors
+        are still reported synchronously.
 )";
 }
 
@@ -68,7 +131,8 @@ std::function<void(void)> develop_callback;
 std::mutex develop_callback_mutex;
 
 template <typename Float, typename Spectrum>
-bool render(Object *scene_, size_t sensor_i, filesystem::path filename) {
+bool render(Object *scene_, size_t sensor_i, filesystem::path filename,
+            const std::string &stats_filename, bool write_report) {
     auto *scene = dynamic_cast<Scene<Float, Spectrum> *>(scene_);
     if (!scene)
         Throw("Root element of the input file must be a <scene> tag!");
@@ -88,15 +152,38 @@ bool render(Object *scene_, size_t sensor_i, filesystem::path filename) {
         std::lock_guard<std::mutex> guard(develop_callback_mutex);
         develop_callback = [&]() { film->develop(); };
     }
+    Statistics::reset();
+    Timer timer;
+    ScopedStage render_stage(ReportStage::Render);
     bool success = integrator->render(scene, sensor.get());
+    render_stage.finish();
+    double render_time = timer.value() / 1000.0;
     /* critical section */ {
         std::lock_guard<std::mutex> guard(develop_callback_mutex);
         develop_callback = nullptr;
     }
-    if (success)
-        film->develop();
-    else
+    if (success) {
+        /* develop */ {
+            ScopedStage develop_stage(ReportStage::Develop);
+            film->develop();
+        }
+        Statistics::print_report(render_time);
+        MemoryTracker::print_report();
+        if (!stats_filename.empty())
+            Statistics::write_json(stats_filename, render_time);
+        if (write_report) {
+            double spp = (double) sensor->sampler()->sample_count(),
+                   samples = spp * hprod(film->crop_size());
+            RenderReport::set_value("thread_count", (double) __global_thread_count);
+            RenderReport::set_value("spp", spp);
+            RenderReport::set_value("samples_per_second",
+                                    render_time > 0 ? samples / render_time : 0.0);
+            filename.replace_extension("json");
+            RenderReport::write_json(filename);
+        }
+    } else {
         Log(Warn, "\U0000274C Rendering failed, result not saved.");
+    }
     return success;
 }
 
@@ -130,10 +217,22 @@ int main(int argc, char *argv[]) {
     auto arg_sensor_i  = parser.add(StringVec{ "-s", "--sensor" }, true);
     auto arg_output    = parser.add(StringVec{ "-o", "--output" }, true);
     auto arg_update    = parser.add(StringVec{ "-u", "--update" }, false);
+    auto arg_report    = parser.add(StringVec{ "-r", "--report" }, false);
+    auto arg_cache     = parser.add(StringVec{ "-c", "--cache" }, false);
+    auto arg_streaming = parser.add(StringVec{ "--streaming" }, false);
+    auto arg_profile   = parser.add(StringVec{ "--profile-json" }, true);
+    auto arg_trace     = parser.add(StringVec{ "--profile-trace" }, true);
+    auto arg_counters  = parser.add(StringVec{ "--profile-counters" }, false);
+    auto arg_objects   = parser.add(StringVec{ "--profile-objects" }, true);
+    auto arg_stats     = parser.add(StringVec{ "--stats-json" }, true);
+    auto arg_log_limit = parser.add(StringVec{ "--log-limit" }, true);
+    auto arg_log_async = parser.add(StringVec{ "--log-async" }, false);
+    auto arg_progress  = parser.add(StringVec{ "--progress-file" }, true);
     auto arg_help      = parser.add(StringVec{ "-h", "--help" });
     auto arg_mode      = parser.add(StringVec{ "-m", "--mode" }, true);
     auto arg_extra     = parser.add("", true);
     bool print_profile = false;
+    std::string profile_json, profile_trace, stats_json;
     xml::ParameterList params;
     std::string error_msg;
 
@@ -151,14 +250,22 @@ int main(int argc, char *argv[]) {
         // Parse all command line options
         parser.parse(argc, argv);
 
+        auto logger = Thread::thread()->logger();
         if (*arg_verbose) {
-            auto logger = Thread::thread()->logger();
             if (arg_verbose->next())
                 logger->set_log_level(Trace);
             else
                 logger->set_log_level(Debug);
         }
 
+        if (*arg_log_limit)
+            logger->set_rate_limit((uint32_t) arg_log_limit->as_int());
+        if (*arg_log_async)
+            logger->set_async(true);
+
+        if (*arg_progress)
+            logger->add_appender(new ProgressFileAppender(arg_progress->as_string()));
+
         while (arg_define && *arg_define) {
             std::string value = arg_define->as_string();
             auto sep = value.find('=');
@@ -168,6 +275,30 @@ int main(int argc, char *argv[]) {
                                             value.substr(sep+1)));
             arg_define = arg_define->next();
         }
+        if (*arg_profile)
+            profile_json = arg_profile->as_string();
+        if (*arg_trace) {
+            profile_trace = arg_trace->as_string();
+            Profiler::enable_trace();
+        }
+        if (*arg_counters) {
+#if defined(MTS_ENABLE_PROFILER)
+            Profiler::enable_counters();
+#else
+            Log(Warn, "--profile-counters: Mitsuba was compiled without "
+                      "MTS_ENABLE_PROFILER, no counters will be recorded.");
+#endif
+        }
+        if (*arg_objects)
+            Profiler::enable_objects((size_t) arg_objects->as_int());
+        if (*arg_stats) {
+            stats_json = arg_stats->as_string();
+#if !defined(MTS_ENABLE_STATS)
+            Log(Warn, "--stats-json: Mitsuba was compiled without MTS_ENABLE_STATS, "
+                      "no statistics will be written.");
+#endif
+        }
+
         std::string mode = (*arg_mode ? arg_mode->as_string() : MTS_DEFAULT_VARIANT);
         if (string::starts_with(mode, "gpu"))
             cie_alloc();
@@ -213,12 +344,16 @@ int main(int argc, char *argv[]) {
             if (*arg_output)
                 filename = arg_output->as_string();
 
+            RenderReport::reset();
+
             // Try and parse a scene from the passed file.
             ref<Object> parsed =
-                xml::load_file(arg_extra->as_string(), mode, params, *arg_update);
+                xml::load_file(arg_extra->as_string(), mode, params, *arg_update,
+                               *arg_cache, *arg_streaming);
 
             bool success = MTS_INVOKE_VARIANT(mode, render, parsed.get(),
-                                              sensor_i, filename);
+                                              sensor_i, filename, stats_json,
+                                              (bool) *arg_report);
             print_profile = print_profile || success;
             arg_extra = arg_extra->next();
         }
@@ -256,8 +391,17 @@ int main(int argc, char *argv[]) {
     }
 
     Profiler::static_shutdown();
-    if (print_profile)
+    if (print_profile) {
         Profiler::print_report();
+        try {
+            if (!profile_json.empty())
+                Profiler::write_json(profile_json);
+            if (!profile_trace.empty())
+                Profiler::write_chrome_trace(profile_trace);
+        } catch (const std::exception &e) {
+            Log(Warn, "%s", e.what());
+        }
+    }
     Bitmap::static_shutdown();
     Logger::static_shutdown();
     Thread::static_shutdown();
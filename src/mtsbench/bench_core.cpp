@@ -0,0 +1,87 @@
+#include "benchmark.h"
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/rfilter.h>
+#include <mitsuba/core/struct.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Resolution of the images used by the Bitmap and StructConverter benchmarks
+static const Vector2u bench_image_size(1024, 1024);
+
+static ref<Bitmap> bench_bitmap(Bitmap::PixelFormat pixel_format) {
+    ref<Bitmap> bitmap = new Bitmap(pixel_format, Struct::Type::Float32, bench_image_size);
+    PCG32<uint32_t> rng;
+    float *data = (float *) bitmap->data();
+    for (size_t i = 0, n = bitmap->pixel_count() * bitmap->channel_count(); i < n; ++i)
+        data[i] = rng.next_float32();
+    return bitmap;
+}
+
+void bench_core(Benchmark &bench) {
+    bench.set_variant("core");
+    size_t pixel_count = hprod(bench_image_size);
+
+    /* StructConverter: float32 RGBA -> 8 bit sRGB (the path taken when
+       writing LDR images) and 8 bit sRGB -> float32 (loading textures) */ {
+        ref<Struct> linear = new Struct(), srgb = new Struct();
+        for (const char *ch : { "R", "G", "B", "A" }) {
+            linear->append(ch, Struct::Type::Float32);
+            uint32_t flags = (uint32_t) Struct::Flags::Normalized;
+            if (ch[0] != 'A')
+                flags |= (uint32_t) Struct::Flags::Gamma;
+            srgb->append(ch, Struct::Type::UInt8, flags);
+        }
+
+        ref<Bitmap> source = bench_bitmap(Bitmap::PixelFormat::RGBA);
+        std::unique_ptr<uint8_t[]> temp(new uint8_t[pixel_count * 4]);
+        std::unique_ptr<float[]> result(new float[pixel_count * 4]);
+
+        StructConverter to_srgb(linear, srgb), to_srgb_dither(linear, srgb, true),
+                        to_linear(srgb, linear);
+
+        bench.run("struct_converter.float32_to_srgb8", pixel_count, [&]() {
+            to_srgb.convert(pixel_count, source->data(), temp.get());
+            do_not_optimize(temp[0]);
+        });
+        bench.run("struct_converter.float32_to_srgb8_dither", pixel_count, [&]() {
+            to_srgb_dither.convert(pixel_count, source->data(), temp.get());
+            do_not_optimize(temp[0]);
+        });
+        bench.run("struct_converter.srgb8_to_float32", pixel_count, [&]() {
+            to_linear.convert(pixel_count, temp.get(), result.get());
+            do_not_optimize(result[0]);
+        });
+    }
+
+    /* Bitmap::convert() and Bitmap::resample() */ {
+        ref<Bitmap> rgba = bench_bitmap(Bitmap::PixelFormat::RGBA),
+                    xyz  = bench_bitmap(Bitmap::PixelFormat::XYZA);
+
+        bench.run("bitmap.convert.rgba32f_to_rgb8", pixel_count, [&]() {
+            ref<Bitmap> result = rgba->convert(Bitmap::PixelFormat::RGB,
+                                               Struct::Type::UInt8, true);
+            do_not_optimize(result->data());
+        });
+        bench.run("bitmap.convert.xyza32f_to_rgba16f", pixel_count, [&]() {
+            ref<Bitmap> result = xyz->convert(Bitmap::PixelFormat::RGBA,
+                                              Struct::Type::Float16, false);
+            do_not_optimize(result->data());
+        });
+
+        for (const char *name : { "box", "tent", "gaussian", "mitchell", "lanczos" }) {
+            ref<Bitmap::ReconstructionFilter> rfilter =
+                PluginManager::instance()->create_object<Bitmap::ReconstructionFilter>(
+                    Properties(name));
+            Vector2u half_size = bench_image_size / 2u;
+            bench.run(std::string("bitmap.resample.") + name, hprod(half_size), [&]() {
+                ref<Bitmap> result = rgba->resample(half_size, rfilter);
+                do_not_optimize(result->data());
+            });
+        }
+    }
+}
+
+NAMESPACE_END(mitsuba)
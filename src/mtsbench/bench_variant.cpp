@@ -0,0 +1,429 @@
+#include "benchmark.h"
+#include <mitsuba/core/distr_2d.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/rfilter.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/warp.h>
+#include <mitsuba/core/xml.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/kdtree.h>
+#include <mitsuba/render/mesh.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Number of entries (scalars or packets) processed by one iteration of a kernel benchmark
+static constexpr size_t bench_size = 4096;
+
+/// Number of triangles of the mesh used by the kd-tree benchmarks
+static constexpr size_t bench_triangles = 100000;
+
+/// Resolution of the coherent (pinhole camera) ray set
+static constexpr uint32_t bench_coherent_res = 256;
+
+/// Uniformly distributed random numbers of a scalar or packet type
+template <typename Float> struct BenchRandom {
+    using UInt32 = uint32_array_t<Float>;
+    using UInt64 = uint64_array_t<Float>;
+
+    BenchRandom(uint64_t seed) {
+        m_rng.seed(seed, PCG32_DEFAULT_STREAM + arange<UInt64>());
+    }
+
+    Float next_1d() {
+        if constexpr (is_double_v<scalar_t<Float>>)
+            return m_rng.next_float64();
+        else
+            return m_rng.next_float32();
+    }
+
+    Point<Float, 2> next_2d() {
+        Float x = next_1d();
+        return Point<Float, 2>(x, next_1d());
+    }
+
+    PCG32<UInt32> m_rng;
+};
+
+/// Evaluate \c func for every element of \c inputs and keep the results alive
+template <typename T, typename Func>
+MTS_INLINE void bench_apply(const std::vector<T> &inputs, Func &&func) {
+    for (const T &value : inputs)
+        do_not_optimize(func(value));
+}
+
+// =======================================================================
+//! @{ \name warp:: functions
+// =======================================================================
+
+template <typename Float, typename Spectrum> void bench_warp(Benchmark &bench) {
+    MTS_IMPORT_CORE_TYPES()
+    constexpr size_t items = bench_size * array_size_v<Float>;
+
+    BenchRandom<Float> rng(1);
+    std::vector<Point2f> samples(bench_size);
+    std::vector<Vector3f> directions(bench_size);
+    for (size_t i = 0; i < bench_size; ++i) {
+        samples[i] = rng.next_2d();
+        directions[i] = warp::square_to_uniform_sphere(rng.next_2d());
+    }
+
+    auto run = [&](const std::string &name, auto func) {
+        bench.run("warp." + name, items, [&]() { bench_apply(samples, func); });
+    };
+
+    auto run_pdf = [&](const std::string &name, auto func) {
+        bench.run("warp." + name, items, [&]() { bench_apply(directions, func); });
+    };
+
+    run("square_to_uniform_disk", [](const Point2f &s) {
+        return warp::square_to_uniform_disk(s); });
+    run("square_to_uniform_disk_concentric", [](const Point2f &s) {
+        return warp::square_to_uniform_disk_concentric(s); });
+    run("square_to_uniform_triangle", [](const Point2f &s) {
+        return warp::square_to_uniform_triangle(s); });
+    run("square_to_std_normal", [](const Point2f &s) {
+        return warp::square_to_std_normal(s); });
+    run("square_to_tent", [](const Point2f &s) {
+        return warp::square_to_tent(s); });
+    run("square_to_uniform_sphere", [](const Point2f &s) {
+        return warp::square_to_uniform_sphere(s); });
+    run("square_to_uniform_hemisphere", [](const Point2f &s) {
+        return warp::square_to_uniform_hemisphere(s); });
+    run("square_to_cosine_hemisphere", [](const Point2f &s) {
+        return warp::square_to_cosine_hemisphere(s); });
+    run("square_to_uniform_cone", [](const Point2f &s) {
+        return warp::square_to_uniform_cone(s, Float(.5f)); });
+    run("square_to_beckmann", [](const Point2f &s) {
+        return warp::square_to_beckmann(s, Float(.3f)); });
+    run("square_to_von_mises_fisher", [](const Point2f &s) {
+        return warp::square_to_von_mises_fisher(s, ScalarFloat(10.f)); });
+    run("square_to_rough_fiber", [](const Point2f &s) {
+        return warp::square_to_rough_fiber(Point3f(s.x(), s.y(), s.x()),
+                                           Vector3f(0.f, 0.f, 1.f),
+                                           Vector3f(1.f, 0.f, 0.f),
+                                           ScalarFloat(10.f)); });
+
+    run_pdf("square_to_cosine_hemisphere_pdf", [](const Vector3f &v) {
+        return warp::square_to_cosine_hemisphere_pdf(v); });
+    run_pdf("square_to_beckmann_pdf", [](const Vector3f &v) {
+        return warp::square_to_beckmann_pdf(v, Float(.3f)); });
+    run_pdf("square_to_von_mises_fisher_pdf", [](const Vector3f &v) {
+        return warp::square_to_von_mises_fisher_pdf(v, ScalarFloat(10.f)); });
+}
+
+//! @}
+// =======================================================================
+
+// =======================================================================
+//! @{ \name Hierarchical2D / Marginal2D
+// =======================================================================
+
+template <typename Float, typename Spectrum> void bench_distr_2d(Benchmark &bench) {
+    MTS_IMPORT_CORE_TYPES()
+    constexpr size_t items = bench_size * array_size_v<Float>;
+    const ScalarVector2u res(256, 128);
+
+    // Smooth positive function with a sharp peak
+    std::vector<ScalarFloat> data(hprod(res));
+    for (uint32_t y = 0; y < res.y(); ++y) {
+        for (uint32_t x = 0; x < res.x(); ++x) {
+            ScalarFloat dx = x / ScalarFloat(res.x()) - .3f,
+                        dy = y / ScalarFloat(res.y()) - .6f;
+            data[y * res.x() + x] = .1f + std::exp(-50.f * (dx * dx + dy * dy));
+        }
+    }
+
+    BenchRandom<Float> rng(2);
+    std::vector<Point2f> samples(bench_size);
+    for (auto &s : samples)
+        s = rng.next_2d();
+
+    auto run = [&](const std::string &name, const auto &distr) {
+        bench.run("distr_2d." + name + ".sample", items, [&]() {
+            bench_apply(samples, [&](const Point2f &s) { return distr.sample(s); });
+        });
+        bench.run("distr_2d." + name + ".eval", items, [&]() {
+            bench_apply(samples, [&](const Point2f &s) { return distr.eval(s); });
+        });
+        bench.run("distr_2d." + name + ".invert", items, [&]() {
+            bench_apply(samples, [&](const Point2f &s) { return distr.invert(s); });
+        });
+    };
+
+    run("hierarchical", Hierarchical2D<Float, 0>(data.data(), res));
+    run("marginal_discrete", Marginal2D<Float, 0, false>(data.data(), res));
+    run("marginal_continuous", Marginal2D<Float, 0, true>(data.data(), res));
+}
+
+//! @}
+// =======================================================================
+
+// =======================================================================
+//! @{ \name kd-tree construction and traversal, ray-triangle intersection
+// =======================================================================
+
+template <typename Float, typename Spectrum> void bench_kdtree(Benchmark &bench) {
+    MTS_IMPORT_TYPES(Mesh, ShapeKDTree)
+    using InputFloat  = typename Mesh::InputFloat;
+    using ScalarIndex = typename Mesh::ScalarIndex;
+    constexpr size_t items = bench_size * array_size_v<Float>;
+
+    /* Random triangle soup in the unit cube: small triangles around
+       uniformly distributed centers */
+    ref<Struct> vertex_struct = new Struct(), face_struct = new Struct();
+    for (const char *name : { "x", "y", "z" })
+        vertex_struct->append(name, struct_type_v<InputFloat>);
+    for (const char *name : { "i0", "i1", "i2" })
+        face_struct->append(name, struct_type_v<ScalarIndex>);
+
+    ref<Mesh> mesh = new Mesh("bench_mesh", vertex_struct, 3 * bench_triangles,
+                              face_struct, bench_triangles);
+    InputFloat *vertices = (InputFloat *) mesh->vertices();
+    ScalarIndex *faces = (ScalarIndex *) mesh->faces();
+    BenchRandom<ScalarFloat> scalar_rng(3);
+    for (size_t i = 0; i < bench_triangles; ++i) {
+        ScalarPoint3f center(scalar_rng.next_1d(), scalar_rng.next_1d(),
+                             scalar_rng.next_1d());
+        for (size_t j = 0; j < 3; ++j) {
+            for (size_t k = 0; k < 3; ++k)
+                vertices[(3 * i + j) * 3 + k] =
+                    (InputFloat) (center[k] + .02f * (scalar_rng.next_1d() - .5f));
+            faces[3 * i + j] = ScalarIndex(3 * i + j);
+        }
+    }
+    mesh->recompute_bbox();
+
+    /* The kd-tree builder reports its progress at the 'Info' level, which
+       is far too verbose when it runs many times in a row */
+    Logger *logger = Thread::thread()->logger();
+    auto build = [&]() {
+        ref<ShapeKDTree> kdtree = new ShapeKDTree(Properties());
+        kdtree->add_shape(mesh);
+        LogLevel level = logger->log_level();
+        logger->set_log_level(std::max(level, Warn));
+        kdtree->build();
+        logger->set_log_level(level);
+        return kdtree;
+    };
+
+    bench.run("kdtree.build", bench_triangles, [&]() { do_not_optimize(build().get()); });
+    ref<ShapeKDTree> kdtree = build();
+
+    BenchRandom<Float> rng(4);
+    Wavelength wavelengths = zero<Wavelength>();
+
+    // Random rays: uniformly distributed origins and directions
+    std::vector<Ray3f> random_rays(bench_size);
+    for (auto &ray : random_rays) {
+        Point3f o(rng.next_1d(), rng.next_1d(), rng.next_1d());
+        Vector3f d = warp::square_to_uniform_sphere(rng.next_2d());
+        ray = Ray3f(o, d, Float(0.f), wavelengths);
+    }
+
+    /* Coherent rays: pinhole camera in front of the cube, consecutive
+       rays (and packet lanes) visit neighboring pixels in scanline order */
+    std::vector<Ray3f> coherent_rays(bench_size);
+    for (size_t i = 0; i < bench_size; ++i) {
+        UInt32 index = UInt32(uint32_t(i * array_size_v<Float>)) + arange<UInt32>();
+        index %= bench_coherent_res * bench_coherent_res;
+        Float x = Float(index % bench_coherent_res) / Float(bench_coherent_res),
+              y = Float(index / bench_coherent_res) / Float(bench_coherent_res);
+        Point3f o(.5f, .5f, -1.f);
+        Vector3f d = normalize(Point3f(x, y, 0.f) - o);
+        coherent_rays[i] = Ray3f(o, d, Float(0.f), wavelengths);
+    }
+
+    auto traverse = [&](const std::string &name, const std::vector<Ray3f> &rays) {
+        bench.run("kdtree.ray_intersect." + name, items, [&]() {
+            Float cache[MTS_KD_INTERSECTION_CACHE_SIZE];
+            bench_apply(rays, [&](const Ray3f &ray) {
+                return kdtree->template ray_intersect<false>(ray, cache, true).second;
+            });
+        });
+        bench.run("kdtree.ray_test." + name, items, [&]() {
+            bench_apply(rays, [&](const Ray3f &ray) {
+                return kdtree->template ray_intersect<true>(ray, (Float *) nullptr, true).first;
+            });
+        });
+    };
+
+    traverse("random", random_rays);
+    traverse("coherent", coherent_rays);
+
+    // Ray-triangle tests against random triangles, half of which are hit
+    std::vector<std::pair<UInt32, Ray3f>> triangle_queries(bench_size);
+    for (auto &[index, ray] : triangle_queries) {
+        index = UInt32(rng.next_1d() * ScalarFloat(bench_triangles));
+        auto fi = mesh->face_indices(index);
+        Point3f target = (mesh->vertex_position(fi[0]) + mesh->vertex_position(fi[1]) +
+                          mesh->vertex_position(fi[2])) * (1.f / 3.f);
+        Point3f o = target + warp::square_to_uniform_sphere(rng.next_2d());
+        Vector3f d = normalize(target - o);
+        d = select(rng.next_1d() < .5f, d, -d);
+        ray = Ray3f(o, d, Float(0.f), wavelengths);
+    }
+
+    bench.run("mesh.ray_intersect_triangle", items, [&]() {
+        for (auto const &[index, ray] : triangle_queries)
+            do_not_optimize(std::get<3>(mesh->ray_intersect_triangle(index, ray)));
+    });
+}
+
+//! @}
+// =======================================================================
+
+// =======================================================================
+//! @{ \name BSDF plugins
+// =======================================================================
+
+template <typename Float, typename Spectrum>
+void bench_bsdf(Benchmark &bench, const std::string &variant,
+                const xml::ParameterList &params) {
+    MTS_IMPORT_TYPES(BSDF)
+    constexpr size_t items = bench_size * array_size_v<Float>;
+
+    /* Every BSDF plugin with representative parameters. 'measured'
+       requires a data file, specified via -D measured=<filename> */
+    const std::pair<const char *, const char *> bsdfs[] = {
+        { "diffuse",         "<bsdf type='diffuse'/>" },
+        { "conductor",       "<bsdf type='conductor'/>" },
+        { "roughconductor",  "<bsdf type='roughconductor'>"
+                             "<float name='alpha' value='0.2'/></bsdf>" },
+        { "roughconductor_anisotropic",
+                             "<bsdf type='roughconductor'>"
+                             "<float name='alpha_u' value='0.05'/>"
+                             "<float name='alpha_v' value='0.3'/></bsdf>" },
+        { "dielectric",      "<bsdf type='dielectric'/>" },
+        { "thindielectric",  "<bsdf type='thindielectric'/>" },
+        { "roughdielectric", "<bsdf type='roughdielectric'>"
+                             "<float name='alpha' value='0.2'/></bsdf>" },
+        { "plastic",         "<bsdf type='plastic'/>" },
+        { "roughplastic",    "<bsdf type='roughplastic'/>" },
+        { "null",            "<bsdf type='null'/>" },
+        { "twosided",        "<bsdf type='twosided'>"
+                             "<bsdf type='roughconductor'/></bsdf>" },
+        { "mask",            "<bsdf type='mask'><float name='opacity' value='0.5'/>"
+                             "<bsdf type='diffuse'/></bsdf>" },
+        { "blendbsdf",       "<bsdf type='blendbsdf'><float name='weight' value='0.3'/>"
+                             "<bsdf type='diffuse'/><bsdf type='roughconductor'/></bsdf>" },
+        { "polarizer",       "<bsdf type='polarizer'/>" },
+        { "retarder",        "<bsdf type='retarder'/>" },
+        { "measured",        "<bsdf type='measured'>"
+                             "<string name='filename' value='$measured'/></bsdf>" }
+    };
+
+    BenchRandom<Float> rng(5);
+    std::vector<SurfaceInteraction3f> interactions(bench_size);
+    std::vector<Vector3f> directions(bench_size);
+    std::vector<std::pair<Float, Point2f>> samples(bench_size);
+    for (size_t i = 0; i < bench_size; ++i) {
+        SurfaceInteraction3f si = zero<SurfaceInteraction3f>();
+        si.n = Normal3f(0.f, 0.f, 1.f);
+        si.sh_frame = Frame3f(si.n);
+        si.uv = rng.next_2d();
+        si.wi = warp::square_to_cosine_hemisphere(rng.next_2d());
+        si.wavelengths = sample_wavelength<Float, Spectrum>(rng.next_1d()).first;
+        interactions[i] = si;
+        directions[i] = warp::square_to_cosine_hemisphere(rng.next_2d());
+        samples[i].first = rng.next_1d();
+        samples[i].second = rng.next_2d();
+    }
+
+    BSDFContext ctx;
+    for (auto const &[name, xml_string] : bsdfs) {
+        std::string prefix = std::string("bsdf.") + name;
+        if (!bench.enabled(prefix))
+            continue;
+
+        ref<BSDF> bsdf;
+        try {
+            std::string str(xml_string);
+            str.insert(5, " version='2.0.0'"); // after "<bsdf"
+            bsdf = dynamic_cast<BSDF *>(xml::load_string(str, variant, params).get());
+        } catch (const std::exception &e) {
+            Log(Warn, "Skipping %s: %s", prefix, e.what());
+            continue;
+        }
+
+        bench.run(prefix + ".eval", items, [&]() {
+            for (size_t i = 0; i < bench_size; ++i)
+                do_not_optimize(bsdf->eval(ctx, interactions[i], directions[i]));
+        });
+        bench.run(prefix + ".pdf", items, [&]() {
+            for (size_t i = 0; i < bench_size; ++i)
+                do_not_optimize(bsdf->pdf(ctx, interactions[i], directions[i]));
+        });
+        bench.run(prefix + ".sample", items, [&]() {
+            for (size_t i = 0; i < bench_size; ++i)
+                do_not_optimize(bsdf->sample(ctx, interactions[i], samples[i].first,
+                                             samples[i].second).second);
+        });
+    }
+}
+
+//! @}
+// =======================================================================
+
+// =======================================================================
+//! @{ \name ImageBlock::put() with each reconstruction filter
+// =======================================================================
+
+template <typename Float, typename Spectrum> void bench_imageblock(Benchmark &bench) {
+    MTS_IMPORT_TYPES(ImageBlock, ReconstructionFilter)
+    constexpr size_t items = bench_size * array_size_v<Float>;
+    const ScalarVector2i size(64, 64);
+
+    BenchRandom<Float> rng(6);
+    std::vector<std::pair<Point2f, Wavelength>> samples(bench_size);
+    for (auto &[pos, wavelengths] : samples) {
+        pos = rng.next_2d() * ScalarVector2f(size);
+        wavelengths = sample_wavelength<Float, Spectrum>(rng.next_1d()).first;
+    }
+    Spectrum value(.5f);
+
+    for (const char *name : { "box", "tent", "gaussian", "mitchell", "catmullrom", "lanczos" }) {
+        std::string bench_name = std::string("imageblock.put.") + name;
+        if (!bench.enabled(bench_name))
+            continue;
+        ref<ReconstructionFilter> rfilter =
+            PluginManager::instance()->create_object<ReconstructionFilter>(Properties(name));
+        ref<ImageBlock> block = new ImageBlock(size, 5, rfilter, false, false);
+        block->clear();
+
+        bench.run(bench_name, items, [&]() {
+            for (auto const &[pos, wavelengths] : samples)
+                do_not_optimize(block->put(pos, wavelengths, value, Float(1.f)));
+        });
+    }
+}
+
+//! @}
+// =======================================================================
+
+template <typename Float, typename Spectrum>
+void bench_variant_impl(Benchmark &bench, const std::string &variant,
+                        const xml::ParameterList &params) {
+    if constexpr (is_dynamic_array_v<Float>) {
+        Throw("Benchmarks are only available for scalar and packet variants!");
+    } else {
+        bench_warp<Float, Spectrum>(bench);
+        bench_distr_2d<Float, Spectrum>(bench);
+        bench_kdtree<Float, Spectrum>(bench);
+        bench_bsdf<Float, Spectrum>(bench, variant, params);
+        bench_imageblock<Float, Spectrum>(bench);
+    }
+}
+
+void bench_variant(Benchmark &bench, const std::string &variant,
+                   const xml::ParameterList &params) {
+    bench.set_variant(variant);
+    MTS_INVOKE_VARIANT(variant, bench_variant_impl, bench, variant, params);
+}
+
+NAMESPACE_END(mitsuba)
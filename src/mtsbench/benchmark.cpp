@@ -0,0 +1,60 @@
+#include "benchmark.h"
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/util.h>
+#include <algorithm>
+#include <fstream>
+
+NAMESPACE_BEGIN(mitsuba)
+
+#if defined(_MSC_VER)
+volatile const void *benchmark_sink = nullptr;
+#endif
+
+void Benchmark::add_result(BenchmarkResult result, std::vector<double> &timings) {
+    std::sort(timings.begin(), timings.end());
+    result.min_time = timings.front();
+    result.median_time = timings[timings.size() / 2];
+
+    Log(Info, "%s [%s]: %s per iteration (%.4g items/s)", result.name,
+        result.variant, util::time_string((float) (result.median_time * 1000), true),
+        result.items / result.median_time);
+    m_results.push_back(result);
+}
+
+void Benchmark::print_report() const {
+    size_t name_width = 9, variant_width = 7;
+    for (auto const &r : m_results) {
+        name_width = std::max(name_width, r.name.length());
+        variant_width = std::max(variant_width, r.variant.length());
+    }
+
+    Log(Info, "\U0001F4CA Benchmark results:");
+    Log(Info, "    %-*s  %-*s  %12s  %12s  %14s", (int) name_width, "Benchmark",
+        (int) variant_width, "Variant", "Median", "Min", "Items/s");
+    for (auto const &r : m_results)
+        Log(Info, "    %-*s  %-*s  %12s  %12s  %14.4g", (int) name_width, r.name,
+            (int) variant_width, r.variant,
+            util::time_string((float) (r.median_time * 1000), true),
+            util::time_string((float) (r.min_time * 1000), true),
+            r.items / r.median_time);
+}
+
+void Benchmark::write_json(const fs::path &filename) const {
+    std::ofstream os(filename.native());
+    if (!os.good())
+        Throw("Benchmark::write_json(): could not open \"%s\"", filename);
+
+    os << "{\n  \"results\": [";
+    for (size_t i = 0; i < m_results.size(); ++i) {
+        const BenchmarkResult &r = m_results[i];
+        os << (i == 0 ? "\n" : ",\n")
+           << "    { \"name\": \"" << r.name << "\", \"variant\": \"" << r.variant
+           << "\", \"items\": " << r.items << ", \"iterations\": " << r.iterations
+           << ", \"min_s\": " << r.min_time << ", \"median_s\": " << r.median_time
+           << ", \"items_per_second\": " << r.items / r.median_time << " }";
+    }
+    os << "\n  ]\n}\n";
+    Log(Info, "Wrote benchmark results to \"%s\"", filename);
+}
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <mitsuba/mitsuba.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/xml.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Prevent the compiler from optimizing away the computation of \c value
+template <typename T> MTS_INLINE void do_not_optimize(const T &value) {
+#if defined(_MSC_VER)
+    extern volatile const void *benchmark_sink;
+    benchmark_sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/// Timings of a single benchmark
+struct BenchmarkResult {
+    std::string name;
+    std::string variant;
+    /// Work items (rays, samples, pixels, ..) processed by one iteration
+    size_t items;
+    /// Iterations per repetition
+    size_t iterations;
+    /// Fastest and median time of one iteration over all repetitions (seconds)
+    double min_time, median_time;
+};
+
+/**
+ * \brief Minimal harness for timing small kernels
+ *
+ * Each benchmark is first calibrated so that a repetition (a batch of
+ * iterations) takes roughly <tt>min_time / repetitions</tt> seconds, after
+ * which the repetitions are timed. The fastest and median iteration times are
+ * reported, the latter being robust to interference from other processes.
+ */
+class Benchmark {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Benchmark(double min_time, size_t repetitions, const std::string &filter)
+        : m_min_time(min_time), m_repetitions(repetitions), m_filter(filter) { }
+
+    /// Set the variant that subsequent results are attributed to
+    void set_variant(const std::string &variant) { m_variant = variant; }
+
+    /// Does the name filter specified on the command line select \c name?
+    bool enabled(const std::string &name) const {
+        return m_filter.empty() || name.find(m_filter) != std::string::npos;
+    }
+
+    /**
+     * \brief Time the function \c func, which processes \c items work items
+     * per invocation.
+     *
+     * Benchmarks are identified by hierarchical names such as
+     * <tt>bsdf.roughconductor.sample</tt>.
+     */
+    template <typename Func> void run(const std::string &name, size_t items, Func &&func) {
+        if (!enabled(name))
+            return;
+
+        auto time = [&](size_t iterations) {
+            auto start = Clock::now();
+            for (size_t i = 0; i < iterations; ++i)
+                func();
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        };
+
+        // Warm up caches and determine the number of iterations per repetition
+        double target = m_min_time / m_repetitions, elapsed = time(1);
+        size_t iterations = 1;
+        while (elapsed < target && iterations < (1ull << 30)) {
+            size_t next = elapsed > 0 ? size_t(iterations * 1.2 * target / elapsed) + 1
+                                      : iterations * 10;
+            iterations = std::min(std::max(next, iterations + 1), iterations * 10);
+            elapsed = time(iterations);
+        }
+
+        std::vector<double> timings(m_repetitions);
+        for (size_t i = 0; i < m_repetitions; ++i)
+            timings[i] = time(iterations) / iterations;
+
+        add_result(BenchmarkResult{ name, m_variant, items, iterations,
+                                    0.0, 0.0 }, timings);
+    }
+
+    /// Print a summary table to the log
+    void print_report() const;
+
+    /// Write all results to a JSON file
+    void write_json(const fs::path &filename) const;
+
+private:
+    void add_result(BenchmarkResult result, std::vector<double> &timings);
+
+private:
+    double m_min_time;
+    size_t m_repetitions;
+    std::string m_filter;
+    std::string m_variant;
+    std::vector<BenchmarkResult> m_results;
+};
+
+/// Benchmarks that do not depend on the variant (StructConverter, Bitmap)
+extern void bench_core(Benchmark &bench);
+
+/**
+ * \brief Benchmarks of a specific scalar or packet variant
+ *
+ * \c params are passed to the XML parser when instantiating plugins
+ * (e.g. <tt>measured</tt>, which requires the name of a data file).
+ */
+extern void bench_variant(Benchmark &bench, const std::string &variant,
+                          const xml::ParameterList &params);
+
+NAMESPACE_END(mitsuba)
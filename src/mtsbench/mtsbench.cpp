@@ -0,0 +1,162 @@
+#include "benchmark.h"
+#include <mitsuba/core/argparser.h>
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/jit.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/fwd.h>
+#include <tbb/task_scheduler_init.h>
+
+using namespace mitsuba;
+
+static void help() {
+    std::cout << util::info_build(1) << std::endl;
+    std::cout << util::info_copyright() << std::endl;
+    std::cout << util::info_features() << std::endl;
+    std::cout << R"(
+Usage: mtsbench [options]
+
+Microbenchmarks of performance-critical kernels: kd-tree construction and
+traversal (random and coherent rays), ray-triangle intersection, BSDF
+evaluation/sampling, warping functions, 2D distributions, image block
+splatting, StructConverter and Bitmap conversion/resampling.
+
+Options:
+
+    -h, --help
+        Display this help text.
+
+    -m <variant>, --mode <variant>
+        Only run the benchmarks of the given variant (can be specified
+        multiple times). Default: all enabled scalar and packet variants.
+
+        Available modes:
+              )" << string::indent(MTS_VARIANTS, 14) << R"(
+    -f <string>, --filter <string>
+        Only run benchmarks whose name contains the given string
+        (e.g. "kdtree", "bsdf.roughconductor", "warp.").
+
+    -o <filename>, --output <filename>
+        Write the results to a JSON file.
+
+    -T <seconds>, --time <seconds>
+        Approximate duration of each benchmark. Default: 0.5.
+
+    -r <count>, --repetitions <count>
+        Number of timed repetitions of each benchmark, from which the
+        fastest and median time are reported. Default: 5.
+
+    -D <key>=<value>, --define <key>=<value>
+        Define a constant that can referenced as "$key" by the plugin
+        descriptions (e.g. -D measured=<file> to benchmark the
+        'measured' BSDF).
+
+    -v, --verbose
+        Be more verbose.
+)";
+}
+
+int main(int argc, char *argv[]) {
+    Jit::static_initialization();
+    Class::static_initialization();
+    Thread::static_initialization();
+    Logger::static_initialization();
+    Bitmap::static_initialization();
+    Profiler::static_initialization();
+
+    // Ensure that the mitsuba-render shared library is loaded
+    librender_nop();
+
+    ArgParser parser;
+    using StringVec      = std::vector<std::string>;
+    auto arg_help        = parser.add(StringVec{ "-h", "--help" });
+    auto arg_mode        = parser.add(StringVec{ "-m", "--mode" }, true);
+    auto arg_filter      = parser.add(StringVec{ "-f", "--filter" }, true);
+    auto arg_output      = parser.add(StringVec{ "-o", "--output" }, true);
+    auto arg_time        = parser.add(StringVec{ "-T", "--time" }, true);
+    auto arg_repetitions = parser.add(StringVec{ "-r", "--repetitions" }, true);
+    auto arg_define      = parser.add(StringVec{ "-D", "--define" }, true);
+    auto arg_verbose     = parser.add(StringVec{ "-v", "--verbose" }, false);
+    std::string error_msg;
+
+    try {
+        parser.parse(argc, argv);
+
+        if (*arg_help) {
+            help();
+        } else {
+            if (*arg_verbose)
+                Thread::thread()->logger()->set_log_level(Debug);
+
+            xml::ParameterList params;
+            while (arg_define && *arg_define) {
+                std::string value = arg_define->as_string();
+                auto sep = value.find('=');
+                if (sep == std::string::npos)
+                    Throw("-D/--define: expect key=value pair!");
+                params.push_back(std::make_pair(value.substr(0, sep),
+                                                value.substr(sep+1)));
+                arg_define = arg_define->next();
+            }
+
+            std::vector<std::string> variants;
+            while (arg_mode && *arg_mode) {
+                variants.push_back(arg_mode->as_string());
+                arg_mode = arg_mode->next();
+            }
+            if (variants.empty()) {
+                for (const std::string &variant : string::tokenize(MTS_VARIANTS, "\n")) {
+                    if (string::starts_with(variant, "scalar_") ||
+                        string::starts_with(variant, "packet_"))
+                        variants.push_back(variant);
+                }
+            }
+
+            // Kernels run on the main thread, the kd-tree builder uses TBB
+            tbb::task_scheduler_init init((int) __global_thread_count);
+
+            // Append the mitsuba directory to the FileResolver search path list
+            ref<FileResolver> fr = Thread::thread()->file_resolver();
+            fs::path base_path = util::library_path().parent_path();
+            if (!fr->contains(base_path))
+                fr->append(base_path);
+
+            Log(Info, "%s", util::info_build((int) __global_thread_count));
+            Log(Info, "%s", util::info_features());
+#if !defined(NDEBUG)
+            Log(Warn, "Benchmarks are compiled in debug mode, timings are not representative.");
+#endif
+
+            Benchmark bench(*arg_time ? arg_time->as_float() : 0.5,
+                            *arg_repetitions ? (size_t) arg_repetitions->as_int() : 5,
+                            *arg_filter ? arg_filter->as_string() : "");
+
+            bench_core(bench);
+            for (const std::string &variant : variants)
+                bench_variant(bench, variant, params);
+
+            bench.print_report();
+            if (*arg_output)
+                bench.write_json(arg_output->as_string());
+        }
+    } catch (const std::exception &e) {
+        error_msg = std::string("Caught a critical exception: ") + e.what();
+    } catch (...) {
+        error_msg = std::string("Caught a critical exception of unknown type!");
+    }
+
+    if (!error_msg.empty())
+        std::cerr << std::endl << error_msg << std::endl;
+
+    Profiler::static_shutdown();
+    Bitmap::static_shutdown();
+    Logger::static_shutdown();
+    Thread::static_shutdown();
+    Class::static_shutdown();
+    Jit::static_shutdown();
+    return error_msg.empty() ? 0 : -1;
+}
@@ -0,0 +1,381 @@
+"""
+Procedurally generated benchmark scenes and an end-to-end throughput tool.
+
+The scenes are fully described by a handful of parameters (triangle count and
+layout, number of emitters, repetitions of the mesh, participating media),
+which makes it possible to collect reproducible scaling numbers without
+shipping large assets. Each run invokes the ``mitsuba`` executable with a
+fixed sample count and collects samples/sec, rays/sec and memory usage from
+its render report (``-r``) and statistics (``--stats-json``, requires a build
+with ``MTS_ENABLE_STATS``).
+
+Usage::
+
+    python -m mitsuba.python.benchmark --triangles 1000000 --layout clustered \\
+        --emitters 16 --scaling --output results.json
+"""
+
+import argparse
+import json
+import math
+import os
+import random
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def write_ply(filename, vertices, faces):
+    """
+    Write a triangle mesh to a binary PLY file.
+
+    Parameter ``vertices`` (list):
+        Flat list of vertex coordinates (x0, y0, z0, x1, ...)
+
+    Parameter ``faces`` (list):
+        Flat list of vertex indices, three per triangle
+    """
+    with open(filename, 'wb') as f:
+        f.write(('ply\n'
+                 'format binary_little_endian 1.0\n'
+                 'element vertex %i\n'
+                 'property float x\n'
+                 'property float y\n'
+                 'property float z\n'
+                 'element face %i\n'
+                 'property list uchar int vertex_indices\n'
+                 'end_header\n' % (len(vertices) // 3, len(faces) // 3)).encode())
+        f.write(struct.pack('<%if' % len(vertices), *vertices))
+        face = struct.Struct('<Biii')
+        f.write(b''.join(face.pack(3, faces[i], faces[i + 1], faces[i + 2])
+                         for i in range(0, len(faces), 3)))
+
+
+def generate_triangles(count, layout='random', clusters=16, seed=0):
+    """
+    Generate ``count`` small random triangles within the cube [-1, 1]^3.
+
+    With ``layout='random'``, triangle centers are uniformly distributed. With
+    ``layout='clustered'``, they follow a mixture of ``clusters`` Gaussians,
+    which yields the strongly varying density of real scenes (and a much
+    deeper kd-tree).
+    """
+    if layout not in ['random', 'clustered']:
+        raise ValueError('Unknown layout "%s"' % layout)
+
+    rng = random.Random(seed)
+    # Edge length such that the triangles cover the volume about once
+    size = 2.0 / max(count, 1) ** (1.0 / 3.0)
+    centers = [(rng.uniform(-.8, .8), rng.uniform(-.8, .8), rng.uniform(-.8, .8),
+                rng.uniform(.05, .2)) for i in range(clusters)]
+
+    vertices, faces = [], []
+    for i in range(count):
+        if layout == 'random':
+            c = [rng.uniform(-1, 1) for k in range(3)]
+        else:
+            cx, cy, cz, sigma = centers[rng.randrange(clusters)]
+            c = [min(max(rng.gauss(v, sigma), -1), 1) for v in (cx, cy, cz)]
+            # Smaller triangles where the density is high
+            size = 2.0 * sigma / max(count / clusters, 1) ** (1.0 / 3.0)
+        for j in range(3):
+            vertices.extend(c[k] + size * rng.uniform(-.5, .5) for k in range(3))
+        faces.extend((3 * i, 3 * i + 1, 3 * i + 2))
+    return vertices, faces
+
+
+def write_volume(filename, res, seed=0):
+    """
+    Write a density grid in Mitsuba's binary volume format (version 3,
+    float32) with a procedural, smoothly varying density in [0, 1].
+    """
+    rng = random.Random(seed)
+    blobs = [(rng.random(), rng.random(), rng.random(), rng.uniform(.05, .2))
+             for i in range(8)]
+    values = []
+    for z in range(res):
+        for y in range(res):
+            for x in range(res):
+                p = (x / (res - 1), y / (res - 1), z / (res - 1))
+                d = sum(math.exp(-((p[0] - bx) ** 2 + (p[1] - by) ** 2 +
+                                   (p[2] - bz) ** 2) / (2 * r * r))
+                        for bx, by, bz, r in blobs)
+                values.append(min(d, 1.0))
+    with open(filename, 'wb') as f:
+        f.write(b'VOL')
+        f.write(struct.pack('<Biiiii', 3, 1, res, res, res, 1))
+        f.write(struct.pack('<6f', 0, 0, 0, 1, 1, 1))
+        f.write(struct.pack('<%if' % len(values), *values))
+
+
+def generate_scene(directory, triangles=100000, layout='random', clusters=16,
+                   emitters=1, repeat=1, medium=False, width=256, height=256,
+                   spp=16, max_depth=6, seed=0):
+    """
+    Generate a benchmark scene in ``directory`` and return the path of its
+    XML description.
+
+    Parameter ``triangles`` (int):
+        Number of triangles of the mesh (see ``generate_triangles()``)
+
+    Parameter ``emitters`` (int):
+        Number of small spherical area lights scattered through the scene,
+        in addition to a dim constant environment
+
+    Parameter ``repeat`` (int):
+        Number of copies of the mesh, arranged on a grid. All copies
+        reference the same file, which mimics the deep repetition of
+        instanced scenes.
+
+    Parameter ``medium`` (bool):
+        Fill a box around the geometry with a heterogeneous medium and render
+        with the volumetric path tracer
+    """
+    os.makedirs(directory, exist_ok=True)
+    rng = random.Random(seed)
+
+    write_ply(os.path.join(directory, 'mesh.ply'),
+              *generate_triangles(triangles, layout, clusters, seed))
+
+    # Arrange copies of the mesh on a (roughly) cubic grid of unit cells
+    n = max(int(math.ceil(repeat ** (1.0 / 3.0))), 1)
+    extent = 2.0 * n
+    shapes = []
+    for i in range(repeat):
+        x, y, z = i % n, (i // n) % n, i // (n * n)
+        shapes.append("""
+        <shape type="ply">
+            <string name="filename" value="mesh.ply"/>
+            <transform name="to_world">
+                <translate x="{x}" y="{y}" z="{z}"/>
+            </transform>
+            <bsdf type="roughplastic">
+                <rgb name="diffuse_reflectance" value="{r:.3f}, {g:.3f}, {b:.3f}"/>
+            </bsdf>
+        </shape>""".format(x=2 * x - n + 1, y=2 * y - n + 1, z=2 * z - n + 1,
+                           r=rng.uniform(.2, .8), g=rng.uniform(.2, .8),
+                           b=rng.uniform(.2, .8)))
+
+    for i in range(emitters):
+        p = [rng.uniform(-.5, .5) * extent for k in range(3)]
+        shapes.append("""
+        <shape type="sphere">
+            <point name="center" x="{x:.4f}" y="{y:.4f}" z="{z:.4f}"/>
+            <float name="radius" value="{radius:.4f}"/>
+            <emitter type="area">
+                <rgb name="radiance" value="{power:.4f}"/>
+            </emitter>
+        </shape>""".format(x=p[0], y=p[1], z=p[2], radius=.02 * extent,
+                           power=10.0 / max(emitters, 1) ** .5))
+
+    integrator = 'path'
+    if medium:
+        integrator = 'volpath'
+        write_volume(os.path.join(directory, 'density.vol'), 32, seed)
+        vertices = [c * extent * .55 for v in range(8)
+                    for c in ((v & 1) * 2 - 1, ((v >> 1) & 1) * 2 - 1, ((v >> 2) & 1) * 2 - 1)]
+        faces = [0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4,
+                 2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5]
+        write_ply(os.path.join(directory, 'box.ply'), vertices, faces)
+        shapes.append("""
+        <shape type="ply">
+            <string name="filename" value="box.ply"/>
+            <bsdf type="null"/>
+            <medium name="interior" type="heterogeneous">
+                <volume name="sigma_t" type="gridvolume">
+                    <string name="filename" value="density.vol"/>
+                    <transform name="to_world">
+                        <scale value="{size}"/>
+                        <translate value="{offset}, {offset}, {offset}"/>
+                    </transform>
+                </volume>
+                <rgb name="albedo" value="0.8, 0.8, 0.8"/>
+                <float name="density_scale" value="{density}"/>
+            </medium>
+        </shape>""".format(size=1.1 * extent, offset=-.55 * extent,
+                           density=2.0 / extent))
+
+    xml = """<scene version="2.0.0">
+    <integrator type="{integrator}">
+        <integer name="max_depth" value="{max_depth}"/>
+    </integrator>
+
+    <sensor type="perspective">
+        <float name="fov" value="45"/>
+        <transform name="to_world">
+            <lookat origin="{d:.4f}, {d:.4f}, {d:.4f}" target="0, 0, 0" up="0, 0, 1"/>
+        </transform>
+        <sampler type="independent">
+            <integer name="sample_count" value="{spp}"/>
+        </sampler>
+        <film type="hdrfilm">
+            <integer name="width" value="{width}"/>
+            <integer name="height" value="{height}"/>
+        </film>
+    </sensor>
+
+    <emitter type="constant">
+        <rgb name="radiance" value="0.1"/>
+    </emitter>
+    {shapes}
+</scene>
+""".format(integrator=integrator, max_depth=max_depth, d=1.4 * extent, spp=spp,
+           width=width, height=height, shapes='\n'.join(shapes))
+
+    filename = os.path.join(directory, 'scene.xml')
+    with open(filename, 'w') as f:
+        f.write(xml)
+    return filename
+
+
+def find_executable():
+    """Locate the ``mitsuba`` executable (next to the Python package or on the PATH)"""
+    dist = os.path.realpath(os.path.join(os.path.dirname(__file__), '..', '..', '..'))
+    for name in ['mitsuba', 'mitsuba.exe']:
+        candidate = os.path.join(dist, name)
+        if os.path.isfile(candidate):
+            return candidate
+    return shutil.which('mitsuba')
+
+
+def run(scene, threads, mode='scalar_rgb', executable=None):
+    """
+    Render ``scene`` with the given number of threads and return a dictionary
+    with the throughput and memory figures of the run.
+    """
+    executable = executable or find_executable()
+    if executable is None:
+        raise RuntimeError('Could not find the "mitsuba" executable!')
+
+    directory = os.path.dirname(scene)
+    output = os.path.join(directory, 'render_%i.exr' % threads)
+    report = os.path.splitext(output)[0] + '.json'
+    stats = os.path.join(directory, 'stats_%i.json' % threads)
+    for fname in [report, stats]:
+        if os.path.exists(fname):
+            os.remove(fname)
+
+    start = time.time()
+    subprocess.run([executable, '-m', mode, '-t', str(threads), '-r',
+                    '--stats-json', stats, '-o', output, scene],
+                   check=True, stdout=subprocess.DEVNULL)
+    elapsed = time.time() - start
+
+    with open(report) as f:
+        report = json.load(f)
+
+    render_time = report['stages']['render']['wall_s']
+    result = {
+        'threads': threads,
+        'wall_time_s': elapsed,
+        'render_time_s': render_time,
+        'samples_per_second': report.get('samples_per_second'),
+        'rays_per_second': None,
+        'peak_rss_bytes': report['peak_rss_bytes'],
+        'memory_bytes': report['memory_bytes'],
+        'stages': report['stages']
+    }
+
+    # Ray counts are only available when Mitsuba was built with MTS_ENABLE_STATS
+    if os.path.exists(stats):
+        with open(stats) as f:
+            counters = json.load(f)['counters']
+        rays = counters['Intersection rays'] + counters['Shadow rays']
+        if render_time > 0:
+            result['rays_per_second'] = rays / render_time
+
+    return result
+
+
+def thread_counts(max_threads):
+    """Thread counts of a scaling sweep: powers of two up to (and including) ``max_threads``"""
+    counts, n = [], 1
+    while n < max_threads:
+        counts.append(n)
+        n *= 2
+    counts.append(max_threads)
+    return counts
+
+
+def main(args=None):
+    parser = argparse.ArgumentParser(
+        prog='python -m mitsuba.python.benchmark',
+        description='Render a procedurally generated scene with a fixed '
+                    'sample count and report throughput and memory usage.')
+    parser.add_argument('--triangles', type=int, default=100000,
+                        help='Number of triangles (default: %(default)s)')
+    parser.add_argument('--layout', choices=['random', 'clustered'], default='random',
+                        help='Spatial distribution of the triangles (default: %(default)s)')
+    parser.add_argument('--clusters', type=int, default=16,
+                        help='Number of clusters of the "clustered" layout (default: %(default)s)')
+    parser.add_argument('--emitters', type=int, default=1,
+                        help='Number of area lights (default: %(default)s)')
+    parser.add_argument('--repeat', type=int, default=1,
+                        help='Number of copies of the mesh (default: %(default)s)')
+    parser.add_argument('--medium', action='store_true',
+                        help='Add a heterogeneous participating medium')
+    parser.add_argument('--width', type=int, default=256)
+    parser.add_argument('--height', type=int, default=256)
+    parser.add_argument('--spp', type=int, default=16,
+                        help='Samples per pixel (default: %(default)s)')
+    parser.add_argument('--max-depth', type=int, default=6,
+                        help='Maximum path depth (default: %(default)s)')
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('-m', '--mode', default='scalar_rgb',
+                        help='Variant to render with (default: %(default)s)')
+    parser.add_argument('-t', '--threads', type=int, default=os.cpu_count(),
+                        help='Number of threads (maximum thread count with --scaling)')
+    parser.add_argument('--scaling', action='store_true',
+                        help='Render with 1, 2, 4, .., THREADS threads and report '
+                             'the parallel efficiency')
+    parser.add_argument('--mitsuba', default=None,
+                        help='Path to the "mitsuba" executable')
+    parser.add_argument('--scene-dir', default=None,
+                        help='Write the generated scene to this directory '
+                             '(default: temporary directory)')
+    parser.add_argument('-o', '--output', default=None,
+                        help='Write the results to a JSON file')
+    args = parser.parse_args(args)
+
+    directory = args.scene_dir or tempfile.mkdtemp(prefix='mitsuba-benchmark-')
+    try:
+        scene = generate_scene(directory, triangles=args.triangles, layout=args.layout,
+                               clusters=args.clusters, emitters=args.emitters,
+                               repeat=args.repeat, medium=args.medium,
+                               width=args.width, height=args.height, spp=args.spp,
+                               max_depth=args.max_depth, seed=args.seed)
+
+        counts = thread_counts(args.threads) if args.scaling else [args.threads]
+        results = []
+        for n in counts:
+            result = run(scene, n, args.mode, args.mitsuba)
+            if results:
+                base = results[0]
+                speedup = result['samples_per_second'] / base['samples_per_second']
+                result['speedup'] = speedup
+                result['efficiency'] = speedup * base['threads'] / n
+            else:
+                result['speedup'] = result['efficiency'] = 1.0
+            results.append(result)
+
+            rays = result['rays_per_second']
+            print('%3i thread%s: %10.4g samples/s, %s rays/s, peak memory %.1f MiB, '
+                  'efficiency %.1f%%' % (n, ' ' if n == 1 else 's',
+                  result['samples_per_second'],
+                  '%10.4g' % rays if rays is not None else '       n/a',
+                  result['peak_rss_bytes'] / 2 ** 20, 100 * result['efficiency']))
+            sys.stdout.flush()
+
+        if args.output:
+            with open(args.output, 'w') as f:
+                json.dump({'scene': vars(args), 'results': results}, f, indent=2)
+    finally:
+        if args.scene_dir is None:
+            shutil.rmtree(directory, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    main()
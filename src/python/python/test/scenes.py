@@ -255,6 +255,118 @@ def make_museum_plane_scene(spp = 16, roughness = 0.01):
 #     return integrator
 
 
+def make_corner_scene(integrator, emitter='area', spp=64, glass=False):
+    """
+    Small scene (32x32 pixels) consisting of a floor and a wall, which is
+    used to compare integrators against the path tracer.
+
+    ``integrator`` is the XML description of the integrator. ``emitter``
+    is one of ``'point'``, ``'area'`` or ``'small_area'`` (a small and
+    bright area light). When ``glass`` is set, a glass sphere is placed on
+    the floor, which casts a caustic.
+    """
+    emitters = {
+        'point': """<emitter type="point">
+                <point name="position" x="0.5" y="0.5" z="2"/>
+                <spectrum name="intensity" value="10"/>
+            </emitter>""",
+        'area': """<shape type="rectangle">
+                <transform name="to_world">
+                    <scale value="0.5"/>
+                    <rotate x="1" angle="180"/>
+                    <translate z="3"/>
+                </transform>
+                <emitter type="area">
+                    <spectrum name="radiance" value="10"/>
+                </emitter>
+            </shape>""",
+        'small_area': """<shape type="rectangle">
+                <transform name="to_world">
+                    <scale value="0.05"/>
+                    <rotate x="1" angle="180"/>
+                    <translate z="3"/>
+                </transform>
+                <emitter type="area">
+                    <spectrum name="radiance" value="1000"/>
+                </emitter>
+            </shape>"""
+    }
+
+    sphere = """<shape type="sphere">
+            <point name="center" x="0" y="0" z="1"/>
+            <float name="radius" value="0.6"/>
+            <bsdf type="dielectric"/>
+        </shape>"""
+
+    scene = mitsuba.core.xml.load_string("""<scene version="2.0.0">
+        {integrator}
+        <sensor type="perspective">
+            <float name="fov" value="60"/>
+            <transform name="to_world">
+                <lookat origin="0, -4, 3" target="0, 0, 0" up="0, 0, 1"/>
+            </transform>
+            <film type="hdrfilm">
+                <integer name="width" value="32"/>
+                <integer name="height" value="32"/>
+                <rfilter type="box"/>
+            </film>
+            <sampler type="independent">
+                <integer name="sample_count" value="{spp}"/>
+            </sampler>
+        </sensor>
+        <shape type="rectangle">
+            <transform name="to_world">
+                <scale value="2"/>
+            </transform>
+            <bsdf type="diffuse">
+                <rgb name="reflectance" value="0.5"/>
+            </bsdf>
+        </shape>
+        <shape type="rectangle">
+            <transform name="to_world">
+                <rotate y="1" angle="90"/>
+                <translate x="-1.5" z="1"/>
+            </transform>
+            <bsdf type="diffuse">
+                <rgb name="reflectance" value="0.8"/>
+            </bsdf>
+        </shape>
+        {sphere}
+        {emitter}
+    </scene>""".format(integrator=integrator, emitter=emitters[emitter], spp=spp,
+                       sphere=sphere if glass else ''))
+    assert scene is not None
+    return scene
+
+
+def render_scene(scene):
+    """
+    Render a scene with its integrator, and return the raw (linear RGB)
+    contents of the film as a NumPy array
+    """
+    import numpy as np
+    from mitsuba.core import Bitmap, Struct
+
+    sensor = scene.sensors()[0]
+    assert scene.integrator().render(scene, sensor)
+    converted = sensor.film().bitmap(raw=True).convert(
+        Bitmap.PixelFormat.RGB, Struct.Type.Float32, False)
+    return np.array(converted, copy=True)
+
+
+def check_corner_scene(image, ref):
+    """
+    Check that two renderings of ``make_corner_scene()`` agree, both overall
+    and in the left and right halves (which see different parts of the scene)
+    """
+    import numpy as np
+    import enoki as ek
+
+    assert ek.allclose(np.mean(image), np.mean(ref), rtol=5e-2)
+    assert ek.allclose(np.mean(image[:, :16]), np.mean(ref[:, :16]), rtol=8e-2)
+    assert ek.allclose(np.mean(image[:, 16:]), np.mean(ref[:, 16:]), rtol=8e-2)
+
+
 """
 Per-channel (RGBA) average pixel value for the scenes in this file.
 """
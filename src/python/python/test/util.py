@@ -80,3 +80,61 @@ def make_tmpfile(request, tmpdir_factory):
     path_value = str(my_dir.join('tmpfile'))
     open(path_value, 'a').close()
     return path_value
+
+
+def render_executable(tmpdir, args=[]):
+    """
+    Render a small generated benchmark scene (see
+    ``mitsuba.python.benchmark.generate_scene()``) with the ``mitsuba``
+    executable, passing the additional command line arguments ``args``.
+    Returns the filename of the output image.
+
+    The calling test is skipped if the executable cannot be found.
+    """
+    import subprocess
+    from mitsuba.python.benchmark import find_executable, generate_scene
+
+    executable = find_executable()
+    if executable is None:
+        pytest.skip('Could not find the "mitsuba" executable')
+
+    scene = generate_scene(str(tmpdir), triangles=10000, emitters=2,
+                           width=128, height=128, spp=16)
+    output = os.path.join(str(tmpdir), 'render.exr')
+    subprocess.run([executable, '-m', mitsuba.variant(), '-o', output] +
+                   [str(arg) for arg in args] + [scene],
+                   check=True, stdout=subprocess.DEVNULL)
+    return output
+
+
+def make_sampler(name, sample_count=16, **kwargs):
+    """
+    Load a sampler plugin of the given type. Additional integer and boolean
+    parameters of the plugin can be passed as keyword arguments.
+    """
+    from mitsuba.core.xml import load_string
+    props = ''.join(
+        '<boolean name="%s" value="%s"/>' % (k, 'true' if v else 'false')
+        if isinstance(v, bool) else '<integer name="%s" value="%d"/>' % (k, v)
+        for k, v in kwargs.items())
+    s = load_string("""<sampler version="2.0.0" type="%s">
+            <integer name="sample_count" value="%d"/>
+            %s
+        </sampler>""" % (name, sample_count, props))
+    assert s is not None
+    return s
+
+
+def draw_samples(sampler, pixel, dimensions, dim2=False):
+    """
+    Draw all samples of a pixel using ``Sampler.start_sample()``. Returns a
+    list with the values of every dimension, which are 2D points (tuples)
+    when ``dim2`` is set and scalars otherwise.
+    """
+    result = [[] for d in range(dimensions)]
+    for i in range(sampler.sample_count()):
+        sampler.start_sample(pixel, i)
+        for d in range(dimensions):
+            result[d].append(tuple(sampler.next_2d()) if dim2
+                             else sampler.next_1d())
+    return result
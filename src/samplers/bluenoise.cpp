@@ -0,0 +1,178 @@
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/qmc.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/render/sampler.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _sampler-bluenoise:
+
+Blue noise sampler (:monosp:`bluenoise`)
+----------------------------------------
+
+.. pluginparameters::
+
+ * - sample_count
+   - |int|
+   - Number of samples per pixel. Should be a power of two (Default: 4)
+ * - seed
+   - |int|
+   - Seed offset. Rendering successive frames of an animation with different
+     seeds avoids a static noise pattern. (Default: 0)
+
+This plugin distributes the Monte Carlo error of the rendered image as *blue
+noise* in screen space [GF16]_: the error of neighboring pixels is
+anticorrelated, which makes it perceptually less objectionable and easier to
+remove using a denoiser. This is most noticeable at low sample counts, e.g.
+in previews.
+
+All pixels use the same padded and Owen-scrambled Sobol sequence (see the
+:ref:`Sobol <sampler-sobol>` sampler), which is then shifted toroidally
+(Cranley-Patterson rotation) by the value of a 256x256 blue noise tile at the
+pixel position. Each dimension looks up the tile at a different, hashed
+offset, so that all dimensions are decorrelated from each other while
+every one of them remains blue noise in screen space.
+
+Since the sequence itself is the same for all pixels, the error of different
+pixels is only decorrelated by the tile. Compared to the :ref:`Sobol
+<sampler-sobol>` sampler, the error is thus similar in magnitude but
+concentrated at high frequencies.
+
+.. [GF16] Iliyan Georgiev and Marcos Fajardo. Blue-noise Dithered Sampling.
+   ACM SIGGRAPH 2016 Talks.
+
+ */
+
+template <typename Float, typename Spectrum>
+class BlueNoiseSampler final : public Sampler<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Sampler, m_sample_count, m_base_seed)
+    MTS_IMPORT_TYPES()
+
+    BlueNoiseSampler(const Properties &props = Properties()) : Base(props) {
+        if (!math::is_power_of_two(m_sample_count))
+            Log(Warn, "The sample count (%i) should be a power of two for the "
+                      "blue noise sampler to achieve optimal stratification!", m_sample_count);
+        if constexpr (is_cuda_array_v<Float>)
+            m_tile = DynamicBuffer<Float>::copy(dither_matrix256, 256 * 256);
+        if (!is_dynamic_array_v<Float>)
+            seed(0);
+    }
+
+    ref<Base> clone() override {
+        BlueNoiseSampler *sampler = new BlueNoiseSampler();
+        sampler->m_sample_count = m_sample_count;
+        sampler->m_base_seed = m_base_seed;
+        sampler->m_tile = m_tile;
+        return sampler;
+    }
+
+    /// Maps the seed value to a pixel within the tile, see \ref Sampler::seed()
+    void seed(UInt64 seed_value) override {
+        UInt32 value = UInt32(seed_value);
+        if constexpr (is_array_v<Float> && !is_dynamic_array_v<Float>)
+            value += arange<UInt32>();
+        m_pixel = Point2u(value, sr<8>(value));
+        m_sample_index = zero<UInt32>(slices(value));
+        m_dimension = 0;
+    }
+
+    void start_sample(const Point2u &pixel, const UInt32 &sample_index,
+                      Mask active = true) override {
+        if constexpr (is_array_v<Float> && !is_dynamic_array_v<Float>) {
+            masked(m_pixel, active) = pixel;
+            masked(m_sample_index, active) = sample_index;
+        } else {
+            ENOKI_MARK_USED(active);
+            m_pixel = pixel;
+            m_sample_index = sample_index;
+        }
+        m_dimension = 0;
+    }
+
+    Float next_1d(Mask active = true) override {
+        UInt32 index = shuffled_index(active);
+        UInt32 scramble = sample_tea_32(2 * m_dimension + 1, (uint32_t) m_base_seed);
+        UInt32 value = owen_scramble(reverse_bits(index), scramble);
+        value += shift(2 * m_dimension, active);
+        m_dimension++;
+        return fixed_to_unit<Float>(value);
+    }
+
+    Point2f next_2d(Mask active = true) override {
+        UInt32 index = shuffled_index(active);
+        uint64_t scramble = sample_tea_64(2 * m_dimension + 1, (uint32_t) m_base_seed);
+
+        auto [x, y] = sobol_2d(index);
+        x = owen_scramble(x, UInt32((uint32_t) scramble)) + shift(2 * m_dimension, active);
+        y = owen_scramble(y, UInt32((uint32_t) (scramble >> 32))) +
+            shift(2 * m_dimension + 1, active);
+        m_dimension++;
+
+        return Point2f(fixed_to_unit<Float>(x), fixed_to_unit<Float>(y));
+    }
+
+    /// Return the size of the wavefront (or 0, if not seeded)
+    size_t wavefront_size() const override { return slices(m_sample_index); }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "BlueNoiseSampler[" << std::endl
+            << "  sample_count = " << m_sample_count << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    /**
+     * Pseudorandom permutation of the sample indices (decorrelates the
+     * dimensions). Unlike in the Sobol sampler, it is the same for all pixels.
+     */
+    UInt32 shuffled_index(Mask active) const {
+        if constexpr (is_dynamic_array_v<Float>) {
+            if (slices(m_sample_index) == 0)
+                Throw("Sampler::seed() must be invoked before using this sampler!");
+        }
+        UInt32 seed = sample_tea_32(2 * m_dimension, (uint32_t) m_base_seed);
+        return permute_kensler(m_sample_index, (uint32_t) m_sample_count, seed, active);
+    }
+
+    /**
+     * Toroidal shift of the axis \c axis (32 bit fixed point), given by the
+     * blue noise tile at the current pixel. Every axis uses a different
+     * pseudorandom offset into the tile.
+     */
+    UInt32 shift(uint32_t axis, Mask active) const {
+        uint32_t offset = sample_tea_32((uint32_t) m_base_seed, axis);
+        UInt32 x = (m_pixel.x() + offset) & 0xffu,
+               y = (m_pixel.y() + sr<8>(offset)) & 0xffu,
+               index = sl<8>(y) + x;
+
+        Float32 value;
+        if constexpr (is_cuda_array_v<Float>)
+            value = gather<Float>(m_tile, index, active);
+        else
+            value = gather<Float32>(dither_matrix256, index, active);
+
+        // Recover the integer entry of the tile in [0, 65535] (see dither_matrix256)
+        return sl<16>(UInt32(value * 65535.f + 32768.f));
+    }
+
+protected:
+    /// Copy of the blue noise tile on the GPU (unused in CPU variants)
+    DynamicBuffer<Float> m_tile;
+    /// Coordinates of the current pixel
+    Point2u m_pixel;
+    /// Index of the current sample within its pixel
+    UInt32 m_sample_index;
+    /// Number of dimensions (1D or 2D) drawn from the current sample
+    uint32_t m_dimension = 0;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(BlueNoiseSampler, Sampler)
+MTS_EXPORT_PLUGIN(BlueNoiseSampler, "Blue Noise Sampler");
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,191 @@
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/qmc.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/render/sampler.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _sampler-halton:
+
+Halton sampler (:monosp:`halton`)
+---------------------------------
+
+.. pluginparameters::
+
+ * - sample_count
+   - |int|
+   - Number of samples per pixel (Default: 4)
+ * - scramble
+   - |int|
+   - Permutation applied to the digits of the third and higher dimensions:
+     the value -1 selects the Faure permutations, any other value a
+     pseudorandom permutation seeded by this number. (Default: -1)
+
+This plugin generates the points of a scrambled Halton sequence, where
+dimension :math:`i` is given by the radical inverse of the sample index in the
+:math:`i`-th prime base. A single Halton sequence is used for the whole image:
+the first two dimensions are spread over a tile of :math:`128\times 243`
+pixels (the smallest powers of two and three covering 128 pixels), and every
+pixel is assigned the subsequence of points that fall into it. This mapping
+can be inverted in closed form, hence the samples of a pixel can be generated
+in any order [Gru12]_. The samples of each pixel are then well stratified
+along the first two dimensions, and the image does not depend on the order
+in which the blocks are rendered.
+
+Higher dimensions use the digit permutations precomputed by the
+``RadicalInverse`` class to break up the correlations that plague the Halton
+sequence in large prime bases. The sequence provides 1024 dimensions; beyond
+that, the sampler wraps around to the third dimension.
+
+Compared to the :ref:`Sobol <sampler-sobol>` sampler, the radical inverse is
+more costly to evaluate, but all dimensions of a path are sampled from a
+single low-discrepancy sequence instead of being padded.
+
+.. [Gru12] Leonhard Grünschloß, Matthias Raab, and Alexander Keller.
+   Enumerating Quasi-Monte Carlo Point Sequences in Elementary Intervals.
+   Monte Carlo and Quasi-Monte Carlo Methods 2010, 2012.
+
+ */
+
+/// Multiplicative inverse of \c a modulo \c n (extended Euclidean algorithm)
+static constexpr uint64_t multiplicative_inverse(int64_t a, int64_t n) {
+    int64_t t = 0, t_next = 1, r = n, r_next = a % n;
+    while (r_next != 0) {
+        int64_t q = r / r_next, tmp = t - q * t_next;
+        t = t_next; t_next = tmp;
+        tmp = r - q * r_next;
+        r = r_next; r_next = tmp;
+    }
+    return (uint64_t) (t < 0 ? t + n : t);
+}
+
+template <typename Float, typename Spectrum>
+class HaltonSampler final : public Sampler<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Sampler, m_sample_count, m_base_seed)
+    MTS_IMPORT_TYPES()
+
+    HaltonSampler(const Properties &props = Properties()) : Base(props) {
+        m_inv = new RadicalInverse(8161, props.int_("scramble", -1));
+        if (!is_dynamic_array_v<Float>)
+            seed(0);
+    }
+
+    ref<Base> clone() override {
+        HaltonSampler *sampler = new HaltonSampler(m_inv);
+        sampler->m_sample_count = m_sample_count;
+        sampler->m_base_seed = m_base_seed;
+        return sampler;
+    }
+
+    /// Maps the seed value to a pixel within the tile, see \ref Sampler::seed()
+    void seed(UInt64 seed_value) override {
+        UInt32 value = UInt32(seed_value);
+        if constexpr (is_array_v<Float> && !is_dynamic_array_v<Float>)
+            value += arange<UInt32>();
+        m_index = pixel_offset(Point2u(value, value / scale_x));
+        m_dimension = 0;
+    }
+
+    void start_sample(const Point2u &pixel, const UInt32 &sample_index,
+                      Mask active = true) override {
+        UInt64 index = pixel_offset(pixel) + UInt64(sample_index) * stride;
+        if constexpr (is_array_v<Float> && !is_dynamic_array_v<Float>)
+            masked(m_index, active) = index;
+        else {
+            ENOKI_MARK_USED(active);
+            m_index = index;
+        }
+        m_dimension = 0;
+    }
+
+    Float next_1d(Mask /* active */ = true) override {
+        return sample_dimension(next_dimension());
+    }
+
+    Point2f next_2d(Mask /* active */ = true) override {
+        uint32_t dim_x = next_dimension(),
+                 dim_y = next_dimension();
+        return Point2f(sample_dimension(dim_x), sample_dimension(dim_y));
+    }
+
+    /// Return the size of the wavefront (or 0, if not seeded)
+    size_t wavefront_size() const override { return slices(m_index); }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "HaltonSampler[" << std::endl
+            << "  sample_count = " << m_sample_count << "," << std::endl
+            << "  scramble = " << m_inv->scramble() << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    HaltonSampler(RadicalInverse *inv) : Base(Properties()), m_inv(inv) { }
+
+    /// Index of the first point of the Halton sequence that falls into \c pixel
+    UInt64 pixel_offset(const Point2u &pixel) const {
+        /* The radical inverse in base 2 of the index, scaled by 2^7, lands in
+           column 'x' iff the 7 lowest binary digits of the index are those of
+           'x' in reverse order. The same holds for base 3 and row 'y'. Both
+           conditions are combined using the Chinese remainder theorem. */
+        UInt32 x = pixel.x() & (scale_x - 1),
+               y = pixel.y() % scale_y,
+               index_x = sr<32 - exponent_x>(reverse_bits(x)),
+               index_y = zero<UInt32>(slices(y));
+
+        for (uint32_t i = 0; i < exponent_y; ++i) {
+            UInt32 next = y / 3u;
+            index_y = index_y * 3u + (y - next * 3u);
+            y = next;
+        }
+
+        return (UInt64(index_x) * (scale_y * inverse_x) +
+                UInt64(index_y) * (scale_x * inverse_y)) % stride;
+    }
+
+    /// Return the current dimension and advance, wrapping around after the last prime base
+    uint32_t next_dimension() {
+        if constexpr (is_dynamic_array_v<Float>) {
+            if (slices(m_index) == 0)
+                Throw("Sampler::seed() must be invoked before using this sampler!");
+        }
+        uint32_t dim = m_dimension++;
+        if (dim >= m_inv->bases())
+            dim = 2 + (dim - 2) % ((uint32_t) m_inv->bases() - 2);
+        return dim;
+    }
+
+    Float sample_dimension(uint32_t dim) const {
+        /* The leading digits of the first two dimensions select the pixel.
+           Dropping them yields the position within the pixel. */
+        if (dim == 0)
+            return m_inv->eval<Float>(0, sr<exponent_x>(m_index));
+        else if (dim == 1)
+            return m_inv->eval<Float>(1, m_index / (uint64_t) scale_y);
+        else
+            return m_inv->eval_scrambled<Float>(dim, m_index);
+    }
+
+protected:
+    /// Size of the tile over which the first two dimensions are spread (2^7 x 3^5)
+    static constexpr uint32_t exponent_x = 7, scale_x = 128,
+                              exponent_y = 5, scale_y = 243;
+    static constexpr uint64_t stride = (uint64_t) scale_x * scale_y;
+    static constexpr uint64_t inverse_x = multiplicative_inverse(scale_y, scale_x),
+                              inverse_y = multiplicative_inverse(scale_x, scale_y);
+
+    ref<RadicalInverse> m_inv;
+    /// Index of the current sample within the Halton sequence
+    UInt64 m_index;
+    /// Number of dimensions drawn from the current sample
+    uint32_t m_dimension = 0;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(HaltonSampler, Sampler)
+MTS_EXPORT_PLUGIN(HaltonSampler, "Halton Sampler");
+NAMESPACE_END(mitsuba)
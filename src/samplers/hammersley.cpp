@@ -0,0 +1,155 @@
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/qmc.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/render/sampler.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _sampler-hammersley:
+
+Hammersley sampler (:monosp:`hammersley`)
+-----------------------------------------
+
+.. pluginparameters::
+
+ * - sample_count
+   - |int|
+   - Number of samples per pixel (Default: 4)
+ * - scramble
+   - |int|
+   - Permutation applied to the digits of the radical inverse: the value -1
+     selects the Faure permutations, any other value a pseudorandom
+     permutation seeded by this number. (Default: -1)
+ * - seed
+   - |int|
+   - Seed offset (Default: 0)
+
+This plugin generates the points of a scrambled Hammersley point set, whose
+size is given by the sample count. The first dimension of sample :math:`i` is
+:math:`i/N`, and dimension :math:`k>0` is given by the (permuted) radical
+inverse of :math:`i` in the :math:`k`-th prime base. The first 2D sample of
+every pixel is thus a Hammersley point set, which is perfectly stratified.
+
+Every pixel uses the same point set, shifted toroidally (Cranley-Patterson
+rotation) by an offset that is different for every pixel and dimension. The
+offsets are obtained by hashing the pixel coordinates, the dimension and the
+seed offset, so that the resulting image doesn't depend on the order in which
+the blocks are rendered, and the error is decorrelated between pixels.
+
+Unlike the :ref:`Halton <sampler-halton>` sampler, the point set depends on
+the sample count, so progressive rendering with a growing number of samples
+is not possible.
+
+ */
+
+template <typename Float, typename Spectrum>
+class HammersleySampler final : public Sampler<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Sampler, m_sample_count, m_base_seed)
+    MTS_IMPORT_TYPES()
+
+    HammersleySampler(const Properties &props = Properties()) : Base(props) {
+        m_inv = new RadicalInverse(8161, props.int_("scramble", -1));
+        if (!is_dynamic_array_v<Float>)
+            seed(0);
+    }
+
+    ref<Base> clone() override {
+        HammersleySampler *sampler = new HammersleySampler(m_inv);
+        sampler->m_sample_count = m_sample_count;
+        sampler->m_base_seed = m_base_seed;
+        return sampler;
+    }
+
+    /// Maps the seed value to a pixel, see \ref Sampler::seed()
+    void seed(UInt64 seed_value) override {
+        UInt32 value = UInt32(seed_value);
+        if constexpr (is_array_v<Float> && !is_dynamic_array_v<Float>)
+            value += arange<UInt32>();
+        m_pixel_seed = sample_tea_32(value, UInt32((uint32_t) m_base_seed));
+        m_sample_index = zero<UInt32>(slices(m_pixel_seed));
+        m_dimension = 0;
+    }
+
+    void start_sample(const Point2u &pixel, const UInt32 &sample_index,
+                      Mask active = true) override {
+        UInt32 pixel_seed = sample_tea_32(
+            sample_tea_32(pixel.x(), pixel.y()), UInt32((uint32_t) m_base_seed));
+        if constexpr (is_array_v<Float> && !is_dynamic_array_v<Float>) {
+            masked(m_pixel_seed, active) = pixel_seed;
+            masked(m_sample_index, active) = sample_index;
+        } else {
+            ENOKI_MARK_USED(active);
+            m_pixel_seed = pixel_seed;
+            m_sample_index = sample_index;
+        }
+        m_dimension = 0;
+    }
+
+    Float next_1d(Mask /* active */ = true) override {
+        return sample_dimension(next_dimension());
+    }
+
+    Point2f next_2d(Mask /* active */ = true) override {
+        uint32_t dim_x = next_dimension(),
+                 dim_y = next_dimension();
+        return Point2f(sample_dimension(dim_x), sample_dimension(dim_y));
+    }
+
+    /// Return the size of the wavefront (or 0, if not seeded)
+    size_t wavefront_size() const override { return slices(m_pixel_seed); }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "HammersleySampler[" << std::endl
+            << "  sample_count = " << m_sample_count << "," << std::endl
+            << "  scramble = " << m_inv->scramble() << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    HammersleySampler(RadicalInverse *inv) : Base(Properties()), m_inv(inv) { }
+
+    /// Return the current dimension and advance, wrapping around after the last prime base
+    uint32_t next_dimension() {
+        if constexpr (is_dynamic_array_v<Float>) {
+            if (slices(m_pixel_seed) == 0)
+                Throw("Sampler::seed() must be invoked before using this sampler!");
+        }
+        uint32_t dim = m_dimension++;
+        if (dim > m_inv->bases())
+            dim = 1 + (dim - 1) % (uint32_t) m_inv->bases();
+        return dim;
+    }
+
+    Float sample_dimension(uint32_t dim) const {
+        Float value;
+        if (dim == 0)
+            value = Float(m_sample_index) * (1.f / (ScalarFloat) m_sample_count);
+        else
+            value = m_inv->eval_scrambled<Float>(dim - 1, UInt64(m_sample_index));
+
+        // Cranley-Patterson rotation
+        value += Float(sample_tea_float32(m_pixel_seed, UInt32(dim)));
+        value = select(value >= 1.f, value - 1.f, value);
+        return min(value, math::OneMinusEpsilon<Float>);
+    }
+
+protected:
+    ref<RadicalInverse> m_inv;
+    /// Hash of the pixel coordinates and the seed offset
+    UInt32 m_pixel_seed;
+    /// Index of the current sample within its pixel
+    UInt32 m_sample_index;
+    /// Number of dimensions drawn from the current sample
+    uint32_t m_dimension = 0;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(HammersleySampler, Sampler)
+MTS_EXPORT_PLUGIN(HammersleySampler, "Hammersley Sampler");
+NAMESPACE_END(mitsuba)
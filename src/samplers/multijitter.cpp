@@ -0,0 +1,195 @@
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/qmc.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/render/sampler.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _sampler-multijitter:
+
+Correlated multi-jittered sampler (:monosp:`multijitter`)
+---------------------------------------------------------
+
+.. pluginparameters::
+
+ * - sample_count
+   - |int|
+   - Number of samples per pixel (Default: 4)
+ * - seed
+   - |int|
+   - Seed offset (Default: 0)
+ * - jitter
+   - |bool|
+   - Adds additional random jitter within the substratum (Default: |true|)
+
+This plugin implements correlated multi-jittered sampling [Ken13]_, which
+performs well at small sample counts (e.g. 4-16 samples per pixel), where
+independent samples tend to clump.
+
+Each 2D sample is drawn from a grid of :math:`m\times n` strata, where
+:math:`m=\lfloor\sqrt{N}\rfloor` and :math:`n=\lceil N/m\rceil` for a sample
+count :math:`N`, e.g. :math:`2\times 3` strata for :math:`N=5` or :math:`N=6`.
+Every stratum is further subdivided into :math:`n\times m` substrata, so that
+no two samples share a column of width :math:`1/(mn)` or a row of height
+:math:`1/(mn)` (a property known as *multi-jittering*). When :math:`N=mn`
+(e.g. for perfect squares, or 2, 6, 8 and 12 samples), every stratum holds
+exactly one sample, and the samples are stratified along each of the two axes
+on a grid of :math:`N` cells. Other sample counts leave :math:`mn-N` strata of
+the grid (fewer than :math:`m`) empty, and the samples then only cover
+:math:`N` of the :math:`mn` cells along each axis. The rows and columns of such
+partially filled grids are shuffled, so that the empty strata change between
+pixels and dimensions. 1D samples are always stratified on a grid of :math:`N`
+cells.
+
+The strata are shuffled using a hash-based permutation that depends on the
+pixel, the dimension and the seed offset, which decorrelates the dimensions
+and neighboring pixels. The samples of a pixel only depend on these values and
+the sample index, so the sampler doesn't need any precomputed tables and the
+rendered image is independent of the thread scheduling.
+
+.. [Ken13] Andrew Kensler. Correlated Multi-Jittered Sampling. Pixar Technical
+   Memo 13-01, 2013.
+
+ */
+
+template <typename Float, typename Spectrum>
+class MultiJitterSampler final : public Sampler<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Sampler, m_sample_count, m_base_seed)
+    MTS_IMPORT_TYPES()
+
+    MultiJitterSampler(const Properties &props = Properties()) : Base(props) {
+        m_jitter = props.bool_("jitter", true);
+        configure();
+        if (!is_dynamic_array_v<Float>)
+            seed(0);
+    }
+
+    ref<Base> clone() override {
+        MultiJitterSampler *sampler = new MultiJitterSampler();
+        sampler->m_sample_count = m_sample_count;
+        sampler->m_base_seed = m_base_seed;
+        sampler->m_jitter = m_jitter;
+        sampler->configure();
+        return sampler;
+    }
+
+    /// Maps the seed value to a pixel, see \ref Sampler::seed()
+    void seed(UInt64 seed_value) override {
+        UInt32 value = UInt32(seed_value);
+        if constexpr (is_array_v<Float> && !is_dynamic_array_v<Float>)
+            value += arange<UInt32>();
+        m_pixel_seed = sample_tea_32(value, UInt32((uint32_t) m_base_seed));
+        m_sample_index = zero<UInt32>(slices(m_pixel_seed));
+        m_dimension = 0;
+    }
+
+    void start_sample(const Point2u &pixel, const UInt32 &sample_index,
+                      Mask active = true) override {
+        UInt32 pixel_seed = sample_tea_32(
+            sample_tea_32(pixel.x(), pixel.y()), UInt32((uint32_t) m_base_seed));
+        if constexpr (is_array_v<Float> && !is_dynamic_array_v<Float>) {
+            masked(m_pixel_seed, active) = pixel_seed;
+            masked(m_sample_index, active) = sample_index;
+        } else {
+            ENOKI_MARK_USED(active);
+            m_pixel_seed = pixel_seed;
+            m_sample_index = sample_index;
+        }
+        m_dimension = 0;
+    }
+
+    Float next_1d(Mask active = true) override {
+        UInt32 seed = pattern_seed();
+        UInt32 stratum = permute_kensler(m_sample_index, (uint32_t) m_sample_count, seed, active);
+        return (Float(stratum) + jitter(seed, 0x68bc21ebu)) * m_inv_sample_count;
+    }
+
+    Point2f next_2d(Mask active = true) override {
+        UInt32 seed = pattern_seed();
+
+        // Shuffle the samples, then the substrata along each axis
+        UInt32 index = permute_kensler(m_sample_index, (uint32_t) m_sample_count,
+                                       seed * 0x51633e2du, active),
+               sx = index % m_strata_x,
+               sy = index / m_strata_x,
+               px = permute_kensler(sx, m_strata_x, seed * 0x68bc21ebu, active),
+               py = permute_kensler(sy, m_strata_y, seed * 0x02e5be93u, active);
+
+        /* The last row of the grid is only partially filled when the sample
+           count isn't a multiple of the number of columns. Shuffle the rows
+           and columns, so that the empty strata are not always the same. */
+        if ((uint32_t) m_sample_count != m_strata_x * m_strata_y) {
+            sx = permute_kensler(sx, m_strata_x, seed * 0xa511e9b3u, active);
+            sy = permute_kensler(sy, m_strata_y, seed * 0x63d83595u, active);
+        }
+
+        Float x = (Float(sx) + (Float(py) + jitter(seed, 0x967a889bu)) * m_inv_strata_y) *
+                  m_inv_strata_x,
+              y = (Float(sy) + (Float(px) + jitter(seed, 0x368cc8b7u)) * m_inv_strata_x) *
+                  m_inv_strata_y;
+
+        return Point2f(min(x, math::OneMinusEpsilon<Float>),
+                       min(y, math::OneMinusEpsilon<Float>));
+    }
+
+    /// Return the size of the wavefront (or 0, if not seeded)
+    size_t wavefront_size() const override { return slices(m_pixel_seed); }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "MultiJitterSampler[" << std::endl
+            << "  sample_count = " << m_sample_count << "," << std::endl
+            << "  strata = [" << m_strata_x << ", " << m_strata_y << "]," << std::endl
+            << "  jitter = " << m_jitter << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    /// Compute the resolution of the 2D stratification grid
+    void configure() {
+        m_strata_x = std::max(1u, (uint32_t) std::sqrt((double) m_sample_count));
+        m_strata_y = ((uint32_t) m_sample_count + m_strata_x - 1) / m_strata_x;
+        m_inv_strata_x = ScalarFloat(1) / m_strata_x;
+        m_inv_strata_y = ScalarFloat(1) / m_strata_y;
+        m_inv_sample_count = ScalarFloat(1) / m_sample_count;
+    }
+
+    /// Seed of the sample pattern for the current pixel and dimension
+    UInt32 pattern_seed() {
+        if constexpr (is_dynamic_array_v<Float>) {
+            if (slices(m_pixel_seed) == 0)
+                Throw("Sampler::seed() must be invoked before using this sampler!");
+        }
+        return sample_tea_32(m_pixel_seed, UInt32(m_dimension++));
+    }
+
+    /// Position within the substratum
+    Float jitter(const UInt32 &seed, uint32_t salt) const {
+        if (!m_jitter)
+            return Float(.5f);
+        return Float(sample_tea_float32(m_sample_index, seed ^ salt));
+    }
+
+protected:
+    bool m_jitter;
+    /// Resolution of the 2D stratification grid (m x n)
+    uint32_t m_strata_x, m_strata_y;
+    ScalarFloat m_inv_strata_x, m_inv_strata_y, m_inv_sample_count;
+
+    /// Hash of the pixel coordinates and the seed offset
+    UInt32 m_pixel_seed;
+    /// Index of the current sample within its pixel
+    UInt32 m_sample_index;
+    /// Number of dimensions (1D or 2D) drawn from the current sample
+    uint32_t m_dimension = 0;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(MultiJitterSampler, Sampler)
+MTS_EXPORT_PLUGIN(MultiJitterSampler, "Correlated Multi-Jittered Sampler");
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,144 @@
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/qmc.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/render/sampler.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _sampler-sobol:
+
+Sobol sampler (:monosp:`sobol`)
+-------------------------------
+
+.. pluginparameters::
+
+ * - sample_count
+   - |int|
+   - Number of samples per pixel. Should be a power of two (Default: 4)
+ * - seed
+   - |int|
+   - Seed offset (Default: 0)
+
+This plugin generates the points of a randomized Sobol sequence. The first two
+dimensions of the Sobol sequence form a (0, 2)-sequence, which means that the
+samples of every pixel are well stratified along both dimensions and in every
+2D projection at the same time when the sample count is a power of two.
+
+Higher dimensions are obtained by *padding*: every call to ``next_1d()`` or
+``next_2d()`` uses these same two dimensions, but with an independent
+pseudorandom permutation of the sample indices and an independent Owen
+scrambling (implemented using the hash-based approach by Burley [Bur20]_).
+Both are seeded by the pixel coordinates, the dimension and the seed offset,
+so that the resulting image doesn't depend on the order in which the blocks
+are rendered, and the error is decorrelated between pixels.
+
+Compared to the :ref:`independent <sampler-independent>` sampler, images
+typically converge considerably faster, in particular for effects dominated
+by a few dimensions (e.g. antialiasing, depth of field, direct illumination).
+
+.. [Bur20] Brent Burley. Practical Hash-based Owen Scrambling. Journal of
+   Computer Graphics Techniques, Vol. 9, 4, 2020.
+
+ */
+
+template <typename Float, typename Spectrum>
+class SobolSampler final : public Sampler<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Sampler, m_sample_count, m_base_seed)
+    MTS_IMPORT_TYPES()
+
+    SobolSampler(const Properties &props = Properties()) : Base(props) {
+        if (!math::is_power_of_two(m_sample_count))
+            Log(Warn, "The sample count (%i) should be a power of two for the "
+                      "Sobol sampler to achieve optimal stratification!", m_sample_count);
+        if (!is_dynamic_array_v<Float>)
+            seed(0);
+    }
+
+    ref<Base> clone() override {
+        SobolSampler *sampler = new SobolSampler();
+        sampler->m_sample_count = m_sample_count;
+        sampler->m_base_seed = m_base_seed;
+        return sampler;
+    }
+
+    /// Maps the seed value to a pixel, see \ref Sampler::seed()
+    void seed(UInt64 seed_value) override {
+        UInt32 value = UInt32(seed_value);
+        if constexpr (is_array_v<Float> && !is_dynamic_array_v<Float>)
+            value += arange<UInt32>();
+        m_pixel_seed = sample_tea_32(value, UInt32((uint32_t) m_base_seed));
+        m_sample_index = zero<UInt32>(slices(m_pixel_seed));
+        m_dimension = 0;
+    }
+
+    void start_sample(const Point2u &pixel, const UInt32 &sample_index,
+                      Mask active = true) override {
+        UInt32 pixel_seed = sample_tea_32(
+            sample_tea_32(pixel.x(), pixel.y()), UInt32((uint32_t) m_base_seed));
+        if constexpr (is_array_v<Float> && !is_dynamic_array_v<Float>) {
+            masked(m_pixel_seed, active) = pixel_seed;
+            masked(m_sample_index, active) = sample_index;
+        } else {
+            ENOKI_MARK_USED(active);
+            m_pixel_seed = pixel_seed;
+            m_sample_index = sample_index;
+        }
+        m_dimension = 0;
+    }
+
+    Float next_1d(Mask active = true) override {
+        UInt32 index = shuffled_index(active);
+        UInt32 scramble = sample_tea_32(m_pixel_seed, UInt32(2 * m_dimension + 1));
+        m_dimension++;
+        return fixed_to_unit<Float>(owen_scramble(reverse_bits(index), scramble));
+    }
+
+    Point2f next_2d(Mask active = true) override {
+        UInt32 index = shuffled_index(active);
+        UInt64 scramble = sample_tea_64(m_pixel_seed, UInt32(2 * m_dimension + 1));
+        m_dimension++;
+
+        auto [x, y] = sobol_2d(index);
+        return Point2f(fixed_to_unit<Float>(owen_scramble(x, UInt32(scramble))),
+                       fixed_to_unit<Float>(owen_scramble(y, UInt32(sr<32>(scramble)))));
+    }
+
+    /// Return the size of the wavefront (or 0, if not seeded)
+    size_t wavefront_size() const override { return slices(m_pixel_seed); }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "SobolSampler[" << std::endl
+            << "  sample_count = " << m_sample_count << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    /// Pseudorandom permutation of the sample indices (decorrelates the dimensions)
+    UInt32 shuffled_index(Mask active) {
+        if constexpr (is_dynamic_array_v<Float>) {
+            if (slices(m_pixel_seed) == 0)
+                Throw("Sampler::seed() must be invoked before using this sampler!");
+        }
+        UInt32 seed = sample_tea_32(m_pixel_seed, UInt32(2 * m_dimension));
+        return permute_kensler(m_sample_index, (uint32_t) m_sample_count, seed, active);
+    }
+
+protected:
+    /// Hash of the pixel coordinates and the seed offset
+    UInt32 m_pixel_seed;
+    /// Index of the current sample within its pixel
+    UInt32 m_sample_index;
+    /// Number of dimensions (1D or 2D) drawn from the current sample
+    uint32_t m_dimension = 0;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(SobolSampler, Sampler)
+MTS_EXPORT_PLUGIN(SobolSampler, "Sobol Sampler");
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,55 @@
+import mitsuba
+import numpy as np
+
+from mitsuba.python.test.util import make_sampler, draw_samples
+
+# Checks shared with the other samplers are in test_samplers.py
+
+
+def estimate(sampler, size, dimension):
+    """Estimate the integral of f(x) = x over [0, 1] in every pixel of an
+    image, using the given dimension of the sampler, and return the error"""
+    result = np.zeros((size, size))
+    for y in range(size):
+        for x in range(size):
+            sampler.seed(y * size + x)
+            for i in range(sampler.sample_count()):
+                sampler.start_sample([x, y], i)
+                for d in range(dimension):
+                    sampler.next_1d()
+                result[y, x] += sampler.next_1d()
+    return result / sampler.sample_count() - 0.5
+
+
+def low_frequency_power(error):
+    """Fraction of the power spectrum of the error below 1/8 of the sampling
+    frequency (~5% for white noise)"""
+    error = error - np.mean(error)
+    spectrum = np.abs(np.fft.fft2(error)) ** 2
+    freq = np.fft.fftfreq(error.shape[0])
+    radius = np.sqrt(freq[:, None] ** 2 + freq[None, :] ** 2)
+    return np.sum(spectrum[radius < 0.125]) / np.sum(spectrum)
+
+
+def test01_stratification(variant_scalar_rgb):
+    # The toroidal shift preserves the stratification of every dimension
+    s = make_sampler('bluenoise', sample_count=64)
+    for pixel in [[0, 0], [5, 17], [300, 1000]]:
+        for values in draw_samples(s, pixel, 3):
+            assert sorted(int(v * 64) for v in values) == list(range(64))
+
+
+def test02_error_spectrum(variant_scalar_rgb):
+    # The error is blue noise in screen space, in every dimension
+    white = low_frequency_power(estimate(make_sampler('independent', 1), 64, 0))
+    assert white > 0.02
+
+    for sample_count in [1, 4]:
+        for dimension in [0, 3]:
+            blue = low_frequency_power(
+                estimate(make_sampler('bluenoise', sample_count), 64, dimension))
+            assert blue < 0.5 * white
+
+    # .. and the pattern depends on the seed
+    assert not np.allclose(estimate(make_sampler('bluenoise', 4, seed=0), 8, 0),
+                           estimate(make_sampler('bluenoise', 4, seed=1), 8, 0))
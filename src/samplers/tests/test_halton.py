@@ -0,0 +1,32 @@
+import mitsuba
+import enoki as ek
+
+from mitsuba.python.test.util import make_sampler, draw_samples
+
+# Checks shared with the other samplers are in test_samplers.py
+
+
+def test01_stratification(variant_scalar_rgb):
+    # The first two dimensions of every pixel are stratified in base 2 and 3
+    for pixel in [[0, 0], [5, 17], [300, 1000]]:
+        x, y, z = draw_samples(make_sampler('halton', sample_count=27), pixel, 3)
+        assert sorted(int(v * 27) for v in y) == list(range(27))
+
+        x, y = draw_samples(make_sampler('halton', sample_count=16), pixel, 2)
+        assert sorted(int(v * 16) for v in x) == list(range(16))
+
+
+def test02_pixel_mapping(variant_scalar_rgb):
+    # Neighboring pixels receive disjoint parts of the same Halton sequence
+    from mitsuba.core import RadicalInverse
+    s, inv = make_sampler('halton'), RadicalInverse()
+    samples = {}
+    for pixel in [[0, 0], [1, 0], [0, 1], [127, 242]]:
+        s.start_sample(pixel, 3)
+        samples[tuple(pixel)] = (s.next_1d(), s.next_1d(), s.next_1d())
+    assert len(set(samples.values())) == 4
+
+    # The scrambled dimensions come from the radical inverse tables
+    s.start_sample([0, 0], 0)
+    s.next_2d()
+    assert ek.allclose(s.next_1d(), inv.eval_scrambled(2, 0))
@@ -0,0 +1,14 @@
+import mitsuba
+
+from mitsuba.python.test.util import make_sampler, draw_samples
+
+# Checks shared with the other samplers are in test_samplers.py
+
+
+def test01_stratification(variant_scalar_rgb):
+    # The rotated point set remains stratified along the first two dimensions
+    s = make_sampler('hammersley', sample_count=32)
+    for pixel in [[0, 0], [5, 17], [123, 4]]:
+        values = draw_samples(s, pixel, 2)
+        for d in range(2):
+            assert sorted(int(v * 32) for v in values[d]) == list(range(32))
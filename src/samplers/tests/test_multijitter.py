@@ -0,0 +1,54 @@
+import mitsuba
+import pytest
+import enoki as ek
+
+from mitsuba.python.test.util import make_sampler, draw_samples
+
+# Checks shared with the other samplers are in test_samplers.py
+
+
+def test01_strata(variant_scalar_rgb):
+    s = make_sampler('multijitter', sample_count=12)
+    assert "strata = [3, 4]" in str(s)
+
+
+@pytest.mark.parametrize("sample_count, m, n", [(4, 2, 2), (8, 2, 4), (12, 3, 4), (16, 4, 4)])
+def test02_stratification(variant_scalar_rgb, sample_count, m, n):
+    s = make_sampler('multijitter', sample_count=sample_count)
+    for pixel in [[0, 0], [5, 17]]:
+        for points in draw_samples(s, pixel, 3, dim2=True):
+            assert all(0 <= x < 1 and 0 <= y < 1 for x, y in points)
+            # One sample per 2D stratum ..
+            assert len(set((int(x * m), int(y * n)) for x, y in points)) == sample_count
+            # .. and per 1D stratum along each axis
+            assert sorted(int(x * sample_count) for x, y in points) == list(range(sample_count))
+            assert sorted(int(y * sample_count) for x, y in points) == list(range(sample_count))
+
+
+def test03_no_jitter(variant_scalar_rgb):
+    # Without jitter, the samples lie at the center of the substrata
+    s = make_sampler('multijitter', jitter=False)
+    for x, y in draw_samples(s, [1, 2], 1, dim2=True)[0]:
+        assert ek.allclose((x * 16) % 1, 0.5) and ek.allclose((y * 16) % 1, 0.5)
+
+
+@pytest.mark.parametrize("sample_count, m, n", [(5, 2, 3), (7, 2, 4), (10, 3, 4)])
+def test04_partial_grid(variant_scalar_rgb, sample_count, m, n):
+    s = make_sampler('multijitter', sample_count=sample_count)
+    empty = set()
+    for pixel in [[i, 2 * i + 1] for i in range(16)]:
+        for points in draw_samples(s, pixel, 2, dim2=True):
+            assert all(0 <= x < 1 and 0 <= y < 1 for x, y in points)
+            # One sample per occupied 2D stratum, and distinct 1D cells of size 1 / (m * n)
+            strata = set((int(x * m), int(y * n)) for x, y in points)
+            assert len(strata) == sample_count
+            assert len(set(int(x * m * n) for x, y in points)) == sample_count
+            assert len(set(int(y * m * n) for x, y in points)) == sample_count
+            empty.update(set((i, j) for i in range(m) for j in range(n)) - strata)
+
+        # 1D samples are stratified on a grid of N cells
+        for values in draw_samples(s, pixel, 2):
+            assert sorted(int(v * sample_count) for v in values) == list(range(sample_count))
+
+    # The empty strata differ between pixels and dimensions
+    assert len(empty) > m * n - sample_count
@@ -0,0 +1,76 @@
+"""
+Checks shared by the samplers that implement Sampler.start_sample(). The
+sequence-specific properties are tested in the files of the individual
+samplers.
+"""
+
+import mitsuba
+import pytest
+import enoki as ek
+
+from mitsuba.python.test.util import make_sampler, draw_samples
+
+# Sampler plugins and the name of the parameter that selects the randomization
+SAMPLERS = [
+    ('sobol', 'seed'),
+    ('halton', 'scramble'),
+    ('hammersley', 'seed'),
+    ('bluenoise', 'seed'),
+    ('multijitter', 'seed'),
+]
+
+
+@pytest.mark.parametrize("name, seed", SAMPLERS)
+def test01_construct(variant_scalar_rgb, name, seed):
+    s = make_sampler(name, sample_count=64)
+    assert s.sample_count() == 64
+
+
+@pytest.mark.parametrize("name, seed", SAMPLERS)
+def test02_stratification(variant_scalar_rgb, name, seed):
+    # The first dimension of every pixel is stratified
+    s = make_sampler(name, sample_count=16)
+    for pixel in [[0, 0], [5, 17], [300, 1000]]:
+        values = draw_samples(s, pixel, 3)
+        assert all(0 <= v < 1 for d in values for v in d)
+        assert sorted(int(v * 16) for v in values[0]) == list(range(16))
+
+
+@pytest.mark.parametrize("name, seed", SAMPLERS)
+def test03_deterministic(variant_scalar_rgb, name, seed):
+    # Samples only depend on the pixel, the sample index and the seed
+    s1, s2 = make_sampler(name), make_sampler(name).clone()
+    assert draw_samples(s1, [7, 9], 3) == draw_samples(s2, [7, 9], 3)
+    assert draw_samples(s1, [7, 9], 3) != draw_samples(s1, [9, 7], 3)
+    assert draw_samples(s1, [7, 9], 3) != \
+        draw_samples(make_sampler(name, **{seed: 1}), [7, 9], 3)
+
+
+@pytest.mark.parametrize("name, seed", SAMPLERS)
+def test04_packet(variant_scalar_rgb, name, seed):
+    """The lanes of a packet match the scalar sampler for the same pixel and
+    sample index"""
+
+    s = make_sampler(name)
+    s.start_sample([2, 3], 5)
+    reference = [s.next_2d(), s.next_1d()]
+
+    try:
+        mitsuba.set_variant('packet_rgb')
+    except:
+        pytest.skip("packet_rgb mode not enabled")
+
+    s_p = make_sampler(name)
+    s_p.start_sample([2, 3], 5)
+    p = s_p.next_2d()
+    assert ek.allclose(p[0][0], reference[0][0])
+    assert ek.allclose(p[1][0], reference[0][1])
+    assert ek.allclose(s_p.next_1d()[0], reference[1])
+
+
+@pytest.mark.parametrize("name, seed", SAMPLERS)
+def test05_single_sample(variant_scalar_rgb, name, seed):
+    # The permutations of a single sample are trivial
+    s = make_sampler(name, sample_count=1)
+    values = draw_samples(s, [4, 2], 3)
+    assert all(len(d) == 1 and 0 <= d[0] < 1 for d in values)
@@ -0,0 +1,40 @@
+import mitsuba
+
+from mitsuba.python.test.util import make_sampler, draw_samples
+
+# Checks shared with the other samplers are in test_samplers.py
+
+
+def is_net(points):
+    """Check that the points form a (0, m, 2)-net in base 2"""
+    n = len(points)
+    m = n.bit_length() - 1
+    for k in range(m + 1):
+        nx, ny = 2 ** k, 2 ** (m - k)
+        cells = set((int(x * nx), int(y * ny)) for x, y in points)
+        if len(cells) != n:
+            return False
+    return True
+
+
+def test01_nets(variant_scalar_rgb):
+    # Every (padded) dimension of every pixel is an Owen-scrambled Sobol net
+    s = make_sampler('sobol', sample_count=64)
+    for pixel in [[0, 0], [5, 17], [123, 4]]:
+        for points in draw_samples(s, pixel, 4, dim2=True):
+            assert all(0 <= x < 1 and 0 <= y < 1 for x, y in points)
+            assert is_net(points)
+
+    # 1D samples following a 2D sample are stratified as well
+    values = []
+    for i in range(s.sample_count()):
+        s.start_sample([3, 3], i)
+        s.next_2d()
+        values.append(s.next_1d())
+    assert sorted(int(v * 64) for v in values) == list(range(64))
+
+
+def test02_decorrelated(variant_scalar_rgb):
+    # The dimensions use different scrambles
+    points = draw_samples(make_sampler('sobol'), [7, 9], 2, dim2=True)
+    assert points[0] != points[1]
@@ -221,6 +221,53 @@ public:
         return std::make_pair(ray, wav_weight);
     }
 
+    /**
+     * \brief Connect a point in the scene to the pinhole (e.g. in light tracing)
+     *
+     * The importance is normalized over the crop window, i.e. it integrates
+     * to one over the subtended solid angle. The field \c uv of the returned
+     * record holds the position of the point in fractional pixel coordinates
+     * relative to the crop window.
+     */
+    std::pair<DirectionSample3f, Spectrum>
+    sample_direction(const Interaction3f &it, const Point2f & /*sample*/,
+                     Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::EndpointSampleDirection, active);
+
+        // Transform the reference point into the local coordinate system
+        auto trafo = m_world_transform->eval(it.time, active);
+        Point3f ref_p = trafo.inverse().transform_affine(it.p);
+
+        // Check if it is outside of the clip range
+        active &= ref_p.z() >= m_near_clip && ref_p.z() <= m_far_clip;
+
+        // Project onto the image plane
+        Point3f screen_sample = m_camera_to_sample * ref_p;
+        DirectionSample3f ds;
+        ds.uv = Point2f(screen_sample.x(), screen_sample.y());
+        active &= all(ds.uv >= 0.f && ds.uv <= 1.f);
+        ds.uv *= m_resolution;
+
+        Vector3f local_d(ref_p);
+        Float dist     = norm(local_d),
+              inv_dist = rcp(dist);
+        local_d *= inv_dist;
+
+        ds.p     = trafo.translation();
+        ds.n     = Normal3f(trafo * Vector3f(0.f, 0.f, 1.f));
+        ds.d     = (ds.p - it.p) * inv_dist;
+        ds.dist  = dist;
+        ds.time  = it.time;
+        ds.pdf   = select(active, Float(1.f), Float(0.f));
+        ds.delta = true;
+
+        return { ds, Spectrum(importance(local_d) * sqr(inv_dist)) & active };
+    }
+
+    Float pdf_direction(const Interaction3f &, const DirectionSample3f &, Mask) const override {
+        return 0.f;
+    }
+
     ScalarBoundingBox3f bbox() const override {
         return m_world_transform->translation_bounds();
     }
@@ -234,6 +281,28 @@ public:
     //! @}
     // =============================================================
 
+    /**
+     * \brief Importance of the direction \c d (in local coordinates) with
+     * respect to the solid angle
+     *
+     * A uniform density over the crop window on the plane z=1 corresponds to
+     * the density \f$1/(A \cos^3\theta)\f$ per unit solid angle, where
+     * \f$A\f$ is the area of the crop window on that plane.
+     */
+    Float importance(const Vector3f &d) const {
+        Float cos_theta = Frame3f::cos_theta(d);
+
+        // Check for a direction that is not in front of the camera
+        Mask valid = cos_theta > 0.f;
+
+        // Check if it falls into the image (in the plane z=1)
+        Float inv_cos_theta = rcp(cos_theta);
+        Point2f p(d.x() * inv_cos_theta, d.y() * inv_cos_theta);
+        valid &= m_image_rect.contains(p);
+
+        return select(valid, m_normalization * inv_cos_theta * sqr(inv_cos_theta), 0.f);
+    }
+
     void traverse(TraversalCallback *callback) override {
         Base::traverse(callback);
         // TODO x_fov
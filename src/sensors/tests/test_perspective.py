@@ -157,3 +157,39 @@ def test04_fov_axis(variant_packet_spectral, origin, direction, fov):
             check_fov(camera, sample)
 
 
+
+@pytest.mark.parametrize("origin", origins)
+@pytest.mark.parametrize("direction", directions)
+def test05_sample_direction(variant_scalar_rgb, origin, direction):
+    # Check that sample_direction() is consistent with sample_ray()
+    from mitsuba.render import Interaction3f
+
+    camera = create_camera(origin, direction)
+    it = Interaction3f()
+    it.time = 0
+
+    for sample in [[0.5, 0.5], [0.2, 0.1], [0.6, 0.9]]:
+        ray, _ = camera.sample_ray(0, 0, sample, 0)
+        it.p = ray(5)
+        ds, weight = camera.sample_direction(it, [0, 0])
+
+        assert ek.allclose(ds.uv, [sample[0] * 512, sample[1] * 256], atol=1e-3)
+        assert ek.allclose(ds.p, origin)
+        assert ek.allclose(ds.d, -ray.d)
+        assert ek.allclose(ds.dist, 5)
+        assert ds.pdf == 1 and ds.delta
+
+        # The importance integrates to one over the image: at its center,
+        # it is the reciprocal of the image area on the plane at distance 1
+        if sample == [0.5, 0.5]:
+            width = 2 * ek.tan(34 / 2 * ek.pi / 180)
+            area = width * width / 2
+            assert ek.allclose(weight, 1 / (area * 25))
+
+    # Points behind the camera (or outside of the image) are invisible
+    it.p = ray(-5)
+    ds, weight = camera.sample_direction(it, [0, 0])
+    assert ds.pdf == 0 and ek.all(weight == 0)
+    it.p = [x + 10 * y for x, y in zip(origin, [direction[1], direction[2], direction[0]])]
+    ds, weight = camera.sample_direction(it, [0, 0])
+    assert ds.pdf == 0 and ek.all(weight == 0)
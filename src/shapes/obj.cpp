@@ -3,6 +3,7 @@
 #include <mitsuba/render/sensor.h>
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/report.h>
 #include <mitsuba/core/mmap.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/timer.h>
@@ -29,6 +30,14 @@ Wavefront OBJ mesh loader (:monosp:`obj`)
  * - flip_tex_coords
    - |bool|
    - Treat the vertical component of the texture as inverted? Most OBJ files use this convention. (Default: |true|)
+ * - compact_attributes
+   - |bool|
+   - Store vertex attributes and face indices using compact encodings, see
+     :ref:`mesh storage options <sec-mesh-options>`. (Default: |false|)
+ * - optimize_layout
+   - |bool|
+   - Reorder faces and vertices along a Morton curve, see
+     :ref:`mesh storage options <sec-mesh-options>`. (Default: |false|)
  * - to_world
    - |transform|
    - Specifies an optional linear object-to-world transformation.
@@ -77,8 +86,9 @@ public:
     MTS_IMPORT_BASE(Mesh, m_vertices, m_faces, m_normal_offset, m_vertex_size, m_face_size,
                     m_texcoord_offset, m_color_offset, m_name, m_bbox, m_to_world, m_vertex_count,
                     m_face_count, m_vertex_struct, m_face_struct, m_disable_vertex_normals,
+                    m_compact_attributes, compact_attributes, m_optimize_layout, optimize_layout,
                     recompute_vertex_normals, is_emitter, emitter, sensor, is_sensor,
-                    has_vertex_normals, vertex)
+                    has_vertex_normals, vertex, allocate_buffer)
     MTS_IMPORT_TYPES()
 
     using typename Base::ScalarSize;
@@ -110,6 +120,7 @@ public:
                       .c_str(), m_name, args...);
         };
 
+        ScopedStage stage(ReportStage::Geometry);
         Log(Debug, "Loading mesh from \"%s\" ..", m_name);
         if (!fs::exists(file_path))
             fail("file not found");
@@ -301,8 +312,8 @@ public:
 
         m_vertex_size = (ScalarSize) m_vertex_struct->size();
         m_face_size   = (ScalarSize) m_face_struct->size();
-        m_vertices    = VertexHolder(new uint8_t[(m_vertex_count + 1) * m_vertex_size]);
-        m_faces       = FaceHolder(new uint8_t[(m_face_count + 1) * m_face_size]);
+        m_vertices    = allocate_buffer((m_vertex_count + 1) * m_vertex_size);
+        m_faces       = allocate_buffer((m_face_count + 1) * m_face_size);
         memcpy(m_faces.get(), triangles.data(), m_face_count * m_face_size);
 
         for (const auto& v_ : vertex_map) {
@@ -343,6 +354,12 @@ public:
         if (!m_disable_vertex_normals && normals.empty())
             recompute_vertex_normals();
 
+        if (m_optimize_layout)
+            optimize_layout();
+
+        if (m_compact_attributes)
+            compact_attributes();
+
         if (is_emitter())
             emitter()->set_shape(this);
         if (is_sensor())
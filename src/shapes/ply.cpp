@@ -5,6 +5,7 @@
 #include <mitsuba/core/mstream.h>
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/report.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/timer.h>
 #include <enoki/half.h>
@@ -30,6 +31,14 @@ PLY (Stanford Triangle Format) mesh loader (:monosp:`ply`)
    - When set to |true|, any existing or computed vertex normals are
      discarded and *face normals* will instead be used during rendering.
      This gives the rendered object a faceted appearance. (Default: |false|)
+ * - compact_attributes
+   - |bool|
+   - Store vertex attributes and face indices using compact encodings, see
+     :ref:`mesh storage options <sec-mesh-options>`. (Default: |false|)
+ * - optimize_layout
+   - |bool|
+   - Reorder faces and vertices along a Morton curve, see
+     :ref:`mesh storage options <sec-mesh-options>`. (Default: |false|)
  * - to_world
    - |transform|
    - Specifies an optional linear object-to-world transformation.
@@ -55,7 +64,9 @@ public:
     MTS_IMPORT_BASE(Mesh, m_vertices, m_faces, m_normal_offset, m_vertex_size, m_face_size,
                     m_texcoord_offset, m_color_offset, m_name, m_bbox, m_to_world, m_vertex_count,
                     m_face_count, m_vertex_struct, m_face_struct, m_disable_vertex_normals,
-                    recompute_vertex_normals, is_emitter, emitter, is_sensor, sensor)
+                    m_compact_attributes, compact_attributes, m_optimize_layout, optimize_layout,
+                    recompute_vertex_normals, is_emitter, emitter, is_sensor, sensor,
+                    allocate_buffer)
     MTS_IMPORT_TYPES()
 
     using typename Base::ScalarSize;
@@ -90,6 +101,7 @@ public:
             Throw("Error while loading PLY file \"%s\": %s!", m_name, descr);
         };
 
+        ScopedStage stage(ReportStage::Geometry);
         Log(Debug, "Loading mesh from \"%s\" ..", m_name);
         if (!fs::exists(file_path))
             fail("file not found");
@@ -165,7 +177,7 @@ public:
                 }
 
                 /* Allocate memory for vertices (+1 unused entry) */
-                m_vertices = VertexHolder(new uint8_t[(el.count + 1) * o_struct_size]);
+                m_vertices = allocate_buffer((el.count + 1) * o_struct_size);
 
                 /* Clear unused entry */
                 memset(m_vertices.get() + o_struct_size * el.count, 0, o_struct_size);
@@ -239,7 +251,7 @@ public:
                     fail(e.what());
                 }
 
-                m_faces = FaceHolder(new uint8_t[(el.count + 1) * o_struct_size]);
+                m_faces = allocate_buffer((el.count + 1) * o_struct_size);
 
                 size_t packet_count     = el.count / elements_per_packet;
                 size_t remainder_count  = el.count % elements_per_packet;
@@ -282,6 +294,12 @@ public:
         if (!m_disable_vertex_normals && !has_vertex_normals)
             recompute_vertex_normals();
 
+        if (m_optimize_layout)
+            optimize_layout();
+
+        if (m_compact_attributes)
+            compact_attributes();
+
         if (is_emitter())
             emitter()->set_shape(this);
         if (is_sensor())
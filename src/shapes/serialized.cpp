@@ -5,6 +5,7 @@
 #include <mitsuba/core/zstream.h>
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/report.h>
 #include <mitsuba/core/timer.h>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -30,6 +31,14 @@ Serialized mesh loader (:monosp:`serialized`)
    - When set to |true|, any existing or computed vertex normals are
      discarded and \emph{face normals} will instead be used during rendering.
      This gives the rendered object a faceted appearance.(Default: |false|)
+ * - compact_attributes
+   - |bool|
+   - Store vertex attributes and face indices using compact encodings, see
+     :ref:`mesh storage options <sec-mesh-options>`. (Default: |false|)
+ * - optimize_layout
+   - |bool|
+   - Reorder faces and vertices along a Morton curve, see
+     :ref:`mesh storage options <sec-mesh-options>`. (Default: |false|)
  * - to_world
    - |transform|
    - Specifies an optional linear object-to-world transformation.
@@ -146,9 +155,10 @@ public:
     MTS_IMPORT_BASE(Mesh, m_vertices, m_faces, m_normal_offset, m_vertex_size, m_face_size,
                     m_texcoord_offset, m_color_offset, m_name, m_bbox, m_to_world, m_vertex_count,
                     m_face_count, m_vertex_struct, m_face_struct, m_disable_vertex_normals,
+                    m_compact_attributes, compact_attributes, m_optimize_layout, optimize_layout,
                     recompute_vertex_normals, is_emitter, emitter, is_sensor, sensor, 
                     vertex, has_vertex_normals, has_vertex_texcoords, vertex_texcoord, 
-                    vertex_normal, vertex_position)
+                    vertex_normal, vertex_position, allocate_buffer)
     MTS_IMPORT_TYPES()
 
     using typename Base::ScalarSize;
@@ -182,6 +192,7 @@ public:
         fs::path file_path = fs->resolve(props.string("filename"));
         m_name = file_path.filename().string();
 
+        ScopedStage stage(ReportStage::Geometry);
         Log(Debug, "Loading mesh from \"%s\" ..", m_name);
         if (!fs::exists(file_path))
             fail("file not found");
@@ -293,11 +304,11 @@ public:
 
         m_vertex_size = (ScalarSize) m_vertex_struct->size();
         m_vertex_count = (ScalarSize) vertex_count;
-        m_vertices = VertexHolder(new uint8_t[(m_vertex_count + 1) * m_vertex_size]);
+        m_vertices = allocate_buffer((m_vertex_count + 1) * m_vertex_size);
 
         m_face_size = (ScalarSize) m_face_struct->size();
         m_face_count = (ScalarSize) face_count;
-        m_faces = FaceHolder(new uint8_t[(m_face_count + 1) * m_face_size]);
+        m_faces = allocate_buffer((m_face_count + 1) * m_face_size);
 
         bool double_precision = has_flag(flags, TriMeshFlags::DoublePrecision);
         read_helper(stream, double_precision, m_vertex_struct->offset("x"), 3);
@@ -346,6 +357,12 @@ public:
         if (!m_disable_vertex_normals && !has_flag(flags, TriMeshFlags::HasNormals))
             recompute_vertex_normals();
 
+        if (m_optimize_layout)
+            optimize_layout();
+
+        if (m_compact_attributes)
+            compact_attributes();
+
         if (is_emitter())
             emitter()->set_shape(this);
         if (is_sensor())
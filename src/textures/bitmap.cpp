@@ -1,7 +1,9 @@
 #include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/memtrack.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/report.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/texture.h>
@@ -64,6 +66,7 @@ public:
         FileResolver* fs = Thread::thread()->file_resolver();
         fs::path file_path = fs->resolve(props.string("filename"));
         m_name = file_path.filename().string();
+        ScopedStage stage(ReportStage::Textures);
         Log(Debug, "Loading bitmap texture from \"%s\" ..", m_name);
 
         m_bitmap = new Bitmap(file_path);
@@ -192,6 +195,8 @@ public:
           m_name(name), m_transform(transform), m_mean(mean) {
         m_data = DynamicBuffer<Float>::copy(bitmap->data(),
             hprod(m_resolution) * Channels);
+        m_memory.reset(MemoryCategory::Textures,
+                       hprod(m_resolution) * Channels * sizeof(ScalarFloat));
     }
 
     void traverse(TraversalCallback *callback) override {
@@ -355,6 +360,7 @@ public:
     MTS_DECLARE_CLASS()
 protected:
     DynamicBuffer<Float> m_data;
+    TrackedAllocation m_memory;
     ScalarVector2u m_resolution;
     std::string m_name;
     ScalarTransform3f m_transform;
@@ -1,5 +1,6 @@
 #include <enoki/stl.h>
 
+#include <mitsuba/core/memtrack.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
@@ -119,6 +120,7 @@ public:
         m_data     = data;
         m_metadata = meta;
         m_size     = hprod(m_metadata.shape);
+        m_memory.reset(MemoryCategory::Volumes, m_data.size() * sizeof(ScalarFloat));
         if (props.bool_("use_grid_bbox", false)) {
             m_world_to_local = m_metadata.transform * m_world_to_local;
             update_bbox();
@@ -386,6 +388,7 @@ public:
     MTS_DECLARE_CLASS()
 protected:
     DynamicBuffer<Float> m_data;
+    TrackedAllocation m_memory;
     bool m_fixed_max = false;
     VolumeMetadata m_metadata;
     size_t m_size;